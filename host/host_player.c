@@ -0,0 +1,388 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file host_player.c
+ * @brief Synchronous player on the real audio provider (host build)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "host_player.h"
+
+#define HOST_CHUNK_SAMPLES  960     // One ROBUST-profile mix chunk
+#define VOLUME_LEVELS       32      // Same as player.c
+
+static const char *TAG = "player";
+
+struct player_s {
+    audio_provider_handle_t provider;
+    host_play_mode_t mode;
+    bool paced;                     // Read-ahead ring: real-time reads
+    double pace;                    // Times real time
+    int volume_index;
+    int16_t pcm[HOST_CHUNK_SAMPLES];
+    host_player_stats_t stats;
+};
+
+static void stats_init_names(host_player_stats_t *stats)
+{
+    stats->open_hit.name = "open (hit)";
+    stats->open_head.name = "open (head)";
+    stats->open_miss.name = "open (miss)";
+    stats->first_read.name = "first read";
+    stats->drain.name = "drain to EOF";
+}
+
+static void sleep_until(int64_t deadline_us)
+{
+    int64_t wait_us = deadline_us - esp_timer_get_time();
+    if (wait_us > 0) {
+        struct timespec ts = { .tv_sec = wait_us / 1000000, .tv_nsec = (wait_us % 1000000) * 1000 };
+        nanosleep(&ts, NULL);
+    }
+}
+
+/**
+ * @brief Open a sound, classify the open, and read it like a voice would
+ */
+static esp_err_t play_sound_sync(player_handle_t player, audio_sound_id_t sound_id)
+{
+    host_player_stats_t *stats = &player->stats;
+    stats->plays++;
+
+    audio_provider_cache_stats_t before;
+    audio_provider_cache_stats_t after;
+    audio_provider_get_cache_stats(player->provider, &before);
+
+    audio_stream_handle_t stream;
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t ret = audio_provider_open_sound(player->provider, sound_id, &stream);
+    int64_t open_us = esp_timer_get_time() - start_us;
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to open %s: %s",
+                 audio_provider_get_sound_name(player->provider, sound_id), esp_err_to_name(ret));
+        stats->play_errors++;
+        return ret;
+    }
+
+    audio_provider_get_cache_stats(player->provider, &after);
+    op_timing_add(after.cache_hits != before.cache_hits ? &stats->open_hit
+                  : after.head_hits != before.head_hits ? &stats->open_head
+                  : &stats->open_miss, open_us);
+
+    if (player->mode == HOST_PLAY_OPEN_ONLY) {
+        audio_provider_close_stream(stream);
+        return ESP_OK;
+    }
+
+    const audio_info_t *info = audio_provider_get_stream_info(stream);
+    uint64_t samples_per_s = (uint64_t)info->frame_rate * info->channels;
+    uint64_t samples = 0;
+    int64_t read_start_us = esp_timer_get_time();
+    while (true) {
+        size_t n = 0;
+        int64_t chunk_us = esp_timer_get_time();
+        ret = audio_provider_read_stream(stream, player->pcm, HOST_CHUNK_SAMPLES, &n);
+        if (samples == 0) {
+            op_timing_add(&stats->first_read, esp_timer_get_time() - chunk_us);
+        }
+        if (ret != ESP_OK || n == 0) {
+            break;
+        }
+        samples += n;
+        if (player->paced && samples_per_s > 0) {
+            sleep_until(read_start_us + (int64_t)(samples * 1e6 / (samples_per_s * player->pace)));
+        }
+    }
+    if (!player->paced) {
+        op_timing_add(&stats->drain, esp_timer_get_time() - read_start_us);
+    }
+    audio_provider_close_stream(stream);
+
+    stats->samples += samples;
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Read error on %s: %s",
+                 audio_provider_get_sound_name(player->provider, sound_id), esp_err_to_name(ret));
+        stats->play_errors++;
+    }
+    return ret;
+}
+
+esp_err_t player_init(const player_config_t *config, player_handle_t *player)
+{
+    if (config == NULL || player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    player_handle_t state = heap_caps_calloc(1, sizeof(struct player_s), MALLOC_CAP_INTERNAL);
+    if (state == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    state->mode = HOST_PLAY_DRAIN;
+    state->paced = (config->stream_ring_kb > 0);
+    state->pace = 1.0;
+    state->volume_index = VOLUME_LEVELS / 2;
+    stats_init_names(&state->stats);
+
+    audio_provider_config_t provider_config = {
+        .cache_size_kb = config->cache_size_kb,
+        .stream_ring_kb = config->stream_ring_kb,
+        .head_cache_kb = config->head_cache_kb,
+        .head_ms = config->head_ms,
+        .eviction_policy = config->cache_policy,
+        .cache_format = config->cache_format,
+        .output_rate = config->output_rate,
+        .resampler_taps = config->resampler_taps,
+        .preload_share = config->preload_share,
+        .downmix_mono = config->downmix_mono,
+    };
+    esp_err_t ret = audio_provider_init(&provider_config, &state->provider);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize audio provider: %s", esp_err_to_name(ret));
+        heap_caps_free(state);
+        return ret;
+    }
+
+    *player = state;
+    return ESP_OK;
+}
+
+esp_err_t player_deinit(player_handle_t player)
+{
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    audio_provider_deinit(player->provider);
+    host_player_reset_stats(player);
+    op_timing_free(&player->stats.open_hit);
+    op_timing_free(&player->stats.open_head);
+    op_timing_free(&player->stats.open_miss);
+    op_timing_free(&player->stats.first_read);
+    op_timing_free(&player->stats.drain);
+    heap_caps_free(player);
+    return ESP_OK;
+}
+
+esp_err_t player_play(player_handle_t player, const char *filename)
+{
+    if (player == NULL || filename == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    audio_sound_id_t id;
+    esp_err_t ret = audio_provider_resolve_sound(player->provider, filename, &id);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return play_sound_sync(player, id);
+}
+
+esp_err_t player_play_sound(player_handle_t player, player_sound_id_t sound_id)
+{
+    if (player == NULL || sound_id == PLAYER_SOUND_ID_NONE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return play_sound_sync(player, (audio_sound_id_t)sound_id);
+}
+
+esp_err_t player_resolve_sound(player_handle_t player, const char *filename,
+                               player_sound_id_t *sound_id)
+{
+    if (player == NULL || filename == NULL || sound_id == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    audio_sound_id_t id;
+    esp_err_t ret = audio_provider_resolve_sound(player->provider, filename, &id);
+    *sound_id = (ret == ESP_OK) ? (player_sound_id_t)id : PLAYER_SOUND_ID_NONE;
+    return ret;
+}
+
+esp_err_t player_stop(player_handle_t player, bool interrupt_now)
+{
+    (void)interrupt_now;
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player->stats.stops++;
+    return ESP_OK;
+}
+
+esp_err_t player_stop_file(player_handle_t player, const char *filename)
+{
+    if (player == NULL || filename == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player->stats.stops++;
+    return ESP_OK;
+}
+
+esp_err_t player_stop_sound(player_handle_t player, player_sound_id_t sound_id)
+{
+    if (player == NULL || sound_id == PLAYER_SOUND_ID_NONE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player->stats.stops++;
+    return ESP_OK;
+}
+
+int player_volume_get_max_index(void)
+{
+    return VOLUME_LEVELS - 1;
+}
+
+esp_err_t player_volume_get(player_handle_t player, int *volume_index)
+{
+    if (player == NULL || volume_index == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *volume_index = player->volume_index;
+    return ESP_OK;
+}
+
+esp_err_t player_volume_set(player_handle_t player, int8_t index)
+{
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player->volume_index = (index < 0) ? 0 : (index >= VOLUME_LEVELS) ? VOLUME_LEVELS - 1 : index;
+    return ESP_OK;
+}
+
+esp_err_t player_volume_adjust(player_handle_t player, int8_t step)
+{
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return player_volume_set(player, (int8_t)(player->volume_index + step));
+}
+
+esp_err_t player_preload(player_handle_t player, const char *filename)
+{
+    if (player == NULL || filename == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return audio_provider_preload(player->provider, filename);
+}
+
+esp_err_t player_preload_bank(player_handle_t player, const char *bank_path)
+{
+    if (player == NULL || bank_path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return audio_provider_preload_bank(player->provider, bank_path);
+}
+
+esp_err_t player_preload_head(player_handle_t player, const char *filename)
+{
+    if (player == NULL || filename == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return audio_provider_register_head(player->provider, filename);
+}
+
+esp_err_t player_load_sound_index(player_handle_t player, const char *path)
+{
+    if (player == NULL || path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return audio_provider_load_index(player->provider, path);
+}
+
+esp_err_t player_set_cache_pins(player_handle_t player,
+                                const player_sound_id_t *current, size_t current_count,
+                                const player_sound_id_t *neighbours, size_t neighbour_count)
+{
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return audio_provider_set_pins(player->provider, current, current_count, neighbours, neighbour_count);
+}
+
+esp_err_t player_prefetch(player_handle_t player, const char *path, bool bank)
+{
+    if (player == NULL || path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return audio_provider_prefetch(player->provider, path, bank);
+}
+
+void player_flush_preload(player_handle_t player)
+{
+    if (player == NULL) {
+        return;
+    }
+    audio_provider_flush_preload_queue(player->provider);
+}
+
+esp_err_t player_purge_cache(player_handle_t player)
+{
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return audio_provider_purge_cache(player->provider);
+}
+
+esp_err_t player_get_warmup(player_handle_t player, audio_provider_warmup_t *warmup)
+{
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return audio_provider_get_warmup(player->provider, warmup);
+}
+
+esp_err_t player_get_preload_stats(player_handle_t player, audio_provider_preload_stats_t *stats)
+{
+    if (player == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return audio_provider_get_preload_stats(player->provider, stats);
+}
+
+void player_print_status(player_handle_t player, status_output_type_t output_type)
+{
+    if (player == NULL) {
+        return;
+    }
+    audio_provider_print_status(player->provider, output_type);
+}
+
+void host_player_set_mode(player_handle_t player, host_play_mode_t mode)
+{
+    player->mode = mode;
+}
+
+void host_player_set_pace(player_handle_t player, double speed)
+{
+    player->pace = (speed > 0) ? speed : 1.0;
+}
+
+host_player_stats_t *host_player_get_stats(player_handle_t player)
+{
+    return &player->stats;
+}
+
+void host_player_reset_stats(player_handle_t player)
+{
+    host_player_stats_t *stats = &player->stats;
+    stats->plays = 0;
+    stats->play_errors = 0;
+    stats->stops = 0;
+    stats->samples = 0;
+    op_timing_reset(&stats->open_hit);
+    op_timing_reset(&stats->open_head);
+    op_timing_reset(&stats->open_miss);
+    op_timing_reset(&stats->first_read);
+    op_timing_reset(&stats->drain);
+}
+
+audio_provider_handle_t host_player_get_provider(player_handle_t player)
+{
+    return player->provider;
+}
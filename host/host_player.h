@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file host_player.h
+ * @brief Host stand-in for the player module (no I2S, no mixer task)
+ *
+ * Implements the player.h functions the mapper calls on top of the real
+ * audio provider. Playback is synchronous, in the calling (replay) thread:
+ * a play opens the sound and reads it to EOF like one player voice would,
+ * then closes it. Stops are counted and otherwise ignored, since nothing is
+ * playing by the time they arrive.
+ *
+ * Direct file reads (stream_ring_kb = 0) are drained as fast as the host
+ * allows. With a read-ahead ring the reads are paced in (scaled) real
+ * time: the streamer task fills the ring at its own speed and an unpaced
+ * reader would only measure underruns.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include "op_timing.h"
+#include "player.h"
+
+/**
+ * @brief What a play does with the opened stream
+ */
+typedef enum {
+    HOST_PLAY_DRAIN,        /**< Read the sound to EOF */
+    HOST_PLAY_OPEN_ONLY,    /**< Open and close (open latency and hit rate only) */
+} host_play_mode_t;
+
+/**
+ * @brief Host player counters and timings (replay thread)
+ */
+typedef struct {
+    uint32_t plays;             /**< Plays requested by the mapper */
+    uint32_t play_errors;       /**< Plays whose open or read failed */
+    uint32_t stops;             /**< Stop requests (ignored) */
+    uint64_t samples;           /**< Samples read from the streams */
+    op_timing_t open_hit;       /**< Open latency, cache hits */
+    op_timing_t open_head;      /**< Open latency, misses started from an attack segment */
+    op_timing_t open_miss;      /**< Open latency, cold misses */
+    op_timing_t first_read;     /**< First read_stream() call after the open */
+    op_timing_t drain;          /**< Remaining reads to EOF (direct reads only) */
+} host_player_stats_t;
+
+void host_player_set_mode(player_handle_t player, host_play_mode_t mode);
+
+/**
+ * @brief Speed of the paced reads (read-ahead ring), times real time (default 1)
+ */
+void host_player_set_pace(player_handle_t player, double speed);
+
+/**
+ * @brief Counters and timings (owned by the player, valid until deinit)
+ */
+host_player_stats_t *host_player_get_stats(player_handle_t player);
+
+/**
+ * @brief Zero the counters and drop the timing samples
+ */
+void host_player_reset_stats(player_handle_t player);
+
+/**
+ * @brief Provider of the player (for the driver's own queries)
+ */
+audio_provider_handle_t host_player_get_provider(player_handle_t player);
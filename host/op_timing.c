@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include "op_timing.h"
+
+#define OP_TIMING_MIN_CAPACITY 256
+
+void op_timing_add(op_timing_t *timing, int64_t us)
+{
+    if (timing->count == timing->capacity) {
+        size_t capacity = timing->capacity ? timing->capacity * 2 : OP_TIMING_MIN_CAPACITY;
+        uint32_t *grown = realloc(timing->us, capacity * sizeof(uint32_t));
+        if (grown == NULL) {
+            return;
+        }
+        timing->us = grown;
+        timing->capacity = capacity;
+    }
+    timing->us[timing->count++] = (us < 0) ? 0 : (us > UINT32_MAX) ? UINT32_MAX : (uint32_t)us;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Nearest-rank percentile of sorted samples
+ */
+static uint32_t percentile(const op_timing_t *timing, unsigned int pct)
+{
+    size_t rank = (timing->count * pct + 99) / 100;
+    return timing->us[rank > 0 ? rank - 1 : 0];
+}
+
+void op_timing_print(op_timing_t *timing, FILE *out)
+{
+    if (timing->count == 0) {
+        return;
+    }
+    qsort(timing->us, timing->count, sizeof(uint32_t), compare_u32);
+    uint64_t total = 0;
+    for (size_t i = 0; i < timing->count; i++) {
+        total += timing->us[i];
+    }
+    fprintf(out, "  %-14s %6zu  %9u %9llu %9u %9u %9u\n", timing->name, timing->count,
+            (unsigned int)timing->us[0], (unsigned long long)(total / timing->count),
+            (unsigned int)percentile(timing, 50), (unsigned int)percentile(timing, 95),
+            (unsigned int)timing->us[timing->count - 1]);
+}
+
+void op_timing_reset(op_timing_t *timing)
+{
+    timing->count = 0;
+}
+
+void op_timing_free(op_timing_t *timing)
+{
+    free(timing->us);
+    timing->us = NULL;
+    timing->count = 0;
+    timing->capacity = 0;
+}
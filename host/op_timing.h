@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file op_timing.h
+ * @brief Per-operation latency samples for the host benchmark
+ *
+ * Every sample is kept (a replay records a few thousand at most), so that
+ * the report gives exact percentiles. Not thread-safe: record from one
+ * thread (the replay thread).
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct {
+    const char *name;
+    uint32_t *us;           // Samples, microseconds
+    size_t count;
+    size_t capacity;
+} op_timing_t;
+
+/**
+ * @brief Add one sample (dropped silently if the array cannot grow)
+ */
+void op_timing_add(op_timing_t *timing, int64_t us);
+
+/**
+ * @brief Print one report row: name, count, min / avg / p50 / p95 / max in us
+ *
+ * Sorts the samples. Prints nothing if there are none.
+ */
+void op_timing_print(op_timing_t *timing, FILE *out);
+
+void op_timing_reset(op_timing_t *timing);
+void op_timing_free(op_timing_t *timing);
@@ -0,0 +1,16 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file gpio.h
+ * @brief GPIO types used by input_scanner.h (host build)
+ */
+
+#pragma once
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_NC (-1)
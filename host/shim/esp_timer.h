@@ -0,0 +1,20 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file esp_timer.h
+ * @brief esp_timer time base on CLOCK_MONOTONIC (host build)
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Microseconds since the program started
+ */
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,14 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file esp_vfs.h
+ * @brief VFS limits used by soundboard.h (host build)
+ */
+
+#pragma once
+
+#define ESP_VFS_PATH_MAX 15
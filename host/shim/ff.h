@@ -0,0 +1,14 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file ff.h
+ * @brief FatFs limits used by soundboard.h (host build)
+ */
+
+#pragma once
+
+#define FF_LFN_BUF 255
@@ -0,0 +1,24 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file FreeRTOS.h
+ * @brief FreeRTOS types and the task / semaphore subset used by the provider (host build)
+ *
+ * Tasks are detached pthreads (priority and core ignored), notifications a
+ * counter under a mutex and condition variable, semaphores a counting
+ * semaphore on the same primitives. One tick is one millisecond.
+ */
+
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_heap_caps.h"      // Pulled in by ESP-IDF's FreeRTOS.h too (port layer)
+#include "freertos/task.h"      // IWYU pragma: export
+#include "freertos/semphr.h"    // IWYU pragma: export
@@ -0,0 +1,25 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file semphr.h
+ * @brief FreeRTOS semaphore subset on pthreads (host build)
+ *
+ * A mutex is a binary semaphore created given (no priority inheritance,
+ * no recursion: the provider uses neither).
+ */
+
+#pragma once
+
+#include "freertos/task.h"
+
+typedef struct host_semaphore_s *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+void vSemaphoreDelete(SemaphoreHandle_t sem);
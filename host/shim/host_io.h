@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file host_io.h
+ * @brief Counted (and optionally throttled) file I/O for the firmware modules
+ *
+ * Force-included into the firmware sources of the host build: fopen, fread
+ * and fseek go through counters, so that the benchmark reports what the
+ * modules read from the "SD card" independently of their own statistics.
+ * An optional throttle sleeps per open and per KB read to stand in for the
+ * SD card (the host page cache is far faster), which keeps the cost-aware
+ * eviction and the preload share meaningful.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief File I/O counters (since start or the last reset)
+ */
+typedef struct {
+    uint64_t opens;         /**< fopen() calls that succeeded */
+    uint64_t reads;         /**< fread() calls */
+    uint64_t read_bytes;    /**< Bytes returned by fread() */
+    uint64_t read_us;       /**< Time in fread(), throttle included */
+    uint64_t seeks;         /**< fseek() calls */
+} host_io_stats_t;
+
+FILE *host_fopen(const char *path, const char *mode);
+size_t host_fread(void *buf, size_t size, size_t count, FILE *fp);
+int host_fseek(FILE *fp, long offset, int whence);
+
+/**
+ * @brief Simulate SD card timing
+ *
+ * @param open_us Sleep per fopen() (0 = none)
+ * @param read_kbps Read throughput in KB/s (0 = unthrottled)
+ */
+void host_io_set_throttle(uint32_t open_us, uint32_t read_kbps);
+
+void host_io_get_stats(host_io_stats_t *stats);
+void host_io_reset_stats(void);
+
+#ifndef HOST_IO_NO_REDIRECT
+    #define fopen(path, mode) host_fopen(path, mode)
+    #define fread(buf, size, count, fp) host_fread(buf, size, count, fp)
+    #define fseek(fp, offset, whence) host_fseek(fp, offset, whence)
+#endif
@@ -0,0 +1,433 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file idf_shim.c
+ * @brief POSIX implementation of the ESP-IDF / FreeRTOS shims (host build)
+ */
+
+#define HOST_IO_NO_REDIRECT
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "host_io.h"
+
+// ---------------------------------------------------------------------------
+// Time
+// ---------------------------------------------------------------------------
+
+static int64_t monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t s_start_us;
+
+__attribute__((constructor)) static void shim_start(void)
+{
+    s_start_us = monotonic_us();
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return monotonic_us() - s_start_us;
+}
+
+static void sleep_us(int64_t us)
+{
+    if (us <= 0) {
+        return;
+    }
+    struct timespec ts = { .tv_sec = us / 1000000, .tv_nsec = (us % 1000000) * 1000 };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+/**
+ * @brief Absolute CLOCK_MONOTONIC deadline of a tick timeout (condition variables)
+ */
+static struct timespec deadline_of(TickType_t ticks)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ts.tv_nsec + (uint64_t)ticks * (1000000000ULL / configTICK_RATE_HZ);
+    ts.tv_sec += (time_t)(ns / 1000000000ULL);
+    ts.tv_nsec = (long)(ns % 1000000000ULL);
+    return ts;
+}
+
+static void cond_init_monotonic(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+// ---------------------------------------------------------------------------
+// Tasks
+// ---------------------------------------------------------------------------
+
+struct host_task_s {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify;            // Notification value (xTaskNotifyGive count)
+    TaskFunction_t fn;
+    void *arg;
+};
+
+static __thread struct host_task_s *s_current_task;
+
+static struct host_task_s *task_alloc(void)
+{
+    struct host_task_s *task = calloc(1, sizeof(*task));
+    if (task != NULL) {
+        pthread_mutex_init(&task->lock, NULL);
+        cond_init_monotonic(&task->cond);
+    }
+    return task;
+}
+
+static void *task_entry(void *arg)
+{
+    s_current_task = arg;
+    s_current_task->fn(s_current_task->arg);
+    vTaskDelete(NULL);      // Task functions normally end with it
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_size,
+                                   void *arg, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core_id)
+{
+    (void)name;
+    (void)stack_size;
+    (void)priority;
+    (void)core_id;
+
+    struct host_task_s *task = task_alloc();
+    if (task == NULL) {
+        return pdFAIL;
+    }
+    task->fn = fn;
+    task->arg = arg;
+    if (handle != NULL) {
+        *handle = task;     // Before the thread runs: tasks may read their own handle
+    }
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int err = pthread_create(&thread, &attr, task_entry, task);
+    pthread_attr_destroy(&attr);
+    if (err != 0) {
+        free(task);
+        if (handle != NULL) {
+            *handle = NULL;
+        }
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task != NULL && task != s_current_task) {
+        ESP_LOGE("shim", "vTaskDelete of another task is not supported");
+        abort();
+    }
+    struct host_task_s *self = s_current_task;
+    s_current_task = NULL;
+    if (self != NULL) {
+        pthread_cond_destroy(&self->cond);
+        pthread_mutex_destroy(&self->lock);
+        free(self);
+    }
+    pthread_exit(NULL);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    if (s_current_task == NULL) {
+        s_current_task = task_alloc();      // Main thread, or a thread not created here
+    }
+    return s_current_task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    sleep_us((int64_t)ticks * (1000000 / configTICK_RATE_HZ));
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / (1000000 / configTICK_RATE_HZ));
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->notify++;
+    pthread_cond_signal(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    struct host_task_s *self = xTaskGetCurrentTaskHandle();
+    struct timespec deadline = deadline_of(ticks);
+
+    pthread_mutex_lock(&self->lock);
+    while (self->notify == 0 && ticks != 0) {
+        int err = (ticks == portMAX_DELAY) ? pthread_cond_wait(&self->cond, &self->lock)
+                                           : pthread_cond_timedwait(&self->cond, &self->lock, &deadline);
+        if (err == ETIMEDOUT) {
+            break;
+        }
+    }
+    uint32_t value = self->notify;
+    if (value > 0) {
+        self->notify = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&self->lock);
+    return value;
+}
+
+// ---------------------------------------------------------------------------
+// Semaphores
+// ---------------------------------------------------------------------------
+
+struct host_semaphore_s {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool given;
+};
+
+static SemaphoreHandle_t semaphore_create(bool given)
+{
+    struct host_semaphore_s *sem = calloc(1, sizeof(*sem));
+    if (sem != NULL) {
+        pthread_mutex_init(&sem->lock, NULL);
+        cond_init_monotonic(&sem->cond);
+        sem->given = given;
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return semaphore_create(true);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return semaphore_create(false);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    struct timespec deadline = deadline_of(ticks);
+
+    pthread_mutex_lock(&sem->lock);
+    while (!sem->given && ticks != 0) {
+        int err = (ticks == portMAX_DELAY) ? pthread_cond_wait(&sem->cond, &sem->lock)
+                                           : pthread_cond_timedwait(&sem->cond, &sem->lock, &deadline);
+        if (err == ETIMEDOUT) {
+            break;
+        }
+    }
+    bool taken = sem->given;
+    sem->given = false;
+    pthread_mutex_unlock(&sem->lock);
+    return taken ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    pthread_mutex_lock(&sem->lock);
+    bool was_given = sem->given;
+    sem->given = true;
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->lock);
+    return was_given ? pdFALSE : pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    if (sem == NULL) {
+        return;
+    }
+    pthread_cond_destroy(&sem->cond);
+    pthread_mutex_destroy(&sem->lock);
+    free(sem);
+}
+
+// ---------------------------------------------------------------------------
+// Heap
+// ---------------------------------------------------------------------------
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    (void)caps;
+    return calloc(n, size);
+}
+
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps)
+{
+    (void)caps;
+    return realloc(ptr, size);
+}
+
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
+{
+    (void)caps;
+    void *ptr = NULL;
+    if (alignment < sizeof(void *)) {
+        alignment = sizeof(void *);
+    }
+    return posix_memalign(&ptr, alignment, size) == 0 ? ptr : NULL;
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+size_t heap_caps_get_total_size(uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? HOST_PSRAM_SIZE : HOST_INTERNAL_SIZE;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return heap_caps_get_total_size(caps);
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return heap_caps_get_total_size(caps);
+}
+
+// ---------------------------------------------------------------------------
+// Logging and errors
+// ---------------------------------------------------------------------------
+
+esp_log_level_t host_log_level = ESP_LOG_WARN;
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    (void)tag;
+    host_log_level = level;
+}
+
+esp_log_level_t esp_log_level_get(const char *tag)
+{
+    (void)tag;
+    return host_log_level;
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+        case ESP_OK:                    return "ESP_OK";
+        case ESP_FAIL:                  return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:            return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:       return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:     return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:      return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:         return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED:     return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:           return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE:  return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_INVALID_CRC:       return "ESP_ERR_INVALID_CRC";
+        case ESP_ERR_INVALID_VERSION:   return "ESP_ERR_INVALID_VERSION";
+        case ESP_ERR_INVALID_MAC:       return "ESP_ERR_INVALID_MAC";
+        case ESP_ERR_NOT_FINISHED:      return "ESP_ERR_NOT_FINISHED";
+        case ESP_ERR_NOT_ALLOWED:       return "ESP_ERR_NOT_ALLOWED";
+        default:                        return "UNKNOWN ERROR";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Counted file I/O
+// ---------------------------------------------------------------------------
+
+static host_io_stats_t s_io;        // __atomic
+static uint32_t s_open_us;
+static uint32_t s_read_kbps;
+
+FILE *host_fopen(const char *path, const char *mode)
+{
+    sleep_us(s_open_us);
+    FILE *fp = fopen(path, mode);
+    if (fp != NULL) {
+        __atomic_add_fetch(&s_io.opens, 1, __ATOMIC_RELAXED);
+    }
+    return fp;
+}
+
+size_t host_fread(void *buf, size_t size, size_t count, FILE *fp)
+{
+    int64_t start_us = esp_timer_get_time();
+    size_t n = fread(buf, size, count, fp);
+    uint64_t bytes = (uint64_t)n * size;
+    if (s_read_kbps > 0) {
+        sleep_us((int64_t)(bytes * 1000000 / 1024 / s_read_kbps) - (esp_timer_get_time() - start_us));
+    }
+    __atomic_add_fetch(&s_io.reads, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s_io.read_bytes, bytes, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s_io.read_us, (uint64_t)(esp_timer_get_time() - start_us), __ATOMIC_RELAXED);
+    return n;
+}
+
+int host_fseek(FILE *fp, long offset, int whence)
+{
+    __atomic_add_fetch(&s_io.seeks, 1, __ATOMIC_RELAXED);
+    return fseek(fp, offset, whence);
+}
+
+void host_io_set_throttle(uint32_t open_us, uint32_t read_kbps)
+{
+    s_open_us = open_us;
+    s_read_kbps = read_kbps;
+}
+
+void host_io_get_stats(host_io_stats_t *stats)
+{
+    stats->opens = __atomic_load_n(&s_io.opens, __ATOMIC_RELAXED);
+    stats->reads = __atomic_load_n(&s_io.reads, __ATOMIC_RELAXED);
+    stats->read_bytes = __atomic_load_n(&s_io.read_bytes, __ATOMIC_RELAXED);
+    stats->read_us = __atomic_load_n(&s_io.read_us, __ATOMIC_RELAXED);
+    stats->seeks = __atomic_load_n(&s_io.seeks, __ATOMIC_RELAXED);
+}
+
+void host_io_reset_stats(void)
+{
+    __atomic_store_n(&s_io.opens, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_io.reads, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_io.read_bytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_io.read_us, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_io.seeks, 0, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,34 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file sdkconfig.h
+ * @brief Kconfig values of the host build (menuconfig defaults)
+ *
+ * Only the options read by the modules built on the host. Cache size,
+ * policy, format, rings and heads are overridden at run time by the
+ * benchmark driver options; the rest is fixed here. Tracing and the
+ * latency probes stay off (firmware only).
+ */
+
+#pragma once
+
+#define CONFIG_SOUNDBOARD_PLAYER_CACHE_SIZE_KB 8192
+#define CONFIG_SOUNDBOARD_STREAM_RING_SIZE_KB 64
+#define CONFIG_SOUNDBOARD_HEAD_CACHE_SIZE_KB 1024
+#define CONFIG_SOUNDBOARD_HEAD_CACHE_MS 200
+#define CONFIG_SOUNDBOARD_PRELOAD_STREAM_SHARE 25
+#define CONFIG_SOUNDBOARD_PLAYER_VOICES 4
+#define CONFIG_SOUNDBOARD_OUTPUT_RATE 48000
+#define CONFIG_SOUNDBOARD_OUTPUT_DOWNMIX_MONO 1
+#define CONFIG_SOUNDBOARD_CACHE_EVICTION_PAGE_COST 1
+#define CONFIG_SOUNDBOARD_CACHE_FORMAT_PCM16 1
+#define CONFIG_SOUNDBOARD_RESAMPLER_SINC 1
+#define CONFIG_SOUNDBOARD_PRELOAD_ADJACENT_PAGES 1
+#define CONFIG_SOUNDBOARD_MAPPER_CACHE 1
+#define CONFIG_SOUNDBOARD_SOUND_INDEX 1
+#define CONFIG_SOUNDBOARD_IO_STATS_ENABLE 1
+#define CONFIG_SOUNDBOARD_INPUT_MODE_POLLING 1
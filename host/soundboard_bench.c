@@ -0,0 +1,894 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file soundboard_bench.c
+ * @brief Host replay benchmark of the provider, mapper and cache policies
+ *
+ * Replays a recorded press sequence through the real mapper and audio
+ * provider against a directory laid out like the SD card, and reports
+ * cache hit rate, evictions, bytes read and per-operation timings. One
+ * replay per eviction policy given, each from a fresh provider.
+ *
+ * Press sequences are either text files (one "<delay_ms> <button> <event>"
+ * per line) or the output of the console `trace save` command, whose input
+ * events are replayed with their recorded timing. `synth` writes a test
+ * card (WAV files of every supported layout, mappings.csv, presses.seq).
+ */
+
+#define HOST_IO_NO_REDIRECT     // The driver's own files are not counted
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "benchmark.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "host_io.h"
+#include "host_player.h"
+#include "mapper.h"
+#include "op_timing.h"
+#include "sound_index.h"
+
+#define BENCH_MAPPINGS_FILE     "mappings.csv"
+#define BENCH_SEQUENCE_FILE     "presses.seq"
+#define BENCH_MAPPER_CACHE_FILE ".mappings.cache"   // mapper.c MAPPER_CACHE_FILE
+#define BENCH_MAX_POLICIES      3
+#define BENCH_SETTLE_TIMEOUT_MS 30000
+#define BENCH_SETTLE_POLL_US    500
+#define BENCH_IDLE_SAMPLES      2                   // Consecutive idle polls to call the preload task idle
+
+#define SYNTH_DEFAULT_PAGES     3
+#define SYNTH_DEFAULT_EVENTS    400
+#define SYNTH_BUTTONS           12
+#define SYNTH_TRACE_INPUT_NAME  "input"
+
+static const char *TAG = "bench";
+
+/**
+ * @brief One replayed input event
+ */
+typedef struct {
+    int64_t t_us;               // Offset from the first event
+    uint8_t button;             // 0 = encoder switch
+    input_event_type_t event;
+} bench_event_t;
+
+typedef struct {
+    bench_event_t *events;
+    size_t count;
+    size_t capacity;
+    bool from_trace;
+} bench_sequence_t;
+
+/**
+ * @brief Run options (command line)
+ */
+typedef struct {
+    const char *root;
+    const char *sequence_path;
+    const char *mappings_file;
+    audio_cache_policy_t policies[BENCH_MAX_POLICIES];
+    int policy_count;
+    player_config_t player;
+    uint32_t sd_open_us;
+    uint32_t sd_kbps;
+    double realtime_speed;      // 0 = settle between events
+    bool open_only;
+    bool cold;                  // Remove the mapper cache and sound index before each replay
+    int repeat;
+    int parse_runs;
+    bool status;
+    bool check;
+} bench_options_t;
+
+static const char *const policy_names[] = {
+    [AUDIO_CACHE_POLICY_LRU] = "lru",
+    [AUDIO_CACHE_POLICY_PAGE_LRU] = "page_lru",
+    [AUDIO_CACHE_POLICY_PAGE_COST] = "page_cost",
+};
+
+static const char *const format_names[] = {
+    [AUDIO_CACHE_FORMAT_PCM16] = "pcm16",
+    [AUDIO_CACHE_FORMAT_MULAW] = "mulaw",
+    [AUDIO_CACHE_FORMAT_IMA_ADPCM] = "adpcm",
+};
+
+static const char *const event_names[] = {
+    [INPUT_EVENT_BUTTON_PRESS] = "press",
+    [INPUT_EVENT_BUTTON_LONG_PRESS] = "long_press",
+    [INPUT_EVENT_BUTTON_RELEASE] = "release",
+    [INPUT_EVENT_ENCODER_ROTATE_CW] = "cw",
+    [INPUT_EVENT_ENCODER_ROTATE_CCW] = "ccw",
+};
+
+#define ARRAY_COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static int name_index(const char *const *names, size_t count, const char *name)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (names[i] != NULL && strcmp(names[i], name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static void sleep_us(int64_t us)
+{
+    if (us > 0) {
+        struct timespec ts = { .tv_sec = us / 1000000, .tv_nsec = (us % 1000000) * 1000 };
+        nanosleep(&ts, NULL);
+    }
+}
+
+/* ============================================================================
+ * Press sequences
+ * ============================================================================ */
+
+static bool sequence_add(bench_sequence_t *seq, int64_t t_us, uint8_t button, input_event_type_t event)
+{
+    if (seq->count == seq->capacity) {
+        size_t capacity = seq->capacity ? seq->capacity * 2 : 256;
+        bench_event_t *grown = realloc(seq->events, capacity * sizeof(bench_event_t));
+        if (grown == NULL) {
+            return false;
+        }
+        seq->events = grown;
+        seq->capacity = capacity;
+    }
+    seq->events[seq->count++] = (bench_event_t){ .t_us = t_us, .button = button, .event = event };
+    return true;
+}
+
+/**
+ * @brief Input events of a trace dump (see trace.h), times relative to the first
+ *
+ * The 32-bit timestamps are unwrapped like scripts/trace_to_json.py does.
+ */
+static esp_err_t sequence_parse_trace(FILE *fp, bench_sequence_t *seq)
+{
+    char line[256];
+    int input_id = -1;
+    bool have_time = false;
+    int64_t latest = 0;
+    int64_t first = 0;
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char name[32];
+        int id;
+        if (sscanf(line, "event,%d,%31[^,],", &id, name) == 2 && strcmp(name, SYNTH_TRACE_INPUT_NAME) == 0) {
+            input_id = id;
+            continue;
+        }
+        unsigned long t_us, dur_us, a, b;
+        unsigned int core, event;
+        char task[16];
+        if (sscanf(line, "rec,%lu,%lu,%u,%15[^,],%u,%lu,%lu", &t_us, &dur_us, &core, task, &event, &a, &b) != 7 ||
+            (int)event != input_id || b > INPUT_EVENT_ENCODER_ROTATE_CCW) {
+            continue;
+        }
+        // Nearest to the latest time seen
+        int64_t ts = (int64_t)t_us;
+        if (have_time) {
+            ts = latest + (int32_t)((uint32_t)t_us - (uint32_t)latest);
+        } else {
+            first = ts;
+            latest = ts;
+            have_time = true;
+        }
+        latest = (ts > latest) ? ts : latest;
+        if (!sequence_add(seq, ts - first, (uint8_t)a, (input_event_type_t)b)) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (input_id < 0) {
+        ESP_LOGE(TAG, "Trace dump without an \"%s\" event entry", SYNTH_TRACE_INPUT_NAME);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Text sequence: "<delay_ms> <button> <event>" per line, # comments
+ */
+static esp_err_t sequence_parse_text(FILE *fp, bench_sequence_t *seq)
+{
+    char line[256];
+    int line_number = 0;
+    int64_t t_us = 0;
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        line_number++;
+        char *p = line + strspn(line, " \t");
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') {
+            continue;
+        }
+        double delay_ms;
+        unsigned int button;
+        char name[16];
+        int event = -1;
+        if (sscanf(p, "%lf %u %15s", &delay_ms, &button, name) == 3) {
+            event = name_index(event_names, ARRAY_COUNT(event_names), name);
+        }
+        if (event < 0 || delay_ms < 0 || button > SYNTH_BUTTONS) {
+            ESP_LOGE(TAG, "Line %d: expected \"<delay_ms> <button 0-%d> <press|long_press|release|cw|ccw>\"",
+                     line_number, SYNTH_BUTTONS);
+            return ESP_ERR_INVALID_ARG;
+        }
+        t_us += (int64_t)(delay_ms * 1000);
+        if (!sequence_add(seq, t_us, (uint8_t)button, (input_event_type_t)event)) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t sequence_load(const char *path, bench_sequence_t *seq)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        ESP_LOGE(TAG, "Cannot open %s: %s", path, strerror(errno));
+        return ESP_ERR_NOT_FOUND;
+    }
+    char first[64] = "";
+    if (fgets(first, sizeof(first), fp) == NULL) {
+        first[0] = '\0';
+    }
+    rewind(fp);
+    seq->from_trace = (strncmp(first, "# soundboard trace", 18) == 0);
+    esp_err_t ret = seq->from_trace ? sequence_parse_trace(fp, seq) : sequence_parse_text(fp, seq);
+    fclose(fp);
+    if (ret == ESP_OK && seq->count == 0) {
+        ESP_LOGE(TAG, "No input events in %s", path);
+        ret = ESP_ERR_NOT_FOUND;
+    }
+    return ret;
+}
+
+/* ============================================================================
+ * Replay
+ * ============================================================================ */
+
+/**
+ * @brief Wait until the preload task has nothing queued, in flight or pending
+ */
+static bool settle(player_handle_t player)
+{
+    int idle = 0;
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)BENCH_SETTLE_TIMEOUT_MS * 1000;
+    while (esp_timer_get_time() < deadline_us) {
+        audio_provider_preload_stats_t stats;
+        player_get_preload_stats(player, &stats);
+        idle = stats.idle ? idle + 1 : 0;
+        if (idle >= BENCH_IDLE_SAMPLES) {
+            return true;
+        }
+        sleep_us(BENCH_SETTLE_POLL_US);
+    }
+    ESP_LOGW(TAG, "Preload task still busy after %d ms", BENCH_SETTLE_TIMEOUT_MS);
+    return false;
+}
+
+static void remove_card_file(const char *root, const char *name)
+{
+    char path[SOUNDBOARD_MAX_PATH_LEN];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    remove(path);
+}
+
+static void print_mb(const char *label, uint64_t bytes)
+{
+    printf("%s%.2f MB", label, (double)bytes / (1024.0 * 1024.0));
+}
+
+/**
+ * @brief Time mapper_init() from the CSV files and from the binary cache
+ *
+ * Each load gets a fresh player, as at boot (the sound index loads once
+ * per provider).
+ */
+static esp_err_t run_parse_benchmark(const bench_options_t *opt)
+{
+    op_timing_t csv = { .name = "init (csv)" };
+    op_timing_t cached = { .name = "init (cache)" };
+
+    esp_err_t ret = ESP_OK;
+    for (int pass = 0; pass < 2 && ret == ESP_OK; pass++) {
+        for (int i = 0; i < opt->parse_runs && ret == ESP_OK; i++) {
+            if (pass == 0) {
+                remove_card_file(opt->root, BENCH_MAPPER_CACHE_FILE);
+            }
+            player_handle_t player;
+            ret = player_init(&opt->player, &player);
+            if (ret != ESP_OK) {
+                break;
+            }
+            mapper_config_t config = {
+                .sdcard_root = opt->root,
+                .sdcard_mappings_file = opt->mappings_file,
+                .player = player,
+            };
+            mapper_handle_t mapper;
+            int64_t start_us = esp_timer_get_time();
+            ret = mapper_init(&config, &mapper);
+            op_timing_add(pass == 0 ? &csv : &cached, esp_timer_get_time() - start_us);
+            if (ret == ESP_OK) {
+                player_flush_preload(player);
+                settle(player);     // The cache file is written in the background
+                mapper_deinit(mapper);
+            }
+            player_deinit(player);
+        }
+    }
+    if (ret != ESP_OK) {
+        printf("Mapper load failed: %s\n", esp_err_to_name(ret));
+    }
+
+    printf("\n=== Mapper load: %d runs each ===\n", opt->parse_runs);
+    printf("Timings (us)       count       min       avg       p50       p95       max\n");
+    op_timing_print(&csv, stdout);
+    op_timing_print(&cached, stdout);
+    op_timing_free(&csv);
+    op_timing_free(&cached);
+    return ret;
+}
+
+/**
+ * @brief One replay of the sequence with a fresh provider
+ *
+ * @return true if every play succeeded and at least one sound was played
+ */
+static bool run_replay(const bench_options_t *opt, const bench_sequence_t *seq, audio_cache_policy_t policy)
+{
+    player_config_t player_config = opt->player;
+    player_config.cache_policy = policy;
+
+    printf("\n=== Replay: %s, cache %zu KB %s, heads %zu KB x %lu ms, %s ===\n",
+           policy_names[policy], player_config.cache_size_kb, format_names[player_config.cache_format],
+           player_config.head_cache_kb, (unsigned long)player_config.head_ms,
+           player_config.stream_ring_kb > 0 ? "read-ahead ring (real-time reads)" : "direct reads");
+
+    if (opt->cold) {
+        remove_card_file(opt->root, BENCH_MAPPER_CACHE_FILE);
+        remove_card_file(opt->root, SOUND_INDEX_FILENAME);
+    }
+    host_io_reset_stats();
+
+    player_handle_t player;
+    esp_err_t ret = player_init(&player_config, &player);
+    if (ret != ESP_OK) {
+        printf("player_init failed: %s\n", esp_err_to_name(ret));
+        return false;
+    }
+    host_player_set_mode(player, opt->open_only ? HOST_PLAY_OPEN_ONLY : HOST_PLAY_DRAIN);
+    host_player_set_pace(player, opt->realtime_speed > 0 ? opt->realtime_speed : 1.0);
+    audio_provider_handle_t provider = host_player_get_provider(player);
+
+    mapper_config_t mapper_config = {
+        .sdcard_root = opt->root,
+        .sdcard_mappings_file = opt->mappings_file,
+        .player = player,
+    };
+    mapper_handle_t mapper;
+    int64_t start_us = esp_timer_get_time();
+    ret = mapper_init(&mapper_config, &mapper);
+    int64_t init_us = esp_timer_get_time() - start_us;
+    if (ret != ESP_OK) {
+        printf("mapper_init failed: %s\n", esp_err_to_name(ret));
+        player_deinit(player);
+        return false;
+    }
+    settle(player);
+    int64_t startup_us = esp_timer_get_time() - start_us;
+
+    host_io_stats_t io;
+    host_io_get_stats(&io);
+    printf("Startup: mapper init %.1f ms, ready %.1f ms (heads, first page), ",
+           init_us / 1000.0, startup_us / 1000.0);
+    print_mb("", io.read_bytes);
+    printf(" read\n");
+
+    // Replay counters from here on
+    op_timing_t press = { .name = "press" };
+    op_timing_t warmups = { .name = "page warm-up" };
+    audio_provider_cache_stats_t cache0;
+    audio_provider_preload_stats_t preload0;
+    audio_provider_warmup_t warmup;
+    audio_provider_get_cache_stats(provider, &cache0);
+    audio_provider_get_preload_stats(provider, &preload0);
+    audio_provider_get_warmup(provider, &warmup);
+    uint32_t warmup_count = warmup.count;
+    host_player_reset_stats(player);
+    host_io_reset_stats();
+    benchmark_log_and_reset(BENCH_SD_READ, NULL);
+
+    int64_t replay_start_us = esp_timer_get_time();
+    size_t replayed = 0;
+    for (int r = 0; r < opt->repeat; r++) {
+        int64_t pass_start_us = esp_timer_get_time();
+        for (size_t i = 0; i < seq->count; i++) {
+            const bench_event_t *ev = &seq->events[i];
+            if (opt->realtime_speed > 0) {
+                sleep_us(pass_start_us + (int64_t)(ev->t_us / opt->realtime_speed) - esp_timer_get_time());
+            } else {
+                settle(player);
+            }
+            audio_provider_get_warmup(provider, &warmup);
+            if (warmup.count != warmup_count) {
+                op_timing_add(&warmups, (int64_t)warmup.ms * 1000);
+                warmup_count = warmup.count;
+            }
+
+            int64_t press_us = esp_timer_get_time();
+            mapper_on_input_event(mapper, ev->button, ev->event);
+            op_timing_add(&press, esp_timer_get_time() - press_us);
+            replayed++;
+        }
+    }
+    settle(player);
+    audio_provider_get_warmup(provider, &warmup);
+    if (warmup.count != warmup_count) {
+        op_timing_add(&warmups, (int64_t)warmup.ms * 1000);
+    }
+    int64_t replay_us = esp_timer_get_time() - replay_start_us;
+
+    audio_provider_cache_stats_t cache;
+    audio_provider_preload_stats_t preload;
+    audio_provider_get_cache_stats(provider, &cache);
+    audio_provider_get_preload_stats(provider, &preload);
+    host_io_get_stats(&io);
+    host_player_stats_t *stats = host_player_get_stats(player);
+
+    uint32_t hits = cache.cache_hits - cache0.cache_hits;
+    uint32_t head_hits = cache.head_hits - cache0.head_hits;
+    uint32_t cold = cache.cold_misses - cache0.cold_misses;
+    uint32_t opens = hits + head_hits + cold;
+    double pct = opens ? 100.0 / opens : 0;
+
+    printf("Events: %zu replayed in %.2f s (%s), %lu plays (%lu errors), %lu stops\n",
+           replayed, replay_us / 1e6,
+           opt->realtime_speed > 0 ? "recorded timing" : "settled between events",
+           (unsigned long)stats->plays, (unsigned long)stats->play_errors, (unsigned long)stats->stops);
+    printf("Opens: %lu = %lu cache hits (%.1f%%), %lu head hits (%.1f%%), %lu cold misses (%.1f%%); "
+           "%lu misses on evicted sounds\n",
+           (unsigned long)opens, (unsigned long)hits, hits * pct, (unsigned long)head_hits, head_hits * pct,
+           (unsigned long)cold, cold * pct, (unsigned long)(cache.reload_misses - cache0.reload_misses));
+    printf("Cache: %lu evictions (%lu pinned for an adjacent page), %zu / %zu KB in use\n",
+           (unsigned long)(cache.evictions - cache0.evictions),
+           (unsigned long)(cache.neighbour_evictions - cache0.neighbour_evictions),
+           cache.used_bytes / 1024, cache.max_bytes / 1024);
+    print_mb("SD reads: ", io.read_bytes);
+    printf(" in %llu freads (%llu fopen, %llu fseek), %.1f ms in fread; ",
+           (unsigned long long)io.reads, (unsigned long long)io.opens, (unsigned long long)io.seeks,
+           io.read_us / 1000.0);
+    print_mb("", stats->samples * sizeof(int16_t));
+    printf(" played\n");
+    printf("Preload: %lu files cached (%lu prefetched), ",
+           (unsigned long)(preload.files - preload0.files),
+           (unsigned long)(preload.prefetch_files - preload0.prefetch_files));
+    print_mb("", preload.bytes - preload0.bytes);
+    printf(", %lu cancelled, %lu dropped by a flush; %lu headers parsed, %lu opens from the index\n",
+           (unsigned long)(preload.cancelled - preload0.cancelled),
+           (unsigned long)(preload.flushed - preload0.flushed),
+           (unsigned long)(cache.header_parses - cache0.header_parses),
+           (unsigned long)(cache.index_opens - cache0.index_opens));
+    printf("Timings (us)       count       min       avg       p50       p95       max\n");
+    op_timing_print(&press, stdout);
+    op_timing_print(&stats->open_hit, stdout);
+    op_timing_print(&stats->open_head, stdout);
+    op_timing_print(&stats->open_miss, stdout);
+    op_timing_print(&stats->first_read, stdout);
+    op_timing_print(&stats->drain, stdout);
+    op_timing_print(&warmups, stdout);
+
+    if (opt->status) {
+        printf("\n");
+        audio_provider_print_status(provider, STATUS_OUTPUT_VERBOSE);
+        benchmark_print_status(STATUS_OUTPUT_NORMAL);
+    }
+
+    bool ok = (stats->plays > 0 && stats->play_errors == 0);
+    op_timing_free(&press);
+    op_timing_free(&warmups);
+    mapper_deinit(mapper);
+    player_deinit(player);
+    return ok;
+}
+
+/* ============================================================================
+ * Test card synthesis
+ * ============================================================================ */
+
+/**
+ * @brief Source layouts of the synthesized sounds (every one the provider converts)
+ */
+static const struct {
+    uint32_t rate;
+    uint16_t channels;
+    uint16_t bits;
+} synth_layouts[] = {
+    { 44100, 1, 16 },
+    { 48000, 2, 16 },
+    { 48000, 1, 24 },
+    { 44100, 2, 32 },
+    { 22050, 1, 16 },
+    { 32000, 2, 24 },
+};
+
+static uint32_t synth_random(uint32_t *state)
+{
+    // xorshift32: reproducible cards and sequences for a given seed
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void put_le(uint8_t *p, uint32_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static esp_err_t synth_wav(const char *path, uint32_t rate, uint16_t channels, uint16_t bits,
+                           uint32_t frames, double freq)
+{
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        ESP_LOGE(TAG, "Cannot create %s: %s", path, strerror(errno));
+        return ESP_FAIL;
+    }
+    uint32_t block = channels * (bits / 8);
+    uint32_t data_size = frames * block;
+    uint8_t hdr[44];
+    memcpy(hdr, "RIFF", 4);
+    put_le(hdr + 4, 36 + data_size, 4);
+    memcpy(hdr + 8, "WAVEfmt ", 8);
+    put_le(hdr + 16, 16, 4);
+    put_le(hdr + 20, 1, 2);                 // PCM
+    put_le(hdr + 22, channels, 2);
+    put_le(hdr + 24, rate, 4);
+    put_le(hdr + 28, rate * block, 4);
+    put_le(hdr + 32, block, 2);
+    put_le(hdr + 34, bits, 2);
+    memcpy(hdr + 36, "data", 4);
+    put_le(hdr + 40, data_size, 4);
+    bool ok = fwrite(hdr, sizeof(hdr), 1, fp) == 1;
+
+    uint8_t frame[8];
+    for (uint32_t f = 0; f < frames && ok; f++) {
+        double fade = (f < frames / 2) ? 1.0 : 2.0 * (frames - f) / frames;
+        double v = 0.5 * fade * sin(2.0 * M_PI * freq * f / rate);
+        for (uint16_t c = 0; c < channels; c++) {
+            int32_t s = (int32_t)(v * (c ? 0.8 : 1.0) * 2147483647.0);
+            put_le(frame + c * (bits / 8), (uint32_t)s >> (32 - bits), bits / 8);
+        }
+        ok = fwrite(frame, block, 1, fp) == 1;
+    }
+    ok = (fclose(fp) == 0) && ok;
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+/**
+ * @brief Random press sequence over the synthesized pages
+ *
+ * Mostly presses and releases on the current page, some long presses, and
+ * page changes with the encoder (switch to page mode, one detent, back).
+ */
+static esp_err_t synth_sequence(const char *path, int pages, int events, uint32_t *rng)
+{
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        ESP_LOGE(TAG, "Cannot create %s: %s", path, strerror(errno));
+        return ESP_FAIL;
+    }
+    fprintf(fp, "# <delay_ms> <button> <event>: button 0 is the encoder switch (cw/ccw: rotation)\n");
+    int written = 0;
+    while (written < events) {
+        uint32_t r = synth_random(rng) % 100;
+        if (pages > 1 && r < 8) {
+            unsigned int gap_ms = 200 + synth_random(rng) % 400;
+            unsigned int turn_ms = 150 + synth_random(rng) % 200;
+            const char *direction = (synth_random(rng) % 3) ? "cw" : "ccw";
+            unsigned int back_ms = 300 + synth_random(rng) % 300;
+            fprintf(fp, "%u 0 press\n%u 0 %s\n%u 0 release\n%u 0 press\n%u 0 release\n",
+                    gap_ms, turn_ms, direction, 50u, back_ms, 80u);
+            written += 5;
+            continue;
+        }
+        unsigned int button = 1 + synth_random(rng) % SYNTH_BUTTONS;
+        unsigned int hold_ms = 40 + synth_random(rng) % 300;
+        unsigned int gap_ms = 100 + synth_random(rng) % 600;
+        fprintf(fp, "%u %u press\n", gap_ms, button);
+        if (r > 94) {
+            fprintf(fp, "%u %u long_press\n", 1000u, button);
+            written++;
+        }
+        fprintf(fp, "%u %u release\n", hold_ms, button);
+        written += 2;
+    }
+    return fclose(fp) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+static int cmd_synth(int argc, char **argv)
+{
+    if (argc < 1) {
+        fprintf(stderr, "synth: card directory required\n");
+        return 2;
+    }
+    const char *root = argv[0];
+    int pages = SYNTH_DEFAULT_PAGES;
+    int events = SYNTH_DEFAULT_EVENTS;
+    uint32_t rng = 12345;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pages") == 0 && i + 1 < argc) {
+            pages = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            events = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            rng = (uint32_t)strtoul(argv[++i], NULL, 0) | 1;
+        } else {
+            fprintf(stderr, "synth: unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (pages < 1 || pages > 99 || events < 1) {
+        fprintf(stderr, "synth: --pages 1-99, --events > 0\n");
+        return 2;
+    }
+
+    char path[SOUNDBOARD_MAX_PATH_LEN];
+    snprintf(path, sizeof(path), "%s/sounds", root);
+    if ((mkdir(root, 0755) != 0 && errno != EEXIST) || (mkdir(path, 0755) != 0 && errno != EEXIST)) {
+        fprintf(stderr, "synth: cannot create %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s", root, BENCH_MAPPINGS_FILE);
+    FILE *map = fopen(path, "w");
+    if (map == NULL) {
+        fprintf(stderr, "synth: cannot create %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    fprintf(map, "# Synthesized by soundboard_bench synth\n");
+    static const char *const actions[] = { "play", "play_cut", "play_lock" };
+    size_t total_bytes = 0;
+    for (int page = 1; page <= pages; page++) {
+        for (int button = 1; button <= SYNTH_BUTTONS; button++) {
+            int n = (page - 1) * SYNTH_BUTTONS + button - 1;
+            int layout = n % (int)ARRAY_COUNT(synth_layouts);
+            uint32_t ms = 100 + synth_random(&rng) % 1400;
+            uint32_t frames = synth_layouts[layout].rate * ms / 1000;
+            snprintf(path, sizeof(path), "%s/sounds/p%02d_b%02d.wav", root, page, button);
+            if (synth_wav(path, synth_layouts[layout].rate, synth_layouts[layout].channels,
+                          synth_layouts[layout].bits, frames, 220.0 + 20.0 * n) != ESP_OK) {
+                fclose(map);
+                return 1;
+            }
+            total_bytes += frames * synth_layouts[layout].channels * (synth_layouts[layout].bits / 8);
+            if (button == SYNTH_BUTTONS) {
+                fprintf(map, "p%02d,%d,press,stop\n", page, button);
+                fprintf(map, "p%02d,%d,long_press,play,sounds/p%02d_b%02d.wav\n", page, button, page, button);
+            } else {
+                fprintf(map, "p%02d,%d,press,%s,sounds/p%02d_b%02d.wav\n", page, button,
+                        actions[n % ARRAY_COUNT(actions)], page, button);
+            }
+        }
+    }
+    if (fclose(map) != 0) {
+        return 1;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s", root, BENCH_SEQUENCE_FILE);
+    if (synth_sequence(path, pages, events, &rng) != ESP_OK) {
+        return 1;
+    }
+    remove_card_file(root, BENCH_MAPPER_CACHE_FILE);
+    remove_card_file(root, SOUND_INDEX_FILENAME);
+
+    printf("Card %s: %d pages, %d sounds (%.1f MB of PCM), %s with %d events\n", root, pages,
+           pages * SYNTH_BUTTONS, total_bytes / (1024.0 * 1024.0), BENCH_SEQUENCE_FILE, events);
+    return 0;
+}
+
+/* ============================================================================
+ * Command line
+ * ============================================================================ */
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "Usage:\n"
+        "  soundboard_bench synth <card_dir> [--pages N] [--events N] [--seed N]\n"
+        "      Write a test card: WAV files, " BENCH_MAPPINGS_FILE ", " BENCH_SEQUENCE_FILE "\n"
+        "  soundboard_bench run <card_dir> [sequence] [options]\n"
+        "      Replay a press sequence (text or `trace save` dump, default <card_dir>/" BENCH_SEQUENCE_FILE ")\n"
+        "\n"
+        "Run options:\n"
+        "  --mappings FILE      Mappings file in card_dir (default " BENCH_MAPPINGS_FILE ")\n"
+        "  --policy P[,P...]    lru, page_lru, page_cost: one replay each (default page_cost)\n"
+        "  --cache-kb N         PSRAM cache size (default %d)\n"
+        "  --format F           Cache format: pcm16, mulaw, adpcm (default pcm16)\n"
+        "  --head-kb N          Attack-segment cache, 0 = off (default %d)\n"
+        "  --head-ms N          Attack-segment length (default %d)\n"
+        "  --ring-kb N          Read-ahead ring per file stream, 0 = direct reads (default 0);\n"
+        "                       with a ring, streamed sounds are read in real time\n"
+        "  --rate HZ            Fixed output rate, sources resampled (default 0 = native)\n"
+        "  --stereo             Keep stereo sources stereo (default: downmix to mono)\n"
+        "  --sd-open-us N       Simulated SD card: sleep per fopen (default 0)\n"
+        "  --sd-kbps N          Simulated SD card: read throughput in KB/s (default 0 = host speed)\n"
+        "  --realtime [SPEED]   Keep the recorded gaps between events, SPEED times faster (default 1,\n"
+        "                       also the pace of ring reads); without it, the preload queue is\n"
+        "                       drained before every event\n"
+        "  --open-only          Open and close the sounds instead of reading them\n"
+        "  --cold               Remove the mapper cache and sound index before each replay\n"
+        "  --repeat N           Replay the sequence N times per policy (default 1)\n"
+        "  --parse-runs N       Also time N mapper loads from CSV and from the binary cache\n"
+        "  --status             Print the provider and I/O status after each replay\n"
+        "  --check              Exit 1 if a play failed or nothing was played\n"
+        "  -v, -vv              Info / debug logs\n",
+        CONFIG_SOUNDBOARD_PLAYER_CACHE_SIZE_KB, CONFIG_SOUNDBOARD_HEAD_CACHE_SIZE_KB,
+        CONFIG_SOUNDBOARD_HEAD_CACHE_MS);
+}
+
+static bool parse_policies(char *list, bench_options_t *opt)
+{
+    opt->policy_count = 0;
+    for (char *name = strtok(list, ","); name != NULL; name = strtok(NULL, ",")) {
+        int policy = name_index(policy_names, ARRAY_COUNT(policy_names), name);
+        if (policy < 0 || opt->policy_count == BENCH_MAX_POLICIES) {
+            return false;
+        }
+        opt->policies[opt->policy_count++] = (audio_cache_policy_t)policy;
+    }
+    return opt->policy_count > 0;
+}
+
+static int parse_run_options(int argc, char **argv, bench_options_t *opt)
+{
+    for (int i = 0; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (strcmp(arg, "--mappings") == 0 && has_value) {
+            opt->mappings_file = argv[++i];
+        } else if (strcmp(arg, "--policy") == 0 && has_value) {
+            if (!parse_policies(argv[++i], opt)) {
+                fprintf(stderr, "Invalid --policy list\n");
+                return 2;
+            }
+        } else if (strcmp(arg, "--cache-kb") == 0 && has_value) {
+            opt->player.cache_size_kb = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--format") == 0 && has_value) {
+            int format = name_index(format_names, ARRAY_COUNT(format_names), argv[++i]);
+            if (format < 0) {
+                fprintf(stderr, "Invalid --format\n");
+                return 2;
+            }
+            opt->player.cache_format = (audio_cache_format_t)format;
+        } else if (strcmp(arg, "--head-kb") == 0 && has_value) {
+            opt->player.head_cache_kb = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--head-ms") == 0 && has_value) {
+            opt->player.head_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--ring-kb") == 0 && has_value) {
+            opt->player.stream_ring_kb = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--rate") == 0 && has_value) {
+            opt->player.output_rate = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--stereo") == 0) {
+            opt->player.downmix_mono = false;
+        } else if (strcmp(arg, "--sd-open-us") == 0 && has_value) {
+            opt->sd_open_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--sd-kbps") == 0 && has_value) {
+            opt->sd_kbps = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--realtime") == 0) {
+            opt->realtime_speed = 1.0;
+            if (has_value && argv[i + 1][0] != '-') {
+                opt->realtime_speed = atof(argv[++i]);
+                if (opt->realtime_speed <= 0) {
+                    fprintf(stderr, "Invalid --realtime speed\n");
+                    return 2;
+                }
+            }
+        } else if (strcmp(arg, "--open-only") == 0) {
+            opt->open_only = true;
+        } else if (strcmp(arg, "--cold") == 0) {
+            opt->cold = true;
+        } else if (strcmp(arg, "--repeat") == 0 && has_value) {
+            opt->repeat = atoi(argv[++i]);
+        } else if (strcmp(arg, "--parse-runs") == 0 && has_value) {
+            opt->parse_runs = atoi(argv[++i]);
+        } else if (strcmp(arg, "--status") == 0) {
+            opt->status = true;
+        } else if (strcmp(arg, "--check") == 0) {
+            opt->check = true;
+        } else if (strcmp(arg, "-v") == 0) {
+            esp_log_level_set("*", ESP_LOG_INFO);
+        } else if (strcmp(arg, "-vv") == 0) {
+            esp_log_level_set("*", ESP_LOG_DEBUG);
+        } else if (opt->sequence_path == NULL && arg[0] != '-') {
+            opt->sequence_path = arg;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            return 2;
+        }
+    }
+    if (opt->repeat < 1 || opt->parse_runs < 0) {
+        fprintf(stderr, "--repeat must be >= 1, --parse-runs >= 0\n");
+        return 2;
+    }
+    return 0;
+}
+
+static int cmd_run(int argc, char **argv)
+{
+    if (argc < 1) {
+        usage();
+        return 2;
+    }
+
+    player_config_t defaults = PLAYER_CONFIG_DEFAULT();
+    defaults.stream_ring_kb = 0;
+    bench_options_t opt = {
+        .root = argv[0],
+        .mappings_file = BENCH_MAPPINGS_FILE,
+        .policies = { AUDIO_CACHE_POLICY_PAGE_COST },
+        .policy_count = 1,
+        .player = defaults,
+        .repeat = 1,
+    };
+    int ret = parse_run_options(argc - 1, argv + 1, &opt);
+    if (ret != 0) {
+        return ret;
+    }
+
+    char default_sequence[SOUNDBOARD_MAX_PATH_LEN];
+    if (opt.sequence_path == NULL) {
+        snprintf(default_sequence, sizeof(default_sequence), "%s/%s", opt.root, BENCH_SEQUENCE_FILE);
+        opt.sequence_path = default_sequence;
+    }
+    bench_sequence_t seq = { 0 };
+    if (sequence_load(opt.sequence_path, &seq) != ESP_OK) {
+        free(seq.events);
+        return 1;
+    }
+    printf("Sequence %s: %zu events over %.1f s%s\n", opt.sequence_path, seq.count,
+           seq.events[seq.count - 1].t_us / 1e6, seq.from_trace ? " (trace dump)" : "");
+
+    host_io_set_throttle(opt.sd_open_us, opt.sd_kbps);
+    if (opt.sd_open_us > 0 || opt.sd_kbps > 0) {
+        printf("Simulated SD card: %lu us per open, %lu KB/s\n",
+               (unsigned long)opt.sd_open_us, (unsigned long)opt.sd_kbps);
+    }
+
+    bool ok = true;
+    for (int i = 0; i < opt.policy_count; i++) {
+        ok = run_replay(&opt, &seq, opt.policies[i]) && ok;
+    }
+    if (opt.parse_runs > 0) {
+        ok = (run_parse_benchmark(&opt) == ESP_OK) && ok;
+    }
+    free(seq.events);
+    return (opt.check && !ok) ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "synth") == 0) {
+        return cmd_synth(argc - 2, argv + 2);
+    }
+    if (argc >= 2 && strcmp(argv[1], "run") == 0) {
+        return cmd_run(argc - 2, argv + 2);
+    }
+    usage();
+    return 2;
+}
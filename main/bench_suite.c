@@ -0,0 +1,817 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file bench_suite.c
+ * @brief Scripted benchmark workloads with machine-readable output
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_app_desc.h"
+#include "esp_heap_caps.h"
+#include "esp_idf_version.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "soundboard.h"
+#include "mixer.h"
+#include "provider.h"
+#include "bench_suite.h"
+
+#ifdef CONFIG_SOUNDBOARD_SD_DIRECT_READ
+    #include "sd_card.h"
+#endif
+
+static const char *TAG = "bench";
+
+#define BENCH_FORMAT_VERSION    1
+
+#define BENCH_TASK_STACK_SIZE   6144
+#define BENCH_TASK_PRIORITY     1       // Below player task: playback keeps priority
+#define BENCH_TASK_CORE         1       // Audio core (same as player task)
+
+#define SD_FILE                 SDCARD_MOUNT_POINT "/.bench.bin"
+#define SD_FILE_SIZE            (512 * 1024)
+#define SD_CHUNK_MIN            512
+#define SD_CHUNK_MAX            (64 * 1024)
+#define SD_WAV_CHUNK            4096            // Provider WAV read size, into PSRAM
+
+#define MEMCPY_REGION_SIZE      (256 * 1024)    // PSRAM source, larger than the PSRAM cache
+#define MEMCPY_PASSES           8
+#define MEMCPY_SMALL            960             // Per-chunk cache hit copy size
+#define MEMCPY_LARGE            (32 * 1024)
+
+#define VOLUME_SAMPLES          480
+#define VOLUME_ITERATIONS       2000
+#define GAIN_HALF               (MIXER_GAIN_UNITY / 2)
+#define GAIN_RAMP_FROM          (MIXER_GAIN_UNITY / 4)
+#define GAIN_RAMP_TO            (MIXER_GAIN_UNITY * 3 / 4)
+
+#define WAV_MAX_FILES           32
+
+#define WARMUP_POLL_MS          20
+#define WARMUP_TIMEOUT_MS       30000
+
+#define MSC_COPY_FILE           SDCARD_MOUNT_POINT "/.bench_copy.tmp"
+
+#define STRESS_PHASE_MS         5000
+#define STRESS_TASK_STACK_SIZE  3072
+#define STRESS_TASK_PRIORITY    3       // Like the input scanner: preempts the preload task
+#define STRESS_TASK_CORE        0       // Producers on core 0, player task on core 1
+#define STRESS_PLAY_MS          20      // Restart period of the played file
+#define STRESS_STOP_EVERY       8       // Plays between two player_stop_file()
+#define STRESS_FLUSH_EVERY      25      // Preload requests between two flushes
+
+typedef struct {
+    const bench_suite_config_t *config;
+    uint32_t workloads;
+    SemaphoreHandle_t done;
+} bench_ctx_t;
+
+static const struct {
+    const char *name;
+    uint32_t bits;
+} s_workloads[] = {
+    { "all",    BENCH_SUITE_ALL },
+    { "sd",     BENCH_SUITE_SD },
+    { "memcpy", BENCH_SUITE_MEMCPY },
+    { "volume", BENCH_SUITE_VOLUME },
+    { "wav",    BENCH_SUITE_WAV },
+    { "warmup", BENCH_SUITE_WARMUP },
+    { "msc",    BENCH_SUITE_MSC },
+    { "stress", BENCH_SUITE_STRESS },
+};
+
+// =============================================================================
+// Output
+// =============================================================================
+
+static void emit_u32(const char *workload, const char *name, uint32_t value, const char *unit)
+{
+    printf("bench,%s,%s,%lu,%s\n", workload, name, (unsigned long)value, unit);
+}
+
+static void emit_f(const char *workload, const char *name, double value, const char *unit)
+{
+    printf("bench,%s,%s,%.2f,%s\n", workload, name, value, unit);
+}
+
+static void emit_str(const char *workload, const char *name, const char *value)
+{
+    printf("bench,%s,%s,%s,-\n", workload, name, value);
+}
+
+static void emit_error(const char *workload, esp_err_t err)
+{
+    printf("bench,%s,error,%d,%s\n", workload, err, esp_err_to_name(err));
+}
+
+// Bytes per microsecond = MB/s; * 1000000 / 1024 = kB/s
+static uint32_t kbps(size_t bytes, int64_t us)
+{
+    return us > 0 ? (uint32_t)((uint64_t)bytes * 1000000 / 1024 / (uint64_t)us) : 0;
+}
+
+static void *alloc_buffer(size_t size, uint32_t caps)
+{
+    void *buf = heap_caps_aligned_alloc(MIXER_BUFFER_ALIGN, size, caps);
+    if (buf == NULL && (caps & MALLOC_CAP_INTERNAL)) {
+        buf = heap_caps_aligned_alloc(MIXER_BUFFER_ALIGN, size, MALLOC_CAP_DEFAULT);
+    }
+    return buf;
+}
+
+// =============================================================================
+// Workloads
+// =============================================================================
+
+static void run_meta(const bench_suite_config_t *config)
+{
+    emit_u32("meta", "format", BENCH_FORMAT_VERSION, "-");
+    emit_str("meta", "firmware", esp_app_get_description()->version);
+    emit_str("meta", "idf", esp_get_idf_version());
+    if (config->sdcard != NULL) {
+        const sdmmc_card_t *card = config->sdcard;
+        emit_str("meta", "card", card->cid.name);
+        emit_u32("meta", "card_size",
+                 (uint32_t)((uint64_t)card->csd.capacity * card->csd.sector_size / (1024 * 1024)), "MB");
+        emit_u32("meta", "card_freq", (uint32_t)card->real_freq_khz, "kHz");
+        // SD results only compare between runs on the same bus (SPI vs SDMMC 1/4-bit)
+        bool spi = (card->host.flags & SDMMC_HOST_FLAG_SPI) != 0;
+        emit_str("meta", "card_bus", spi ? "spi" : "sdmmc");
+        emit_u32("meta", "card_bus_width", spi ? 1 : (1u << card->log_bus_width), "bit");
+    }
+}
+
+/**
+ * @brief Provider-style WAV data reads from offset: buffered stdio
+ *
+ * @return Read time in us, -1 if the file cannot be opened
+ */
+static int64_t sd_wav_read_stdio(uint32_t offset, uint8_t *dst, size_t *total)
+{
+    FILE *f = fopen(SD_FILE, "rb");
+    if (f == NULL) {
+        return -1;
+    }
+    fseek(f, offset, SEEK_SET);
+    size_t n;
+    *total = 0;
+    int64_t start = esp_timer_get_time();
+    while ((n = fread(dst, 1, SD_WAV_CHUNK, f)) > 0) {
+        *total += n;
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    fclose(f);
+    return elapsed;
+}
+
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+/**
+ * @brief Provider-style WAV data reads from offset: direct FatFS reads
+ */
+static int64_t sd_wav_read_direct(uint32_t offset, uint8_t *dst, size_t *total)
+{
+    sd_card_file_t *f;
+    if (sd_card_file_open(SD_FILE, &f) != ESP_OK) {
+        return -1;
+    }
+    sd_card_file_seek(f, offset);
+    size_t n;
+    *total = 0;
+    int64_t start = esp_timer_get_time();
+    while ((n = sd_card_file_read(f, dst, SD_WAV_CHUNK)) > 0) {
+        *total += n;
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    sd_card_file_close(f);
+    return elapsed;
+}
+#endif
+
+/**
+ * @brief 4 KB reads into PSRAM from a plain (44) and a padded (512) WAV data offset
+ */
+static void run_sd_wav(void)
+{
+    static const uint32_t offsets[] = { 44, 512 };
+    uint8_t *dst = alloc_buffer(SD_WAV_CHUNK, MALLOC_CAP_SPIRAM);
+    if (dst == NULL) {
+        emit_error("sd", ESP_ERR_NO_MEM);
+        return;
+    }
+    char name[24];
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        size_t total;
+        int64_t elapsed = sd_wav_read_stdio(offsets[i], dst, &total);
+        if (elapsed < 0) {
+            emit_error("sd", ESP_ERR_NOT_FOUND);
+            break;
+        }
+        snprintf(name, sizeof(name), "wav%lu_stdio", (unsigned long)offsets[i]);
+        emit_u32("sd", name, kbps(total, elapsed), "kB/s");
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+        elapsed = sd_wav_read_direct(offsets[i], dst, &total);
+        if (elapsed < 0) {
+            emit_error("sd", ESP_ERR_NOT_FOUND);
+            break;
+        }
+        snprintf(name, sizeof(name), "wav%lu_direct", (unsigned long)offsets[i]);
+        emit_u32("sd", name, kbps(total, elapsed), "kB/s");
+#endif
+    }
+    heap_caps_free(dst);
+}
+
+/**
+ * @brief Sequential write, then read back at each chunk size (unbuffered stdio), then WAV reads
+ */
+static void run_sd(void)
+{
+    uint8_t *buf = alloc_buffer(SD_CHUNK_MAX, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+    if (buf == NULL) {
+        emit_error("sd", ESP_ERR_NO_MEM);
+        return;
+    }
+    memset(buf, 0xA5, SD_CHUNK_MAX);
+    char name[24];
+
+    FILE *f = fopen(SD_FILE, "wb");
+    if (f == NULL) {
+        emit_error("sd", ESP_ERR_NOT_FOUND);
+        heap_caps_free(buf);
+        return;
+    }
+    setvbuf(f, NULL, _IONBF, 0);
+    int64_t start = esp_timer_get_time();
+    size_t written = 0;
+    while (written < SD_FILE_SIZE && fwrite(buf, 1, SD_CHUNK_MAX, f) == SD_CHUNK_MAX) {
+        written += SD_CHUNK_MAX;
+    }
+    fclose(f);
+    int64_t elapsed = esp_timer_get_time() - start;
+    if (written < SD_FILE_SIZE) {
+        emit_error("sd", ESP_FAIL);
+        goto done;
+    }
+    snprintf(name, sizeof(name), "write_%u", SD_CHUNK_MAX);
+    emit_u32("sd", name, kbps(written, elapsed), "kB/s");
+
+    for (size_t chunk = SD_CHUNK_MIN; chunk <= SD_CHUNK_MAX; chunk *= 2) {
+        start = esp_timer_get_time();
+        f = fopen(SD_FILE, "rb");
+        int64_t open_us = esp_timer_get_time() - start;
+        if (f == NULL) {
+            emit_error("sd", ESP_ERR_NOT_FOUND);
+            goto done;
+        }
+        setvbuf(f, NULL, _IONBF, 0);
+        size_t total = 0;
+        size_t n;
+        start = esp_timer_get_time();
+        while ((n = fread(buf, 1, chunk, f)) > 0) {
+            total += n;
+        }
+        elapsed = esp_timer_get_time() - start;
+        fclose(f);
+
+        if (chunk == SD_CHUNK_MIN) {
+            emit_u32("sd", "open", (uint32_t)open_us, "us");
+        }
+        snprintf(name, sizeof(name), "read_%u", (unsigned)chunk);
+        emit_u32("sd", name, kbps(total, elapsed), "kB/s");
+    }
+    run_sd_wav();
+
+done:
+    remove(SD_FILE);
+    heap_caps_free(buf);
+}
+
+static double memcpy_mbps(uint8_t *dst, const uint8_t *src, size_t region, size_t chunk)
+{
+    int64_t start = esp_timer_get_time();
+    size_t total = 0;
+    for (int pass = 0; pass < MEMCPY_PASSES; pass++) {
+        for (size_t off = 0; off + chunk <= region; off += chunk) {
+            memcpy(dst, src + off, chunk);
+            total += chunk;
+        }
+    }
+    int64_t us = esp_timer_get_time() - start;
+    return us > 0 ? (double)total / (double)us : 0.0;
+}
+
+/**
+ * @brief Cache-hit path copies: PSRAM region walked chunk by chunk into internal RAM
+ */
+static void run_memcpy(void)
+{
+    uint8_t *psram = heap_caps_malloc(MEMCPY_REGION_SIZE, MALLOC_CAP_SPIRAM);
+    uint8_t *internal_src = heap_caps_malloc(MEMCPY_LARGE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    uint8_t *dst = heap_caps_malloc(MEMCPY_LARGE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (psram == NULL || internal_src == NULL || dst == NULL) {
+        emit_error("memcpy", ESP_ERR_NO_MEM);
+        goto done;
+    }
+    memset(psram, 0x5A, MEMCPY_REGION_SIZE);
+    memset(internal_src, 0x5A, MEMCPY_LARGE);
+
+    emit_f("memcpy", "psram_960", memcpy_mbps(dst, psram, MEMCPY_REGION_SIZE, MEMCPY_SMALL), "MB/s");
+    emit_f("memcpy", "psram_32768", memcpy_mbps(dst, psram, MEMCPY_REGION_SIZE, MEMCPY_LARGE), "MB/s");
+    emit_f("memcpy", "internal_960", memcpy_mbps(dst, internal_src, MEMCPY_LARGE, MEMCPY_SMALL), "MB/s");
+
+done:
+    heap_caps_free(psram);
+    heap_caps_free(internal_src);
+    heap_caps_free(dst);
+}
+
+typedef void (*volume_kernel_fn)(int16_t *dst, const int16_t *src, size_t count,
+                                 uint32_t gain_from, uint32_t gain_to);
+
+static double volume_msps(volume_kernel_fn fn, int16_t *dst, const int16_t *src,
+                          uint32_t gain_from, uint32_t gain_to)
+{
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < VOLUME_ITERATIONS; i++) {
+        fn(dst, src, VOLUME_SAMPLES, gain_from, gain_to);
+    }
+    int64_t us = esp_timer_get_time() - start;
+    return us > 0 ? (double)VOLUME_SAMPLES * VOLUME_ITERATIONS / (double)us : 0.0;
+}
+
+/**
+ * @brief Player mix kernels on one 10 ms chunk
+ */
+static void run_volume(void)
+{
+    size_t bytes = VOLUME_SAMPLES * sizeof(int16_t);
+    int16_t *src = alloc_buffer(bytes, MALLOC_CAP_INTERNAL);
+    int16_t *src_psram = alloc_buffer(bytes, MALLOC_CAP_SPIRAM);
+    int16_t *dst = alloc_buffer(bytes, MALLOC_CAP_INTERNAL);
+    if (src == NULL || dst == NULL) {
+        emit_error("volume", ESP_ERR_NO_MEM);
+        goto done;
+    }
+    uint32_t seed = 1;
+    for (size_t i = 0; i < VOLUME_SAMPLES; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        src[i] = (int16_t)(seed >> 16);
+    }
+    memset(dst, 0, bytes);
+
+    emit_f("volume", "scale_const", volume_msps(mixer_scale_s16, dst, src, GAIN_HALF, GAIN_HALF), "Msamples/s");
+    emit_f("volume", "scale_ramp", volume_msps(mixer_scale_s16, dst, src, GAIN_RAMP_FROM, GAIN_RAMP_TO), "Msamples/s");
+    emit_f("volume", "scale_add_const",
+           volume_msps(mixer_scale_add_sat_s16, dst, src, GAIN_HALF, GAIN_HALF), "Msamples/s");
+    if (src_psram != NULL) {
+        memcpy(src_psram, src, bytes);
+        emit_f("volume", "scale_const_psram",
+               volume_msps(mixer_scale_s16, dst, src_psram, GAIN_HALF, GAIN_HALF), "Msamples/s");
+    }
+
+done:
+    heap_caps_free(src);
+    heap_caps_free(src_psram);
+    heap_caps_free(dst);
+}
+
+typedef struct {
+    char (*paths)[SOUNDBOARD_MAX_PATH_LEN];
+    int count;
+} wav_list_t;
+
+static void wav_collect_cb(const char *page_id, uint8_t button_number, const char *filename, void *ctx)
+{
+    wav_list_t *list = (wav_list_t *)ctx;
+    if (list->count >= WAV_MAX_FILES) {
+        return;
+    }
+    for (int i = 0; i < list->count; i++) {
+        if (strcmp(list->paths[i], filename) == 0) {
+            return;
+        }
+    }
+    snprintf(list->paths[list->count++], SOUNDBOARD_MAX_PATH_LEN, "%s", filename);
+}
+
+/**
+ * @brief fopen()/fclose() and header parse of the mapped files (first WAV_MAX_FILES)
+ */
+static void run_wav(void)
+{
+    wav_list_t list = {
+        .paths = malloc(WAV_MAX_FILES * SOUNDBOARD_MAX_PATH_LEN),
+    };
+    if (list.paths == NULL) {
+        emit_error("wav", ESP_ERR_NO_MEM);
+        return;
+    }
+    esp_err_t ret = mapper_for_each_file(SDCARD_MAPPINGS_PATH, SDCARD_MOUNT_POINT, wav_collect_cb, &list);
+    if (ret != ESP_OK || list.count == 0) {
+        emit_error("wav", ret != ESP_OK ? ret : ESP_ERR_NOT_FOUND);
+        free(list.paths);
+        return;
+    }
+
+    uint64_t open_sum = 0, parse_sum = 0;
+    uint32_t open_max = 0, parse_max = 0;
+    int parsed = 0;
+    for (int i = 0; i < list.count; i++) {
+        int64_t start = esp_timer_get_time();
+        FILE *f = fopen(list.paths[i], "rb");
+        if (f != NULL) {
+            fclose(f);
+        }
+        uint32_t open_us = (uint32_t)(esp_timer_get_time() - start);
+
+        audio_info_t info;
+        uint32_t data_offset, data_size;
+        start = esp_timer_get_time();
+        ret = audio_provider_parse_wav_file(list.paths[i], &info, &data_offset, &data_size);
+        uint32_t parse_us = (uint32_t)(esp_timer_get_time() - start);
+        if (f == NULL || ret != ESP_OK) {
+            ESP_LOGW(TAG, "Skipping %s", list.paths[i]);
+            continue;
+        }
+
+        open_sum += open_us;
+        parse_sum += parse_us;
+        open_max = open_us > open_max ? open_us : open_max;
+        parse_max = parse_us > parse_max ? parse_us : parse_max;
+        parsed++;
+    }
+    free(list.paths);
+
+    emit_u32("wav", "files", (uint32_t)parsed, "-");
+    if (parsed == 0) {
+        return;
+    }
+    emit_u32("wav", "open_avg", (uint32_t)(open_sum / parsed), "us");
+    emit_u32("wav", "open_max", open_max, "us");
+    emit_u32("wav", "parse_avg", (uint32_t)(parse_sum / parsed), "us");
+    emit_u32("wav", "parse_max", parse_max, "us");
+}
+
+/**
+ * @brief Purge the cache, re-queue the current page and wait for the warm-up window
+ */
+static esp_err_t warmup_once(const bench_suite_config_t *config, bool use_bank,
+                             audio_provider_warmup_t *result)
+{
+    audio_provider_warmup_t before;
+    esp_err_t ret = player_get_warmup(config->player, &before);
+    if (ret == ESP_OK) {
+        ret = player_purge_cache(config->player);
+    }
+    if (ret == ESP_OK) {
+        ret = mapper_preload_page(config->mapper, use_bank);
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    for (int waited = 0; waited < WARMUP_TIMEOUT_MS; waited += WARMUP_POLL_MS) {
+        vTaskDelay(pdMS_TO_TICKS(WARMUP_POLL_MS));
+        ret = player_get_warmup(config->player, result);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        if (!result->active) {
+            // Window closed without caching anything (page files already referenced)
+            return (result->count != before.count) ? ESP_OK : ESP_ERR_NOT_FOUND;
+        }
+    }
+    return ESP_ERR_TIMEOUT;
+}
+
+static void run_warmup(const bench_suite_config_t *config)
+{
+    if (config->player == NULL || config->mapper == NULL) {
+        emit_error("warmup", ESP_ERR_INVALID_STATE);
+        return;
+    }
+
+    static const struct {
+        bool use_bank;
+        const char *prefix;
+    } runs[] = { { false, "files" }, { true, "bank" } };
+
+    char name[24];
+    for (size_t i = 0; i < sizeof(runs) / sizeof(runs[0]); i++) {
+        audio_provider_warmup_t warmup;
+        esp_err_t ret = warmup_once(config, runs[i].use_bank, &warmup);
+        if (ret != ESP_OK) {
+            emit_error("warmup", ret);
+            continue;
+        }
+        snprintf(name, sizeof(name), "%s_count", runs[i].prefix);
+        emit_u32("warmup", name, warmup.files, "-");
+        snprintf(name, sizeof(name), "%s_size", runs[i].prefix);
+        emit_u32("warmup", name, (uint32_t)(warmup.bytes / 1024), "kB");
+        snprintf(name, sizeof(name), "%s_time", runs[i].prefix);
+        emit_u32("warmup", name, warmup.ms, "ms");
+        snprintf(name, sizeof(name), "%s_rate", runs[i].prefix);
+        emit_u32("warmup", name, kbps(warmup.bytes, (int64_t)warmup.ms * 1000), "kB/s");
+        if (runs[i].use_bank) {
+            // 0: no bank built for the page, the files were loaded instead
+            emit_u32("warmup", "bank_used", warmup.bank ? 1 : 0, "-");
+        }
+    }
+}
+
+static void run_msc(const bench_suite_config_t *config)
+{
+    size_t bytes = 0;
+    uint32_t us = 0;
+    esp_err_t ret = (config->msc != NULL)
+        ? msc_run_copy_benchmark(config->msc, MSC_COPY_FILE, &bytes, &us)
+        : ESP_ERR_INVALID_STATE;
+    if (ret != ESP_OK) {
+        emit_error("msc", ret);
+        return;
+    }
+    emit_u32("msc", "copy_size", (uint32_t)(bytes / 1024), "kB");
+    emit_u32("msc", "copy_rate", kbps(bytes, us), "kB/s");
+}
+
+/**
+ * @brief Shared state of the stress producer tasks
+ */
+typedef struct {
+    const bench_suite_config_t *config;
+    const char *filename;
+    bool stop;                  // Set by the bench task (__atomic)
+    uint32_t volume_ops;
+    uint32_t play_ops;
+    uint32_t preload_ops;
+    SemaphoreHandle_t exited;   // Counting: given once per producer
+} stress_ctx_t;
+
+static void first_file_cb(const char *page_id, uint8_t button_number, const char *filename, void *ctx)
+{
+    char *first = (char *)ctx;
+    if (first[0] == '\0') {
+        snprintf(first, SOUNDBOARD_MAX_PATH_LEN, "%s", filename);
+    }
+}
+
+static inline bool stress_running(stress_ctx_t *ctx)
+{
+    return !__atomic_load_n(&ctx->stop, __ATOMIC_ACQUIRE);
+}
+
+static void stress_play_task(void *arg)
+{
+    stress_ctx_t *ctx = (stress_ctx_t *)arg;
+    while (stress_running(ctx)) {
+        if (++ctx->play_ops % STRESS_STOP_EVERY == 0) {
+            player_stop_file(ctx->config->player, ctx->filename);
+        }
+        player_play(ctx->config->player, ctx->filename);
+        vTaskDelay(pdMS_TO_TICKS(STRESS_PLAY_MS));
+    }
+    xSemaphoreGive(ctx->exited);
+    vTaskDelete(NULL);
+}
+
+static void stress_volume_task(void *arg)
+{
+    stress_ctx_t *ctx = (stress_ctx_t *)arg;
+    while (stress_running(ctx)) {
+        player_volume_adjust(ctx->config->player, (ctx->volume_ops++ & 1) ? 1 : -1);
+        vTaskDelay(1);
+    }
+    xSemaphoreGive(ctx->exited);
+    vTaskDelete(NULL);
+}
+
+static void stress_preload_task(void *arg)
+{
+    stress_ctx_t *ctx = (stress_ctx_t *)arg;
+    while (stress_running(ctx)) {
+        if (++ctx->preload_ops % STRESS_FLUSH_EVERY == 0) {
+            player_flush_preload(ctx->config->player);
+        }
+        player_preload(ctx->config->player, ctx->filename);
+        vTaskDelay(1);
+    }
+    xSemaphoreGive(ctx->exited);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Play the file in a loop for one phase, with or without the volume / preload producers
+ *
+ * @return ESP_OK, or ESP_ERR_NO_MEM if a producer task could not be created
+ *         (the started ones are joined before returning)
+ */
+static esp_err_t stress_phase(stress_ctx_t *ctx, bool hammer, player_timing_t *timing)
+{
+    static const struct {
+        TaskFunction_t fn;
+        const char *name;
+        bool hammer;
+    } producers[] = {
+        { stress_play_task,    "st_play",    false },
+        { stress_volume_task,  "st_volume",  true },
+        { stress_preload_task, "st_preload", true },
+    };
+
+    ctx->stop = false;
+    ctx->volume_ops = ctx->play_ops = ctx->preload_ops = 0;
+    player_reset_timing(ctx->config->player);
+
+    int started = 0;
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0; i < sizeof(producers) / sizeof(producers[0]); i++) {
+        if (producers[i].hammer && !hammer) {
+            continue;
+        }
+        if (xTaskCreatePinnedToCore(producers[i].fn, producers[i].name, STRESS_TASK_STACK_SIZE, ctx,
+                                    STRESS_TASK_PRIORITY, NULL, STRESS_TASK_CORE) != pdPASS) {
+            ret = ESP_ERR_NO_MEM;
+            break;
+        }
+        started++;
+    }
+
+    if (ret == ESP_OK) {
+        vTaskDelay(pdMS_TO_TICKS(STRESS_PHASE_MS));
+    }
+    __atomic_store_n(&ctx->stop, true, __ATOMIC_RELEASE);
+    for (int i = 0; i < started; i++) {
+        xSemaphoreTake(ctx->exited, portMAX_DELAY);
+    }
+    player_get_timing(ctx->config->player, timing);
+    player_stop(ctx->config->player, true);
+    vTaskDelay(pdMS_TO_TICKS(100));     // Let the stop drain before the next phase
+    return ret;
+}
+
+/**
+ * @brief Worst chunk jitter with command / volume / preload producers on core 0
+ *
+ * A baseline phase plays the first mapped file in a loop; the loaded phase
+ * adds tasks adjusting the volume and queueing preloads every tick. The
+ * player and cache loggers are quieted meanwhile (console output would
+ * dominate the timing).
+ */
+static void run_stress(const bench_suite_config_t *config)
+{
+    if (config->player == NULL) {
+        emit_error("stress", ESP_ERR_INVALID_STATE);
+        return;
+    }
+
+    char *filename = calloc(1, SOUNDBOARD_MAX_PATH_LEN);
+    esp_err_t ret = (filename != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+    if (ret == ESP_OK) {
+        ret = mapper_for_each_file(SDCARD_MAPPINGS_PATH, SDCARD_MOUNT_POINT, first_file_cb, filename);
+    }
+    if (ret == ESP_OK && filename[0] == '\0') {
+        ret = ESP_ERR_NOT_FOUND;
+    }
+    stress_ctx_t ctx = {
+        .config = config,
+        .filename = filename,
+        .exited = (ret == ESP_OK) ? xSemaphoreCreateCounting(3, 0) : NULL,
+    };
+    if (ret == ESP_OK && ctx.exited == NULL) {
+        ret = ESP_ERR_NO_MEM;
+    }
+    if (ret != ESP_OK) {
+        emit_error("stress", ret);
+        free(filename);
+        return;
+    }
+
+    int volume = 0;
+    player_volume_get(config->player, &volume);
+    static const char *const quiet_tags[] = { "player", "audio_cache", "audio_provider" };
+    esp_log_level_t levels[sizeof(quiet_tags) / sizeof(quiet_tags[0])];
+    for (size_t i = 0; i < sizeof(quiet_tags) / sizeof(quiet_tags[0]); i++) {
+        levels[i] = esp_log_level_get(quiet_tags[i]);
+        esp_log_level_set(quiet_tags[i], ESP_LOG_WARN);
+    }
+
+    player_timing_t baseline, loaded;
+    ret = stress_phase(&ctx, false, &baseline);
+    uint32_t baseline_plays = ctx.play_ops;
+    if (ret == ESP_OK) {
+        ret = stress_phase(&ctx, true, &loaded);
+    }
+
+    for (size_t i = 0; i < sizeof(quiet_tags) / sizeof(quiet_tags[0]); i++) {
+        esp_log_level_set(quiet_tags[i], levels[i]);
+    }
+    player_volume_set(config->player, (int8_t)volume);
+    vSemaphoreDelete(ctx.exited);
+    free(filename);
+    if (ret != ESP_OK) {
+        emit_error("stress", ret);
+        return;
+    }
+
+    emit_u32("stress", "phase", STRESS_PHASE_MS, "ms");
+    emit_u32("stress", "baseline_chunks", baseline.chunks, "-");
+    emit_u32("stress", "baseline_plays", baseline_plays, "-");
+    emit_u32("stress", "baseline_jitter_peak", baseline.jitter_peak_us, "us");
+    emit_u32("stress", "baseline_busy_peak", baseline.busy_peak_us, "us");
+    emit_u32("stress", "chunks", loaded.chunks, "-");
+    emit_u32("stress", "plays", ctx.play_ops, "-");
+    emit_u32("stress", "volume_ops", ctx.volume_ops, "-");
+    emit_u32("stress", "preload_ops", ctx.preload_ops, "-");
+    emit_u32("stress", "jitter_peak", loaded.jitter_peak_us, "us");
+    emit_u32("stress", "busy_peak", loaded.busy_peak_us, "us");
+    emit_u32("stress", "cmd_ring_full", loaded.cmd_ring_full, "-");
+    emit_u32("stress", "baseline_underruns", baseline.underruns, "-");
+    emit_u32("stress", "underruns", loaded.underruns, "-");
+}
+
+// =============================================================================
+// Task
+// =============================================================================
+
+static void bench_task(void *arg)
+{
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    const bench_suite_config_t *config = ctx->config;
+    int64_t start = esp_timer_get_time();
+
+    run_meta(config);
+    if (ctx->workloads & BENCH_SUITE_SD) {
+        run_sd();
+    }
+    if (ctx->workloads & BENCH_SUITE_MEMCPY) {
+        run_memcpy();
+    }
+    if (ctx->workloads & BENCH_SUITE_VOLUME) {
+        run_volume();
+    }
+    if (ctx->workloads & BENCH_SUITE_WAV) {
+        run_wav();
+    }
+    if (ctx->workloads & BENCH_SUITE_WARMUP) {
+        run_warmup(config);
+    }
+    if (ctx->workloads & BENCH_SUITE_MSC) {
+        run_msc(config);
+    }
+    if (ctx->workloads & BENCH_SUITE_STRESS) {
+        run_stress(config);
+    }
+    emit_u32("end", "total", (uint32_t)((esp_timer_get_time() - start) / 1000), "ms");
+
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+// =============================================================================
+// Public API
+// =============================================================================
+
+uint32_t bench_suite_parse_workload(const char *name)
+{
+    for (size_t i = 0; i < sizeof(s_workloads) / sizeof(s_workloads[0]); i++) {
+        if (strcmp(name, s_workloads[i].name) == 0) {
+            return s_workloads[i].bits;
+        }
+    }
+    return 0;
+}
+
+esp_err_t bench_suite_run(const bench_suite_config_t *config, uint32_t workloads)
+{
+    if (config == NULL || (workloads & (BENCH_SUITE_ALL | BENCH_SUITE_STRESS)) == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bench_ctx_t ctx = {
+        .config = config,
+        .workloads = workloads,
+        .done = xSemaphoreCreateBinary(),
+    };
+    if (ctx.done == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Mixer kernels use PIE registers: run pinned on the audio core like the player
+    if (xTaskCreatePinnedToCore(bench_task, "bench", BENCH_TASK_STACK_SIZE, &ctx,
+                                BENCH_TASK_PRIORITY, NULL, BENCH_TASK_CORE) != pdPASS) {
+        vSemaphoreDelete(ctx.done);
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(ctx.done, portMAX_DELAY);
+    vSemaphoreDelete(ctx.done);
+    return ESP_OK;
+}
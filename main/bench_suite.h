@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file bench_suite.h
+ * @brief Scripted on-device benchmark workloads ('bench' console command)
+ *
+ * Unlike benchmark.h, which aggregates whatever I/O the application happens
+ * to do, each workload here drives a fixed access pattern and prints one
+ * result per line:
+ *
+ *   bench,<workload>,<case>,<value>,<unit>
+ *
+ * The format is stable (bench,meta,format gives its version): the set of
+ * workloads and cases may grow, existing case names and units do not change.
+ * A failing case prints bench,<workload>,error,<esp_err_t>,<error name>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdmmc_cmd.h" // IWYU pragma: keep
+#include "player.h"
+#include "mapper.h"
+#include "msc.h"
+
+/**
+ * @brief Workload selection bits
+ */
+typedef enum {
+    BENCH_SUITE_SD      = 1 << 0,   /**< SD sequential write / read per chunk size (512 B - 64 KB) */
+    BENCH_SUITE_MEMCPY  = 1 << 1,   /**< PSRAM to internal RAM memcpy() bandwidth */
+    BENCH_SUITE_VOLUME  = 1 << 2,   /**< Volume / mix kernel throughput */
+    BENCH_SUITE_WAV     = 1 << 3,   /**< WAV open and header parse cost (mapped files) */
+    BENCH_SUITE_WARMUP  = 1 << 4,   /**< Cache warm-up of the current page (files, then bank) */
+    BENCH_SUITE_MSC     = 1 << 5,   /**< USB drive to SD card copy throughput */
+    BENCH_SUITE_ALL     = 0x3f,
+    BENCH_SUITE_STRESS  = 1 << 6,   /**< Chunk jitter under play / volume / preload load (audible, not in "all") */
+} bench_suite_workload_t;
+
+/**
+ * @brief Modules the workloads run against (NULL members skip their workloads)
+ */
+typedef struct {
+    sdmmc_card_t *sdcard;       /**< SD card (meta line only) */
+    player_handle_t player;     /**< Cache purge, warm-up state, stress target */
+    mapper_handle_t mapper;     /**< Mapped files and current page */
+    msc_handle_t msc;           /**< USB drive copy */
+} bench_suite_config_t;
+
+/**
+ * @brief Parse a workload name ("all", "sd", "memcpy", "volume", "wav", "warmup", "msc", "stress")
+ *
+ * @return Workload bits, or 0 if the name is unknown
+ */
+uint32_t bench_suite_parse_workload(const char *name);
+
+/**
+ * @brief Run the selected workloads and print their results to the console
+ *
+ * Blocks the caller until done. Runs on the audio core below the player
+ * task priority: playback keeps running but skews the results. The warm-up
+ * workload purges the unreferenced cache entries and leaves the current page
+ * cached again.
+ *
+ * @param config Modules to benchmark
+ * @param workloads Bitmask of bench_suite_workload_t
+ * @return
+ *     - ESP_OK when the run completed (individual cases may report errors)
+ *     - ESP_ERR_INVALID_ARG if config is NULL or no workload is selected
+ *     - ESP_ERR_NO_MEM if the benchmark task could not be created
+ */
+esp_err_t bench_suite_run(const bench_suite_config_t *config, uint32_t workloads);
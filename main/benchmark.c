@@ -29,6 +29,8 @@ static const char *subsystem_names[] = {
     [BENCH_CACHE_HIT]  = "CACHE_HIT",
     [BENCH_MSC_READ]   = "MSC_READ",
     [BENCH_MSC_WRITE]  = "MSC_WRITE",
+    [BENCH_RESAMPLE]   = "RESAMPLE",
+    [BENCH_RESAMPLE_LOAD] = "RESAMPLE_LOAD",
 };
 
 #define PRINT_COUNTERS_BUFSIZE 128
@@ -8,7 +8,8 @@
  * @file benchmark.h
  * @brief I/O benchmark instrumentation — global API
  *
- * Provides per-subsystem timing counters for fread/fwrite calls.
+ * Provides per-subsystem timing counters for fread/fwrite calls (and
+ * sample-rate conversion, measured per converted chunk).
  * Usage: call benchmark_record() around each fread/fwrite, then
  * benchmark_log_and_reset() at the end of each file transfer.
  *
@@ -35,6 +36,8 @@ typedef enum {
     BENCH_CACHE_HIT,     /**< PSRAM to Internal RAM memcpy() (cache hit)*/
     BENCH_MSC_READ,      /**< MSC USB read (fread from USB flash drive) */
     BENCH_MSC_WRITE,     /**< MSC SD write (fwrite to SD card) */
+    BENCH_RESAMPLE,      /**< Sample-rate conversion of played streams (player task, output bytes) */
+    BENCH_RESAMPLE_LOAD, /**< Sample-rate conversion at cache load (preload task, output bytes) */
     BENCH_SUBSYSTEM_COUNT
 } benchmark_subsystem_t;
 
@@ -15,17 +15,26 @@
 #include "freertos/FreeRTOS.h"  // IWYU pragma: keep
 #include "esp_console.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "argtable3/argtable3.h"
 
 #include "app_state.h"
 #include "console.h"
 #include "sd_card.h"
 #include "persistent_volume.h"
+#include "mixer.h"
+#include "bench_suite.h"
 #include "soundboard.h"
 
 #ifdef CONFIG_SOUNDBOARD_IO_STATS_ENABLE
     #include "benchmark.h"
 #endif
+#ifdef CONFIG_SOUNDBOARD_LATENCY_STATS_ENABLE
+    #include "latency.h"
+#endif
+#ifdef CONFIG_SOUNDBOARD_TRACE_ENABLE
+    #include "trace.h"
+#endif
 
 static const char *TAG = "console";
 
@@ -240,6 +249,211 @@ static void print_system_status(status_output_type_t output_type)
 }
 
 
+// =============================================================================
+// Task Profiler
+// =============================================================================
+
+#define TOP_DEFAULT_WINDOW_MS   1000
+#define TOP_MAX_WINDOW_MS       60000
+#define TOP_TASK_SLACK          4       // Tasks created between count and snapshot
+#define TOP_STACK_LOW_BYTES     512     // High-water mark flagged as close to overflow
+#define TOP_LOG_TASK_STACK_SIZE 3072
+#define TOP_LOG_TASK_PRIORITY   1       // Above idle only: never delays the audio path
+#define TOP_LOG_TASK_CORE       0
+
+/**
+ * @brief Snapshot of every task's run-time counter
+ */
+typedef struct {
+    TaskStatus_t *tasks;
+    UBaseType_t count;
+    configRUN_TIME_COUNTER_TYPE total;  // Run-time clock when taken
+} top_snapshot_t;
+
+static TaskHandle_t s_top_log_task = NULL;
+static volatile uint32_t s_top_log_period_ms = 0;    // 0 = stop requested
+
+static bool top_snapshot_take(top_snapshot_t *snap)
+{
+    UBaseType_t capacity = uxTaskGetNumberOfTasks() + TOP_TASK_SLACK;
+    snap->tasks = pvPortMalloc(capacity * sizeof(TaskStatus_t));
+    if (snap->tasks == NULL) {
+        snap->count = 0;
+        snap->total = 0;
+        return false;
+    }
+    snap->count = uxTaskGetSystemState(snap->tasks, capacity, &snap->total);
+    return true;
+}
+
+static void top_snapshot_free(top_snapshot_t *snap)
+{
+    vPortFree(snap->tasks);
+    snap->tasks = NULL;
+    snap->count = 0;
+}
+
+/**
+ * @brief Run time of a task in the earlier snapshot (0 if created since)
+ */
+static configRUN_TIME_COUNTER_TYPE top_prev_runtime(const top_snapshot_t *prev, TaskHandle_t handle)
+{
+    for (UBaseType_t i = 0; i < prev->count; i++) {
+        if (prev->tasks[i].xHandle == handle) {
+            return prev->tasks[i].ulRunTimeCounter;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Print per-task CPU over [prev, cur], stack high-water marks and heap
+ *
+ * CPU is a percentage of one core (tasks are pinned); per-core load is
+ * derived from the idle tasks.
+ */
+static void top_print(const top_snapshot_t *prev, const top_snapshot_t *cur)
+{
+    configRUN_TIME_COUNTER_TYPE window = cur->total - prev->total;
+    uint32_t idle_pct_x10[CONFIG_FREERTOS_NUMBER_OF_CORES] = {0};
+
+#ifndef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    printf("  (CPU not measured: CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS disabled)\n");
+#endif
+
+    printf("  %-16s %4s %4s %7s %11s\n", "Task", "Core", "Prio", "CPU", "Stack free");
+    for (UBaseType_t i = 0; i < cur->count; i++) {
+        const TaskStatus_t *t = &cur->tasks[i];
+        configRUN_TIME_COUNTER_TYPE ran = t->ulRunTimeCounter - top_prev_runtime(prev, t->xHandle);
+        uint32_t pct_x10 = (window > 0) ? (uint32_t)((uint64_t)ran * 1000 / window) : 0;
+        BaseType_t core = xTaskGetCoreID(t->xHandle);
+        bool pinned = (core >= 0 && core < CONFIG_FREERTOS_NUMBER_OF_CORES);
+        if (pinned && t->uxCurrentPriority == tskIDLE_PRIORITY && strncmp(t->pcTaskName, "IDLE", 4) == 0) {
+            idle_pct_x10[core] = pct_x10;
+        }
+
+        char core_str[4];
+        if (pinned) {
+            snprintf(core_str, sizeof(core_str), "%d", (int)core);
+        } else {
+            strcpy(core_str, "-");
+        }
+        printf("  %-16s %4s %4u %5lu.%lu%% %8u B%s\n",
+               t->pcTaskName, core_str, (unsigned int)t->uxCurrentPriority,
+               (unsigned long)(pct_x10 / 10), (unsigned long)(pct_x10 % 10),
+               (unsigned int)t->usStackHighWaterMark,
+               (t->usStackHighWaterMark < TOP_STACK_LOW_BYTES) ? "  LOW" : "");
+    }
+
+    for (int core = 0; core < CONFIG_FREERTOS_NUMBER_OF_CORES; core++) {
+        uint32_t busy_x10 = (idle_pct_x10[core] < 1000) ? 1000 - idle_pct_x10[core] : 0;
+        printf("  Core %d load: %lu.%lu%%\n", core, (unsigned long)(busy_x10 / 10), (unsigned long)(busy_x10 % 10));
+    }
+    printf("  Internal heap: %zu KB free, %zu KB minimum, %zu KB largest block\n",
+           heap_caps_get_free_size(MALLOC_CAP_INTERNAL) / 1024,
+           heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL) / 1024,
+           heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL) / 1024);
+#if CONFIG_SPIRAM_SUPPORT
+    printf("  PSRAM heap: %zu KB free, %zu KB minimum, %zu KB largest block\n",
+           heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024,
+           heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM) / 1024,
+           heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) / 1024);
+#endif
+}
+
+/**
+ * @brief Periodic profiler log: each report covers the period since the last one
+ */
+static void top_log_task(void *arg)
+{
+    top_snapshot_t prev;
+    top_snapshot_take(&prev);
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (s_top_log_period_ms > 0) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(s_top_log_period_ms));
+        if (s_top_log_period_ms == 0) {
+            break;
+        }
+        top_snapshot_t cur;
+        if (!top_snapshot_take(&cur)) {
+            continue;
+        }
+        printf("top @ %lld ms (last %lu ms):\n",
+               esp_timer_get_time() / 1000, (unsigned long)s_top_log_period_ms);
+        top_print(&prev, &cur);
+        top_snapshot_free(&prev);
+        prev = cur;
+    }
+
+    top_snapshot_free(&prev);
+    s_top_log_task = NULL;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 'top' command handler (per-task CPU, stack and heap profiler)
+ *
+ * Usage: top [window_ms] | top log <period_ms|off>
+ *   - window_ms: measurement window (default: 1000 ms)
+ *   - log: print the report every period_ms (CPU over the last period), off to stop
+ */
+static int cmd_top(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "log") == 0) {
+        if (argc < 3) {
+            printf("Usage: top log <period_ms|off>\n");
+            return 1;
+        }
+        if (strcmp(argv[2], "off") == 0) {
+            s_top_log_period_ms = 0;
+            printf("Profiler log stopped\n");
+            return 0;
+        }
+        int period = atoi(argv[2]);
+        if (period < 100 || period > TOP_MAX_WINDOW_MS) {
+            printf("Period must be 100-%d ms\n", TOP_MAX_WINDOW_MS);
+            return 1;
+        }
+        s_top_log_period_ms = (uint32_t)period;
+        if (s_top_log_task == NULL &&
+            xTaskCreatePinnedToCore(top_log_task, "top_log", TOP_LOG_TASK_STACK_SIZE, NULL,
+                                    TOP_LOG_TASK_PRIORITY, &s_top_log_task, TOP_LOG_TASK_CORE) != pdPASS) {
+            s_top_log_period_ms = 0;
+            s_top_log_task = NULL;
+            printf("Failed to start profiler log\n");
+            return 1;
+        }
+        printf("Profiler log every %d ms ('top log off' to stop)\n", period);
+        return 0;
+    }
+
+    int window = (argc >= 2) ? atoi(argv[1]) : TOP_DEFAULT_WINDOW_MS;
+    if (window <= 0 || window > TOP_MAX_WINDOW_MS) {
+        printf("Usage: top [window_ms] | top log <period_ms|off>\n");
+        return 1;
+    }
+
+    top_snapshot_t prev;
+    top_snapshot_t cur;
+    if (!top_snapshot_take(&prev)) {
+        printf("Out of memory\n");
+        return 1;
+    }
+    vTaskDelay(pdMS_TO_TICKS(window));
+    if (!top_snapshot_take(&cur)) {
+        top_snapshot_free(&prev);
+        printf("Out of memory\n");
+        return 1;
+    }
+
+    printf("Task profile over %d ms:\n", window);
+    top_print(&prev, &cur);
+    top_snapshot_free(&prev);
+    top_snapshot_free(&cur);
+    return 0;
+}
+
 /**
  * @brief 'erase_sdcard' command - Recursively erase all files on SD card
  */
@@ -304,6 +518,12 @@ static void print_all_status(status_output_type_t output_type)
 #ifdef IO_STATS_ENABLE
     benchmark_print_status(output_type);
 #endif
+#ifdef LATENCY_STATS_ENABLE
+    latency_print_status(output_type);
+#endif
+#ifdef TRACE_ENABLE
+    trace_print_status(output_type);
+#endif
 }
 
 /**
@@ -339,6 +559,12 @@ static int cmd_status(int argc, char **argv)
         printf("  display  - OLED display\n");
         printf("  volume   - Persistent volume\n");
         printf("  player   - Audio player and cache\n");
+#ifdef LATENCY_STATS_ENABLE
+        printf("  latency  - Press-to-sound latency\n");
+#endif
+#ifdef TRACE_ENABLE
+        printf("  trace    - Event trace ring\n");
+#endif
         printf("  all      - Print all modules\n\n");
         printf("Output types:\n");
         printf("  compact  - Single-line summary\n");
@@ -375,6 +601,14 @@ static int cmd_status(int argc, char **argv)
 #ifdef IO_STATS_ENABLE
     } else if (strcmp(module, "benchmark") == 0) {
         benchmark_print_status(output_type);
+#endif
+#ifdef LATENCY_STATS_ENABLE
+    } else if (strcmp(module, "latency") == 0) {
+        latency_print_status(output_type);
+#endif
+#ifdef TRACE_ENABLE
+    } else if (strcmp(module, "trace") == 0) {
+        trace_print_status(output_type);
 #endif
     } else {
         printf("Unknown module: %s\n", module);
@@ -550,6 +784,194 @@ static int cmd_volume(int argc, char **argv)
     return 0;
 }
 
+/**
+ * @brief 'i2s_profile' command handler
+ *
+ * Usage: i2s_profile [auto|low_latency|balanced|robust]
+ * Without argument, shows the selected and active DMA profile.
+ */
+static int cmd_i2s_profile(int argc, char **argv)
+{
+    if (!s_app->player) {
+        printf("Player not available\n");
+        return 1;
+    }
+
+    if (argc >= 2) {
+        player_dma_profile_t profile = PLAYER_DMA_PROFILE_COUNT;
+        for (int p = 0; p < PLAYER_DMA_PROFILE_COUNT; p++) {
+            if (strcmp(argv[1], player_dma_profile_name((player_dma_profile_t)p)) == 0) {
+                profile = (player_dma_profile_t)p;
+                break;
+            }
+        }
+        if (profile == PLAYER_DMA_PROFILE_COUNT) {
+            printf("Usage: i2s_profile [auto|low_latency|balanced|robust]\n");
+            return 1;
+        }
+        esp_err_t ret = player_set_dma_profile(s_app->player, profile);
+        if (ret != ESP_OK) {
+            printf("Failed to set DMA profile: %s\n", esp_err_to_name(ret));
+            return 1;
+        }
+    }
+
+    player_dma_profile_t selected, active;
+    player_get_dma_profile(s_app->player, &selected, &active);
+    printf("I2S DMA profile: %s (active ring: %s)\n",
+           player_dma_profile_name(selected), player_dma_profile_name(active));
+    if (argc >= 2 && selected != active) {
+        printf("Applied when the next sound starts with no other voice playing\n");
+    }
+    return 0;
+}
+
+/**
+ * @brief 'mixer_bench' command handler (mixer kernel microbenchmark)
+ *
+ * Usage: mixer_bench [samples] [runs]
+ *   - samples: buffer size in samples (default: 480, one player chunk)
+ *   - runs: iterations per kernel (default: 200)
+ */
+static int cmd_mixer_bench(int argc, char **argv)
+{
+    int samples = (argc > 1) ? atoi(argv[1]) : 480;
+    int runs = (argc > 2) ? atoi(argv[2]) : 200;
+
+    if (samples <= 0 || runs <= 0) {
+        printf("Usage: mixer_bench [samples] [runs]\n");
+        return 1;
+    }
+
+    esp_err_t ret = mixer_run_benchmark((size_t)samples, runs);
+    if (ret != ESP_OK) {
+        printf("Mixer benchmark failed: %s\n", esp_err_to_name(ret));
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 'bench' command handler (scripted benchmark suite)
+ *
+ * Usage: bench [all|sd|memcpy|volume|wav|warmup|msc|stress]...
+ *   - No argument: all workloads
+ *   - Output: one "bench,<workload>,<case>,<value>,<unit>" line per result
+ */
+static int cmd_bench(int argc, char **argv)
+{
+    uint32_t workloads = (argc > 1) ? 0 : BENCH_SUITE_ALL;
+    for (int i = 1; i < argc; i++) {
+        uint32_t bits = bench_suite_parse_workload(argv[i]);
+        if (bits == 0) {
+            printf("Usage: bench [all|sd|memcpy|volume|wav|warmup|msc|stress]...\n");
+            return 1;
+        }
+        workloads |= bits;
+    }
+
+    const bench_suite_config_t config = {
+        .sdcard = s_app->sdcard,
+        .player = s_app->player,
+        .mapper = s_app->mapper,
+        .msc = s_app->msc,
+    };
+    esp_err_t ret = bench_suite_run(&config, workloads);
+    if (ret != ESP_OK) {
+        printf("Benchmark failed: %s\n", esp_err_to_name(ret));
+        return 1;
+    }
+
+    return 0;
+}
+
+#ifdef LATENCY_STATS_ENABLE
+/**
+ * @brief 'latency' command handler (press-to-sound latency histograms)
+ *
+ * Usage: latency [reset]
+ *   - No argument: per-stage p50/p95/p99/max, split by cache hit / miss
+ *   - reset: clear the histograms
+ */
+static int cmd_latency(int argc, char **argv)
+{
+    if (argc >= 2) {
+        if (strcmp(argv[1], "reset") != 0) {
+            printf("Usage: latency [reset]\n");
+            return 1;
+        }
+        latency_reset();
+        printf("Latency histograms cleared\n");
+        return 0;
+    }
+
+    latency_print_status(STATUS_OUTPUT_VERBOSE);
+    return 0;
+}
+#endif
+
+#ifdef TRACE_ENABLE
+#define TRACE_DEFAULT_PATH  SDCARD_MOUNT_POINT "/trace.csv"
+
+/**
+ * @brief 'trace' command handler (event trace ring)
+ *
+ * Usage: trace [on|off|clear|dump|save [path]]
+ *   - No argument: ring state
+ *   - dump: print the ring over UART, save: write it to a file (default: /sdcard/trace.csv)
+ *   - Convert with scripts/trace_to_json.py for Chrome / Perfetto
+ */
+static int cmd_trace(int argc, char **argv)
+{
+    if (argc < 2) {
+        trace_print_status(STATUS_OUTPUT_NORMAL);
+        return 0;
+    }
+
+    const char *action = argv[1];
+    if (strcmp(action, "on") == 0 || strcmp(action, "off") == 0) {
+        trace_set_enabled(action[1] == 'n');
+        trace_print_status(STATUS_OUTPUT_COMPACT);
+        return 0;
+    }
+    if (strcmp(action, "clear") == 0) {
+        trace_clear();
+        printf("Trace ring cleared\n");
+        return 0;
+    }
+    if (strcmp(action, "dump") == 0) {
+        esp_err_t ret = trace_dump(stdout);
+        if (ret != ESP_OK) {
+            printf("Trace dump failed: %s\n", esp_err_to_name(ret));
+            return 1;
+        }
+        return 0;
+    }
+    if (strcmp(action, "save") == 0) {
+        const char *path = (argc >= 3) ? argv[2] : TRACE_DEFAULT_PATH;
+        FILE *fp = fopen(path, "w");
+        if (fp == NULL) {
+            printf("Cannot create %s\n", path);
+            return 1;
+        }
+        esp_err_t ret = trace_dump(fp);
+        if (fclose(fp) != 0 && ret == ESP_OK) {
+            ret = ESP_FAIL;
+        }
+        if (ret != ESP_OK) {
+            printf("Trace save failed: %s\n", esp_err_to_name(ret));
+            return 1;
+        }
+        printf("Trace written to %s\n", path);
+        return 0;
+    }
+
+    printf("Usage: trace [on|off|clear|dump|save [path]]\n");
+    return 1;
+}
+#endif
+
 // =============================================================================
 // Command Registration
 // =============================================================================
@@ -631,6 +1053,58 @@ static void register_all_commands(void)
     };
     ESP_ERROR_CHECK(esp_console_cmd_register(&volume_cmd));
 
+    const esp_console_cmd_t i2s_profile_cmd = {
+        .command = "i2s_profile",
+        .help = "Query or select the I2S DMA profile (applied when a sound starts alone)",
+        .hint = "[auto|low_latency|balanced|robust]",
+        .func = &cmd_i2s_profile,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&i2s_profile_cmd));
+
+    const esp_console_cmd_t mixer_bench_cmd = {
+        .command = "mixer_bench",
+        .help = "Benchmark mixer kernels (cycles/sample, SIMD vs scalar)",
+        .hint = "[samples] [runs]",
+        .func = &cmd_mixer_bench,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&mixer_bench_cmd));
+
+    const esp_console_cmd_t bench_cmd = {
+        .command = "bench",
+        .help = "Run scripted benchmarks (CSV: bench,<workload>,<case>,<value>,<unit>)",
+        .hint = "[all|sd|memcpy|volume|wav|warmup|msc|stress]...",
+        .func = &cmd_bench,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&bench_cmd));
+
+    const esp_console_cmd_t top_cmd = {
+        .command = "top",
+        .help = "Per-task CPU (sliding window), stack high-water marks and heap watermarks",
+        .hint = "[window_ms] | log <period_ms|off>",
+        .func = &cmd_top,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&top_cmd));
+
+#ifdef LATENCY_STATS_ENABLE
+    const esp_console_cmd_t latency_cmd = {
+        .command = "latency",
+        .help = "Press-to-sound latency per stage (p50/p95/p99/max, cache hit vs miss)",
+        .hint = "[reset]",
+        .func = &cmd_latency,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&latency_cmd));
+#endif
+
+#ifdef TRACE_ENABLE
+    const esp_console_cmd_t trace_cmd = {
+        .command = "trace",
+        .help = "Event trace ring: state, pause/resume, clear, dump over UART or save to file",
+        .hint = "[on|off|clear|dump|save [path]]",
+        .func = &cmd_trace,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&trace_cmd));
+#endif
+
 }
 
 // =============================================================================
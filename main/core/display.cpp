@@ -5,9 +5,11 @@
  */
 
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"  // IWYU pragma: keep
 #include "lcdgfx.h"             // IWYU pragma: keep
 #include <inttypes.h>
+#include <new>
 #include <stdint.h>
 #include <string.h>
 
@@ -21,7 +23,7 @@ static const char *TAG = "display";
 #define DISPLAY_MSG_LEN       64
 
 // Display task parameters
-#define DISPLAY_QUEUE_DEPTH     10
+#define DISPLAY_QUEUE_DEPTH     10    // Layout messages (value updates go to the mailbox)
 #define DISPLAY_TASK_STACK_SIZE 3072
 #define DISPLAY_TASK_PRIORITY   1     // tskIDLE_PRIORITY + 1
 #define DISPLAY_TASK_CORE       0     // PRO_CPU — low priority UI
@@ -32,6 +34,8 @@ static const char *TAG = "display";
 } while (0)
 
 // Display update message types
+// Value updates (playing, volume, page, MSC progress) are posted to a
+// latest-value mailbox with one pending bit per type, the others are queued.
 // NOTE: ordering matters — display_task() dispatches using >= DISPLAY_MSG_MSC_ANALYSIS
 // to split player-mode vs MSC-mode messages. Keep MSC types grouped at the end.
 typedef enum : uint8_t {
@@ -52,6 +56,7 @@ typedef enum : uint8_t {
 // Display update message
 typedef struct {
     display_msg_type_t type;
+    uint32_t seq;               // Post order, shared with the mailbox values (set by post_msg())
     union {
         struct {
             char filename[DISPLAY_FILENAME_LEN];  // Empty string means stop
@@ -103,17 +108,178 @@ typedef enum : uint8_t {
 
 // display width used for progress bars
 #define DISPLAY_WIDTH 128  // pixels
+#define DISPLAY_HEIGHT 64  // pixels
+#define DISPLAY_PAGES (DISPLAY_HEIGHT / 8)  // SSD1306 pages: 8 pixel rows, one byte per column
+
+#define STATS_WINDOW_US 1000000  // I2C busy time window (peak ms/s)
+
+/**
+ * @brief In-RAM copy of the SSD1306 display memory
+ *
+ * Layouts draw here with the subset of the lcdgfx drawing API they use;
+ * flush() then sends only the columns whose bytes changed, one span per
+ * page, so a redraw of unchanged content costs no I2C traffic.
+ *
+ * Text uses the lcdgfx fixed fonts (header: type, width, height, first
+ * char; glyphs page by page) and must start on a page boundary (y % 8 == 0).
+ */
+class OledFramebuffer {
+public:
+    void clear()
+    {
+        for (int page = 0; page < DISPLAY_PAGES; page++) {
+            for (int x = 0; x < DISPLAY_WIDTH; x++) {
+                write(page, x, 0x00);
+            }
+        }
+    }
+
+    void setColor(uint8_t color) { m_color = color; }
+    void setBackground(uint8_t color) { m_background = color; }
+    void setFixedFont(const uint8_t *font) { m_font = font; }
+
+    void fillRect(int x0, int y0, int x1, int y1)
+    {
+        x0 = clamp(x0, DISPLAY_WIDTH);
+        x1 = clamp(x1, DISPLAY_WIDTH);
+        y0 = clamp(y0, DISPLAY_HEIGHT);
+        y1 = clamp(y1, DISPLAY_HEIGHT);
+        for (int page = y0 / 8; page <= y1 / 8; page++) {
+            int top = (page == y0 / 8) ? (y0 % 8) : 0;
+            int bottom = (page == y1 / 8) ? (y1 % 8) : 7;
+            uint8_t mask = (uint8_t)((0xFF << top) & (0xFF >> (7 - bottom)));
+            for (int x = x0; x <= x1; x++) {
+                uint8_t old = m_pixels[page][x];
+                write(page, x, m_color ? (old | mask) : (old & ~mask));
+            }
+        }
+    }
+
+    void drawRect(int x0, int y0, int x1, int y1)
+    {
+        fillRect(x0, y0, x1, y0);
+        fillRect(x0, y1, x1, y1);
+        fillRect(x0, y0, x0, y1);
+        fillRect(x1, y0, x1, y1);
+    }
+
+    void printFixed(int x, int y, const char *text)
+    {
+        if (m_font == NULL || text == NULL) {
+            return;
+        }
+        const int width = m_font[1];
+        const int pages = (m_font[2] + 7) / 8;
+        const uint8_t first = m_font[3];
+        const uint8_t *glyphs = m_font + 4;
+        const uint8_t invert = m_background ? 0xFF : 0x00;
+
+        for (; *text != '\0' && x < DISPLAY_WIDTH; text++, x += width) {
+            uint8_t c = (uint8_t)*text;
+            if (c < first || c > 0x7F) {
+                c = '?';
+            }
+            const uint8_t *glyph = glyphs + (size_t)(c - first) * width * pages;
+            for (int p = 0; p < pages && y / 8 + p < DISPLAY_PAGES; p++) {
+                for (int col = 0; col < width && x + col < DISPLAY_WIDTH; col++) {
+                    write(y / 8 + p, x + col, glyph[p * width + col] ^ invert);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Send the dirty spans to the display (blocking I2C)
+     *
+     * @return Bytes sent (0 if nothing changed)
+     */
+    size_t flush(DisplaySSD1306_128x64_I2C *display)
+    {
+        size_t bytes = 0;
+        for (int page = 0; page < DISPLAY_PAGES; page++) {
+            if (m_dirty_x0[page] > m_dirty_x1[page]) {
+                continue;
+            }
+            int w = m_dirty_x1[page] - m_dirty_x0[page] + 1;
+            display->drawBuffer1Fast(m_dirty_x0[page], page * 8, w, 8, &m_pixels[page][m_dirty_x0[page]]);
+            bytes += w;
+            m_dirty_x0[page] = DISPLAY_WIDTH - 1;
+            m_dirty_x1[page] = 0;
+        }
+        return bytes;
+    }
+
+private:
+    static int clamp(int v, int size) { return v < 0 ? 0 : (v >= size ? size - 1 : v); }
+
+    void write(int page, int x, uint8_t value)
+    {
+        if (m_pixels[page][x] == value) {
+            return;
+        }
+        m_pixels[page][x] = value;
+        if (x < m_dirty_x0[page]) {
+            m_dirty_x0[page] = x;
+        }
+        if (x > m_dirty_x1[page]) {
+            m_dirty_x1[page] = x;
+        }
+    }
+
+    uint8_t m_pixels[DISPLAY_PAGES][DISPLAY_WIDTH] = {};
+    uint8_t m_dirty_x0[DISPLAY_PAGES] = {};         // Dirty column span per page (x0 > x1: clean)
+    uint8_t m_dirty_x1[DISPLAY_PAGES] = {};
+    const uint8_t *m_font = NULL;
+    uint8_t m_color = 0xFF;
+    uint8_t m_background = 0x00;
+};
+
+#define MAILBOX_BIT(type) (1u << (type))
+
+/**
+ * @brief Latest-value mailbox for the frequent updates
+ *
+ * A post overwrites the previous value; the display task only renders the
+ * last one. Posting over a value not rendered yet counts as coalesced.
+ * Each value keeps the sequence number of its post, so that it is rendered
+ * before the queued layout messages posted after it.
+ */
+typedef struct {
+    portMUX_TYPE lock;
+    uint32_t pending;                           // MAILBOX_BIT(display_msg_type_t)
+    uint32_t seq[DISPLAY_MSG_MSC_CONFIRM + 1];  // Post order of each pending value
+    char filename[DISPLAY_FILENAME_LEN];        // DISPLAY_MSG_PLAYING (empty: stopped)
+    uint16_t progress;
+    int volume_index;                           // DISPLAY_MSG_VOLUME
+    char page_id[DISPLAY_PAGE_ID_LEN];          // DISPLAY_MSG_PAGE_CHANGED
+    char msc_filename[DISPLAY_FILENAME_LEN];    // DISPLAY_MSG_MSC_PROGRESS
+    uint16_t msc_progress;
+} display_mailbox_t;
 
 /**
  * @brief Display module state
  */
 struct display_state_s {
-    DisplaySSD1306_128x64_I2C *display;        // lcdgfx display object
+    DisplaySSD1306_128x64_I2C *display;        // lcdgfx display object (I2C transfers only)
+    OledFramebuffer fb;                        // Layouts draw here, flushed after each batch
     display_config_t config;                   // Display configuration
 
     // Async task infrastructure
-    QueueHandle_t msg_queue;                   // Message queue for display updates
-    TaskHandle_t task_handle;                  // Display task handle
+    QueueHandle_t msg_queue;                   // Message queue for layout changes
+    display_mailbox_t mailbox;                 // Latest values (playing, volume, page, MSC progress)
+    TaskHandle_t task_handle;                  // Display task handle, notified on every post
+    uint32_t post_seq;                         // Post order counter, queue and mailbox (atomic)
+
+    // Statistics (written by the display task, except the post counters)
+    uint32_t flushes;                          // Flushes that sent data
+    uint64_t flush_bytes;                      // Framebuffer bytes sent
+    int64_t i2c_busy_us;                       // Time spent in I2C transfers since init
+    int64_t stats_start_us;
+    int64_t window_start_us;                   // Current 1 s window
+    int64_t window_busy_us;
+    uint32_t peak_busy_ms;                     // Busiest 1 s window (ms of I2C per second)
+    uint32_t coalesced;                        // Mailbox values replaced before being rendered
+    uint32_t dropped;                          // Layout messages dropped (queue full)
 
     // Current layout
     display_layout_t current_layout;           // Which layout is currently displayed
@@ -154,14 +320,14 @@ static void draw_progress_bar_fill(display_handle_t oled, int y, uint16_t progre
 {
     uint16_t fill_width = progress_to_pixels(DISPLAY_WIDTH - 4, progress);
     if (fill_width > 0) {
-        oled->display->setColor(0xFF);
-        oled->display->fillRect(2, y + 2, 2 + fill_width - 1, y + 5);
+        oled->fb.setColor(0xFF);
+        oled->fb.fillRect(2, y + 2, 2 + fill_width - 1, y + 5);
     }
     if (fill_width < DISPLAY_WIDTH - 4) {
-        oled->display->setColor(0x00);
-        oled->display->fillRect(2 + fill_width, y + 2, 125, y + 5);
+        oled->fb.setColor(0x00);
+        oled->fb.fillRect(2 + fill_width, y + 2, 125, y + 5);
     }
-    oled->display->setColor(0xFF);
+    oled->fb.setColor(0xFF);
 }
 
 /**
@@ -210,9 +376,9 @@ static void layout_startup(display_handle_t oled)
 {
     if (oled == NULL) return;
 
-    oled->display->clear();
-    oled->display->setFixedFont(ssd1306xled_font8x16);
-    oled->display->printFixed(0, 8, "Starting...", STYLE_NORMAL);
+    oled->fb.clear();
+    oled->fb.setFixedFont(ssd1306xled_font8x16);
+    oled->fb.printFixed(0, 8, "Starting...");
 
     oled->current_layout = LAYOUT_STARTUP;
     ESP_LOGD(TAG, "Layout: startup");
@@ -240,37 +406,37 @@ static void layout_idle(display_handle_t oled, const char *page, int volume_inde
     bool volume_changed = (oled->volume_index != volume_index);
 
     if (full_refresh) {
-        oled->display->clear();
+        oled->fb.clear();
 
         // Line 1: Page (large font)
-        oled->display->setFixedFont(ssd1306xled_font8x16);
-        oled->display->printFixed(0, 0, page, STYLE_NORMAL);
+        oled->fb.setFixedFont(ssd1306xled_font8x16);
+        oled->fb.printFixed(0, 0, page);
 
         // Line 2: Volume (large font)
         char vol_str[20];
         snprintf(vol_str, sizeof(vol_str), "Volume %d", volume_index);
-        oled->display->printFixed(0, 24, vol_str, STYLE_NORMAL);
+        oled->fb.printFixed(0, 24, vol_str);
     } else {
         // Selective refresh: only areas where values changed
 
         // Page name (y=0-15, 8x16 font)
         if (page_changed) {
-            oled->display->setColor(0x00);
-            oled->display->fillRect(0, 0, 127, 15);
-            oled->display->setColor(0xFF);
-            oled->display->setFixedFont(ssd1306xled_font8x16);
-            oled->display->printFixed(0, 0, page, STYLE_NORMAL);
+            oled->fb.setColor(0x00);
+            oled->fb.fillRect(0, 0, 127, 15);
+            oled->fb.setColor(0xFF);
+            oled->fb.setFixedFont(ssd1306xled_font8x16);
+            oled->fb.printFixed(0, 0, page);
         }
 
         // Volume (y=24-39, 8x16 font)
         if (volume_changed) {
-            oled->display->setColor(0x00);
-            oled->display->fillRect(0, 24, 127, 39);
-            oled->display->setColor(0xFF);
-            oled->display->setFixedFont(ssd1306xled_font8x16);
+            oled->fb.setColor(0x00);
+            oled->fb.fillRect(0, 24, 127, 39);
+            oled->fb.setColor(0xFF);
+            oled->fb.setFixedFont(ssd1306xled_font8x16);
             char vol_str[20];
             snprintf(vol_str, sizeof(vol_str), "Volume %d", volume_index);
-            oled->display->printFixed(0, 24, vol_str, STYLE_NORMAL);
+            oled->fb.printFixed(0, 24, vol_str);
         }
     }
 
@@ -295,27 +461,27 @@ static void layout_page_select(display_handle_t oled, const char *page, bool for
     bool page_changed = (strcmp(page, oled->current_page) != 0);
 
     if (full_refresh) {
-        oled->display->clear();
+        oled->fb.clear();
 
         // Line 1: "Page Select" in inverse video (white bg, black text)
         // lcdgfx 1-bit text rendering XORs font data with m_bgColor,
         // so setBackground(0xFF) inverts text pixels to black-on-white
-        oled->display->setFixedFont(ssd1306xled_font8x16);
-        oled->display->setColor(0xFF);
-        oled->display->fillRect(0, 0, 127, 15);
-        oled->display->setBackground(0xFF);
-        oled->display->printFixed(0, 0, "Page Select", STYLE_NORMAL);
-        oled->display->setBackground(0x00);
+        oled->fb.setFixedFont(ssd1306xled_font8x16);
+        oled->fb.setColor(0xFF);
+        oled->fb.fillRect(0, 0, 127, 15);
+        oled->fb.setBackground(0xFF);
+        oled->fb.printFixed(0, 0, "Page Select");
+        oled->fb.setBackground(0x00);
 
         // Line 2: current page name (large font)
-        oled->display->printFixed(0, 24, page, STYLE_NORMAL);
+        oled->fb.printFixed(0, 24, page);
     } else if (page_changed) {
         // Selective refresh: only the page name area (y=24-39)
-        oled->display->setColor(0x00);
-        oled->display->fillRect(0, 24, 127, 39);
-        oled->display->setColor(0xFF);
-        oled->display->setFixedFont(ssd1306xled_font8x16);
-        oled->display->printFixed(0, 24, page, STYLE_NORMAL);
+        oled->fb.setColor(0x00);
+        oled->fb.fillRect(0, 24, 127, 39);
+        oled->fb.setColor(0xFF);
+        oled->fb.setFixedFont(ssd1306xled_font8x16);
+        oled->fb.printFixed(0, 24, page);
     }
 
     UPDATE_OLED(oled->current_page, page);
@@ -345,21 +511,21 @@ static void layout_playing(display_handle_t oled, const char *filename, uint16_t
     bool progress_changed = (cur_bar != new_bar);
 
     if (full_refresh) {
-        oled->display->clear();
+        oled->fb.clear();
 
         // Line 1: "Playing" (large font, y=0-15)
-        oled->display->setFixedFont(ssd1306xled_font8x16);
-        oled->display->printFixed(0, 0, "Playing", STYLE_NORMAL);
+        oled->fb.setFixedFont(ssd1306xled_font8x16);
+        oled->fb.printFixed(0, 0, "Playing");
 
         // Progress bar frame (y=16-23)
-        oled->display->drawRect(0, 16, 127, 23);
+        oled->fb.drawRect(0, 16, 127, 23);
 
         // Filename (small font, y=32 onwards)
-        oled->display->setFixedFont(ssd1306xled_font6x8);
+        oled->fb.setFixedFont(ssd1306xled_font6x8);
         size_t name_len = strlen(short_name);
         const size_t max_chars_per_line = 21;
         if (name_len <= max_chars_per_line) {
-            oled->display->printFixed(0, 32, short_name, STYLE_NORMAL);
+            oled->fb.printFixed(0, 32, short_name);
         } else {
             char line1[24];
             char line2[24];
@@ -367,8 +533,8 @@ static void layout_playing(display_handle_t oled, const char *filename, uint16_t
             line1[max_chars_per_line] = '\0';
             strncpy(line2, short_name + max_chars_per_line, max_chars_per_line);
             line2[max_chars_per_line] = '\0';
-            oled->display->printFixed(0, 32, line1, STYLE_NORMAL);
-            oled->display->printFixed(0, 40, line2, STYLE_NORMAL);
+            oled->fb.printFixed(0, 32, line1);
+            oled->fb.printFixed(0, 40, line2);
         }
 
         // Force progress bar fill on first draw
@@ -400,17 +566,17 @@ static void layout_msc_analysis(display_handle_t oled, const char *status_msg, b
     bool msg_changed = (strcmp(status_msg, oled->msc_status_msg) != 0);
 
     if (full_refresh) {
-        oled->display->clear();
-        oled->display->setFixedFont(ssd1306xled_font8x16);
-        oled->display->printFixed(0, 0, "Checking data", STYLE_NORMAL);
-        oled->display->setFixedFont(ssd1306xled_font6x8);
-        oled->display->printFixed(0, 24, status_msg, STYLE_NORMAL);
+        oled->fb.clear();
+        oled->fb.setFixedFont(ssd1306xled_font8x16);
+        oled->fb.printFixed(0, 0, "Checking data");
+        oled->fb.setFixedFont(ssd1306xled_font6x8);
+        oled->fb.printFixed(0, 24, status_msg);
     } else if (msg_changed) {
-        oled->display->setColor(0x00);
-        oled->display->fillRect(0, 24, 127, 31);
-        oled->display->setColor(0xFF);
-        oled->display->setFixedFont(ssd1306xled_font6x8);
-        oled->display->printFixed(0, 24, status_msg, STYLE_NORMAL);
+        oled->fb.setColor(0x00);
+        oled->fb.fillRect(0, 24, 127, 31);
+        oled->fb.setColor(0xFF);
+        oled->fb.setFixedFont(ssd1306xled_font6x8);
+        oled->fb.printFixed(0, 24, status_msg);
     }
 
     UPDATE_OLED(oled->msc_status_msg, status_msg);
@@ -449,12 +615,12 @@ static void layout_msc_progress(display_handle_t oled, const char *filename, uin
     extract_filename(oled->full_filename, short_name, sizeof(short_name));
 
     if (full_refresh) {
-        oled->display->clear();
-        oled->display->setFixedFont(ssd1306xled_font8x16);
-        oled->display->printFixed(0, 0, "Updating...", STYLE_NORMAL);
+        oled->fb.clear();
+        oled->fb.setFixedFont(ssd1306xled_font8x16);
+        oled->fb.printFixed(0, 0, "Updating...");
 
         // Draw progress bar frame (static)
-        oled->display->drawRect(0, 24, 127, 31);
+        oled->fb.drawRect(0, 24, 127, 31);
 
         // Force both dynamic areas on first draw
         progress_changed = true;
@@ -468,12 +634,12 @@ static void layout_msc_progress(display_handle_t oled, const char *filename, uin
 
     // Selective refresh: filename
     if (filename_changed) {
-        oled->display->setColor(0x00);
-        oled->display->fillRect(0, 48, 127, 63);
-        oled->display->setColor(0xFF);
+        oled->fb.setColor(0x00);
+        oled->fb.fillRect(0, 48, 127, 63);
+        oled->fb.setColor(0xFF);
 
-        oled->display->setFixedFont(ssd1306xled_font6x8);
-        oled->display->printFixed(0, 48, short_name, STYLE_NORMAL);
+        oled->fb.setFixedFont(ssd1306xled_font6x8);
+        oled->fb.printFixed(0, 48, short_name);
     }
 
     oled->current_layout = LAYOUT_MSC_PROGRESS;
@@ -506,42 +672,42 @@ static void layout_msc_menu(display_handle_t oled, int selected, bool force)
     bool selection_changed = (oled->msc_menu_selected != selected);
 
     if (full_refresh) {
-        oled->display->clear();
+        oled->fb.clear();
 
         // Title
-        oled->display->setFixedFont(ssd1306xled_font8x16);
-        oled->display->printFixed(0, 0, "USB Update", STYLE_NORMAL);
+        oled->fb.setFixedFont(ssd1306xled_font8x16);
+        oled->fb.printFixed(0, 0, "USB Update");
 
         // Menu items (6x8 font, 8px spacing, starting below 8x16 title)
-        oled->display->setFixedFont(ssd1306xled_font6x8);
+        oled->fb.setFixedFont(ssd1306xled_font6x8);
         for (int i = 0; i < menu_count; i++) {
             char line[24];
             snprintf(line, sizeof(line), "%c %s",
                      (i == selected) ? '>' : ' ',
                      menu_items[i]);
-            oled->display->printFixed(0, 24 + (i * 8), line, STYLE_NORMAL);
+            oled->fb.printFixed(0, 24 + (i * 8), line);
         }
     } else if (selection_changed) {
         // Selective refresh: only redraw the two affected menu items
-        oled->display->setFixedFont(ssd1306xled_font6x8);
+        oled->fb.setFixedFont(ssd1306xled_font6x8);
 
         // Clear and redraw old selected item (remove '>')
         int old_y = 24 + (oled->msc_menu_selected * 8);
-        oled->display->setColor(0x00);
-        oled->display->fillRect(0, old_y, 127, old_y + 7);
-        oled->display->setColor(0xFF);
+        oled->fb.setColor(0x00);
+        oled->fb.fillRect(0, old_y, 127, old_y + 7);
+        oled->fb.setColor(0xFF);
         char line_old[24];
         snprintf(line_old, sizeof(line_old), "  %s", menu_items[oled->msc_menu_selected]);
-        oled->display->printFixed(0, old_y, line_old, STYLE_NORMAL);
+        oled->fb.printFixed(0, old_y, line_old);
 
         // Clear and redraw new selected item (add '>')
         int new_y = 24 + (selected * 8);
-        oled->display->setColor(0x00);
-        oled->display->fillRect(0, new_y, 127, new_y + 7);
-        oled->display->setColor(0xFF);
+        oled->fb.setColor(0x00);
+        oled->fb.fillRect(0, new_y, 127, new_y + 7);
+        oled->fb.setColor(0xFF);
         char line_new[24];
         snprintf(line_new, sizeof(line_new), "> %s", menu_items[selected]);
-        oled->display->printFixed(0, new_y, line_new, STYLE_NORMAL);
+        oled->fb.printFixed(0, new_y, line_new);
     }
 
     oled->msc_menu_selected = selected;
@@ -563,19 +729,19 @@ static void layout_msc_confirm(display_handle_t oled, const char *action,
 {
     if (oled == NULL) return;
 
-    oled->display->clear();
+    oled->fb.clear();
 
-    oled->display->setFixedFont(ssd1306xled_font8x16);
-    oled->display->printFixed(0, 0, action, STYLE_NORMAL);
+    oled->fb.setFixedFont(ssd1306xled_font8x16);
+    oled->fb.printFixed(0, 0, action);
 
-    oled->display->setFixedFont(ssd1306xled_font6x8);
-    oled->display->printFixed(0, 24, line1, STYLE_NORMAL);
+    oled->fb.setFixedFont(ssd1306xled_font6x8);
+    oled->fb.printFixed(0, 24, line1);
     if (line2 != NULL && line2[0] != '\0') {
-        oled->display->printFixed(0, 32, line2, STYLE_NORMAL);
+        oled->fb.printFixed(0, 32, line2);
     }
 
-    oled->display->printFixed(0, 48, "Red btn: YES", STYLE_NORMAL);
-    oled->display->printFixed(0, 56, "Other:   CANCEL", STYLE_NORMAL);
+    oled->fb.printFixed(0, 48, "Red btn: YES");
+    oled->fb.printFixed(0, 56, "Other:   CANCEL");
 
     UPDATE_OLED(oled->confirm_action, action);
     UPDATE_OLED(oled->confirm_line1, line1);
@@ -593,10 +759,10 @@ static void layout_reboot(display_handle_t oled)
 {
     if (oled == NULL) return;
 
-    oled->display->clear();
-    oled->display->setFixedFont(ssd1306xled_font8x16);
+    oled->fb.clear();
+    oled->fb.setFixedFont(ssd1306xled_font8x16);
     // Centered horizontally: (128 - 12*8) / 2 = 16
-    oled->display->printFixed(16, 24, "Rebooting...", STYLE_NORMAL);
+    oled->fb.printFixed(16, 24, "Rebooting...");
 
     oled->current_layout = LAYOUT_REBOOT;
     ESP_LOGD(TAG, "Layout: reboot");
@@ -612,11 +778,11 @@ static void layout_error(display_handle_t oled, const char *message)
 {
     if (oled == NULL) return;
 
-    oled->display->clear();
-    oled->display->setFixedFont(ssd1306xled_font8x16);
-    oled->display->printFixed(0, 0, "Error", STYLE_NORMAL);
-    oled->display->setFixedFont(ssd1306xled_font6x8);
-    oled->display->printFixed(0, 24, message, STYLE_NORMAL);
+    oled->fb.clear();
+    oled->fb.setFixedFont(ssd1306xled_font8x16);
+    oled->fb.printFixed(0, 0, "Error");
+    oled->fb.setFixedFont(ssd1306xled_font6x8);
+    oled->fb.printFixed(0, 24, message);
 
     UPDATE_OLED(oled->error_message, message);
     oled->current_layout = LAYOUT_ERROR;
@@ -645,6 +811,10 @@ static void handle_player_mode_msg(display_handle_t oled, const display_msg_t *m
                     layout_playing(oled, msg->data.playback.filename,
                                    msg->data.playback.progress, false);
                 }
+            } else if (!is_stop) {
+                // Shown when leaving page select (the start may have been coalesced)
+                UPDATE_OLED(oled->full_filename, msg->data.playback.filename);
+                oled->player_progress = msg->data.playback.progress;
             }
             break;
         }
@@ -724,10 +894,98 @@ static void handle_msc_mode_msg(display_handle_t oled, const display_msg_t *msg)
     }
 }
 
+static void dispatch_msg(display_handle_t oled, const display_msg_t *msg)
+{
+    if (msg->type >= DISPLAY_MSG_MSC_ANALYSIS) {
+        handle_msc_mode_msg(oled, msg);
+    } else {
+        handle_player_mode_msg(oled, msg);
+    }
+}
+
 /**
- * @brief Display task - processes update messages from queue
+ * @brief Render the pending mailbox values (latest of each type) posted before a sequence number
  *
- * Low priority task that blocks on message queue and updates display asynchronously
+ * @param before Values posted at or after this one stay pending
+ */
+static void apply_mailbox(display_handle_t oled, uint32_t before)
+{
+    static const display_msg_type_t order[] = {
+        DISPLAY_MSG_PAGE_CHANGED, DISPLAY_MSG_VOLUME, DISPLAY_MSG_PLAYING, DISPLAY_MSG_MSC_PROGRESS,
+    };
+    display_mailbox_t *mb = &oled->mailbox;
+    display_msg_t msg;
+
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        memset(&msg, 0, sizeof(msg));
+        msg.type = order[i];
+
+        taskENTER_CRITICAL(&mb->lock);
+        bool pending = (mb->pending & MAILBOX_BIT(order[i])) != 0 &&
+                       (int32_t)(mb->seq[order[i]] - before) < 0;
+        if (pending) {
+            mb->pending &= ~MAILBOX_BIT(order[i]);
+        }
+        if (pending) {
+            switch (order[i]) {
+                case DISPLAY_MSG_PAGE_CHANGED:
+                    UPDATE_OLED(msg.data.page.page_id, mb->page_id);
+                    break;
+                case DISPLAY_MSG_VOLUME:
+                    msg.data.volume.volume_index = mb->volume_index;
+                    break;
+                case DISPLAY_MSG_PLAYING:
+                    UPDATE_OLED(msg.data.playback.filename, mb->filename);
+                    msg.data.playback.progress = mb->progress;
+                    break;
+                default:
+                    UPDATE_OLED(msg.data.msc_progress.filename, mb->msc_filename);
+                    msg.data.msc_progress.progress = mb->msc_progress;
+                    break;
+            }
+        }
+        taskEXIT_CRITICAL(&mb->lock);
+
+        if (pending) {
+            dispatch_msg(oled, &msg);
+        }
+    }
+}
+
+/**
+ * @brief Send the framebuffer changes and account the I2C time
+ */
+static void flush_framebuffer(display_handle_t oled)
+{
+    int64_t t0 = esp_timer_get_time();
+    size_t bytes = oled->fb.flush(oled->display);
+    if (bytes == 0) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+
+    oled->flushes++;
+    oled->flush_bytes += bytes;
+    oled->i2c_busy_us += now - t0;
+    oled->window_busy_us += now - t0;
+    int64_t window_us = now - oled->window_start_us;
+    if (window_us >= STATS_WINDOW_US) {
+        uint32_t busy_ms = (uint32_t)(oled->window_busy_us * 1000 / window_us);
+        if (busy_ms > oled->peak_busy_ms) {
+            oled->peak_busy_ms = busy_ms;
+        }
+        oled->window_start_us = now;
+        oled->window_busy_us = 0;
+    }
+}
+
+/**
+ * @brief Display task - renders queued layout changes and mailbox values
+ *
+ * Low priority task woken by a notification on every post. Each wake-up
+ * drains the queue in order, rendering the mailbox values posted before
+ * each message ahead of it (a layout message replaces what they draw),
+ * then the remaining values on top, and flushes the framebuffer once.
  */
 static void display_task(void *arg)
 {
@@ -737,14 +995,40 @@ static void display_task(void *arg)
     ESP_LOGI(TAG, "Display task started");
 
     while (1) {
-        if (xQueueReceive(oled->msg_queue, &msg, portMAX_DELAY) == pdTRUE) {
-            if (msg.type >= DISPLAY_MSG_MSC_ANALYSIS) {
-                handle_msc_mode_msg(oled, &msg);
-            } else {
-                handle_player_mode_msg(oled, &msg);
-            }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (xQueueReceive(oled->msg_queue, &msg, 0) == pdTRUE) {
+            apply_mailbox(oled, msg.seq);
+            dispatch_msg(oled, &msg);
         }
+        apply_mailbox(oled, __atomic_load_n(&oled->post_seq, __ATOMIC_RELAXED) + 1);
+        flush_framebuffer(oled);
+    }
+}
+
+/**
+ * @brief Queue a layout message and wake the display task
+ */
+static void post_msg(display_handle_t oled, display_msg_t *msg, const char *what)
+{
+    msg->seq = __atomic_add_fetch(&oled->post_seq, 1, __ATOMIC_RELAXED);
+    if (xQueueSend(oled->msg_queue, msg, 0) != pdTRUE) {
+        __atomic_fetch_add(&oled->dropped, 1, __ATOMIC_RELAXED);
+        ESP_LOGW(TAG, "Display queue full, dropped %s", what);
+        return;
+    }
+    xTaskNotifyGive(oled->task_handle);
+}
+
+/**
+ * @brief Mark a mailbox value pending (mailbox lock held)
+ */
+static inline void mailbox_mark(display_handle_t oled, display_msg_type_t type)
+{
+    if (oled->mailbox.pending & MAILBOX_BIT(type)) {
+        oled->coalesced++;
     }
+    oled->mailbox.pending |= MAILBOX_BIT(type);
+    oled->mailbox.seq[type] = __atomic_add_fetch(&oled->post_seq, 1, __ATOMIC_RELAXED);
 }
 
 //
@@ -762,9 +1046,7 @@ extern "C" void display_show_idle(display_handle_t oled)
         .data = {}
     };
 
-    if (xQueueSend(oled->msg_queue, &msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Display queue full, dropped UAC idle message");
-    }
+    post_msg(oled, &msg, "UAC idle message");
 }
 
 extern "C" void display_on_volume_changed(display_handle_t oled, int volume_index)
@@ -773,18 +1055,11 @@ extern "C" void display_on_volume_changed(display_handle_t oled, int volume_inde
         return;
     }
 
-    display_msg_t msg = {
-        .type = DISPLAY_MSG_VOLUME,
-        .data = {
-            .volume = {
-                .volume_index = volume_index
-            }
-        }
-    };
-
-    if (xQueueSend(oled->msg_queue, &msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Display queue full, dropped volume update");
-    }
+    taskENTER_CRITICAL(&oled->mailbox.lock);
+    oled->mailbox.volume_index = volume_index;
+    mailbox_mark(oled, DISPLAY_MSG_VOLUME);
+    taskEXIT_CRITICAL(&oled->mailbox.lock);
+    xTaskNotifyGive(oled->task_handle);
 }
 
 extern "C" void display_on_playing(display_handle_t oled, const char *filename, uint16_t progress)
@@ -793,25 +1068,12 @@ extern "C" void display_on_playing(display_handle_t oled, const char *filename,
         return;
     }
 
-    display_msg_t msg = {
-        .type = DISPLAY_MSG_PLAYING,
-        .data = {
-            .playback = {
-                .filename = {0},
-                .progress = progress
-            }
-        }
-    };
-
-    if (filename != NULL) {
-        strncpy(msg.data.playback.filename, filename,
-                sizeof(msg.data.playback.filename) - 1);
-        msg.data.playback.filename[sizeof(msg.data.playback.filename) - 1] = '\0';
-    }
-
-    if (xQueueSend(oled->msg_queue, &msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Display queue full, dropped playback update");
-    }
+    taskENTER_CRITICAL(&oled->mailbox.lock);
+    UPDATE_OLED(oled->mailbox.filename, filename != NULL ? filename : "");
+    oled->mailbox.progress = progress;
+    mailbox_mark(oled, DISPLAY_MSG_PLAYING);
+    taskEXIT_CRITICAL(&oled->mailbox.lock);
+    xTaskNotifyGive(oled->task_handle);
 }
 
 extern "C" void display_on_page_changed(display_handle_t oled, const char *page_id)
@@ -820,24 +1082,11 @@ extern "C" void display_on_page_changed(display_handle_t oled, const char *page_
         return;
     }
 
-    display_msg_t msg = {
-        .type = DISPLAY_MSG_PAGE_CHANGED,
-        .data = {
-            .page = {
-                .page_id = {0}
-            }
-        }
-    };
-
-    if (page_id != NULL) {
-        strncpy(msg.data.page.page_id, page_id,
-                sizeof(msg.data.page.page_id) - 1);
-        msg.data.page.page_id[sizeof(msg.data.page.page_id) - 1] = '\0';
-    }
-
-    if (xQueueSend(oled->msg_queue, &msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Display queue full, dropped page change update");
-    }
+    taskENTER_CRITICAL(&oled->mailbox.lock);
+    UPDATE_OLED(oled->mailbox.page_id, page_id != NULL ? page_id : "");
+    mailbox_mark(oled, DISPLAY_MSG_PAGE_CHANGED);
+    taskEXIT_CRITICAL(&oled->mailbox.lock);
+    xTaskNotifyGive(oled->task_handle);
 }
 
 extern "C" void display_on_encoder_mode_changed(display_handle_t oled, bool is_page_mode)
@@ -855,9 +1104,7 @@ extern "C" void display_on_encoder_mode_changed(display_handle_t oled, bool is_p
         }
     };
 
-    if (xQueueSend(oled->msg_queue, &msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Display queue full, dropped encoder mode message");
-    }
+    post_msg(oled, &msg, "encoder mode message");
 }
 
 extern "C" void display_show_reboot(display_handle_t oled)
@@ -871,9 +1118,7 @@ extern "C" void display_show_reboot(display_handle_t oled)
         .data = {}  // No payload for reboot
     };
 
-    if (xQueueSend(oled->msg_queue, &msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Display queue full, dropped reboot message");
-    }
+    post_msg(oled, &msg, "reboot message");
 }
 
 extern "C" void display_on_error(display_handle_t oled, const char *message)
@@ -896,9 +1141,7 @@ extern "C" void display_on_error(display_handle_t oled, const char *message)
         msg.data.error.message[sizeof(msg.data.error.message) - 1] = '\0';
     }
 
-    if (xQueueSend(oled->msg_queue, &msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Display queue full, dropped error message");
-    }
+    post_msg(oled, &msg, "error message");
 }
 
 extern "C" void display_on_msc_analysis(display_handle_t oled, const char *status_msg)
@@ -922,9 +1165,7 @@ extern "C" void display_on_msc_analysis(display_handle_t oled, const char *statu
         msg.data.msc_analysis.status_msg[sizeof(msg.data.msc_analysis.status_msg) - 1] = '\0';
     }
 
-    if (xQueueSend(oled->msg_queue, &msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Display queue full, dropped MSC analysis message");
-    }
+    post_msg(oled, &msg, "MSC analysis message");
 }
 
 
@@ -943,9 +1184,7 @@ extern "C" void display_on_msc_menu(display_handle_t oled, int selected_index)
         }
     };
 
-    if (xQueueSend(oled->msg_queue, &msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Display queue full, dropped MSC menu message");
-    }
+    post_msg(oled, &msg, "MSC menu message");
 }
 
 extern "C" void display_on_msc_confirm(display_handle_t oled, const char *action,
@@ -970,9 +1209,7 @@ extern "C" void display_on_msc_confirm(display_handle_t oled, const char *action
         strncpy(msg.data.msc_confirm.line2, line2, sizeof(msg.data.msc_confirm.line2) - 1);
     }
 
-    if (xQueueSend(oled->msg_queue, &msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Display queue full, dropped MSC confirm message");
-    }
+    post_msg(oled, &msg, "MSC confirm message");
 }
 
 extern "C" void display_on_msc_progress(display_handle_t oled, const char *filename, uint16_t progress)
@@ -981,25 +1218,12 @@ extern "C" void display_on_msc_progress(display_handle_t oled, const char *filen
         return;
     }
 
-    display_msg_t msg = {
-        .type = DISPLAY_MSG_MSC_PROGRESS,
-        .data = {
-            .msc_progress = {
-                .filename = {0},
-                .progress = progress
-            }
-        }
-    };
-
-    if (filename != NULL) {
-        strncpy(msg.data.msc_progress.filename, filename,
-                sizeof(msg.data.msc_progress.filename) - 1);
-        msg.data.msc_progress.filename[sizeof(msg.data.msc_progress.filename) - 1] = '\0';
-    }
-
-    if (xQueueSend(oled->msg_queue, &msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Display queue full, dropped MSC progress message");
-    }
+    taskENTER_CRITICAL(&oled->mailbox.lock);
+    UPDATE_OLED(oled->mailbox.msc_filename, filename != NULL ? filename : "");
+    oled->mailbox.msc_progress = progress;
+    mailbox_mark(oled, DISPLAY_MSG_MSC_PROGRESS);
+    taskEXIT_CRITICAL(&oled->mailbox.lock);
+    xTaskNotifyGive(oled->task_handle);
 }
 
 extern "C" esp_err_t display_init(const display_config_t *config, display_handle_t *display_handle)
@@ -1062,6 +1286,12 @@ extern "C" esp_err_t display_init(const display_config_t *config, display_handle
         return ESP_ERR_NO_MEM;
     }
 
+    // Framebuffer matches the cleared display memory
+    new (&oled->fb) OledFramebuffer();
+    portMUX_INITIALIZE(&oled->mailbox.lock);
+    oled->stats_start_us = esp_timer_get_time();
+    oled->window_start_us = oled->stats_start_us;
+
     // Initialize display
     oled->display->begin();
     oled->display->clear();
@@ -1084,6 +1314,7 @@ extern "C" esp_err_t display_init(const display_config_t *config, display_handle
 
     // Draw initial startup screen (synchronous)
     layout_startup(oled);
+    flush_framebuffer(oled);
 
     // Create message queue
     oled->msg_queue = xQueueCreate(DISPLAY_QUEUE_DEPTH, sizeof(display_msg_t));
@@ -1185,12 +1416,20 @@ extern "C" void display_print_status(display_handle_t handle, status_output_type
         case LAYOUT_ERROR: layout_name = "error"; break;
     }
 
+    int64_t uptime_us = esp_timer_get_time() - handle->stats_start_us;
+    uint32_t busy_ms_per_s = (uptime_us > 0) ? (uint32_t)(handle->i2c_busy_us * 1000 / uptime_us) : 0;
+
     if (output_type == STATUS_OUTPUT_COMPACT) {
-        printf("[display] initialized, layout=%s, 128x64 OLED\n", layout_name);
+        printf("[display] initialized, layout=%s, 128x64 OLED, I2C %" PRIu32 " ms/s\n",
+               layout_name, busy_ms_per_s);
     } else {
         printf("Display Status:\n");
         printf("  Current layout: %s\n", layout_name);
         printf("  I2C: SDA=GPIO%d, SCL=GPIO%d\n", handle->config.sda_gpio, handle->config.scl_gpio);
+        printf("  I2C bus: %" PRIu32 " ms/s average, %" PRIu32 " ms/s peak, %" PRIu32 " flushes, %" PRIu64 " bytes\n",
+               busy_ms_per_s, handle->peak_busy_ms, handle->flushes, handle->flush_bytes);
+        printf("  Updates: %" PRIu32 " coalesced, %" PRIu32 " dropped (queue full)\n",
+               handle->coalesced, __atomic_load_n(&handle->dropped, __ATOMIC_RELAXED));
 
         if (output_type == STATUS_OUTPUT_VERBOSE) {
             printf("  I2C address: 0x%02X\n", handle->config.i2c_address);
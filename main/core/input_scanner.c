@@ -5,12 +5,21 @@
  */
 
 #include "input_scanner.h"
+#include "driver/pulse_cnt.h"
+#include "esp_attr.h"
 #include "esp_log.h"
 #include "esp_heap_caps.h"
 #include "esp_timer.h"
 #include "rom/ets_sys.h"
 #include <inttypes.h>
 
+#ifdef CONFIG_SOUNDBOARD_LATENCY_STATS_ENABLE
+    #include "latency.h"
+#endif
+#ifdef CONFIG_SOUNDBOARD_TRACE_ENABLE
+    #include "trace.h"
+#endif
+
 static const char *TAG = "input_scanner";
 
 /**
@@ -34,6 +43,20 @@ typedef enum {
 // Forward declaration
 struct input_scanner_s;
 
+/**
+ * @brief Press latency statistics (written by the scanner task)
+ *
+ * Measured from the first detection of a press to the return of its PRESS
+ * callback (debounce included): the key edge interrupt in interrupt mode, the
+ * first scan that saw the key pressed in polling mode (the edge itself is up
+ * to one scan interval earlier, added to the bound shown by status).
+ */
+typedef struct {
+    uint32_t presses;
+    int64_t sum_us;
+    int64_t max_us;
+} press_latency_stats_t;
+
 /**
  * @brief Per-button state tracking
  *
@@ -55,6 +78,8 @@ typedef struct {
     uint8_t btn_num;                // Button number (0 for encoder, col + row * MATRIX_COLS + 1 for matrix)
     input_scanner_callback_t callback;  // User callback function
     void *user_ctx;                 // User context for callback
+
+    press_latency_stats_t *latency; // Shared press latency statistics
 } button_state_info_t;
 
 /**
@@ -84,6 +109,8 @@ typedef struct {
 
     // Switch button state (uses button_state_info_t)
     button_state_info_t sw_state;
+
+    uint32_t detents;               // Detents reported since init
 } encoder_state_info_t;
 
 /**
@@ -100,6 +127,18 @@ struct input_scanner_s {
 
     // Encoder state
     encoder_state_info_t encoder_state;
+
+    // Interrupt mode
+    pcnt_unit_handle_t pcnt_unit;        // Encoder quadrature counter
+    pcnt_channel_handle_t pcnt_chan[2];  // Edges on CLK, edges on DT
+    int32_t pending_detents;             // Detents counted by the PCNT ISR (+: CCW, -: CW), not reported yet
+    int64_t edge_us;                     // First key edge since the last wake-up (0: none)
+    bool isr_handlers_added;
+
+    // Statistics
+    press_latency_stats_t latency;
+    uint32_t wakeups;                    // Scanner task wake-ups (one per scan in polling mode)
+    int64_t start_us;
 };
 
 // ===== Helper Functions =====
@@ -125,6 +164,7 @@ static inline button_state_info_t *get_button_state(input_scanner_handle_t handl
  * @param long_press_us Long press threshold in microseconds
  * @param callback User callback function
  * @param user_ctx User context for callback
+ * @param latency Press latency statistics to update
  */
 static inline void init_button_state(button_state_info_t *btn,
                                      uint8_t btn_num,
@@ -132,7 +172,8 @@ static inline void init_button_state(button_state_info_t *btn,
                                      int64_t debounce_release_us,
                                      int64_t long_press_us,
                                      input_scanner_callback_t callback,
-                                     void *user_ctx)
+                                     void *user_ctx,
+                                     press_latency_stats_t *latency)
 {
     btn->state = BUTTON_STATE_IDLE;
     btn->state_change_time_us = 0;
@@ -144,6 +185,7 @@ static inline void init_button_state(button_state_info_t *btn,
     btn->btn_num = btn_num;
     btn->callback = callback;
     btn->user_ctx = user_ctx;
+    btn->latency = latency;
 }
 
 /**
@@ -177,10 +219,23 @@ static void button_fsm_update(button_state_info_t *btn, bool pressed, int64_t no
                 btn->press_start_time_us = now;
                 btn->long_press_triggered = false;
 
+#ifdef LATENCY_STATS_ENABLE
+                latency_trigger_begin(btn->state_change_time_us, now);
+#endif
+#ifdef TRACE_ENABLE
+                trace_event(TRACE_INPUT_EVENT, btn->btn_num, INPUT_EVENT_BUTTON_PRESS);
+#endif
                 // Invoke user callback
                 if (btn->callback != NULL) {
                     btn->callback(btn->btn_num, INPUT_EVENT_BUTTON_PRESS, btn->user_ctx);
                 }
+
+                int64_t latency_us = esp_timer_get_time() - btn->state_change_time_us;
+                btn->latency->presses++;
+                btn->latency->sum_us += latency_us;
+                if (latency_us > btn->latency->max_us) {
+                    btn->latency->max_us = latency_us;
+                }
             }
             break;
 
@@ -192,6 +247,12 @@ static void button_fsm_update(button_state_info_t *btn, bool pressed, int64_t no
                 // Long press threshold reached
                 btn->long_press_triggered = true;
 
+#ifdef LATENCY_STATS_ENABLE
+                latency_trigger_begin(0, now);  // No debounce: no edge mark
+#endif
+#ifdef TRACE_ENABLE
+                trace_event(TRACE_INPUT_EVENT, btn->btn_num, INPUT_EVENT_BUTTON_LONG_PRESS);
+#endif
                 // Invoke user callback
                 if (btn->callback != NULL) {
                     btn->callback(btn->btn_num, INPUT_EVENT_BUTTON_LONG_PRESS, btn->user_ctx);
@@ -207,6 +268,12 @@ static void button_fsm_update(button_state_info_t *btn, bool pressed, int64_t no
                 // Debounce time elapsed, confirm release
                 btn->state = BUTTON_STATE_IDLE;
 
+#ifdef LATENCY_STATS_ENABLE
+                latency_trigger_begin(btn->state_change_time_us, now);
+#endif
+#ifdef TRACE_ENABLE
+                trace_event(TRACE_INPUT_EVENT, btn->btn_num, INPUT_EVENT_BUTTON_RELEASE);
+#endif
                 // Invoke user callback
                 if (btn->callback != NULL) {
                     btn->callback(btn->btn_num, INPUT_EVENT_BUTTON_RELEASE, btn->user_ctx);
@@ -258,11 +325,11 @@ static int8_t encoder_decode_direction(uint8_t prev_state, uint8_t new_state)
  * @brief Scan one row and update button states
  *
  * Uses unified button FSM for all buttons in the row.
+ *
+ * @param now Scan time in microseconds (key edge time on an interrupt wake-up)
  */
-static void scan_row(input_scanner_handle_t handle, uint8_t row)
+static void scan_row(input_scanner_handle_t handle, uint8_t row, int64_t now)
 {
-    int64_t now = esp_timer_get_time();
-
     // Drive this row HIGH (active) - allows current to flow through diode when button pressed
     gpio_set_level(handle->config.row_gpios[row], 1);
 
@@ -287,6 +354,20 @@ static void scan_row(input_scanner_handle_t handle, uint8_t row)
 
 // ===== Encoder Polling =====
 
+/**
+ * @brief Report one encoder detent to the user callback
+ */
+static void encoder_report_detent(encoder_state_info_t *enc, input_event_type_t event)
+{
+    enc->detents++;
+#ifdef TRACE_ENABLE
+    trace_event(TRACE_INPUT_EVENT, 0, event);
+#endif
+    if (enc->callback != NULL) {
+        enc->callback(enc->sw_state.btn_num, event, enc->user_ctx);
+    }
+}
+
 /**
  * @brief Poll encoder quadrature pins for rotation
  *
@@ -316,14 +397,10 @@ static void poll_encoder_quadrature(encoder_state_info_t *enc)
 
                 // Check for detent completion (ENCODER_STEPS_PER_DETENT steps in same direction)
                 if (enc->step_counter >= ENCODER_STEPS_PER_DETENT) {
-                    if (enc->callback != NULL) {
-                        enc->callback(enc->sw_state.btn_num, INPUT_EVENT_ENCODER_ROTATE_CCW, enc->user_ctx);
-                    }
+                    encoder_report_detent(enc, INPUT_EVENT_ENCODER_ROTATE_CCW);
                     enc->step_counter = 0;
                 } else if (enc->step_counter <= -ENCODER_STEPS_PER_DETENT) {
-                    if (enc->callback != NULL) {
-                        enc->callback(enc->sw_state.btn_num, INPUT_EVENT_ENCODER_ROTATE_CW, enc->user_ctx);
-                    }
+                    encoder_report_detent(enc, INPUT_EVENT_ENCODER_ROTATE_CW);
                     enc->step_counter = 0;
                 }
             }
@@ -341,10 +418,10 @@ static void poll_encoder_quadrature(encoder_state_info_t *enc)
  * in the encoder state structure.
  *
  * @param enc Encoder state structure (self-contained)
+ * @param now Scan time in microseconds
  */
-static void poll_encoder_switch(encoder_state_info_t *enc)
+static void poll_encoder_switch(encoder_state_info_t *enc, int64_t now)
 {
-    int64_t now = esp_timer_get_time();
     int sw_level = gpio_get_level(enc->sw_gpio);
     bool pressed = (sw_level == 0);  // Active low
 
@@ -352,10 +429,322 @@ static void poll_encoder_switch(encoder_state_info_t *enc)
     button_fsm_update(&enc->sw_state, pressed, now);
 }
 
+// ===== Interrupt Mode =====
+
+/**
+ * @brief Key edge ISR (matrix columns, encoder switch): wake the scanner task
+ *
+ * Edge interrupts are disabled until the task has scanned the keys back to
+ * idle, since the row scan itself toggles the columns.
+ */
+static void IRAM_ATTR key_edge_isr(void *arg)
+{
+    input_scanner_handle_t handle = (input_scanner_handle_t)arg;
+
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        gpio_intr_disable(handle->config.col_gpios[col]);
+    }
+    if (handle->config.encoder_sw_gpio != GPIO_NUM_NC) {
+        gpio_intr_disable(handle->config.encoder_sw_gpio);
+    }
+    if (handle->edge_us == 0) {
+        handle->edge_us = esp_timer_get_time();
+    }
+
+    BaseType_t high_task_wakeup = pdFALSE;
+    vTaskNotifyGiveFromISR(handle->task_handle, &high_task_wakeup);
+    portYIELD_FROM_ISR(high_task_wakeup);
+}
+
+/**
+ * @brief PCNT watch point ISR: one detent completed (the counter resets at the limits)
+ */
+static bool IRAM_ATTR encoder_pcnt_on_reach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata,
+                                            void *user_ctx)
+{
+    input_scanner_handle_t handle = (input_scanner_handle_t)user_ctx;
+
+    __atomic_fetch_add(&handle->pending_detents, (edata->watch_point_value > 0) ? 1 : -1, __ATOMIC_RELAXED);
+
+    // Detents before the task exists are reported on its first wake-up
+    BaseType_t high_task_wakeup = pdFALSE;
+    if (handle->task_handle != NULL) {
+        vTaskNotifyGiveFromISR(handle->task_handle, &high_task_wakeup);
+    }
+    return high_task_wakeup == pdTRUE;
+}
+
+/**
+ * @brief Report the detents counted by the PCNT ISR
+ */
+static void drain_encoder_detents(input_scanner_handle_t handle)
+{
+    int32_t detents = __atomic_exchange_n(&handle->pending_detents, 0, __ATOMIC_RELAXED);
+
+    // Same sign convention as poll_encoder_quadrature(): positive steps are CCW
+    for (; detents > 0; detents--) {
+        encoder_report_detent(&handle->encoder_state, INPUT_EVENT_ENCODER_ROTATE_CCW);
+    }
+    for (; detents < 0; detents++) {
+        encoder_report_detent(&handle->encoder_state, INPUT_EVENT_ENCODER_ROTATE_CW);
+    }
+}
+
+/**
+ * @brief Set up the PCNT unit decoding the encoder quadrature
+ *
+ * Both channels count on edges of one phase, with the direction set by the
+ * level of the other one (x4 decoding, same transitions as
+ * encoder_decode_direction()). The limits are one detent: the counter resets
+ * to zero at a limit and the watch point ISR reports the detent.
+ */
+static esp_err_t encoder_pcnt_init(input_scanner_handle_t handle)
+{
+    pcnt_unit_config_t unit_config = {
+        .low_limit = -ENCODER_STEPS_PER_DETENT,
+        .high_limit = ENCODER_STEPS_PER_DETENT,
+    };
+    esp_err_t ret = pcnt_new_unit(&unit_config, &handle->pcnt_unit);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to allocate PCNT unit");
+        return ret;
+    }
+
+    pcnt_glitch_filter_config_t filter_config = {
+        .max_glitch_ns = INPUT_SCANNER_PCNT_GLITCH_NS,
+    };
+    pcnt_chan_config_t clk_config = {
+        .edge_gpio_num = handle->config.encoder_clk_gpio,
+        .level_gpio_num = handle->config.encoder_dt_gpio,
+    };
+    pcnt_chan_config_t dt_config = {
+        .edge_gpio_num = handle->config.encoder_dt_gpio,
+        .level_gpio_num = handle->config.encoder_clk_gpio,
+    };
+    pcnt_event_callbacks_t cbs = {
+        .on_reach = encoder_pcnt_on_reach,
+    };
+
+    ret = pcnt_unit_set_glitch_filter(handle->pcnt_unit, &filter_config);
+    if (ret == ESP_OK) {
+        ret = pcnt_new_channel(handle->pcnt_unit, &clk_config, &handle->pcnt_chan[0]);
+    }
+    if (ret == ESP_OK) {
+        ret = pcnt_new_channel(handle->pcnt_unit, &dt_config, &handle->pcnt_chan[1]);
+    }
+    if (ret == ESP_OK) {
+        // CLK edge: +1 when it reaches the DT level (01 -> 11, 10 -> 00), -1 otherwise
+        pcnt_channel_set_edge_action(handle->pcnt_chan[0], PCNT_CHANNEL_EDGE_ACTION_DECREASE,
+                                     PCNT_CHANNEL_EDGE_ACTION_INCREASE);
+        pcnt_channel_set_level_action(handle->pcnt_chan[0], PCNT_CHANNEL_LEVEL_ACTION_INVERSE,
+                                      PCNT_CHANNEL_LEVEL_ACTION_KEEP);
+        // DT edge: +1 when it leaves the CLK level (00 -> 01, 11 -> 10), -1 otherwise
+        pcnt_channel_set_edge_action(handle->pcnt_chan[1], PCNT_CHANNEL_EDGE_ACTION_INCREASE,
+                                     PCNT_CHANNEL_EDGE_ACTION_DECREASE);
+        pcnt_channel_set_level_action(handle->pcnt_chan[1], PCNT_CHANNEL_LEVEL_ACTION_INVERSE,
+                                      PCNT_CHANNEL_LEVEL_ACTION_KEEP);
+
+        ret = pcnt_unit_add_watch_point(handle->pcnt_unit, ENCODER_STEPS_PER_DETENT);
+    }
+    if (ret == ESP_OK) {
+        ret = pcnt_unit_add_watch_point(handle->pcnt_unit, -ENCODER_STEPS_PER_DETENT);
+    }
+    if (ret == ESP_OK) {
+        ret = pcnt_unit_register_event_callbacks(handle->pcnt_unit, &cbs, handle);
+    }
+    if (ret == ESP_OK) {
+        ret = pcnt_unit_enable(handle->pcnt_unit);
+    }
+    if (ret == ESP_OK) {
+        ret = pcnt_unit_clear_count(handle->pcnt_unit);
+    }
+    if (ret == ESP_OK) {
+        ret = pcnt_unit_start(handle->pcnt_unit);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure encoder PCNT unit");
+    }
+    return ret;
+}
+
+/**
+ * @brief Release the PCNT unit and channels (NULL-safe)
+ */
+static void encoder_pcnt_deinit(input_scanner_handle_t handle)
+{
+    if (handle->pcnt_unit == NULL) {
+        return;
+    }
+    pcnt_unit_stop(handle->pcnt_unit);
+    pcnt_unit_disable(handle->pcnt_unit);
+    for (int i = 0; i < 2; i++) {
+        if (handle->pcnt_chan[i] != NULL) {
+            pcnt_del_channel(handle->pcnt_chan[i]);
+            handle->pcnt_chan[i] = NULL;
+        }
+    }
+    pcnt_del_unit(handle->pcnt_unit);
+    handle->pcnt_unit = NULL;
+}
+
+/**
+ * @brief Add the key edge ISR on the columns and the encoder switch
+ */
+static esp_err_t key_edge_isr_init(input_scanner_handle_t handle)
+{
+    // Shared service: already installed by another module is fine
+    esp_err_t ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "Failed to install GPIO ISR service");
+        return ret;
+    }
+
+    gpio_num_t gpios[MATRIX_COLS + 1];
+    int count = 0;
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        gpios[count++] = handle->config.col_gpios[col];
+    }
+    if (handle->config.encoder_sw_gpio != GPIO_NUM_NC) {
+        gpios[count++] = handle->config.encoder_sw_gpio;
+    }
+
+    handle->isr_handlers_added = true;  // Removal of handlers never added is harmless
+    for (int i = 0; i < count; i++) {
+        gpio_set_intr_type(gpios[i], GPIO_INTR_ANYEDGE);
+        gpio_intr_disable(gpios[i]);
+        ret = gpio_isr_handler_add(gpios[i], key_edge_isr, handle);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to add edge ISR on GPIO %d", gpios[i]);
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+static void key_edge_isr_deinit(input_scanner_handle_t handle)
+{
+    if (!handle->isr_handlers_added) {
+        return;
+    }
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        gpio_intr_disable(handle->config.col_gpios[col]);
+        gpio_isr_handler_remove(handle->config.col_gpios[col]);
+    }
+    if (handle->config.encoder_sw_gpio != GPIO_NUM_NC) {
+        gpio_intr_disable(handle->config.encoder_sw_gpio);
+        gpio_isr_handler_remove(handle->config.encoder_sw_gpio);
+    }
+    handle->isr_handlers_added = false;
+}
+
+/**
+ * @brief Prepare the keys for the edge wake-up
+ *
+ * Drives all rows HIGH so that any pressed key raises its column, then
+ * enables the edge interrupts.
+ *
+ * @return true if no key is down (the task can sleep), false if one already is
+ */
+static bool arm_key_wakeup(input_scanner_handle_t handle)
+{
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        gpio_set_level(handle->config.row_gpios[row], 1);
+    }
+    ets_delay_us(MATRIX_SCAN_SETTLE_DELAY_US);
+
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        gpio_intr_enable(handle->config.col_gpios[col]);
+    }
+    if (handle->config.encoder_sw_gpio != GPIO_NUM_NC) {
+        gpio_intr_enable(handle->config.encoder_sw_gpio);
+    }
+
+    // A key already down raises no edge: check the levels after enabling
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        if (gpio_get_level(handle->config.col_gpios[col]) == 1) {
+            return false;
+        }
+    }
+    return handle->config.encoder_sw_gpio == GPIO_NUM_NC || gpio_get_level(handle->config.encoder_sw_gpio) == 1;
+}
+
+static void disarm_key_wakeup(input_scanner_handle_t handle)
+{
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        gpio_intr_disable(handle->config.col_gpios[col]);
+    }
+    if (handle->config.encoder_sw_gpio != GPIO_NUM_NC) {
+        gpio_intr_disable(handle->config.encoder_sw_gpio);
+    }
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        gpio_set_level(handle->config.row_gpios[row], 0);
+    }
+}
+
 // ===== Main Task =====
 
 /**
- * @brief Input scanner task - periodically polls matrix and encoder
+ * @brief Scan the matrix and the encoder switch once
+ *
+ * @param now Scan time in microseconds
+ * @return true while any key is pressed or debouncing
+ */
+static bool scan_keys(input_scanner_handle_t handle, int64_t now)
+{
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        scan_row(handle, row, now);
+    }
+
+    // Poll encoder switch (if present)
+    if (handle->config.encoder_sw_gpio != GPIO_NUM_NC) {
+        poll_encoder_switch(&handle->encoder_state, now);
+    }
+
+    if (handle->encoder_state.sw_state.state != BUTTON_STATE_IDLE) {
+        return true;
+    }
+    for (int i = 0; i < MATRIX_ROWS * MATRIX_COLS; i++) {
+        if (handle->button_states[i].state != BUTTON_STATE_IDLE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Interrupt mode loop: sleep until a key edge or a detent, scan while keys are active
+ */
+static void input_scanner_interrupt_loop(input_scanner_handle_t handle)
+{
+    TickType_t scan_interval_ticks = pdMS_TO_TICKS(handle->config.scan_interval_ms);
+
+    while (handle->running) {
+        if (arm_key_wakeup(handle)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        disarm_key_wakeup(handle);
+        if (!handle->running) {
+            break;
+        }
+        handle->wakeups++;
+        drain_encoder_detents(handle);
+
+        // First scan right away, timed from the key edge: debounce starts there
+        int64_t edge_us = __atomic_exchange_n(&handle->edge_us, 0, __ATOMIC_RELAXED);
+        TickType_t start_tick = xTaskGetTickCount();
+        bool active = scan_keys(handle, (edge_us != 0) ? edge_us : esp_timer_get_time());
+
+        while (active && handle->running) {
+            vTaskDelayUntil(&start_tick, scan_interval_ticks);
+            handle->wakeups++;
+            drain_encoder_detents(handle);
+            active = scan_keys(handle, esp_timer_get_time());
+        }
+    }
+}
+
+/**
+ * @brief Input scanner task - polls matrix and encoder, or waits for input edges
  */
 static void input_scanner_task(void *arg)
 {
@@ -366,27 +755,29 @@ static void input_scanner_task(void *arg)
         return;
     }
 
-    ESP_LOGI(TAG, "Input scanner task started (%dx%d matrix + encoder, scan interval %lu ms)",
-             MATRIX_ROWS, MATRIX_COLS, handle->config.scan_interval_ms);
+    ESP_LOGI(TAG, "Input scanner task started (%dx%d matrix + encoder, %s, scan interval %lu ms)",
+             MATRIX_ROWS, MATRIX_COLS, handle->config.use_interrupts ? "interrupt mode" : "polling",
+             handle->config.scan_interval_ms);
+
+    if (handle->config.use_interrupts) {
+        input_scanner_interrupt_loop(handle);
+        ESP_LOGI(TAG, "Input scanner task stopped");
+        vTaskDelete(NULL);
+        return;
+    }
 
     TickType_t scan_interval_ticks = pdMS_TO_TICKS(handle->config.scan_interval_ms);
 
     while (handle->running) {
         TickType_t start_tick = xTaskGetTickCount();
+        handle->wakeups++;
 
-        // Scan matrix
-        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
-            scan_row(handle, row);
-        }
+        // Scan matrix and encoder switch
+        scan_keys(handle, esp_timer_get_time());
 
         // Poll encoder quadrature
         poll_encoder_quadrature(&handle->encoder_state);
 
-        // Poll encoder switch (if present)
-        if (handle->config.encoder_sw_gpio != GPIO_NUM_NC) {
-            poll_encoder_switch(&handle->encoder_state);
-        }
-
         // Wait for next scan interval (deterministic timing)
         vTaskDelayUntil(&start_tick, scan_interval_ticks);
     }
@@ -462,7 +853,7 @@ esp_err_t input_scanner_init(const input_scanner_config_t *config, input_scanner
         uint8_t btn_num = col + (row * MATRIX_COLS) + 1;
         init_button_state(&handle->button_states[i], btn_num,
                          debounce_press_us, debounce_release_us, long_press_us,
-                         config->callback, config->user_ctx);
+                         config->callback, config->user_ctx, &handle->latency);
     }
 
     // Initialize encoder state (self-contained)
@@ -480,7 +871,7 @@ esp_err_t input_scanner_init(const input_scanner_config_t *config, input_scanner
     // Initialize encoder switch state (button number 0)
     init_button_state(&handle->encoder_state.sw_state, 0,
                      debounce_press_us, debounce_release_us, long_press_us,
-                     config->callback, config->user_ctx);
+                     config->callback, config->user_ctx, &handle->latency);
 
     esp_err_t ret;
 
@@ -547,8 +938,21 @@ esp_err_t input_scanner_init(const input_scanner_config_t *config, input_scanner
         }
     }
 
+    // Interrupt mode: edges stay disabled until the task arms them
+    if (config->use_interrupts) {
+        ret = encoder_pcnt_init(handle);
+        if (ret == ESP_OK) {
+            ret = key_edge_isr_init(handle);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to set up interrupt mode: %s", esp_err_to_name(ret));
+            goto cleanup;
+        }
+    }
+
     // Create scanner task
     handle->running = true;
+    handle->start_us = esp_timer_get_time();
     BaseType_t task_ret = xTaskCreatePinnedToCore(
         input_scanner_task,
         "input_scanner",
@@ -574,6 +978,8 @@ esp_err_t input_scanner_init(const input_scanner_config_t *config, input_scanner
     return ESP_OK;
 
 cleanup:
+    key_edge_isr_deinit(handle);
+    encoder_pcnt_deinit(handle);
     heap_caps_free(handle->button_states);
     heap_caps_free(handle);
     return ret;
@@ -591,8 +997,11 @@ esp_err_t input_scanner_deinit(input_scanner_handle_t handle)
         return ESP_ERR_INVALID_STATE;
     }
 
-    // Stop task
+    // Stop task (woken if it sleeps in interrupt mode)
     handle->running = false;
+    key_edge_isr_deinit(handle);
+    encoder_pcnt_deinit(handle);
+    xTaskNotifyGive(handle->task_handle);
 
     // Wait for task to finish (give it 100ms)
     vTaskDelay(pdMS_TO_TICKS(100));
@@ -641,18 +1050,51 @@ void input_scanner_print_status(input_scanner_handle_t handle, status_output_typ
     bool encoder_pressed = (handle->encoder_state.sw_state.state == BUTTON_STATE_PRESSED ||
                            handle->encoder_state.sw_state.state == BUTTON_STATE_DEBOUNCE_RELEASE);
 
+    // Wake-up rate and press latency (0.1 units)
+    const char *mode = handle->config.use_interrupts ? "interrupt" : "polling";
+    int64_t uptime_us = esp_timer_get_time() - handle->start_us;
+    uint32_t wakeups_x10 = (uptime_us > 0) ? (uint32_t)((int64_t)handle->wakeups * 10000000 / uptime_us) : 0;
+    uint32_t presses = handle->latency.presses;
+    uint32_t avg_latency_x10 = (presses > 0) ? (uint32_t)(handle->latency.sum_us / presses / 100) : 0;
+    uint32_t max_latency_x10 = (uint32_t)(handle->latency.max_us / 100);
+
     if (output_type == STATUS_OUTPUT_COMPACT) {
-        printf("[input] %s, %" PRIu32 "ms scan, %d button%s pressed\n",
+        printf("[input] %s, %s, %" PRIu32 "ms scan, %" PRIu32 ".%" PRIu32 " wakeups/s, %d button%s pressed\n",
                running ? "running" : "stopped",
+               mode,
                scan_interval,
+               wakeups_x10 / 10, wakeups_x10 % 10,
                pressed_count,
                pressed_count == 1 ? "" : "s");
     } else {
         printf("Input Scanner Status:\n");
         printf("  Task: %s\n", running ? "Running" : "Stopped");
-        printf("  Scan interval: %" PRIu32 " ms\n", scan_interval);
+        if (handle->config.use_interrupts) {
+            printf("  Mode: interrupt (PCNT encoder, key edge wake-up)\n");
+            printf("  Scan interval: %" PRIu32 " ms (while a key is active)\n", scan_interval);
+        } else {
+            printf("  Mode: polling\n");
+            printf("  Scan interval: %" PRIu32 " ms\n", scan_interval);
+        }
+        printf("  Wakeups: %" PRIu32 " (%" PRIu32 ".%" PRIu32 "/s average)\n",
+               handle->wakeups, wakeups_x10 / 10, wakeups_x10 % 10);
+        if (handle->config.use_interrupts) {
+            printf("  Press latency: avg %" PRIu32 ".%" PRIu32 " ms, max %" PRIu32 ".%" PRIu32 " ms "
+                   "(%" PRIu32 " presses, key edge to callback return)\n",
+                   avg_latency_x10 / 10, avg_latency_x10 % 10, max_latency_x10 / 10, max_latency_x10 % 10,
+                   presses);
+        } else {
+            // The edge is up to one scan interval before the first scan that saw it
+            uint32_t bound_x10 = max_latency_x10 + scan_interval * 10;
+            printf("  Press latency: avg %" PRIu32 ".%" PRIu32 " ms, max %" PRIu32 ".%" PRIu32 " ms, "
+                   "bound %" PRIu32 ".%" PRIu32 " ms (%" PRIu32 " presses, first scan to callback return, "
+                   "+%" PRIu32 " ms scan)\n",
+                   avg_latency_x10 / 10, avg_latency_x10 % 10, max_latency_x10 / 10, max_latency_x10 % 10,
+                   bound_x10 / 10, bound_x10 % 10, presses, scan_interval);
+        }
         printf("  Matrix: %d button%s pressed\n", pressed_count, pressed_count == 1 ? "" : "s");
         printf("  Encoder switch: %s\n", encoder_pressed ? "Pressed" : "Released");
+        printf("  Encoder: %" PRIu32 " detents\n", handle->encoder_state.detents);
 
         if (output_type == STATUS_OUTPUT_VERBOSE) {
             printf("  Matrix GPIOs:\n");
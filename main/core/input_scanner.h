@@ -1,9 +1,16 @@
 /**
  * @file input_scanner.h
- * @brief Unified polling-based input scanner for matrix keypad and rotary encoder
+ * @brief Unified input scanner for matrix keypad and rotary encoder
  *
- * This module combines matrix keypad scanning and rotary encoder polling into a single
+ * This module combines matrix keypad scanning and rotary encoder decoding into a single
  * FreeRTOS task with consistent architecture and callback contexts.
+ *
+ * Two modes (CONFIG_SOUNDBOARD_INPUT_MODE):
+ * - Polling: the task scans the matrix and samples the encoder every scan interval.
+ * - Interrupt: the encoder is decoded by the PCNT peripheral, and the matrix rows
+ *   are all driven HIGH while idle so that any key press raises a column edge
+ *   interrupt. The task sleeps until an edge or an encoder detent, then scans at
+ *   the scan interval (debounce, long press) until all keys are released again.
  */
 
 #pragma once
@@ -83,6 +90,21 @@ typedef void (*input_scanner_callback_t)(
  */
 #define MATRIX_SCAN_SETTLE_DELAY_US 10
 
+#ifdef CONFIG_SOUNDBOARD_INPUT_MODE_INTERRUPT
+    #define INPUT_SCANNER_USE_INTERRUPTS true
+#else
+    #define INPUT_SCANNER_USE_INTERRUPTS false
+#endif
+
+/**
+ * @brief PCNT glitch filter for the encoder quadrature inputs (interrupt mode)
+ *
+ * Pulses shorter than this are ignored by the counter. Contact bounce longer
+ * than the filter is harmless: full quadrature decoding counts it up and back
+ * down, so it never completes a detent.
+ */
+#define INPUT_SCANNER_PCNT_GLITCH_NS 10000
+
 /**
  * @brief Input scanner configuration
  */
@@ -98,6 +120,7 @@ typedef struct {
 
     // Timing parameters
     uint32_t scan_interval_ms;          ///< Polling interval in milliseconds (default: 5ms)
+    bool use_interrupts;                ///< Interrupt mode: PCNT encoder, edge wake-up for the matrix
 
     // Button debounce parameters (matrix + encoder switch)
     uint32_t button_debounce_press_ms;  ///< Press debounce time in milliseconds (default: 10ms)
@@ -147,6 +170,7 @@ typedef struct {
     .encoder_dt_gpio = CONFIG_SOUNDBOARD_ENCODER_DT_GPIO, \
     .encoder_sw_gpio = CONFIG_SOUNDBOARD_ENCODER_SW_GPIO, \
     .scan_interval_ms = CONFIG_SOUNDBOARD_MATRIX_SCAN_INTERVAL_MS, \
+    .use_interrupts = INPUT_SCANNER_USE_INTERRUPTS, \
     .button_debounce_press_ms = CONFIG_SOUNDBOARD_MATRIX_DEBOUNCE_PRESS_MS, \
     .button_debounce_release_ms = CONFIG_SOUNDBOARD_MATRIX_DEBOUNCE_RELEASE_MS, \
     .long_press_ms = CONFIG_SOUNDBOARD_MATRIX_LONG_PRESS_MS, \
@@ -162,7 +186,8 @@ typedef struct {
  * @brief Initialize unified input scanner
  *
  * Creates a FreeRTOS task that polls the matrix keypad and rotary encoder at the
- * configured scan interval. All callbacks are invoked from task context (not ISR).
+ * configured scan interval, or in interrupt mode sleeps until a key edge or an
+ * encoder detent. All callbacks are invoked from task context (not ISR).
  *
  * @param config Configuration structure
  * @param out_handle Output handle on success
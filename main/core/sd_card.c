@@ -11,8 +11,11 @@
 #include "freertos/FreeRTOS.h"   // IWYU pragma: keep
 #include "esp_log.h"
 #include "esp_heap_caps.h"
+#include "esp_timer.h"
 #include "esp_vfs_fat.h"
+#include "esp_memory_utils.h"
 #include "driver/sdspi_host.h"
+#include "driver/sdmmc_host.h"
 #include "driver/spi_common.h"
 
 #include "sd_card.h"
@@ -24,43 +27,83 @@
 #define SD_CARD_FATFS_DRIVE         "0:"
 #define BYTES_PER_GB                (1024ULL * 1024 * 1024)
 
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+    #define SD_CARD_SECTOR_SIZE     512     // FatFS sector of SD cards
+    #define SD_CARD_DIRECT_BUF_SIZE ((uint32_t)CONFIG_SOUNDBOARD_SD_DIRECT_BUF_KB * 1024)
+    #define SD_CARD_DIRECT_BUF_ALIGN 64     // DMA and cache line alignment
+#endif
+
+#if defined(CONFIG_SOUNDBOARD_SD_INTERFACE_SDMMC_1BIT) || defined(CONFIG_SOUNDBOARD_SD_INTERFACE_SDMMC_4BIT)
+    #define SD_CARD_USE_SDMMC       1
+    #ifdef CONFIG_SOUNDBOARD_SD_INTERFACE_SDMMC_4BIT
+        #define SD_CARD_BUS_WIDTH   4
+    #else
+        #define SD_CARD_BUS_WIDTH   1
+    #endif
+    #ifdef CONFIG_SOUNDBOARD_SD_SDMMC_FREQ_DEFAULT
+        #define SD_CARD_SDMMC_FREQ_KHZ  SDMMC_FREQ_DEFAULT      // 20 MHz
+    #else
+        #define SD_CARD_SDMMC_FREQ_KHZ  SDMMC_FREQ_HIGHSPEED    // 40 MHz, falls back to 20 MHz
+    #endif
+#else
+    #define SD_CARD_USE_SDMMC       0
+#endif
+
 static const char *TAG = "sd_card";
 static const char *s_mount_point = NULL;
 static sdmmc_card_t *s_card = NULL;
 
-esp_err_t sd_card_init(const sd_card_spi_config_t *config, sdmmc_card_t **out_card)
+#if SD_CARD_USE_SDMMC
+
+/**
+ * @brief Mount through the SDMMC host (slot 1, pins routed by the GPIO matrix)
+ */
+static esp_err_t mount_sdmmc(const sd_card_spi_config_t *config,
+                             const esp_vfs_fat_sdmmc_mount_config_t *mount_config,
+                             sdmmc_card_t **out_card)
 {
-    if (config == NULL) {
-        ESP_LOGE(TAG, "config is NULL");
-        return ESP_ERR_INVALID_ARG;
-    }
+    sdmmc_host_t host = SDMMC_HOST_DEFAULT();
+    host.max_freq_khz = SD_CARD_SDMMC_FREQ_KHZ;
+
+    sdmmc_slot_config_t slot_config = SDMMC_SLOT_CONFIG_DEFAULT();
+    slot_config.width = SD_CARD_BUS_WIDTH;
+    slot_config.clk = config->sclk_io_num;
+    slot_config.cmd = config->mosi_io_num;
+    slot_config.d0 = config->miso_io_num;
+#if SD_CARD_BUS_WIDTH == 4
+    slot_config.d1 = config->d1_io_num;
+    slot_config.d2 = config->d2_io_num;
+    slot_config.d3 = config->cs_io_num;
+#endif
+    // External pull-ups are still required, the internal ones only help at low speed
+    slot_config.flags |= SDMMC_SLOT_FLAG_INTERNAL_PULLUP;
+
+    ESP_LOGI(TAG, "Using SDMMC %d-bit, max %d kHz", SD_CARD_BUS_WIDTH, host.max_freq_khz);
+    ESP_LOGI(TAG, "Using SDMMC pins - CMD:%d CLK:%d D0:%d", config->mosi_io_num, config->sclk_io_num,
+        config->miso_io_num);
+#if SD_CARD_BUS_WIDTH == 4
+    ESP_LOGI(TAG, "Using SDMMC pins - D1:%d D2:%d D3:%d", config->d1_io_num, config->d2_io_num,
+        config->cs_io_num);
+#endif
 
-    if (config->mount_point == NULL) {
-        ESP_LOGE(TAG, "mount_point is NULL");
-        return ESP_ERR_INVALID_ARG;
-    }
+    ESP_LOGI(TAG, "Mounting filesystem at %s", config->mount_point);
+    return esp_vfs_fat_sdmmc_mount(config->mount_point, &host, &slot_config, mount_config, out_card);
+}
 
-    if (out_card == NULL) {
-        ESP_LOGE(TAG, "out_card is NULL");
-        return ESP_ERR_INVALID_ARG;
-    }
+#else
 
+/**
+ * @brief Mount through the SPI host (bus initialized here, freed on failure)
+ */
+static esp_err_t mount_spi(const sd_card_spi_config_t *config,
+                           const esp_vfs_fat_sdmmc_mount_config_t *mount_config,
+                           sdmmc_card_t **out_card)
+{
     esp_err_t ret;
 
-    // Options for mounting the filesystem
-    esp_vfs_fat_sdmmc_mount_config_t mount_config = {
-        .format_if_mount_failed = false, .max_files = SD_CARD_MAX_OPEN_FILES, .allocation_unit_size = SD_CARD_ALLOC_UNIT_SIZE};
-
-    ESP_LOGI(TAG, "Initializing SD card via SPI");
     ESP_LOGI(TAG, "Using SPI pins - MOSI:%d MISO:%d CLK:%d CS:%d", config->mosi_io_num, config->miso_io_num,
         config->sclk_io_num, config->cs_io_num);
 
-
-    // Wait for SD card to power up and stabilize
-    // SD cards require 1ms minimum, but some need up to 74 clock cycles at 400kHz
-    ESP_LOGI(TAG, "Waiting for SD card to stabilize (250ms)");
-    vTaskDelay(pdMS_TO_TICKS(SD_CARD_STABILISATION_DELAY_MS));
-
     // Initialize SPI bus
     sdmmc_host_t host = SDSPI_HOST_DEFAULT();
     host.max_freq_khz = SD_CARD_MAX_FREQ_KHZ;
@@ -90,7 +133,56 @@ esp_err_t sd_card_init(const sd_card_spi_config_t *config, sdmmc_card_t **out_ca
     slot_config.host_id = host.slot;
 
     ESP_LOGI(TAG, "Mounting filesystem at %s", config->mount_point);
-    ret = esp_vfs_fat_sdspi_mount(config->mount_point, &host, &slot_config, &mount_config, out_card);
+    ret = esp_vfs_fat_sdspi_mount(config->mount_point, &host, &slot_config, mount_config, out_card);
+    if (ret != ESP_OK) {
+        ESP_LOGI(TAG, "Cleaning up SPI bus after failure");
+        spi_bus_free(host.slot);
+    }
+    return ret;
+}
+
+#endif
+
+esp_err_t sd_card_init(const sd_card_spi_config_t *config, sdmmc_card_t **out_card)
+{
+    if (config == NULL) {
+        ESP_LOGE(TAG, "config is NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (config->mount_point == NULL) {
+        ESP_LOGE(TAG, "mount_point is NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (out_card == NULL) {
+        ESP_LOGE(TAG, "out_card is NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret;
+
+    // Options for mounting the filesystem
+    esp_vfs_fat_sdmmc_mount_config_t mount_config = {
+        .format_if_mount_failed = false, .max_files = SD_CARD_MAX_OPEN_FILES, .allocation_unit_size = SD_CARD_ALLOC_UNIT_SIZE};
+
+    ESP_LOGI(TAG, "Initializing SD card via %s", SD_CARD_USE_SDMMC ? "SDMMC" : "SPI");
+
+    // Wait for SD card to power up and stabilize
+    // SD cards require 1ms minimum, but some need up to 74 clock cycles at 400kHz.
+    // The card is powered since reset: only wait for what is left of the delay.
+    int64_t since_boot_ms = esp_timer_get_time() / 1000;
+    if (since_boot_ms < SD_CARD_STABILISATION_DELAY_MS) {
+        uint32_t wait_ms = SD_CARD_STABILISATION_DELAY_MS - (uint32_t)since_boot_ms;
+        ESP_LOGI(TAG, "Waiting for SD card to stabilize (%lums)", (unsigned long)wait_ms);
+        vTaskDelay(pdMS_TO_TICKS(wait_ms));
+    }
+
+#if SD_CARD_USE_SDMMC
+    ret = mount_sdmmc(config, &mount_config, out_card);
+#else
+    ret = mount_spi(config, &mount_config, out_card);
+#endif
 
     if (ret != ESP_OK) {
         if (ret == ESP_FAIL) {
@@ -103,8 +195,6 @@ esp_err_t sd_card_init(const sd_card_spi_config_t *config, sdmmc_card_t **out_ca
         } else {
             ESP_LOGE(TAG, "Failed to initialize SD card: %s (0x%x).", esp_err_to_name(ret), ret);
         }
-        ESP_LOGI(TAG, "Cleaning up SPI bus after failure");
-        spi_bus_free(host.slot);
         return ret;
     }
 
@@ -125,19 +215,22 @@ esp_err_t sd_card_deinit(sdmmc_card_t *card)
         return ESP_ERR_INVALID_ARG;
     }
 
-    // Unmount filesystem
+    // Unmount filesystem (also deinitializes the SDMMC host)
     esp_err_t ret = esp_vfs_fat_sdcard_unmount(s_mount_point, card);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to unmount SD card: %s", esp_err_to_name(ret));
         return ret;
     }
 
+#if !SD_CARD_USE_SDMMC
     // Free SPI bus
     ret = spi_bus_free(SDSPI_DEFAULT_HOST);
     if (ret != ESP_OK) {
         ESP_LOGW(TAG, "Failed to free SPI bus: %s", esp_err_to_name(ret));
     }
+#endif
 
+    s_card = NULL;
     ESP_LOGI(TAG, "SD card unmounted");
 
     return ESP_OK;
@@ -233,6 +326,174 @@ esp_err_t sd_card_erase_all(const char *mount_point)
     return ESP_OK;
 }
 
+/* ============================================================================
+ * Direct Reads
+ * ============================================================================ */
+
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+
+struct sd_card_file_s {
+    FIL fil;
+    uint8_t *buf;           // Internal DMA-capable, SD_CARD_DIRECT_BUF_SIZE bytes
+    uint32_t buf_offset;    // File offset of buf[0] (sector aligned)
+    uint32_t buf_len;       // Valid bytes in buf
+    uint32_t pos;           // Read position
+};
+
+// Direct read counters (__atomic, updated by the reading tasks)
+static struct {
+    uint32_t opens;
+    uint32_t unaligned;     // Buffer fills from an unaligned position (partial first sector)
+    uint32_t fills;         // f_read() calls into the buffer
+    uint32_t passthrough;   // f_read() calls straight into the caller's buffer
+    uint32_t sectors;       // Sectors read by both
+    uint32_t errors;
+} s_direct;
+
+esp_err_t sd_card_file_open(const char *path, sd_card_file_t **out_file)
+{
+    if (path == NULL || out_file == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    size_t mount_len = (s_mount_point != NULL) ? strlen(s_mount_point) : 0;
+    if (s_card == NULL || mount_len == 0 || strncmp(path, s_mount_point, mount_len) != 0 ||
+        path[mount_len] != '/') {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    // VFS path to FatFS path: the mount point is the SD card drive
+    char fatfs_path[SOUNDBOARD_MAX_PATH_LEN + sizeof(SD_CARD_FATFS_DRIVE)];
+    int len = snprintf(fatfs_path, sizeof(fatfs_path), SD_CARD_FATFS_DRIVE "%s", path + mount_len);
+    if (len < 0 || (size_t)len >= sizeof(fatfs_path)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // The FIL sector buffer (partial sector at the end of file) is a DMA target too
+    sd_card_file_t *file = heap_caps_calloc(1, sizeof(sd_card_file_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+    uint8_t *buf = heap_caps_aligned_alloc(SD_CARD_DIRECT_BUF_ALIGN, SD_CARD_DIRECT_BUF_SIZE,
+                                           MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+    if (file == NULL || buf == NULL) {
+        heap_caps_free(file);
+        heap_caps_free(buf);
+        return ESP_ERR_NO_MEM;
+    }
+    if (f_open(&file->fil, fatfs_path, FA_READ) != FR_OK) {
+        heap_caps_free(file);
+        heap_caps_free(buf);
+        return ESP_ERR_NOT_FOUND;
+    }
+    file->buf = buf;
+    __atomic_add_fetch(&s_direct.opens, 1, __ATOMIC_RELAXED);
+
+    *out_file = file;
+    return ESP_OK;
+}
+
+uint32_t sd_card_file_size(const sd_card_file_t *file)
+{
+    return (uint32_t)f_size(&file->fil);
+}
+
+esp_err_t sd_card_file_seek(sd_card_file_t *file, uint32_t offset)
+{
+    if (offset > f_size(&file->fil)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    file->pos = offset;
+    return ESP_OK;
+}
+
+bool sd_card_file_eof(const sd_card_file_t *file)
+{
+    return file->pos >= f_size(&file->fil);
+}
+
+/**
+ * @brief f_read() at a sector-aligned offset (seeks only after a skip)
+ *
+ * @return Bytes read, 0 on error
+ */
+static size_t direct_read_at(sd_card_file_t *file, void *dst, uint32_t offset, size_t len)
+{
+    UINT br = 0;
+    if ((f_tell(&file->fil) != offset && f_lseek(&file->fil, offset) != FR_OK) ||
+        f_read(&file->fil, dst, len, &br) != FR_OK) {
+        __atomic_add_fetch(&s_direct.errors, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    __atomic_add_fetch(&s_direct.sectors, (br + SD_CARD_SECTOR_SIZE - 1) / SD_CARD_SECTOR_SIZE,
+                       __ATOMIC_RELAXED);
+    return br;
+}
+
+size_t sd_card_file_read(sd_card_file_t *file, void *dst, size_t len)
+{
+    uint32_t left_in_file = (uint32_t)f_size(&file->fil) - file->pos;
+    if (len > left_in_file) {
+        len = left_in_file;
+    }
+
+    size_t done = 0;
+    while (done < len) {
+        uint8_t *out = (uint8_t *)dst + done;
+        size_t left = len - done;
+
+        // Buffered bytes first
+        if (file->pos >= file->buf_offset && file->pos < file->buf_offset + file->buf_len) {
+            size_t n = file->buf_offset + file->buf_len - file->pos;
+            if (n > left) {
+                n = left;
+            }
+            memcpy(out, file->buf + (file->pos - file->buf_offset), n);
+            file->pos += n;
+            done += n;
+            continue;
+        }
+
+        // Whole sectors from an aligned position: straight into a DMA-capable destination
+        size_t whole = left - left % SD_CARD_SECTOR_SIZE;
+        if (whole > 0 && file->pos % SD_CARD_SECTOR_SIZE == 0 &&
+            esp_ptr_dma_capable(out) && ((uintptr_t)out & 3) == 0) {
+            __atomic_add_fetch(&s_direct.passthrough, 1, __ATOMIC_RELAXED);
+            size_t n = direct_read_at(file, out, file->pos, whole);
+            file->pos += n;
+            done += n;
+            if (n < whole) {
+                break;
+            }
+            continue;
+        }
+
+        // Fill the buffer from the sector holding pos to the next buffer-size boundary:
+        // one multi-sector read, within one cluster when the buffer size divides it
+        uint32_t start = file->pos - file->pos % SD_CARD_SECTOR_SIZE;
+        uint32_t end = start - start % SD_CARD_DIRECT_BUF_SIZE + SD_CARD_DIRECT_BUF_SIZE;
+        if (start != file->pos) {
+            __atomic_add_fetch(&s_direct.unaligned, 1, __ATOMIC_RELAXED);
+        }
+        __atomic_add_fetch(&s_direct.fills, 1, __ATOMIC_RELAXED);
+        file->buf_offset = start;
+        file->buf_len = direct_read_at(file, file->buf, start, end - start);
+        if (file->buf_len <= file->pos - start) {
+            file->buf_len = 0;
+            break;  // Read error
+        }
+    }
+    return done;
+}
+
+void sd_card_file_close(sd_card_file_t *file)
+{
+    if (file == NULL) {
+        return;
+    }
+    f_close(&file->fil);
+    heap_caps_free(file->buf);
+    heap_caps_free(file);
+}
+
+#endif // SD_CARD_DIRECT_READ_ENABLE
+
 /* ============================================================================
  * SD Card Status
  * ============================================================================ */
@@ -278,16 +539,44 @@ void sd_card_print_status(status_output_type_t output_type)
             printf("  Capacity: %.1f GB\n", (double)total_bytes / BYTES_PER_GB);
             printf("  Free space: %.1f GB (%d%%)\n",
                    (double)free_bytes / BYTES_PER_GB, free_percent);
+#if SD_CARD_USE_SDMMC
+            printf("  Interface: SDMMC %d-bit, %d kHz (max %d kHz)\n",
+                   1 << s_card->log_bus_width, s_card->real_freq_khz, SD_CARD_SDMMC_FREQ_KHZ);
+#else
+            printf("  Interface: SPI, %d kHz\n", s_card->real_freq_khz);
+#endif
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+            uint32_t reads = __atomic_load_n(&s_direct.fills, __ATOMIC_RELAXED) +
+                             __atomic_load_n(&s_direct.passthrough, __ATOMIC_RELAXED);
+            uint32_t sectors = __atomic_load_n(&s_direct.sectors, __ATOMIC_RELAXED);
+            printf("  Direct reads: %lu opens, %lu reads (%.1f sectors each), %lu unaligned, %lu errors\n",
+                   (unsigned long)__atomic_load_n(&s_direct.opens, __ATOMIC_RELAXED),
+                   (unsigned long)reads, reads > 0 ? (double)sectors / reads : 0.0,
+                   (unsigned long)__atomic_load_n(&s_direct.unaligned, __ATOMIC_RELAXED),
+                   (unsigned long)__atomic_load_n(&s_direct.errors, __ATOMIC_RELAXED));
+#endif
 
             if (output_type == STATUS_OUTPUT_VERBOSE) {
                 printf("  Card name: %s\n", s_card->cid.name);
                 printf("  Sector size: %d bytes\n", s_card->csd.sector_size);
+#if SD_CARD_USE_SDMMC
+                printf("  SDMMC pins: CMD=%d, CLK=%d, D0=%d",
+                       CONFIG_SOUNDBOARD_SD_MOSI_GPIO,
+                       CONFIG_SOUNDBOARD_SD_CLK_GPIO,
+                       CONFIG_SOUNDBOARD_SD_MISO_GPIO);
+#if SD_CARD_BUS_WIDTH == 4
+                printf(", D1=%d, D2=%d, D3=%d", SD_CARD_D1_GPIO, SD_CARD_D2_GPIO,
+                       CONFIG_SOUNDBOARD_SD_CS_GPIO);
+#endif
+                printf("\n");
+#else
                 printf("  SPI frequency: %d kHz\n", SD_CARD_MAX_FREQ_KHZ);
                 printf("  SPI pins: MOSI=%d, MISO=%d, CLK=%d, CS=%d\n",
                        CONFIG_SOUNDBOARD_SD_MOSI_GPIO,
                        CONFIG_SOUNDBOARD_SD_MISO_GPIO,
                        CONFIG_SOUNDBOARD_SD_CLK_GPIO,
                        CONFIG_SOUNDBOARD_SD_CS_GPIO);
+#endif
             }
         } else {
             printf("  State: Not mounted\n");
@@ -11,16 +11,35 @@
 #include "soundboard.h"
 
 /**
- * @brief SD card SPI pin configuration
+ * @brief SD card pin configuration
+ *
+ * The interface (SPI, SDMMC 1-bit or 4-bit) is chosen in Kconfig
+ * (CONFIG_SOUNDBOARD_SD_INTERFACE). In SDMMC mode the SPI pins take their
+ * native SD roles: MOSI = CMD, MISO = D0, SCLK = CLK, CS = D3.
  */
 typedef struct {
     const char *mount_point; /*!< VFS mount point (e.g. "/sdcard") */
-    int mosi_io_num;    /*!< GPIO number for MOSI signal */
-    int miso_io_num;    /*!< GPIO number for MISO signal */
+    int mosi_io_num;    /*!< GPIO number for MOSI signal (SDMMC CMD) */
+    int miso_io_num;    /*!< GPIO number for MISO signal (SDMMC D0) */
     int sclk_io_num;    /*!< GPIO number for SCLK signal */
-    int cs_io_num;      /*!< GPIO number for CS signal */
+    int cs_io_num;      /*!< GPIO number for CS signal (SDMMC D3) */
+    int d1_io_num;      /*!< GPIO number for SDMMC D1 (4-bit mode only, -1 otherwise) */
+    int d2_io_num;      /*!< GPIO number for SDMMC D2 (4-bit mode only, -1 otherwise) */
 } sd_card_spi_config_t;
 
+#ifdef CONFIG_SOUNDBOARD_SD_DIRECT_READ
+    // to guard sd_card_file_*() calls in other modules with #ifdef
+    #define SD_CARD_DIRECT_READ_ENABLE
+#endif
+
+#ifdef CONFIG_SOUNDBOARD_SD_INTERFACE_SDMMC_4BIT
+    #define SD_CARD_D1_GPIO CONFIG_SOUNDBOARD_SD_D1_GPIO
+    #define SD_CARD_D2_GPIO CONFIG_SOUNDBOARD_SD_D2_GPIO
+#else
+    #define SD_CARD_D1_GPIO -1
+    #define SD_CARD_D2_GPIO -1
+#endif
+
 /**
  * @brief Default SD card SPI configuration macro
  *
@@ -39,14 +58,17 @@ typedef struct {
     .miso_io_num = CONFIG_SOUNDBOARD_SD_MISO_GPIO, \
     .sclk_io_num = CONFIG_SOUNDBOARD_SD_CLK_GPIO, \
     .cs_io_num = CONFIG_SOUNDBOARD_SD_CS_GPIO, \
+    .d1_io_num = SD_CARD_D1_GPIO, \
+    .d2_io_num = SD_CARD_D2_GPIO, \
 }
 
 
 /**
- * @brief Initialize SD card with SPI interface
+ * @brief Initialize SD card with the configured interface
  *
- * This function initializes the SPI bus, mounts the FAT filesystem on the SD card,
- * and makes it accessible via VFS at the configured mount point.
+ * This function initializes the SPI bus or the SDMMC host, mounts the FAT
+ * filesystem on the SD card, and makes it accessible via VFS at the
+ * configured mount point.
  *
  * @param[in] config SPI pin configuration for SD card
  * @param[out] out_card Pointer to store SD card information (must not be NULL)
@@ -60,7 +82,7 @@ typedef struct {
 esp_err_t sd_card_init(const sd_card_spi_config_t *config, sdmmc_card_t **out_card);
 
 /**
- * @brief Unmount SD card and deinitialize SPI bus
+ * @brief Unmount SD card and deinitialize SPI bus / SDMMC host
  *
  * @param[in] card SD card handle obtained from sd_card_init()
  *
@@ -85,6 +107,65 @@ esp_err_t sd_card_deinit(sdmmc_card_t *card);
  */
 esp_err_t sd_card_erase_all(const char *mount_point);
 
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+
+/**
+ * @brief File on the SD card read directly through FatFS (no stdio)
+ *
+ * Reads are served from a DMA-capable internal buffer that always starts on
+ * a sector boundary: an unaligned position (the PCM data of a plain WAV
+ * starts at byte 44) costs one partial sector, read once, and every buffer
+ * fill after it is one multi-sector f_read(). Reads of whole sectors at an
+ * aligned position into a DMA-capable destination skip the buffer.
+ *
+ * A handle is used by one task at a time (FatFS serializes the volume).
+ */
+typedef struct sd_card_file_s sd_card_file_t;
+
+/**
+ * @brief Open a file of the mounted SD card for direct reads
+ *
+ * @param path VFS path (under the mount point passed to sd_card_init())
+ * @param[out] out_file Handle positioned at offset 0
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_NOT_SUPPORTED if the path is not on the mounted SD card (use stdio)
+ *      - ESP_ERR_NOT_FOUND if the file cannot be opened
+ *      - ESP_ERR_NO_MEM if the read buffer cannot be allocated
+ */
+esp_err_t sd_card_file_open(const char *path, sd_card_file_t **out_file);
+
+/**
+ * @brief Size of the file in bytes
+ */
+uint32_t sd_card_file_size(const sd_card_file_t *file);
+
+/**
+ * @brief Set the read position (no I/O: the next read fills the buffer if needed)
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG past the end of the file
+ */
+esp_err_t sd_card_file_seek(sd_card_file_t *file, uint32_t offset);
+
+/**
+ * @brief Read bytes at the current position
+ *
+ * @return Bytes stored in dst (less than len at end of file or on error)
+ */
+size_t sd_card_file_read(sd_card_file_t *file, void *dst, size_t len);
+
+/**
+ * @brief true once the read position reached the end of the file
+ */
+bool sd_card_file_eof(const sd_card_file_t *file);
+
+/**
+ * @brief Close the file and free its buffer (NULL accepted)
+ */
+void sd_card_file_close(sd_card_file_t *file);
+
+#endif // SD_CARD_DIRECT_READ_ENABLE
+
 /**
  * @brief Print SD card status information to console
  *
@@ -0,0 +1,237 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "latency.h"
+#include "freertos/FreeRTOS.h"  // IWYU pragma: keep
+#include "freertos/task.h"
+#include "soundboard.h"
+#include <stdio.h>
+#include <string.h>
+
+// Log-linear buckets: values below 2^SUB_BITS us are exact, then each power
+// of two is split into 2^SUB_BITS buckets (<= 25% relative error). Values up
+// to 2^22 us (~4 s) are bucketed, larger ones land in the last bucket.
+#define LATENCY_SUB_BITS        2
+#define LATENCY_SUB_BUCKETS     (1u << LATENCY_SUB_BITS)
+#define LATENCY_MAX_MSB         21
+#define LATENCY_BUCKETS         ((LATENCY_MAX_MSB - LATENCY_SUB_BITS + 2) * LATENCY_SUB_BUCKETS)
+
+/**
+ * @brief Aggregated stages (intervals between two marks)
+ */
+typedef enum {
+    STAGE_DEBOUNCE,     // edge -> debounce decision
+    STAGE_DISPATCH,     // debounce decision -> mapper
+    STAGE_MAPPER,       // mapper -> enqueue
+    STAGE_QUEUE,        // enqueue -> dequeue
+    STAGE_OPEN,         // dequeue -> stream open
+    STAGE_FIRST_WRITE,  // stream open -> first I2S write returned
+    STAGE_PLAY,         // enqueue -> first I2S write (all triggers)
+    STAGE_TOTAL,        // edge -> first I2S write (button triggers)
+    STAGE_COUNT
+} latency_stage_t;
+
+static const struct {
+    const char *name;
+    latency_mark_t from, to;
+} stages[STAGE_COUNT] = {
+    [STAGE_DEBOUNCE]    = { "debounce",    LATENCY_MARK_EDGE,     LATENCY_MARK_DEBOUNCE },
+    [STAGE_DISPATCH]    = { "dispatch",    LATENCY_MARK_DEBOUNCE, LATENCY_MARK_MAPPER },
+    [STAGE_MAPPER]      = { "mapper",      LATENCY_MARK_MAPPER,   LATENCY_MARK_ENQUEUE },
+    [STAGE_QUEUE]       = { "queue",       LATENCY_MARK_ENQUEUE,  LATENCY_MARK_DEQUEUE },
+    [STAGE_OPEN]        = { "open",        LATENCY_MARK_DEQUEUE,  LATENCY_MARK_OPEN },
+    [STAGE_FIRST_WRITE] = { "first_write", LATENCY_MARK_OPEN,     LATENCY_MARK_FIRST_WRITE },
+    [STAGE_PLAY]        = { "play",        LATENCY_MARK_ENQUEUE,  LATENCY_MARK_FIRST_WRITE },
+    [STAGE_TOTAL]       = { "total",       LATENCY_MARK_EDGE,     LATENCY_MARK_FIRST_WRITE },
+};
+
+/**
+ * @brief One stage histogram
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[LATENCY_BUCKETS];
+} latency_histogram_t;
+
+enum { CLASS_HIT, CLASS_MISS, CLASS_COUNT };
+static const char *class_names[CLASS_COUNT] = { "hit", "miss" };
+
+static latency_histogram_t s_histograms[CLASS_COUNT][STAGE_COUNT];
+
+// Pending trigger of the input scanner task (written and consumed by that task)
+static struct {
+    TaskHandle_t task;
+    latency_trace_t trace;
+} s_pending;
+
+static uint32_t bucket_index(uint32_t us)
+{
+    if (us < LATENCY_SUB_BUCKETS) {
+        return us;
+    }
+    uint32_t msb = 31 - (uint32_t)__builtin_clz(us);
+    if (msb > LATENCY_MAX_MSB) {
+        return LATENCY_BUCKETS - 1;
+    }
+    uint32_t sub = (us >> (msb - LATENCY_SUB_BITS)) & (LATENCY_SUB_BUCKETS - 1);
+    return (msb - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS + sub;
+}
+
+// Largest value of a bucket (percentiles are reported conservatively)
+static uint32_t bucket_upper(uint32_t index)
+{
+    if (index < LATENCY_SUB_BUCKETS) {
+        return index;
+    }
+    uint32_t group = index / LATENCY_SUB_BUCKETS;
+    uint32_t sub = index % LATENCY_SUB_BUCKETS;
+    uint32_t width = 1u << (group - 1);
+    return (LATENCY_SUB_BUCKETS + sub) * width + width - 1;
+}
+
+static uint32_t histogram_percentile(const latency_histogram_t *h, uint32_t permille)
+{
+    uint64_t rank = ((uint64_t)h->count * permille + 999) / 1000;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint32_t upper = bucket_upper(i);
+            return upper < h->max_us ? upper : h->max_us;
+        }
+    }
+    return h->max_us;
+}
+
+static void histogram_add(latency_histogram_t *h, int64_t us)
+{
+    uint32_t v = (us < 0) ? 0 : (us > UINT32_MAX ? UINT32_MAX : (uint32_t)us);
+    h->buckets[bucket_index(v)]++;
+    h->count++;
+    h->sum_us += v;
+    if (v > h->max_us) {
+        h->max_us = v;
+    }
+}
+
+void latency_trigger_begin(int64_t edge_us, int64_t now_us)
+{
+    memset(&s_pending.trace, 0, sizeof(s_pending.trace));
+    s_pending.trace.t_us[LATENCY_MARK_EDGE] = edge_us;
+    s_pending.trace.t_us[LATENCY_MARK_DEBOUNCE] = now_us;
+    s_pending.task = xTaskGetCurrentTaskHandle();
+}
+
+void latency_trigger_mark(latency_mark_t mark)
+{
+    if (s_pending.task != NULL && s_pending.task == xTaskGetCurrentTaskHandle()) {
+        latency_trace_mark(&s_pending.trace, mark);
+    }
+}
+
+void latency_trace_start(latency_trace_t *trace)
+{
+    if (s_pending.task != NULL && s_pending.task == xTaskGetCurrentTaskHandle()) {
+        *trace = s_pending.trace;
+        s_pending.task = NULL;
+    } else {
+        memset(trace, 0, sizeof(*trace));
+    }
+    latency_trace_mark(trace, LATENCY_MARK_ENQUEUE);
+}
+
+void latency_record(const latency_trace_t *trace, bool cache_hit)
+{
+    latency_histogram_t *hist = s_histograms[cache_hit ? CLASS_HIT : CLASS_MISS];
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        int64_t from = trace->t_us[stages[s].from];
+        int64_t to = trace->t_us[stages[s].to];
+        if (from == 0 || to == 0) {
+            continue;
+        }
+        histogram_add(&hist[s], to - from);
+    }
+}
+
+void latency_reset(void)
+{
+    memset(s_histograms, 0, sizeof(s_histograms));
+}
+
+static void print_stage(int cls, int stage)
+{
+    const latency_histogram_t *h = &s_histograms[cls][stage];
+    if (h->count == 0) {
+        return;
+    }
+    printf("    %-4s %-11s %6lu %8lu %8lu %8lu %8lu %8lu\n",
+           class_names[cls], stages[stage].name, (unsigned long)h->count,
+           (unsigned long)(h->sum_us / h->count),
+           (unsigned long)histogram_percentile(h, 500),
+           (unsigned long)histogram_percentile(h, 950),
+           (unsigned long)histogram_percentile(h, 990),
+           (unsigned long)h->max_us);
+}
+
+void latency_print_status(status_output_type_t output_type)
+{
+    if (output_type == STATUS_OUTPUT_COMPACT) {
+        printf("[latency]");
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            const latency_histogram_t *h = &s_histograms[c][STAGE_TOTAL];
+            if (h->count == 0) {
+                h = &s_histograms[c][STAGE_PLAY];
+            }
+            if (h->count == 0) {
+                printf(" %s=no data", class_names[c]);
+                continue;
+            }
+            printf(" %s=p50 %lu/p99 %lu us", class_names[c],
+                   (unsigned long)histogram_percentile(h, 500),
+                   (unsigned long)histogram_percentile(h, 990));
+        }
+        printf("\n");
+        return;
+    }
+
+    printf("Latency Status:\n");
+    bool any = false;
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        any |= s_histograms[c][STAGE_PLAY].count > 0;
+    }
+    if (!any) {
+        printf("  No play traced yet\n");
+        return;
+    }
+
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        for (int s = STAGE_PLAY; s <= STAGE_TOTAL; s++) {
+            const latency_histogram_t *h = &s_histograms[c][s];
+            if (h->count == 0) {
+                continue;
+            }
+            printf("  %s %s: p50 %lu us, p95 %lu us, p99 %lu us, max %lu us (%lu plays)\n",
+                   class_names[c], s == STAGE_TOTAL ? "press to sound" : "enqueue to sound",
+                   (unsigned long)histogram_percentile(h, 500),
+                   (unsigned long)histogram_percentile(h, 950),
+                   (unsigned long)histogram_percentile(h, 990),
+                   (unsigned long)h->max_us, (unsigned long)h->count);
+        }
+    }
+
+    if (output_type >= STATUS_OUTPUT_VERBOSE) {
+        printf("  Stages (us, percentiles are bucket upper bounds, <= 25%% over):\n");
+        printf("    %-4s %-11s %6s %8s %8s %8s %8s %8s\n",
+               "src", "stage", "count", "mean", "p50", "p95", "p99", "max");
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            for (int s = 0; s < STAGE_COUNT; s++) {
+                print_stage(c, s);
+            }
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file latency.h
+ * @brief Press-to-sound latency instrumentation — global API
+ *
+ * A trace follows one play trigger through the pipeline:
+ *   button edge seen -> debounce decision -> mapper_on_input_event()
+ *   -> player_play() enqueue -> cmd_play() dequeue -> stream open
+ *   -> first i2s_channel_write() carrying the sound (returned)
+ *
+ * The first three marks are taken in the input scanner task, which calls the
+ * mapper and player_play() synchronously: latency_trigger_begin() opens a
+ * pending trigger for the calling task and player_play() moves it into the
+ * play command. Plays without a button press (console, startup sound) are
+ * traced from the enqueue on. Completed traces are aggregated into per-stage
+ * log-linear histograms, split by cache hit vs miss.
+ *
+ * All state is module-internal. Counters are written by the player task and
+ * read without locking (values may be one trace apart).
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_timer.h"
+#include "soundboard.h"
+
+// to guard latency_*() calls in other modules with #ifdef
+#define LATENCY_STATS_ENABLE
+
+/**
+ * @brief Timestamps of a trace
+ */
+typedef enum {
+    LATENCY_MARK_EDGE,          /**< First scan that saw the button change */
+    LATENCY_MARK_DEBOUNCE,      /**< Debounce decision (event emitted) */
+    LATENCY_MARK_MAPPER,        /**< mapper_on_input_event() entered */
+    LATENCY_MARK_ENQUEUE,       /**< Play command queued by player_play() */
+    LATENCY_MARK_DEQUEUE,       /**< Play command received by the player task */
+    LATENCY_MARK_OPEN,          /**< Stream opened */
+    LATENCY_MARK_FIRST_WRITE,   /**< First I2S write with samples of the sound returned */
+    LATENCY_MARK_COUNT
+} latency_mark_t;
+
+/**
+ * @brief One traced play trigger (0 = mark not taken)
+ */
+typedef struct {
+    int64_t t_us[LATENCY_MARK_COUNT];
+} latency_trace_t;
+
+/**
+ * @brief Open the pending trigger of the calling task (input scanner)
+ *
+ * @param edge_us  Time the button change was first seen (0 for events without
+ *                 debounce, e.g. long press: no debounce / total stage)
+ * @param now_us   Debounce decision time
+ */
+void latency_trigger_begin(int64_t edge_us, int64_t now_us);
+
+/**
+ * @brief Stamp a mark of the calling task's pending trigger (no-op if none)
+ */
+void latency_trigger_mark(latency_mark_t mark);
+
+/**
+ * @brief Start the trace of a play command
+ *
+ * Moves the calling task's pending trigger (if any) into trace, then stamps
+ * LATENCY_MARK_ENQUEUE. The pending trigger is consumed: one press traces
+ * the first sound it starts.
+ *
+ * @param[out] trace Trace carried by the play command
+ */
+void latency_trace_start(latency_trace_t *trace);
+
+/**
+ * @brief Stamp a mark of a trace with the current time
+ */
+static inline void latency_trace_mark(latency_trace_t *trace, latency_mark_t mark)
+{
+    trace->t_us[mark] = esp_timer_get_time();
+}
+
+/**
+ * @brief Aggregate a completed trace (LATENCY_MARK_FIRST_WRITE stamped)
+ *
+ * @param trace     Completed trace
+ * @param cache_hit true if the stream was served by the PSRAM cache
+ */
+void latency_record(const latency_trace_t *trace, bool cache_hit);
+
+/**
+ * @brief Clear all histograms
+ */
+void latency_reset(void);
+
+/**
+ * @brief Print latency statistics to console
+ *
+ * COMPACT and NORMAL print the press-to-sound totals, VERBOSE adds the
+ * per-stage p50/p95/p99/max table.
+ *
+ * @param output_type Output verbosity level
+ */
+void latency_print_status(status_output_type_t output_type);
@@ -15,6 +15,8 @@
 #include "esp_log_level.h"
 #include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"   // IWYU pragma: keep
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
 #include "esp_spiffs.h"
 #include "nvs_flash.h"
@@ -26,6 +28,10 @@
 #include "console.h"
 #include "esp_timer.h"
 
+#ifdef CONFIG_SOUNDBOARD_TRACE_ENABLE
+    #include "trace.h"
+#endif
+
 
 static const char *TAG = "soundboard";
 
@@ -45,6 +51,61 @@ const char *const SDCARD_MAPPINGS_PATH = SDCARD_MOUNT_POINT "/" SDCARD_MAPPINGS_
 static app_state_t s_app_state = {0};
 
 
+/* ============================================================================
+ * Boot Phases
+ * ============================================================================ */
+
+/** Boot phase task parameters (one short-lived task per phase) */
+#define BOOT_TASK_STACK_SIZE 4096
+#define BOOT_TASK_PRIORITY   1    // Same as app_main
+
+/**
+ * @brief Boot phases, run concurrently as soon as their dependencies are done
+ */
+typedef enum {
+    BOOT_PHASE_DISPLAY,
+    BOOT_PHASE_SPIFFS,
+    BOOT_PHASE_NVS,
+    BOOT_PHASE_SDCARD,
+    BOOT_PHASE_MSC,
+    BOOT_PHASE_PLAYER,
+    BOOT_PHASE_STARTUP_SOUND,
+    BOOT_PHASE_MAPPER,
+    BOOT_PHASE_INPUT,
+    BOOT_PHASE_COUNT,
+} boot_phase_id_t;
+
+#define BOOT_BIT(phase)   ((EventBits_t)1 << (phase))
+#define BOOT_ALL_BITS     (BOOT_BIT(BOOT_PHASE_COUNT) - 1)
+#define BOOT_FAILED_BIT   BOOT_BIT(BOOT_PHASE_COUNT)  // A fatal phase failed
+
+typedef struct {
+    const char *name;
+    esp_err_t (*run)(void);
+    EventBits_t deps;            // BOOT_BIT() of phases that must be done first
+    BaseType_t core;
+    const char *fatal_msg;       // NULL: non-fatal
+} boot_phase_t;
+
+/**
+ * @brief Measured timeline of one boot phase (us since boot)
+ */
+typedef struct {
+    int64_t start_us;
+    int64_t end_us;
+    esp_err_t result;
+    bool skipped;                // Not run: a fatal phase failed before
+} boot_timing_t;
+
+static EventGroupHandle_t s_boot_events;
+static boot_timing_t s_boot_timing[BOOT_PHASE_COUNT];
+static int64_t s_boot_ready_us;
+static TaskHandle_t s_main_task;
+
+// VFS registration is not thread-safe: SPIFFS and SD card mounts take turns
+static SemaphoreHandle_t s_vfs_mutex;
+
+
 /* ============================================================================
  * Log Level Configuration
  * ============================================================================ */
@@ -208,16 +269,21 @@ static void player_event_callback(const player_event_data_t *event, void *user_c
         return;
     }
 
+    // Events of the startup sound (played during boot) are dropped silently
     if (s_app_state.mode != APP_MODE_PLAYER) {
-        ESP_LOGW(TAG, "Player event ignored (not in PLAYER mode)");
+        if (s_app_state.mode != APP_MODE_NONE) {
+            ESP_LOGW(TAG, "Player event ignored (not in PLAYER mode)");
+        }
         return;
     }
 
     switch (event->name) {
         case PLAYER_EVENT_STARTED:
-            ESP_LOGD(TAG, "Playback started: %s", event->filename ? event->filename : "(unknown)");
-            if (event->filename != NULL) {
-                display_on_playing(oled, event->filename, 0);
+            ESP_LOGD(TAG, "Playback started: %s (sound %u)",
+                     event->playback.filename ? event->playback.filename : "(unknown)",
+                     (unsigned)event->playback.sound_id);
+            if (event->playback.filename != NULL) {
+                display_on_playing(oled, event->playback.filename, 0);
             }
             break;
 
@@ -497,7 +563,7 @@ static esp_err_t init_msc(msc_handle_t *msc)
     ESP_LOGI(TAG, "Initializing MSC module...");
 
     msc_config_t config = {
-        .main_task = xTaskGetCurrentTaskHandle(),
+        .main_task = s_main_task,
         .event_cb = msc_event_callback,
         .event_cb_ctx = NULL,
     };
@@ -525,6 +591,183 @@ static void init_console(const app_state_t *app_state)
 }
 
 
+/**
+ * @brief Play the SPIFFS startup sound (no SD card needed)
+ * @note NON-FATAL - boot continues silently
+ */
+static esp_err_t play_startup_sound(player_handle_t player)
+{
+#ifdef CONFIG_SOUNDBOARD_STARTUP_SOUND
+    const char *path = SPIFFS_MOUNT_POINT "/" CONFIG_SOUNDBOARD_STARTUP_SOUND_FILE;
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        ESP_LOGW(TAG, "Startup sound not found: %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    return player_play(player, path);
+#else
+    (void)player;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+// Phase adapters: one signature for the boot table, results into s_app_state
+
+static esp_err_t boot_display(void)
+{
+    return init_display(&s_app_state.oled);
+}
+
+static esp_err_t boot_spiffs(void)
+{
+    xSemaphoreTake(s_vfs_mutex, portMAX_DELAY);
+    esp_err_t ret = init_spiffs();
+    xSemaphoreGive(s_vfs_mutex);
+    return ret;
+}
+
+static esp_err_t boot_nvs(void)
+{
+    return init_nvs();
+}
+
+static esp_err_t boot_sdcard(void)
+{
+    xSemaphoreTake(s_vfs_mutex, portMAX_DELAY);
+    esp_err_t ret = init_sd_card(&s_app_state.sdcard);
+    xSemaphoreGive(s_vfs_mutex);
+    return ret;
+}
+
+static esp_err_t boot_msc(void)
+{
+    return init_msc(&s_app_state.msc);
+}
+
+static esp_err_t boot_player(void)
+{
+    return init_player(&s_app_state.player);
+}
+
+static esp_err_t boot_startup_sound(void)
+{
+    return play_startup_sound(s_app_state.player);
+}
+
+static esp_err_t boot_mapper(void)
+{
+    return init_mapper(s_app_state.player, &s_app_state.mapper, &s_app_state.config_source);
+}
+
+static esp_err_t boot_input(void)
+{
+    // Events are dropped until APP_MODE_PLAYER is set (input_scanner_callback)
+    return init_input_scanner(s_app_state.mapper, &s_app_state.input_scanner);
+}
+
+/**
+ * @brief Boot dependency graph
+ *
+ * Only real dependencies: the player loads its volume from NVS, the startup
+ * sound lives in SPIFFS, the mapper reads mappings from SPIFFS and the SD
+ * card and preloads through the player. Core 0 takes the SPI/USB/I2C bring-up,
+ * core 1 the flash and audio side.
+ */
+static const boot_phase_t s_boot_phases[BOOT_PHASE_COUNT] = {
+    [BOOT_PHASE_DISPLAY] = { "display", boot_display, 0, 0, NULL },
+    [BOOT_PHASE_SPIFFS]  = { "spiffs", boot_spiffs, 0, 1, "SPIFFS required for fallback config" },
+    [BOOT_PHASE_NVS]     = { "nvs", boot_nvs, 0, 1, "NVS required for volume persistence" },
+    [BOOT_PHASE_SDCARD]  = { "sdcard", boot_sdcard, 0, 0, NULL },
+    [BOOT_PHASE_MSC]     = { "msc", boot_msc, 0, 0, NULL },
+    [BOOT_PHASE_PLAYER]  = { "player", boot_player, BOOT_BIT(BOOT_PHASE_NVS), 1,
+                             "Player required for audio playback" },
+    [BOOT_PHASE_STARTUP_SOUND] = { "startup_sound", boot_startup_sound,
+                                   BOOT_BIT(BOOT_PHASE_PLAYER) | BOOT_BIT(BOOT_PHASE_SPIFFS), 1, NULL },
+    [BOOT_PHASE_MAPPER]  = { "mapper", boot_mapper,
+                             BOOT_BIT(BOOT_PHASE_SPIFFS) | BOOT_BIT(BOOT_PHASE_SDCARD) | BOOT_BIT(BOOT_PHASE_PLAYER),
+                             0, "Mapper required for button mappings" },
+    [BOOT_PHASE_INPUT]   = { "input", boot_input, 0, 1, "Input scanner required for user interaction" },
+};
+
+/**
+ * @brief Wait for the dependencies of a phase, run it and publish its bit
+ */
+static void boot_run_phase(const boot_phase_t *phase)
+{
+    boot_phase_id_t id = (boot_phase_id_t)(phase - s_boot_phases);
+    boot_timing_t *timing = &s_boot_timing[id];
+
+    if (phase->deps != 0) {
+        xEventGroupWaitBits(s_boot_events, phase->deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+
+    if (xEventGroupGetBits(s_boot_events) & BOOT_FAILED_BIT) {
+        timing->skipped = true;
+        timing->result = ESP_ERR_INVALID_STATE;
+    } else {
+        timing->start_us = esp_timer_get_time();
+        timing->result = phase->run();
+        timing->end_us = esp_timer_get_time();
+        if (timing->result != ESP_OK && phase->fatal_msg != NULL) {
+            ESP_LOGE(TAG, "FATAL: %s", phase->fatal_msg);
+            xEventGroupSetBits(s_boot_events, BOOT_FAILED_BIT);
+        }
+    }
+
+    xEventGroupSetBits(s_boot_events, BOOT_BIT(id));
+}
+
+static void boot_phase_task(void *arg)
+{
+    boot_run_phase((const boot_phase_t *)arg);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Run all boot phases and wait for them
+ * @return ESP_OK, or ESP_FAIL if a fatal phase failed
+ */
+static esp_err_t run_boot_phases(void)
+{
+    s_boot_events = xEventGroupCreate();
+    s_vfs_mutex = xSemaphoreCreateMutex();
+    if (s_boot_events == NULL || s_vfs_mutex == NULL) {
+        ESP_LOGE(TAG, "FATAL: cannot allocate boot synchronization");
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        const boot_phase_t *phase = &s_boot_phases[i];
+        if (xTaskCreatePinnedToCore(boot_phase_task, phase->name, BOOT_TASK_STACK_SIZE, (void *)phase,
+                                    BOOT_TASK_PRIORITY, NULL, phase->core) != pdPASS) {
+            // Run inline: dependencies are satisfied in table order
+            ESP_LOGW(TAG, "Boot task '%s' not created, running inline", phase->name);
+            boot_run_phase(phase);
+        }
+    }
+
+    EventBits_t bits = xEventGroupWaitBits(s_boot_events, BOOT_ALL_BITS, pdFALSE, pdTRUE, portMAX_DELAY);
+    return (bits & BOOT_FAILED_BIT) ? ESP_FAIL : ESP_OK;
+}
+
+/**
+ * @brief Log the boot timeline (one line per phase)
+ */
+static void print_boot_timeline(void)
+{
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        const boot_timing_t *t = &s_boot_timing[i];
+        if (t->skipped) {
+            printf("    %-14s skipped\n", s_boot_phases[i].name);
+            continue;
+        }
+        printf("    %-14s core %d  %5lld -> %5lld ms (%4lld ms)%s%s\n",
+               s_boot_phases[i].name, (int)s_boot_phases[i].core,
+               t->start_us / 1000, t->end_us / 1000, (t->end_us - t->start_us) / 1000,
+               t->result == ESP_OK ? "" : "  ", t->result == ESP_OK ? "" : esp_err_to_name(t->result));
+    }
+}
+
 /* ============================================================================
  * console utility
  * ============================================================================ */
@@ -549,11 +792,16 @@ void app_print_status(status_output_type_t output_type)
     }
 
     if (output_type == STATUS_OUTPUT_COMPACT) {
-        printf("[app] mode=%s, config=%s\n", mode_str, config_src);
+        printf("[app] mode=%s, config=%s, boot=%lldms\n", mode_str, config_src, s_boot_ready_us / 1000);
     } else {
         printf("Application Status:\n");
         printf("  Mode: %s\n", mode_str);
         printf("  Config source: %s\n", config_src);
+        printf("  Boot: ready at %lld ms, startup sound at %lld ms\n", s_boot_ready_us / 1000,
+               s_boot_timing[BOOT_PHASE_STARTUP_SOUND].result == ESP_OK
+                   ? s_boot_timing[BOOT_PHASE_STARTUP_SOUND].end_us / 1000 : -1LL);
+        printf("  Boot timeline:\n");
+        print_boot_timeline();
 
         if (output_type == STATUS_OUTPUT_VERBOSE) {
             printf("  Uptime: %" PRId64 " s\n", esp_timer_get_time() / 1000000);
@@ -569,51 +817,31 @@ void app_main(void)
 {
     ESP_LOGI(TAG, "=== Soundboard Starting ===");
     set_loglevels();
-
-    // -------------------------------------------------------------------------
-    // Phase 1: Display (early init for startup screen)
-    // -------------------------------------------------------------------------
-    init_display(&s_app_state.oled);  // NON-FATAL
-
-    // -------------------------------------------------------------------------
-    // Phase 2: Storage subsystems
-    // -------------------------------------------------------------------------
-    if (init_spiffs() != ESP_OK) {
-        ESP_LOGE(TAG, "FATAL: SPIFFS required for fallback config");
-        return;
+#ifdef TRACE_ENABLE
+    // First, so the boot is traced (non-fatal: events are dropped without a ring)
+    if (trace_init(CONFIG_SOUNDBOARD_TRACE_BUFFER_KB) != ESP_OK) {
+        ESP_LOGW(TAG, "Event trace disabled");
     }
-
-    if (init_nvs() != ESP_OK) {
-        ESP_LOGE(TAG, "FATAL: NVS required for volume persistence");
-        return;
-    }
-
-    init_sd_card(&s_app_state.sdcard);  // NON-FATAL
-
-    // -------------------------------------------------------------------------
-    // Phase 3: USB subsystem
-    // -------------------------------------------------------------------------
-    init_msc(&s_app_state.msc);  // NON-FATAL
+#endif
 
     // -------------------------------------------------------------------------
-    // Phase 4: Audio subsystem
+    // Phases 1-5: display, storage, USB, audio and input, concurrently on
+    // both cores with only real dependencies enforced (see s_boot_phases)
     // -------------------------------------------------------------------------
-    if (init_player(&s_app_state.player) != ESP_OK) {
-        ESP_LOGE(TAG, "FATAL: Player required for audio playback");
+    s_main_task = xTaskGetCurrentTaskHandle();
+    if (run_boot_phases() != ESP_OK) {
+        print_boot_timeline();
         return;
     }
 
-    if (init_mapper(s_app_state.player, &s_app_state.mapper, &s_app_state.config_source) != ESP_OK) {
-        ESP_LOGE(TAG, "FATAL: Mapper required for button mappings");
-        return;
+    // PLAYER_EVENT_READY and MAPPER_EVENT_LOADED may have fired before the display was up
+    int volume_index;
+    if (player_volume_get(s_app_state.player, &volume_index) == ESP_OK) {
+        display_on_volume_changed(s_app_state.oled, volume_index);
     }
-
-    // -------------------------------------------------------------------------
-    // Phase 5: Input subsystem
-    // -------------------------------------------------------------------------
-    if (init_input_scanner(s_app_state.mapper, &s_app_state.input_scanner) != ESP_OK) {
-        ESP_LOGE(TAG, "FATAL: Input scanner required for user interaction");
-        return;
+    const char *page_id = mapper_get_current_page(s_app_state.mapper);
+    if (page_id != NULL) {
+        display_on_page_changed(s_app_state.oled, page_id);
     }
 
     // -------------------------------------------------------------------------
@@ -626,7 +854,9 @@ void app_main(void)
     // -------------------------------------------------------------------------
     display_show_idle(s_app_state.oled);
     app_set_mode(APP_MODE_PLAYER);
-    ESP_LOGI(TAG, "=== Soundboard Ready ===");
+    s_boot_ready_us = esp_timer_get_time();
+    ESP_LOGI(TAG, "=== Soundboard Ready (%lld ms) ===", s_boot_ready_us / 1000);
+    app_print_status(STATUS_OUTPUT_NORMAL);
 
     // -------------------------------------------------------------------------
     // Main event loop - wait for MSC notifications
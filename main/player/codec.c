@@ -0,0 +1,386 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file codec.c
+ * @brief mu-law (G.711) and IMA ADPCM encode/decode for the PSRAM cache,
+ *        WAV sample conversion to 16-bit PCM
+ */
+
+#include <string.h>
+#include "codec.h"
+#include "mixer.h"
+
+#define MULAW_BIAS          0x84
+#define MULAW_CLIP          32635
+
+#define ADPCM_HEADER_BYTES  4       // Per channel: int16 sample, uint8 index, 0
+#define ADPCM_GROUP_BYTES   4       // Per channel: 8 nibbles
+#define ADPCM_GROUP_SAMPLES 8
+#define ADPCM_MAX_INDEX     88
+
+static const int16_t adpcm_step_table[ADPCM_MAX_INDEX + 1] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+    34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143,
+    157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024,
+    3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t adpcm_index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+// ============================================================================
+// mu-law
+// ============================================================================
+
+static inline uint8_t mulaw_encode(int16_t pcm)
+{
+    int32_t s = pcm;
+    uint8_t sign = 0;
+    if (s < 0) {
+        sign = 0x80;
+        s = -s;
+    }
+    if (s > MULAW_CLIP) {
+        s = MULAW_CLIP;
+    }
+    s += MULAW_BIAS;
+
+    uint8_t exponent = 7;
+    for (int32_t mask = 0x4000; (s & mask) == 0 && exponent > 0; mask >>= 1) {
+        exponent--;
+    }
+    uint8_t mantissa = (uint8_t)((s >> (exponent + 3)) & 0x0F);
+    return (uint8_t)~(sign | (exponent << 4) | mantissa);
+}
+
+static inline int16_t mulaw_decode(uint8_t u)
+{
+    u = (uint8_t)~u;
+    int32_t s = ((((int32_t)u & 0x0F) << 3) + MULAW_BIAS) << ((u >> 4) & 0x07);
+    s -= MULAW_BIAS;
+    return (int16_t)((u & 0x80) ? -s : s);
+}
+
+// ============================================================================
+// IMA ADPCM
+// ============================================================================
+
+static inline size_t adpcm_block_align(uint16_t channels)
+{
+    return (size_t)CODEC_ADPCM_BLOCK_BYTES * channels;
+}
+
+// Frames per block: the header sample plus two nibbles per data byte
+static inline size_t adpcm_block_frames(void)
+{
+    return (CODEC_ADPCM_BLOCK_BYTES - ADPCM_HEADER_BYTES) * 2 + 1;
+}
+
+static inline int16_t adpcm_step(codec_adpcm_state_t *st, uint8_t nibble)
+{
+    int32_t step = adpcm_step_table[st->index];
+    int32_t delta = step >> 3;
+    if (nibble & 4) {
+        delta += step;
+    }
+    if (nibble & 2) {
+        delta += step >> 1;
+    }
+    if (nibble & 1) {
+        delta += step >> 2;
+    }
+
+    int32_t pred = st->predictor + ((nibble & 8) ? -delta : delta);
+    if (pred > INT16_MAX) {
+        pred = INT16_MAX;
+    } else if (pred < INT16_MIN) {
+        pred = INT16_MIN;
+    }
+    st->predictor = (int16_t)pred;
+
+    int32_t index = (int32_t)st->index + adpcm_index_table[nibble];
+    if (index < 0) {
+        index = 0;
+    } else if (index > ADPCM_MAX_INDEX) {
+        index = ADPCM_MAX_INDEX;
+    }
+    st->index = (uint8_t)index;
+    return st->predictor;
+}
+
+static inline uint8_t adpcm_encode_sample(codec_adpcm_state_t *st, int16_t sample)
+{
+    int32_t step = adpcm_step_table[st->index];
+    int32_t diff = (int32_t)sample - st->predictor;
+    uint8_t nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+    if (diff >= step) {
+        nibble |= 4;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        nibble |= 2;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        nibble |= 1;
+    }
+
+    // Same reconstruction as the decoder so both stay in lockstep
+    adpcm_step(st, nibble);
+    return nibble;
+}
+
+// Encode one block; frames past the end of src repeat the last frame
+static void adpcm_encode_block(codec_state_t *state, uint8_t *dst, const int16_t *src, size_t frames)
+{
+    uint16_t ch = state->channels;
+    size_t last = frames - 1;
+
+    for (uint16_t c = 0; c < ch; c++) {
+        codec_adpcm_state_t *st = &state->adpcm[c];
+        st->predictor = src[c];
+        uint8_t *hdr = dst + c * ADPCM_HEADER_BYTES;
+        hdr[0] = (uint8_t)(st->predictor & 0xFF);
+        hdr[1] = (uint8_t)((uint16_t)st->predictor >> 8);
+        hdr[2] = st->index;
+        hdr[3] = 0;
+    }
+
+    uint8_t *out = dst + ch * ADPCM_HEADER_BYTES;
+    size_t groups = (adpcm_block_frames() - 1) / ADPCM_GROUP_SAMPLES;
+    for (size_t g = 0; g < groups; g++) {
+        size_t first = 1 + g * ADPCM_GROUP_SAMPLES;
+        for (uint16_t c = 0; c < ch; c++) {
+            codec_adpcm_state_t *st = &state->adpcm[c];
+            for (size_t w = 0; w < ADPCM_GROUP_SAMPLES; w += 2) {
+                size_t f0 = first + w;
+                size_t f1 = f0 + 1;
+                int16_t s0 = src[(f0 < frames ? f0 : last) * ch + c];
+                int16_t s1 = src[(f1 < frames ? f1 : last) * ch + c];
+                uint8_t lo = adpcm_encode_sample(st, s0);
+                uint8_t hi = adpcm_encode_sample(st, s1);
+                *out++ = (uint8_t)(lo | (hi << 4));
+            }
+        }
+    }
+}
+
+static void adpcm_decode(codec_state_t *state, int16_t *dst, const uint8_t *data,
+                         size_t frame_pos, size_t frames)
+{
+    uint16_t ch = state->channels;
+    size_t block_align = adpcm_block_align(ch);
+    size_t block_frames = adpcm_block_frames();
+    size_t block = frame_pos / block_frames;
+    size_t k = frame_pos % block_frames;
+    const uint8_t *blk = data + block * block_align;
+
+    for (size_t f = 0; f < frames; f++) {
+        if (k == 0) {
+            for (uint16_t c = 0; c < ch; c++) {
+                const uint8_t *hdr = blk + c * ADPCM_HEADER_BYTES;
+                codec_adpcm_state_t *st = &state->adpcm[c];
+                st->predictor = (int16_t)(hdr[0] | (hdr[1] << 8));
+                st->index = hdr[2] > ADPCM_MAX_INDEX ? ADPCM_MAX_INDEX : hdr[2];
+                *dst++ = st->predictor;
+            }
+        } else {
+            size_t j = k - 1;
+            const uint8_t *group = blk + ch * ADPCM_HEADER_BYTES +
+                                   (j / ADPCM_GROUP_SAMPLES) * ch * ADPCM_GROUP_BYTES;
+            size_t w = j % ADPCM_GROUP_SAMPLES;
+            for (uint16_t c = 0; c < ch; c++) {
+                uint8_t byte = group[c * ADPCM_GROUP_BYTES + w / 2];
+                uint8_t nibble = (w & 1) ? (byte >> 4) : (byte & 0x0F);
+                *dst++ = adpcm_step(&state->adpcm[c], nibble);
+            }
+        }
+
+        if (++k == block_frames) {
+            k = 0;
+            blk += block_align;
+        }
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool codec_supports(audio_cache_format_t format, uint16_t channels)
+{
+    switch (format) {
+        case AUDIO_CACHE_FORMAT_PCM16:
+        case AUDIO_CACHE_FORMAT_MULAW:
+            return channels > 0;
+        case AUDIO_CACHE_FORMAT_IMA_ADPCM:
+            return channels > 0 && channels <= CODEC_ADPCM_MAX_CHANNELS;
+        default:
+            return false;
+    }
+}
+
+size_t codec_encoded_size(audio_cache_format_t format, uint32_t frames, uint16_t channels)
+{
+    switch (format) {
+        case AUDIO_CACHE_FORMAT_MULAW:
+            return (size_t)frames * channels;
+        case AUDIO_CACHE_FORMAT_IMA_ADPCM: {
+            size_t blocks = (frames + adpcm_block_frames() - 1) / adpcm_block_frames();
+            return blocks * adpcm_block_align(channels);
+        }
+        case AUDIO_CACHE_FORMAT_PCM16:
+        default:
+            return (size_t)frames * channels * sizeof(int16_t);
+    }
+}
+
+const char *codec_format_name(audio_cache_format_t format)
+{
+    switch (format) {
+        case AUDIO_CACHE_FORMAT_PCM16:      return "pcm16";
+        case AUDIO_CACHE_FORMAT_MULAW:      return "mulaw";
+        case AUDIO_CACHE_FORMAT_IMA_ADPCM:  return "ima_adpcm";
+        default:                            return "unknown";
+    }
+}
+
+void codec_state_init(codec_state_t *state, audio_cache_format_t format, uint16_t channels)
+{
+    memset(state, 0, sizeof(*state));
+    state->format = format;
+    state->channels = channels;
+}
+
+size_t codec_encode_chunk_frames(const codec_state_t *state, size_t max_frames)
+{
+    if (state->format == AUDIO_CACHE_FORMAT_IMA_ADPCM) {
+        return adpcm_block_frames() <= max_frames ? adpcm_block_frames() : 0;
+    }
+    return max_frames;
+}
+
+size_t codec_encode(codec_state_t *state, uint8_t *dst, const int16_t *src, size_t frames)
+{
+    size_t samples = frames * state->channels;
+
+    switch (state->format) {
+        case AUDIO_CACHE_FORMAT_MULAW:
+            for (size_t i = 0; i < samples; i++) {
+                dst[i] = mulaw_encode(src[i]);
+            }
+            return samples;
+        case AUDIO_CACHE_FORMAT_IMA_ADPCM:
+            if (frames == 0) {
+                return 0;
+            }
+            adpcm_encode_block(state, dst, src, frames);
+            return adpcm_block_align(state->channels);
+        case AUDIO_CACHE_FORMAT_PCM16:
+        default:
+            memcpy(dst, src, samples * sizeof(int16_t));
+            return samples * sizeof(int16_t);
+    }
+}
+
+void codec_decode(codec_state_t *state, int16_t *dst, const uint8_t *data,
+                  size_t frame_pos, size_t frames)
+{
+    switch (state->format) {
+        case AUDIO_CACHE_FORMAT_MULAW: {
+            const uint8_t *src = data + frame_pos * state->channels;
+            size_t samples = frames * state->channels;
+            for (size_t i = 0; i < samples; i++) {
+                dst[i] = mulaw_decode(src[i]);
+            }
+            break;
+        }
+        case AUDIO_CACHE_FORMAT_IMA_ADPCM:
+            adpcm_decode(state, dst, data, frame_pos, frames);
+            break;
+        case AUDIO_CACHE_FORMAT_PCM16:
+        default:
+            memcpy(dst, data + frame_pos * state->channels * sizeof(int16_t),
+                   frames * state->channels * sizeof(int16_t));
+            break;
+    }
+}
+
+// ============================================================================
+// WAV sample conversion
+// ============================================================================
+
+bool codec_pcm_supports(uint16_t bit_depth)
+{
+    return bit_depth == 16 || bit_depth == 24 || bit_depth == 32;
+}
+
+void codec_pcm_init(codec_pcm_t *pcm, const audio_info_t *src, bool downmix)
+{
+    pcm->channels = src->channels;
+    pcm->sample_bytes = src->bit_depth / 8;
+    pcm->out_channels = (downmix && src->channels == 2) ? 1 : src->channels;
+    pcm->dither = 0x9E3779B9u;
+}
+
+void codec_pcm_output_info(const codec_pcm_t *pcm, const audio_info_t *src, audio_info_t *dst)
+{
+    *dst = *src;
+    dst->channels = pcm->out_channels;
+    dst->bit_depth = 16;
+}
+
+/**
+ * @brief Convert frames of file bytes (narrowed in place) into dst
+ */
+static void pcm_convert(codec_pcm_t *pcm, int16_t *dst, uint8_t *src, size_t frames)
+{
+    int16_t *pcm16 = (int16_t *)src;
+    if (pcm->sample_bytes != sizeof(int16_t)) {
+        mixer_narrow_s16(pcm16, src, frames * pcm->channels, pcm->sample_bytes, &pcm->dither);
+    }
+    if (pcm->out_channels != pcm->channels) {
+        mixer_downmix_s16(dst, pcm16, frames);
+    } else {
+        memcpy(dst, pcm16, frames * codec_pcm_out_frame_bytes(pcm));
+    }
+}
+
+size_t codec_pcm_read(codec_pcm_t *pcm, FILE *fp, int16_t *dst, size_t frames,
+                      void *scratch, size_t scratch_size)
+{
+    size_t frame_bytes = codec_pcm_frame_bytes(pcm);
+    if (codec_pcm_passthrough(pcm)) {
+        return fread(dst, frame_bytes, frames, fp);
+    }
+
+    size_t chunk_frames = scratch_size / frame_bytes;
+    size_t done = 0;
+    while (done < frames && chunk_frames > 0) {
+        size_t n = frames - done;
+        if (n > chunk_frames) {
+            n = chunk_frames;
+        }
+        size_t got = fread(scratch, frame_bytes, n, fp);
+        pcm_convert(pcm, dst + done * pcm->out_channels, scratch, got);
+        done += got;
+        if (got != n) {
+            break;
+        }
+    }
+    return done;
+}
@@ -0,0 +1,194 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file codec.h
+ * @brief Compressed sample formats of the PSRAM cache (mu-law, IMA ADPCM),
+ *        and the conversion of WAV sample data to 16-bit PCM
+ *
+ * Encoding runs once per file at cache load (preload task) or bank build
+ * (MSC update); decoding runs in the player task for every cached chunk, so
+ * it is sequential and keeps its state across calls.
+ *
+ * Everything past the file reader is 16-bit PCM: 24-bit and 32-bit samples
+ * are reduced to 16 bits and, with downmix on, stereo is averaged to mono
+ * while reading (codec_pcm_read()).
+ *
+ * IMA ADPCM uses the Microsoft WAV (format 0x11) block layout with
+ * CODEC_ADPCM_BLOCK_BYTES per channel: each block starts with one header
+ * per channel (int16 first sample, uint8 step index, 0), followed by 4-byte
+ * groups of 8 nibbles per channel, interleaved, low nibble first.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "provider.h"
+
+#define CODEC_ADPCM_BLOCK_BYTES     512     // Block size per channel
+#define CODEC_ADPCM_MAX_CHANNELS    2
+#define CODEC_PCM_SCRATCH_ALIGN     16      // Scratch alignment for the SIMD downmix
+
+/**
+ * @brief Running IMA ADPCM state of one channel
+ */
+typedef struct {
+    int16_t predictor;
+    uint8_t index;
+} codec_adpcm_state_t;
+
+/**
+ * @brief Sequential encoder / decoder state of one sound
+ */
+typedef struct {
+    audio_cache_format_t format;
+    uint16_t channels;
+    codec_adpcm_state_t adpcm[CODEC_ADPCM_MAX_CHANNELS];
+} codec_state_t;
+
+/**
+ * @brief Conversion of the WAV sample data of one file to 16-bit PCM
+ */
+typedef struct {
+    uint16_t channels;       // Channels in the file
+    uint16_t sample_bytes;   // Bytes per sample in the file (2, 3 or 4)
+    uint16_t out_channels;   // Channels handed out (1 when stereo is downmixed)
+    uint32_t dither;         // TPDF dither generator state (24/32-bit sources)
+} codec_pcm_t;
+
+/**
+ * @brief true if format can store audio with this channel count
+ */
+bool codec_supports(audio_cache_format_t format, uint16_t channels);
+
+/**
+ * @brief Encoded size in bytes of frames 16-bit PCM frames
+ */
+size_t codec_encoded_size(audio_cache_format_t format, uint32_t frames, uint16_t channels);
+
+/**
+ * @brief Short format name for logs and status output
+ */
+const char *codec_format_name(audio_cache_format_t format);
+
+/**
+ * @brief Reset a state to the start of a sound
+ */
+void codec_state_init(codec_state_t *state, audio_cache_format_t format, uint16_t channels);
+
+/**
+ * @brief Frames to pass per codec_encode() call
+ *
+ * One ADPCM block, or max_frames for sample-wise formats. Callers feed the
+ * PCM in chunks of exactly this many frames (only the last one may be
+ * shorter) so that ADPCM blocks line up.
+ *
+ * @param state Encoder state
+ * @param max_frames Frames that fit in the caller's staging buffer
+ * @return Frames per call, 0 if one ADPCM block does not fit in max_frames
+ */
+size_t codec_encode_chunk_frames(const codec_state_t *state, size_t max_frames);
+
+/**
+ * @brief Encode the next chunk of interleaved 16-bit PCM
+ *
+ * @param state Encoder state (advanced)
+ * @param dst Output, at least codec_encoded_size(frames) bytes
+ * @param src Interleaved PCM
+ * @param frames Frames in src (see codec_encode_chunk_frames())
+ * @return Bytes written to dst
+ */
+size_t codec_encode(codec_state_t *state, uint8_t *dst, const int16_t *src, size_t frames);
+
+/**
+ * @brief Decode frames starting at frame_pos into interleaved 16-bit PCM
+ *
+ * Decoding is sequential: frame_pos must follow the previous call on the
+ * same state (first call at frame 0).
+ *
+ * @param state Decoder state (advanced)
+ * @param dst Output samples (frames * channels)
+ * @param data Encoded sound (start of the cache entry)
+ * @param frame_pos First frame to decode
+ * @param frames Frames to decode
+ */
+void codec_decode(codec_state_t *state, int16_t *dst, const uint8_t *data,
+                  size_t frame_pos, size_t frames);
+
+/**
+ * @brief true if WAV samples of this bit depth can be read (16, 24 or 32 bits)
+ */
+bool codec_pcm_supports(uint16_t bit_depth);
+
+/**
+ * @brief Set up the conversion of a file
+ *
+ * @param pcm Conversion state
+ * @param src Format of the file (from the WAV header)
+ * @param downmix Average stereo files to mono
+ */
+void codec_pcm_init(codec_pcm_t *pcm, const audio_info_t *src, bool downmix);
+
+/**
+ * @brief Format handed out for a file: 16 bits, downmixed channel count, same rate and length
+ */
+void codec_pcm_output_info(const codec_pcm_t *pcm, const audio_info_t *src, audio_info_t *dst);
+
+/**
+ * @brief true if the file already holds the output format (read straight into the destination)
+ */
+static inline bool codec_pcm_passthrough(const codec_pcm_t *pcm)
+{
+    return pcm->sample_bytes == sizeof(int16_t) && pcm->out_channels == pcm->channels;
+}
+
+/**
+ * @brief Bytes of one frame in the file
+ */
+static inline size_t codec_pcm_frame_bytes(const codec_pcm_t *pcm)
+{
+    return (size_t)pcm->channels * pcm->sample_bytes;
+}
+
+/**
+ * @brief Bytes of one output frame
+ */
+static inline size_t codec_pcm_out_frame_bytes(const codec_pcm_t *pcm)
+{
+    return (size_t)pcm->out_channels * sizeof(int16_t);
+}
+
+/**
+ * @brief File bytes behind out_bytes of output PCM (whole output frames unless passthrough)
+ */
+static inline uint32_t codec_pcm_file_bytes(const codec_pcm_t *pcm, uint32_t out_bytes)
+{
+    if (codec_pcm_passthrough(pcm)) {
+        return out_bytes;
+    }
+    return (uint32_t)(out_bytes / codec_pcm_out_frame_bytes(pcm) * codec_pcm_frame_bytes(pcm));
+}
+
+/**
+ * @brief Read frames from a file positioned in its PCM data, converted to 16-bit PCM
+ *
+ * Passthrough files are read straight into dst. Others are read into
+ * scratch, at most scratch_size bytes at a time, and converted into dst.
+ *
+ * @param pcm Conversion state (dither advanced)
+ * @param fp File positioned on a frame boundary of the PCM data
+ * @param dst Output, frames * out_channels samples
+ * @param frames Frames to read
+ * @param scratch File bytes staging (not used for passthrough files, may then be NULL),
+ *                CODEC_PCM_SCRATCH_ALIGN aligned for the SIMD downmix
+ * @param scratch_size Scratch size, at least one file frame
+ * @return Frames read (less than frames at end of file or on error)
+ */
+size_t codec_pcm_read(codec_pcm_t *pcm, FILE *fp, int16_t *dst, size_t frames,
+                      void *scratch, size_t scratch_size);
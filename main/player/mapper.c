@@ -5,14 +5,49 @@
  */
 
 #include <ctype.h>    // for isspace()
+#include <inttypes.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include "mapper.h"
 #include "player.h"
+#include "sound_bank.h"
+#include "sound_index.h"
 #include "esp_log.h"
 #include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+#ifdef CONFIG_SOUNDBOARD_LATENCY_STATS_ENABLE
+    #include "latency.h"
+#endif
+#ifdef CONFIG_SOUNDBOARD_TRACE_ENABLE
+    #include "trace.h"
+#endif
 
 static const char *TAG = "mapper";
 
+#define MAPPER_BUTTON_COUNT     12                                  // Matrix buttons (1-12)
+#define MAPPER_EVENT_COUNT      (INPUT_EVENT_BUTTON_RELEASE + 1)    // Button events per button
+#define MAPPER_PAGE_SOUNDS_MAX  (MAPPER_BUTTON_COUNT * MAPPER_EVENT_COUNT)
+
+#ifdef CONFIG_SOUNDBOARD_PRELOAD_ADJACENT_PAGES
+    #define MAPPER_PREFETCH_ADJACENT true   // Prefetch the previous/next pages in page mode
+#else
+    #define MAPPER_PREFETCH_ADJACENT false
+#endif
+
+#ifdef CONFIG_SOUNDBOARD_MAPPER_CACHE
+    #define MAPPER_CACHE_ENABLED true       // Binary cache of the parsed mappings on the SD card
+#else
+    #define MAPPER_CACHE_ENABLED false
+#endif
+#define MAPPER_CACHE_FILE       ".mappings.cache"
+
+#ifdef CONFIG_SOUNDBOARD_SOUND_INDEX
+    #define MAPPER_SOUND_INDEX_ENABLED true // On-card WAV layout index (no header parse on open)
+#else
+    #define MAPPER_SOUND_INDEX_ENABLED false
+#endif
+
 
 /* ============================================================================
  * Linked List Data Structures for Mappings
@@ -40,6 +75,7 @@ typedef struct page_node_s {
     char page_id[PAGE_ID_MAX_LEN];      /**< Page string identifier (e.g., "default", "fx") */
     uint8_t page_number;                /**< 1-based page number (for direct selection via buttons) */
     mapping_node_t *mappings;           /**< Linked list of mappings for this page */
+    const action_t *actions[MAPPER_BUTTON_COUNT][MAPPER_EVENT_COUNT]; /**< Dispatch table (into mappings) */
     struct page_node_s *prev;           /**< Previous page (circular) */
     struct page_node_s *next;           /**< Next page (circular) */
 } page_node_t;
@@ -74,17 +110,31 @@ struct mapper_s {
     // Page count for display purposes
     uint8_t page_count;
 
+    // Pages indexed by page_number - 1 (built after loading)
+    page_node_t **page_table;
+
+    // Single allocation holding all pages and mappings when loaded from the
+    // binary cache (NULL: nodes allocated one by one by the CSV parser)
+    void *arena;
+    bool loaded_from_cache;
+    uint32_t load_ms;                           // Mappings load time at init
+
+    // SD card root for per-page sound banks (NULL: no SD card source)
+    const char *sdcard_root;
+
     // Unified event callback
     mapper_event_cb_t event_cb;
     void *event_cb_ctx;
 
     // Encoder mode state (toggle between volume and page)
     encoder_mode_t encoder_mode;
+    int8_t page_direction;                      // Last page rotation (1 = next, -1 = prev), prefetch order
 
     // Button FSM: single active button tracking
     button_fsm_state_t button_fsm_state;
     uint8_t current_button;                     // 0 = none, 1-12 = matrix button
-    char current_filename[SOUNDBOARD_MAX_PATH_LEN]; // filename of active playback
+    player_sound_id_t current_sound_id;         // sound of active playback
+    char current_filename[SOUNDBOARD_MAX_PATH_LEN]; // filename of active playback, only when current_sound_id is NONE
 };
 
 /* ============================================================================
@@ -218,6 +268,15 @@ static void free_page_mappings(page_node_t *page)
  */
 static void free_all_pages(mapper_handle_t mapper)
 {
+    if (mapper->arena != NULL) {
+        heap_caps_free(mapper->arena);
+        mapper->arena = NULL;
+        mapper->current_page = NULL;
+        mapper->first_page = NULL;
+        mapper->page_count = 0;
+        return;
+    }
+
     if (mapper->current_page == NULL) {
         return;
     }
@@ -250,42 +309,91 @@ static void free_all_pages(mapper_handle_t mapper)
  */
 static page_node_t *find_page_by_number(mapper_handle_t mapper, uint8_t page_number)
 {
-    if (mapper->first_page == NULL || page_number == 0 || page_number > mapper->page_count) {
+    if (mapper->page_table == NULL || page_number == 0 || page_number > mapper->page_count) {
         return NULL;
     }
 
-    // Start from first page and traverse
-    page_node_t *page = mapper->first_page;
-    do {
-        if (page->page_number == page_number) {
-            return page;
-        }
-        page = page->next;
-    } while (page != mapper->first_page);
-
-    return NULL;  // Should not reach here if page_count is accurate
+    return mapper->page_table[page_number - 1];
 }
 
 /**
- * @brief Find mapping in current page
+ * @brief Find action in current page
+ *
+ * @return Action from the current page's dispatch table, or NULL if unmapped
  */
-static const mapping_node_t *find_mapping(mapper_handle_t mapper,
-                                          uint8_t button_number,
-                                          input_event_type_t event)
+static const action_t *find_action(mapper_handle_t mapper,
+                                   uint8_t button_number,
+                                   input_event_type_t event)
 {
-    if (mapper->current_page == NULL) {
+    if (mapper->current_page == NULL || button_number < 1 || button_number > MAPPER_BUTTON_COUNT ||
+        (int)event >= MAPPER_EVENT_COUNT) {
         return NULL;
     }
 
-    mapping_node_t *mapping = mapper->current_page->mappings;
-    while (mapping != NULL) {
-        if (mapping->button_number == button_number && mapping->event == event) {
-            return mapping;
+    return mapper->current_page->actions[button_number - 1][event];
+}
+
+static bool action_has_file(action_type_t type);
+
+/**
+ * @brief Load the WAV layout index kept next to the SD card mappings
+ *
+ * Not fatal: without it every file header is parsed on open.
+ */
+static void load_sound_index(mapper_handle_t mapper)
+{
+    char path[SOUNDBOARD_MAX_PATH_LEN];
+    snprintf(path, sizeof(path), "%s/%s", mapper->sdcard_root, SOUND_INDEX_FILENAME);
+    esp_err_t ret = player_load_sound_index(mapper->player, path);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Sound index not loaded: %s", esp_err_to_name(ret));
+    }
+}
+
+/**
+ * @brief Compile loaded mappings into dispatch tables
+ *
+ * Builds the page index and, per page, the [button][event] action table
+ * pointing into the mapping nodes (stable after loading). Play actions get
+ * their sound ID resolved so the player does not look files up by name.
+ *
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the page index cannot be allocated
+ */
+static esp_err_t build_dispatch_tables(mapper_handle_t mapper)
+{
+    if (mapper->first_page == NULL) {
+        return ESP_OK;
+    }
+
+    mapper->page_table = heap_caps_calloc(mapper->page_count, sizeof(page_node_t *), MALLOC_CAP_INTERNAL);
+    if (mapper->page_table == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate page table (%d pages)", mapper->page_count);
+        return ESP_ERR_NO_MEM;
+    }
+
+    int unresolved = 0;
+    page_node_t *page = mapper->first_page;
+    do {
+        mapper->page_table[page->page_number - 1] = page;
+        memset(page->actions, 0, sizeof(page->actions));
+
+        for (mapping_node_t *m = page->mappings; m != NULL; m = m->next) {
+            page->actions[m->button_number - 1][m->event] = &m->action;
+
+            if (action_has_file(m->action.type) &&
+                player_resolve_sound(mapper->player, m->action.params.play.filename,
+                                     &m->action.params.play.sound_id) != ESP_OK) {
+                unresolved++;   // Falls back to play by filename
+            }
         }
-        mapping = mapping->next;
+        page = page->next;
+    } while (page != mapper->first_page);
+
+    if (unresolved > 0) {
+        ESP_LOGW(TAG, "%d play mappings without sound ID (played by filename)", unresolved);
     }
 
-    return NULL;
+    return ESP_OK;
 }
 
 /* ============================================================================
@@ -452,6 +560,7 @@ static esp_err_t parse_action(char** tokens, int num_tokens, action_t* action, c
         case ACTION_TYPE_PLAY_LOCK:
             trim(tokens[1]);
             build_absolute_path(action->params.play.filename, root, tokens[1]);
+            action->params.play.sound_id = PLAYER_SOUND_ID_NONE;
             break;
 
         default:
@@ -691,6 +800,363 @@ static esp_err_t load_all_mappings(mapper_handle_t mapper,
     return ESP_OK;
 }
 
+/* ============================================================================
+ * Binary Mapping Cache
+ * ============================================================================ */
+
+/*
+ * Cache file layout (native byte order, written and read by the same firmware):
+ *
+ *   mapper_cache_header_t
+ *   per page, in list order from the first page:
+ *     u8 page_number, u8 id_len, u16 mapping_count, id bytes
+ *     per mapping, in list order:
+ *       u8 button, u8 event, u8 action type, u8 unused, u16 path_len, path bytes
+ *
+ * The header holds a key per source CSV (size, mtime, FNV-1a of the root and
+ * content): the cache is used only when both keys match the files found at
+ * boot, otherwise the CSV files are parsed and the cache is rewritten.
+ */
+
+#define MAPPER_CACHE_MAGIC      0x4D504253u     // "SBPM"
+#define MAPPER_CACHE_VERSION    1
+#define MAPPER_CACHE_MAX_SIZE   (256 * 1024)
+#define MAPPER_CACHE_MAPPING_MIN 6              // Smallest mapping record (empty path)
+#define MAPPER_CACHE_TMP_SUFFIX ".tmp"
+#define FNV1A_OFFSET            0x811C9DC5u
+#define FNV1A_PRIME             0x01000193u
+
+typedef struct {
+    uint32_t size;
+    uint32_t hash;                      // FNV-1a of root and content (0: source absent)
+    int64_t mtime;
+} mapper_cache_key_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t page_id_len;                // PAGE_ID_MAX_LEN
+    uint8_t event_count;                // MAPPER_EVENT_COUNT
+    uint16_t path_len;                  // SOUNDBOARD_MAX_PATH_LEN
+    uint16_t page_count;
+    uint32_t mapping_count;
+    uint32_t body_size;
+    uint32_t body_hash;                 // FNV-1a of the body
+    mapper_cache_key_t sources[2];      // SPIFFS, SD card
+} mapper_cache_header_t;
+
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+} cache_reader_t;
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ p[i]) * FNV1A_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Compute the cache key of one mappings source (zeroed if absent)
+ */
+static void cache_key_of(const char *root, const char *mappings_filename, mapper_cache_key_t *key)
+{
+    memset(key, 0, sizeof(*key));
+    if (root == NULL || mappings_filename == NULL) {
+        return;
+    }
+
+    char path[SOUNDBOARD_MAX_PATH_LEN];
+    snprintf(path, sizeof(path), "%s/%s", root, mappings_filename);
+
+    struct stat st;
+    FILE *f = fopen(path, "r");
+    if (f == NULL || stat(path, &st) != 0) {
+        if (f != NULL) {
+            fclose(f);
+        }
+        return;
+    }
+
+    // Paths in the cache are absolute: a different root is a different key
+    uint32_t hash = fnv1a(FNV1A_OFFSET, root, strlen(root) + 1);
+    char buf[512];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        hash = fnv1a(hash, buf, n);
+    }
+    fclose(f);
+
+    key->size = (uint32_t)st.st_size;
+    key->mtime = (int64_t)st.st_mtime;
+    key->hash = hash | 1;   // Never 0 for a present source
+}
+
+static bool cache_read(cache_reader_t *r, void *out, size_t len)
+{
+    if ((size_t)(r->end - r->p) < len) {
+        return false;
+    }
+    memcpy(out, r->p, len);
+    r->p += len;
+    return true;
+}
+
+/**
+ * @brief Load the pages and mappings from the cache file into one arena
+ *
+ * @return ESP_OK on success; any error means the CSV files must be parsed
+ */
+static esp_err_t load_mapping_cache(mapper_handle_t mapper, const char *cache_path,
+                                    const mapper_cache_key_t keys[2])
+{
+    struct stat st;
+    if (stat(cache_path, &st) != 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (st.st_size < (off_t)sizeof(mapper_cache_header_t) || st.st_size > MAPPER_CACHE_MAX_SIZE) {
+        ESP_LOGW(TAG, "Ignoring mapping cache: bad size %ld", (long)st.st_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // One read of the whole file
+    size_t file_size = (size_t)st.st_size;
+    uint8_t *buf = heap_caps_malloc(file_size, MALLOC_CAP_SPIRAM);
+    if (buf == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    FILE *f = fopen(cache_path, "rb");
+    size_t got = (f != NULL) ? fread(buf, 1, file_size, f) : 0;
+    if (f != NULL) {
+        fclose(f);
+    }
+
+    mapper_cache_header_t hdr;
+    memcpy(&hdr, buf, MIN(got, sizeof(hdr)));
+    const uint8_t *body = buf + sizeof(hdr);
+    if (got != file_size ||
+        hdr.magic != MAPPER_CACHE_MAGIC || hdr.version != MAPPER_CACHE_VERSION ||
+        hdr.page_id_len != PAGE_ID_MAX_LEN || hdr.event_count != MAPPER_EVENT_COUNT ||
+        hdr.path_len != SOUNDBOARD_MAX_PATH_LEN ||
+        hdr.body_size != file_size - sizeof(hdr) ||
+        hdr.body_hash != fnv1a(FNV1A_OFFSET, body, hdr.body_size) ||
+        hdr.page_count == 0 || hdr.page_count > UINT8_MAX ||
+        hdr.mapping_count > hdr.body_size / MAPPER_CACHE_MAPPING_MIN) {
+        ESP_LOGW(TAG, "Ignoring mapping cache: invalid or corrupt");
+        heap_caps_free(buf);
+        return ESP_ERR_INVALID_CRC;
+    }
+    if (memcmp(hdr.sources, keys, sizeof(hdr.sources)) != 0) {
+        ESP_LOGI(TAG, "Mappings changed since the cache was written");
+        heap_caps_free(buf);
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    size_t arena_size = hdr.page_count * sizeof(page_node_t) + hdr.mapping_count * sizeof(mapping_node_t);
+    uint8_t *arena = heap_caps_calloc(1, arena_size, MALLOC_CAP_INTERNAL);
+    if (arena == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate mapping arena (%u bytes)", (unsigned)arena_size);
+        heap_caps_free(buf);
+        return ESP_ERR_NO_MEM;
+    }
+    page_node_t *pages = (page_node_t *)arena;
+    mapping_node_t *nodes = (mapping_node_t *)(arena + hdr.page_count * sizeof(page_node_t));
+
+    cache_reader_t r = { .p = body, .end = body + hdr.body_size };
+    uint32_t node_index = 0;
+    bool ok = true;
+
+    for (int i = 0; ok && i < hdr.page_count; i++) {
+        page_node_t *page = &pages[i];
+        uint8_t id_len;
+        uint16_t count;
+        ok = cache_read(&r, &page->page_number, 1) && cache_read(&r, &id_len, 1) &&
+             cache_read(&r, &count, 2) && id_len < PAGE_ID_MAX_LEN &&
+             cache_read(&r, page->page_id, id_len) &&
+             page->page_number >= 1 && page->page_number <= hdr.page_count &&
+             count <= hdr.mapping_count - node_index;
+
+        // Mappings are stored in list order: append to keep it
+        mapping_node_t **tail = &page->mappings;
+        for (uint16_t j = 0; ok && j < count; j++) {
+            mapping_node_t *node = &nodes[node_index++];
+            uint8_t rec[4] = {0};
+            uint16_t path_len;
+            ok = cache_read(&r, rec, sizeof(rec)) && cache_read(&r, &path_len, 2) &&
+                 rec[0] >= 1 && rec[0] <= MAPPER_BUTTON_COUNT && rec[1] < MAPPER_EVENT_COUNT &&
+                 rec[2] <= ACTION_TYPE_PLAY_LOCK && path_len < SOUNDBOARD_MAX_PATH_LEN &&
+                 cache_read(&r, node->action.params.play.filename, path_len);
+            if (!ok) {
+                break;
+            }
+            node->button_number = rec[0];
+            node->event = (input_event_type_t)rec[1];
+            node->action.type = (action_type_t)rec[2];
+            if (action_has_file(node->action.type)) {
+                node->action.params.play.sound_id = PLAYER_SOUND_ID_NONE;
+            }
+            *tail = node;
+            tail = &node->next;
+        }
+
+        page->prev = &pages[(i + hdr.page_count - 1) % hdr.page_count];
+        page->next = &pages[(i + 1) % hdr.page_count];
+    }
+    heap_caps_free(buf);
+
+    if (!ok || node_index != hdr.mapping_count || r.p != r.end) {
+        ESP_LOGW(TAG, "Ignoring mapping cache: malformed records");
+        heap_caps_free(arena);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    mapper->arena = arena;
+    mapper->first_page = &pages[0];     // Stored first: page_number 1
+    mapper->current_page = &pages[0];
+    mapper->page_count = (uint8_t)hdr.page_count;
+
+    ESP_LOGI(TAG, "Mappings loaded from cache: %d pages, %" PRIu32 " mappings, current='%s'",
+             mapper->page_count, hdr.mapping_count, mapper->current_page->page_id);
+    return ESP_OK;
+}
+
+static size_t cache_put(uint8_t *p, const void *data, size_t len)
+{
+    if (p != NULL) {
+        memcpy(p, data, len);
+    }
+    return len;
+}
+
+/**
+ * @brief Serialize the loaded pages (out NULL: only compute the body size)
+ */
+static size_t serialize_pages(const mapper_handle_t mapper, uint8_t *out, uint32_t *mapping_count)
+{
+    size_t n = 0;
+    *mapping_count = 0;
+
+    const page_node_t *page = mapper->first_page;
+    do {
+        uint16_t count = 0;
+        for (const mapping_node_t *m = page->mappings; m != NULL; m = m->next) {
+            count++;
+        }
+        uint8_t id_len = (uint8_t)strlen(page->page_id);
+        n += cache_put(out ? out + n : NULL, &page->page_number, 1);
+        n += cache_put(out ? out + n : NULL, &id_len, 1);
+        n += cache_put(out ? out + n : NULL, &count, 2);
+        n += cache_put(out ? out + n : NULL, page->page_id, id_len);
+
+        for (const mapping_node_t *m = page->mappings; m != NULL; m = m->next) {
+            uint8_t rec[4] = { m->button_number, (uint8_t)m->event, (uint8_t)m->action.type, 0 };
+            uint16_t path_len = action_has_file(m->action.type) ?
+                                (uint16_t)strlen(m->action.params.play.filename) : 0;
+            n += cache_put(out ? out + n : NULL, rec, sizeof(rec));
+            n += cache_put(out ? out + n : NULL, &path_len, 2);
+            n += cache_put(out ? out + n : NULL, m->action.params.play.filename, path_len);
+        }
+        *mapping_count += count;
+        page = page->next;
+    } while (page != mapper->first_page);
+
+    return n;
+}
+
+/**
+ * @brief Write the cache file for the mappings just parsed (temporary file renamed)
+ */
+static void write_mapping_cache(mapper_handle_t mapper, const char *cache_path,
+                                const mapper_cache_key_t keys[2])
+{
+    uint32_t mapping_count;
+    size_t body_size = serialize_pages(mapper, NULL, &mapping_count);
+    size_t file_size = sizeof(mapper_cache_header_t) + body_size;
+    if (file_size > MAPPER_CACHE_MAX_SIZE) {
+        ESP_LOGW(TAG, "Mappings too large for the cache (%u bytes)", (unsigned)file_size);
+        return;
+    }
+
+    uint8_t *buf = heap_caps_malloc(file_size, MALLOC_CAP_SPIRAM);
+    if (buf == NULL) {
+        return;
+    }
+    uint8_t *body = buf + sizeof(mapper_cache_header_t);
+    serialize_pages(mapper, body, &mapping_count);
+
+    mapper_cache_header_t hdr = {
+        .magic = MAPPER_CACHE_MAGIC,
+        .version = MAPPER_CACHE_VERSION,
+        .page_id_len = PAGE_ID_MAX_LEN,
+        .event_count = MAPPER_EVENT_COUNT,
+        .path_len = SOUNDBOARD_MAX_PATH_LEN,
+        .page_count = mapper->page_count,
+        .mapping_count = mapping_count,
+        .body_size = (uint32_t)body_size,
+        .body_hash = fnv1a(FNV1A_OFFSET, body, body_size),
+    };
+    memcpy(hdr.sources, keys, sizeof(hdr.sources));
+    memcpy(buf, &hdr, sizeof(hdr));
+
+    char tmp_path[SOUNDBOARD_MAX_PATH_LEN + sizeof(MAPPER_CACHE_TMP_SUFFIX)];
+    snprintf(tmp_path, sizeof(tmp_path), "%s" MAPPER_CACHE_TMP_SUFFIX, cache_path);
+
+    FILE *f = fopen(tmp_path, "wb");
+    bool ok = (f != NULL) && fwrite(buf, 1, file_size, f) == file_size;
+    if (f != NULL) {
+        ok = (fclose(f) == 0) && ok;
+    }
+    heap_caps_free(buf);
+
+    if (ok) {
+        remove(cache_path);
+        ok = (rename(tmp_path, cache_path) == 0);
+    }
+    if (!ok) {
+        ESP_LOGW(TAG, "Failed to write mapping cache %s", cache_path);
+        remove(tmp_path);
+        return;
+    }
+    ESP_LOGI(TAG, "Mapping cache written: %u bytes", (unsigned)file_size);
+}
+
+/**
+ * @brief Load the mappings from the binary cache, or from the CSV files
+ *
+ * The cache lives on the SD card next to the mappings file. When it is
+ * missing or stale, the CSV files are parsed and the cache is rewritten.
+ * Without an SD card the CSV files are always parsed.
+ */
+static esp_err_t load_mappings(mapper_handle_t mapper, const mapper_config_t *config)
+{
+    bool use_cache = MAPPER_CACHE_ENABLED && mapper->sdcard_root != NULL;
+    char cache_path[SOUNDBOARD_MAX_PATH_LEN];
+    mapper_cache_key_t keys[2];
+
+    if (use_cache) {
+        snprintf(cache_path, sizeof(cache_path), "%s/%s", mapper->sdcard_root, MAPPER_CACHE_FILE);
+        cache_key_of(config->spiffs_root, config->spiffs_mappings_file, &keys[0]);
+        cache_key_of(config->sdcard_root, config->sdcard_mappings_file, &keys[1]);
+        if (load_mapping_cache(mapper, cache_path, keys) == ESP_OK) {
+            mapper->loaded_from_cache = true;
+            return ESP_OK;
+        }
+    }
+
+    esp_err_t ret = load_all_mappings(mapper,
+                                      config->spiffs_root,
+                                      config->spiffs_mappings_file,
+                                      config->sdcard_root,
+                                      config->sdcard_mappings_file);
+    if (ret == ESP_OK && use_cache) {
+        write_mapping_cache(mapper, cache_path, keys);
+    }
+    return ret;
+}
+
 /* ============================================================================
  * Public Validation API
  * ============================================================================ */
@@ -755,6 +1221,38 @@ esp_err_t mapper_validate_file(const char *filepath, const char *root, bool chec
     return ESP_OK;
 }
 
+esp_err_t mapper_for_each_file(const char *filepath, const char *root,
+                               mapper_file_cb_t cb, void *ctx)
+{
+    if (filepath == NULL || root == NULL || cb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    FILE *f = fopen(filepath, "r");
+    if (f == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    char line[512];
+    while (fgets(line, sizeof(line), f) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        trim(line);
+
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+
+        parsed_mapping_t parsed;
+        if (validate_line(line, root, &parsed) != ESP_OK || !action_has_file(parsed.action.type)) {
+            continue;
+        }
+        cb(parsed.page_id, parsed.button_number, parsed.action.params.play.filename, ctx);
+    }
+
+    fclose(f);
+    return ESP_OK;
+}
+
 /* ============================================================================
  * Event Notification Helpers
  * ============================================================================ */
@@ -804,6 +1302,9 @@ static void notify_encoder_mode_changed(mapper_handle_t mapper, encoder_mode_t m
 
 static void notify_page_changed(mapper_handle_t mapper)
 {
+#ifdef TRACE_ENABLE
+    trace_event(TRACE_MAPPER_PAGE, mapper->current_page ? mapper->current_page->page_number : 0, 0);
+#endif
     if (mapper->event_cb == NULL) return;
 
     mapper_event_t evt = {
@@ -818,20 +1319,102 @@ static void notify_page_changed(mapper_handle_t mapper)
 }
 
 /**
- * @brief Preload files for current page into cache
+ * @brief Register attack segments for every file on every page
  *
- * Collects filenames from current page's mappings and queues them for
- * background preloading. Files are queued in descending button order
- * (12, 11, ... 1) so that button 1's file loads first (FIFO queue).
+ * Heads are small and stay resident, so any mapped sound can start
+ * instantly even when its page was never preloaded.
  */
-static void preload_current_page_files(mapper_handle_t mapper)
+static void register_all_page_heads(mapper_handle_t mapper)
 {
-    if (mapper == NULL || mapper->current_page == NULL || mapper->player == NULL) {
+    if (mapper == NULL || mapper->first_page == NULL || mapper->player == NULL) {
         return;
     }
 
+    int registered = 0;
+    page_node_t *page = mapper->first_page;
+    do {
+        for (mapping_node_t *m = page->mappings; m != NULL; m = m->next) {
+            if (!action_has_file(m->action.type)) {
+                continue;
+            }
+            esp_err_t ret = player_preload_head(mapper->player, m->action.params.play.filename);
+            if (ret == ESP_ERR_NOT_SUPPORTED) {
+                return;     // Attack-segment cache disabled
+            }
+            if (ret == ESP_OK) {
+                registered++;
+            }
+        }
+        page = page->next;
+    } while (page != mapper->first_page);
+
+    ESP_LOGD(TAG, "Attack segments registered for %d mappings", registered);
+}
+
+/**
+ * @brief Append the distinct resolved sound IDs of a page
+ *
+ * @param ids Output array, entries [0, count) already filled
+ * @param count Number of IDs already in ids
+ * @param max Capacity of ids
+ * @return New number of IDs in ids
+ */
+static size_t collect_page_sounds(const page_node_t *page, player_sound_id_t *ids, size_t count, size_t max)
+{
+    for (const mapping_node_t *m = page->mappings; m != NULL && count < max; m = m->next) {
+        if (!action_has_file(m->action.type) || m->action.params.play.sound_id == PLAYER_SOUND_ID_NONE) {
+            continue;
+        }
+        player_sound_id_t id = m->action.params.play.sound_id;
+        bool found = false;
+        for (size_t i = 0; i < count && !found; i++) {
+            found = (ids[i] == id);
+        }
+        if (!found) {
+            ids[count++] = id;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Pin current page sounds (and adjacent pages) in the cache
+ *
+ * Keeps page-aware eviction policies from dropping sounds that are one
+ * press (or one encoder step) away.
+ */
+static void update_cache_pins(mapper_handle_t mapper)
+{
+    player_sound_id_t current[MAPPER_PAGE_SOUNDS_MAX];
+    player_sound_id_t neighbours[2 * MAPPER_PAGE_SOUNDS_MAX];
     page_node_t *page = mapper->current_page;
 
+    size_t current_count = collect_page_sounds(page, current, 0, MAPPER_PAGE_SOUNDS_MAX);
+    size_t neighbour_count = 0;
+    if (page->prev != page) {
+        neighbour_count = collect_page_sounds(page->prev, neighbours, 0, 2 * MAPPER_PAGE_SOUNDS_MAX);
+        if (page->next != page->prev) {
+            neighbour_count = collect_page_sounds(page->next, neighbours, neighbour_count,
+                                                  2 * MAPPER_PAGE_SOUNDS_MAX);
+        }
+    }
+
+    player_set_cache_pins(mapper->player, current, current_count, neighbours, neighbour_count);
+}
+
+/**
+ * @brief Queue the bank and files of a page for background loading
+ *
+ * Files are queued in ascending button order (1, 2, ... 12) so that
+ * button 1's file loads first (FIFO queue). A file mapped on several
+ * buttons is queued once, at its lowest button.
+ *
+ * @param use_bank Queue the page's sound bank first (if built)
+ * @param prefetch Speculative (adjacent page): best effort, counted apart
+ * @return Number of files queued
+ */
+static int queue_page_preloads(mapper_handle_t mapper, const page_node_t *page, bool use_bank, bool prefetch)
+{
     // Collect unique filenames with their button numbers
     // Max 12 buttons, but same file might be on multiple buttons
     typedef struct {
@@ -839,11 +1422,11 @@ static void preload_current_page_files(mapper_handle_t mapper)
         uint8_t button_number;
     } file_entry_t;
 
-    file_entry_t entries[12];
+    file_entry_t entries[MAPPER_BUTTON_COUNT];
     int entry_count = 0;
 
     // Iterate through mappings and collect unique filenames
-    for (mapping_node_t *m = page->mappings; m != NULL; m = m->next) {
+    for (const mapping_node_t *m = page->mappings; m != NULL; m = m->next) {
         if (!action_has_file(m->action.type)) {
             continue;
         }
@@ -855,15 +1438,15 @@ static void preload_current_page_files(mapper_handle_t mapper)
         for (int i = 0; i < entry_count; i++) {
             if (strcmp(entries[i].filename, filename) == 0) {
                 found = true;
-                // Use highest button number for this file
-                if (m->button_number > entries[i].button_number) {
+                // Use lowest button number for this file
+                if (m->button_number < entries[i].button_number) {
                     entries[i].button_number = m->button_number;
                 }
                 break;
             }
         }
 
-        if (!found && entry_count < 12) {
+        if (!found && entry_count < MAPPER_BUTTON_COUNT) {
             entries[entry_count].filename = filename;
             entries[entry_count].button_number = m->button_number;
             entry_count++;
@@ -871,13 +1454,13 @@ static void preload_current_page_files(mapper_handle_t mapper)
     }
 
     if (entry_count == 0) {
-        return;
+        return 0;
     }
 
-    // Sort by button number descending (bubble sort, small array)
+    // Sort by button number ascending (bubble sort, small array)
     for (int i = 0; i < entry_count - 1; i++) {
         for (int j = 0; j < entry_count - 1 - i; j++) {
-            if (entries[j].button_number < entries[j + 1].button_number) {
+            if (entries[j].button_number > entries[j + 1].button_number) {
                 file_entry_t tmp = entries[j];
                 entries[j] = entries[j + 1];
                 entries[j + 1] = tmp;
@@ -885,26 +1468,126 @@ static void preload_current_page_files(mapper_handle_t mapper)
         }
     }
 
-    // Flush stale preload requests from previous page
-    player_flush_preload(mapper->player);
+    // Bulk load from the page's sound bank first (if built), per-file
+    // preloads below pick up whatever the bank did not provide
+    if (use_bank && mapper->sdcard_root != NULL) {
+        char bank_path[SOUNDBOARD_MAX_PATH_LEN];
+        sound_bank_path(bank_path, sizeof(bank_path), mapper->sdcard_root, page->page_id);
+        if (bank_path[0] != '\0') {
+            if (prefetch) {
+                player_prefetch(mapper->player, bank_path, true);
+            } else {
+                player_preload_bank(mapper->player, bank_path);
+            }
+        }
+    }
 
-    // Queue files for preloading (button 12 first, button 1 last)
-    // Since queue is FIFO, button 1's file will load first
-    ESP_LOGI(TAG, "Preloading %d files for page '%s'", entry_count, page->page_id);
     for (int i = 0; i < entry_count; i++) {
-        ESP_LOGD(TAG, "  Queue preload: btn %d -> %s",
+        ESP_LOGD(TAG, "  Queue %s: btn %d -> %s", prefetch ? "prefetch" : "preload",
                  entries[i].button_number, entries[i].filename);
-        player_preload(mapper->player, entries[i].filename);
+        if (prefetch) {
+            player_prefetch(mapper->player, entries[i].filename, false);
+        } else {
+            player_preload(mapper->player, entries[i].filename);
+        }
     }
+    return entry_count;
+}
+
+/**
+ * @brief Prefetch the pages one encoder step away (page mode only)
+ *
+ * Queued behind the current page, the page in the direction of the last
+ * rotation first. Their sounds are pinned as neighbours, so the flush of the
+ * next page change keeps loading the ones still adjacent and cancels the
+ * others.
+ */
+static void prefetch_adjacent_pages(mapper_handle_t mapper)
+{
+    if (!MAPPER_PREFETCH_ADJACENT || mapper->encoder_mode != ENCODER_MODE_PAGE ||
+        mapper->current_page == NULL || mapper->page_count < 2) {
+        return;
+    }
+
+    const page_node_t *page = mapper->current_page;
+    const page_node_t *ahead = (mapper->page_direction >= 0) ? page->next : page->prev;
+    const page_node_t *behind = (mapper->page_direction >= 0) ? page->prev : page->next;
+    int files = queue_page_preloads(mapper, ahead, true, true);
+    if (behind != ahead) {
+        files += queue_page_preloads(mapper, behind, true, true);
+    }
+    ESP_LOGD(TAG, "Prefetching %d files of the pages around '%s'", files, page->page_id);
+}
+
+/**
+ * @brief Preload files for current page into cache
+ *
+ * Flushes the requests of the previous page, then queues the current page
+ * (see queue_page_preloads()) and, in page mode, the adjacent pages.
+ *
+ * @param use_bank Queue the page's sound bank first (if built)
+ */
+static void preload_current_page_files(mapper_handle_t mapper, bool use_bank)
+{
+    if (mapper == NULL || mapper->current_page == NULL || mapper->player == NULL) {
+        return;
+    }
+
+    page_node_t *page = mapper->current_page;
+
+    // Protect this page (and its neighbours) before loading evicts anything,
+    // and before the flush: loads in flight for sounds left unpinned stop
+    update_cache_pins(mapper);
+
+    // Flush stale preload requests from previous page
+    player_flush_preload(mapper->player);
+
+    int files = queue_page_preloads(mapper, page, use_bank, false);
+    if (files > 0) {
+        ESP_LOGI(TAG, "Preloading %d files for page '%s'", files, page->page_id);
+    }
+    prefetch_adjacent_pages(mapper);
 }
 
 /* ============================================================================
  * Action Execution
  * ============================================================================ */
 
+/**
+ * @brief Start the sound of a play action (by sound ID when resolved)
+ *
+ * Also records it as the sound of the active button, for the stop on release.
+ */
+static void play_action_file(mapper_handle_t mapper, const action_t *action)
+{
+    mapper->current_sound_id = action->params.play.sound_id;
+    if (action->params.play.sound_id != PLAYER_SOUND_ID_NONE) {
+        player_play_sound(mapper->player, action->params.play.sound_id);
+    } else {
+        strncpy(mapper->current_filename, action->params.play.filename, SOUNDBOARD_MAX_PATH_LEN - 1);
+        mapper->current_filename[SOUNDBOARD_MAX_PATH_LEN - 1] = '\0';
+        player_play(mapper->player, action->params.play.filename);
+    }
+}
+
+/**
+ * @brief Stop the sound started by the active button
+ */
+static void stop_current_file(mapper_handle_t mapper)
+{
+    if (mapper->current_sound_id != PLAYER_SOUND_ID_NONE) {
+        player_stop_sound(mapper->player, mapper->current_sound_id);
+    } else {
+        player_stop_file(mapper->player, mapper->current_filename);
+    }
+}
+
 static void execute_action(mapper_handle_t mapper, uint8_t button_number,
                           input_event_type_t event, const action_t *action)
 {
+#ifdef TRACE_ENABLE
+    trace_event(TRACE_MAPPER_ACTION, button_number, action->type);
+#endif
     switch (action->type) {
         case ACTION_TYPE_STOP:
             ESP_LOGI(TAG, "Action: Stop playback");
@@ -915,29 +1598,23 @@ static void execute_action(mapper_handle_t mapper, uint8_t button_number,
 
         case ACTION_TYPE_PLAY:
             ESP_LOGI(TAG, "Action: Play '%s'", action->params.play.filename);
-            player_play(mapper->player, action->params.play.filename);
+            play_action_file(mapper, action);
             mapper->button_fsm_state = BTN_STATE_PLAY_ONCE;
             mapper->current_button = button_number;
-            strncpy(mapper->current_filename, action->params.play.filename, SOUNDBOARD_MAX_PATH_LEN - 1);
-            mapper->current_filename[SOUNDBOARD_MAX_PATH_LEN - 1] = '\0';
             break;
 
         case ACTION_TYPE_PLAY_CUT:
             ESP_LOGI(TAG, "Action: Play '%s' (cut on release)", action->params.play.filename);
-            player_play(mapper->player, action->params.play.filename);
+            play_action_file(mapper, action);
             mapper->button_fsm_state = BTN_STATE_PLAY_CUT;
             mapper->current_button = button_number;
-            strncpy(mapper->current_filename, action->params.play.filename, SOUNDBOARD_MAX_PATH_LEN - 1);
-            mapper->current_filename[SOUNDBOARD_MAX_PATH_LEN - 1] = '\0';
             break;
 
         case ACTION_TYPE_PLAY_LOCK:
             ESP_LOGI(TAG, "Action: Play_lock '%s' (start)", action->params.play.filename);
-            player_play(mapper->player, action->params.play.filename);
+            play_action_file(mapper, action);
             mapper->button_fsm_state = BTN_STATE_PLAY_LOCK_PENDING;
             mapper->current_button = button_number;
-            strncpy(mapper->current_filename, action->params.play.filename, SOUNDBOARD_MAX_PATH_LEN - 1);
-            mapper->current_filename[SOUNDBOARD_MAX_PATH_LEN - 1] = '\0';
             break;
 
         default:
@@ -967,9 +1644,10 @@ static void handle_encoder_rotation(mapper_handle_t handle, input_event_type_t e
         if (handle->current_page != NULL && handle->page_count > 1) {
             handle->current_page = (direction > 0) ? handle->current_page->next
                                                     : handle->current_page->prev;
+            handle->page_direction = direction;
             ESP_LOGI(TAG, "Encoder: page changed to '%s'", handle->current_page->page_id);
             notify_page_changed(handle);
-            preload_current_page_files(handle);
+            preload_current_page_files(handle, true);
         }
     }
 }
@@ -986,6 +1664,9 @@ static void handle_encoder_switch(mapper_handle_t handle, input_event_type_t eve
         ESP_LOGI(TAG, "Encoder mode changed to %s",
                  handle->encoder_mode == ENCODER_MODE_VOLUME ? "VOLUME" : "PAGE");
         notify_encoder_mode_changed(handle, handle->encoder_mode);
+
+        // Browsing pages: get the next ones ready (behind what is already queued)
+        prefetch_adjacent_pages(handle);
     } else if (event == INPUT_EVENT_BUTTON_LONG_PRESS) {
         ESP_LOGD(TAG, "Encoder switch long press: reserved");
     }
@@ -1004,7 +1685,7 @@ static void handle_button_release(mapper_handle_t handle, uint8_t button_number)
         case BTN_STATE_PLAY_CUT:
         case BTN_STATE_PLAY_LOCK_PENDING:
             ESP_LOGI(TAG, "Button %d released: stopping playback", button_number);
-            player_stop(handle->player, true);
+            stop_current_file(handle);
             handle->button_fsm_state = BTN_STATE_INITIAL;
             break;
         case BTN_STATE_PLAY_ONCE:
@@ -1030,7 +1711,7 @@ static void handle_direct_page_select(mapper_handle_t handle, uint8_t button_num
         handle->encoder_mode = ENCODER_MODE_VOLUME;
         notify_encoder_mode_changed(handle, ENCODER_MODE_VOLUME);
         notify_page_changed(handle);
-        preload_current_page_files(handle);
+        preload_current_page_files(handle, true);
     } else {
         ESP_LOGD(TAG, "Page %d does not exist (only %d pages loaded)",
                  button_number, handle->page_count);
@@ -1084,23 +1765,32 @@ esp_err_t mapper_init(const mapper_config_t *config, mapper_handle_t *out_handle
     }
 
     mapper->player = config->player;
+    mapper->sdcard_root = has_sdcard ? config->sdcard_root : NULL;
     mapper->event_cb = config->event_cb;
     mapper->event_cb_ctx = config->event_cb_ctx;
 
     mapper->encoder_mode = ENCODER_MODE_VOLUME;
+    mapper->page_direction = 1;
+    mapper->current_sound_id = PLAYER_SOUND_ID_NONE;
     mapper->current_page = NULL;
     mapper->first_page = NULL;
     mapper->page_count = 0;
 
-    // Load mappings using linked list structure
+    // Load mappings (binary cache or CSV files)
     // current_page and page_count are set during loading
-    esp_err_t ret = load_all_mappings(mapper,
-                                       config->spiffs_root,
-                                       config->spiffs_mappings_file,
-                                       config->sdcard_root,
-                                       config->sdcard_mappings_file);
+    int64_t load_start_us = esp_timer_get_time();
+    esp_err_t ret = load_mappings(mapper, config);
+    mapper->load_ms = (uint32_t)((esp_timer_get_time() - load_start_us) / 1000);
+    if (ret == ESP_OK) {
+        // WAV layouts of the SD card files, attached as the sounds are resolved
+        if (MAPPER_SOUND_INDEX_ENABLED && mapper->sdcard_root != NULL) {
+            load_sound_index(mapper);
+        }
+        ret = build_dispatch_tables(mapper);
+    }
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to load mappings: %s", esp_err_to_name(ret));
+        free_all_pages(mapper);
         heap_caps_free(mapper);
         return ret;
     }
@@ -1119,12 +1809,33 @@ esp_err_t mapper_init(const mapper_config_t *config, mapper_handle_t *out_handle
     // notify observers of loaded state (includes initial page info)
     notify_loaded(mapper);
 
-    // preload files for initial page
-    preload_current_page_files(mapper);
+    // resident attack segments for all pages, then full preload of initial page
+    register_all_page_heads(mapper);
+    preload_current_page_files(mapper, true);
 
     return ESP_OK;
 }
 
+const char *mapper_get_current_page(mapper_handle_t handle)
+{
+    if (handle == NULL || handle->current_page == NULL) {
+        return NULL;
+    }
+    return handle->current_page->page_id;
+}
+
+esp_err_t mapper_preload_page(mapper_handle_t handle, bool use_bank)
+{
+    if (handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->current_page == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    preload_current_page_files(handle, use_bank);
+    return ESP_OK;
+}
+
 void mapper_on_input_event(mapper_handle_t handle,
                         uint8_t button_number,
                         input_event_type_t event)
@@ -1133,6 +1844,10 @@ void mapper_on_input_event(mapper_handle_t handle,
         return;
     }
 
+#ifdef LATENCY_STATS_ENABLE
+    latency_trigger_mark(LATENCY_MARK_MAPPER);
+#endif
+
     // Encoder rotation: volume or page navigation
     if (event == INPUT_EVENT_ENCODER_ROTATE_CW || event == INPUT_EVENT_ENCODER_ROTATE_CCW) {
         handle_encoder_rotation(handle, event);
@@ -1146,7 +1861,7 @@ void mapper_on_input_event(mapper_handle_t handle,
     }
 
     // Matrix buttons (1-12)
-    if (button_number < 1 || button_number > 12) {
+    if (button_number < 1 || button_number > MAPPER_BUTTON_COUNT) {
         return;
     }
 
@@ -1167,10 +1882,10 @@ void mapper_on_input_event(mapper_handle_t handle,
         return;
     }
 
-    // Look up mapping in current page and execute
-    const mapping_node_t *mapping = find_mapping(handle, button_number, event);
-    if (mapping != NULL) {
-        execute_action(handle, button_number, event, &mapping->action);
+    // Look up action in current page's dispatch table and execute
+    const action_t *action = find_action(handle, button_number, event);
+    if (action != NULL) {
+        execute_action(handle, button_number, event, action);
     } else {
         ESP_LOGD(TAG, "No mapping found for page='%s', button=%d, event=%d",
                  handle->current_page ? handle->current_page->page_id : "(none)",
@@ -1185,6 +1900,7 @@ esp_err_t mapper_deinit(mapper_handle_t handle)
     }
 
     free_all_pages(handle);
+    heap_caps_free(handle->page_table);
     heap_caps_free(handle);
 
     ESP_LOGI(TAG, "Mapper deinitialized");
@@ -1318,13 +2034,16 @@ void mapper_print_status(mapper_handle_t handle, status_output_type_t output_typ
     }
 
     if (output_type == STATUS_OUTPUT_COMPACT) {
-        printf("[mapper] page=\"%s\" (%d/%d), mode=%s, %d mappings\n",
-               page_id, page_num, page_count, mode, total_mappings);
+        printf("[mapper] page=\"%s\" (%d/%d), mode=%s, %d mappings (%s)\n",
+               page_id, page_num, page_count, mode, total_mappings,
+               handle->loaded_from_cache ? "cache" : "CSV");
     } else {
         printf("Mapper Status:\n");
         printf("  Current page: \"%s\" (%d of %d)\n", page_id, page_num, page_count);
         printf("  Encoder mode: %s\n", mode);
         printf("  Total mappings: %d\n", total_mappings);
+        printf("  Loaded from: %s in %" PRIu32 " ms\n",
+               handle->loaded_from_cache ? "binary cache" : "CSV files", handle->load_ms);
 
         if (output_type == STATUS_OUTPUT_VERBOSE) {
             // Per-page mapping counts
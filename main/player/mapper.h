@@ -42,6 +42,7 @@ typedef struct {
     union {
         struct {
             char filename[SOUNDBOARD_MAX_PATH_LEN];
+            player_sound_id_t sound_id;     /**< Resolved at load (PLAYER_SOUND_ID_NONE: play by filename) */
         } play;
     } params;
 } action_t;
@@ -195,6 +196,30 @@ void mapper_on_input_event(mapper_handle_t handle,
                         uint8_t button_number,
                         input_event_type_t event);
 
+/**
+ * @brief Page ID of the current page
+ *
+ * @param handle Mapper handle (NULL-safe)
+ * @return Page ID (valid until mapper_deinit()), or NULL if no page is loaded
+ */
+const char *mapper_get_current_page(mapper_handle_t handle);
+
+/**
+ * @brief Queue the current page for preloading again, as on a page change
+ *
+ * Flushes the preload queue (starting a warm-up measurement), then queues
+ * the page's sound bank (when use_bank is set and a bank is built) and its
+ * files. Used by the benchmark suite after a cache purge.
+ *
+ * @param handle Mapper handle
+ * @param use_bank Load the page's sound bank first
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if handle is NULL
+ *     - ESP_ERR_INVALID_STATE if no page is loaded
+ */
+esp_err_t mapper_preload_page(mapper_handle_t handle, bool use_bank);
+
 /**
  * @brief Deinitialize mapper
  *
@@ -237,6 +262,37 @@ void mapper_print_mappings(mapper_handle_t handle);
  */
 esp_err_t mapper_validate_file(const char *filepath, const char *root, bool check_files);
 
+/**
+ * @brief Callback for mapper_for_each_file()
+ *
+ * @param page_id       Page string identifier of the mapping
+ * @param button_number Button number (1-12)
+ * @param filename      Absolute path of the audio file
+ * @param ctx           User context passed to mapper_for_each_file()
+ */
+typedef void (*mapper_file_cb_t)(const char *page_id, uint8_t button_number,
+                                 const char *filename, void *ctx);
+
+/**
+ * @brief Enumerate the audio files referenced by a mappings CSV file
+ *
+ * Calls cb for every valid mapping with a file action, in file order
+ * (a file mapped on several buttons or events is reported each time).
+ * Invalid lines are skipped. Does not require a mapper or player handle;
+ * used to build per-page sound banks.
+ *
+ * @param filepath Full path to the mappings CSV file
+ * @param root     Root path for resolving relative filenames (e.g., "/sdcard")
+ * @param cb       Callback invoked per file mapping
+ * @param ctx      User context passed to cb
+ * @return
+ *     - ESP_OK: File parsed
+ *     - ESP_ERR_INVALID_ARG: NULL filepath, root or cb
+ *     - ESP_ERR_NOT_FOUND: File not found
+ */
+esp_err_t mapper_for_each_file(const char *filepath, const char *root,
+                               mapper_file_cb_t cb, void *ctx);
+
 /**
  * @brief Print mapper status information to console
  *
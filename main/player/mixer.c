@@ -0,0 +1,331 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file mixer.c
+ * @brief PCM sample kernels (PIE SIMD on ESP32-S3, scalar fallback)
+ *
+ * Gain is applied in Q15 (gain >> 1, at most 32767) so that the scalar and
+ * SIMD paths produce identical samples: EE.VMUL.S16 computes (x * y) >> SAR
+ * per lane with 16-bit operands. Ramps step the gain once per 8-sample
+ * block in both paths.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include "mixer.h"
+
+#define MIXER_SIMD_LANES 8      // int16 lanes in one 128-bit Q register
+#define GAIN_Q15_SHIFT   15
+#define GAIN_Q15_HALF    16384  // 0.5: (x * GAIN_Q15_HALF) >> 15 == x >> 1
+
+static inline bool is_simd_aligned(const void *p)
+{
+    return ((uintptr_t)p & (MIXER_BUFFER_ALIGN - 1)) == 0;
+}
+
+static inline int16_t saturate_s16(int32_t v)
+{
+    if (v > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (v < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)v;
+}
+
+static inline int16_t gain_q15(int32_t gain)
+{
+    int32_t g = gain >> 1;
+    return (int16_t)(g > INT16_MAX ? INT16_MAX : g);
+}
+
+static inline int16_t scale_sample(int16_t x, int16_t g15)
+{
+    return (int16_t)(((int32_t)x * g15) >> GAIN_Q15_SHIFT);
+}
+
+/**
+ * @brief true for constant unity or constant mute gain (memcpy/memset paths)
+ */
+static inline bool is_trivial_gain(uint32_t gain_from, uint32_t gain_to)
+{
+    return (gain_from >= MIXER_GAIN_UNITY && gain_to >= MIXER_GAIN_UNITY) ||
+           (gain_from == 0 && gain_to == 0);
+}
+
+/**
+ * @brief Per-block gain increment (Q16) of a linear ramp over count samples
+ */
+static inline int32_t ramp_step(uint32_t gain_from, uint32_t gain_to, size_t count)
+{
+    int32_t blocks = (int32_t)(count / MIXER_SIMD_LANES);
+    return blocks > 0 ? ((int32_t)gain_to - (int32_t)gain_from) / blocks : 0;
+}
+
+// ============================================================================
+// SIMD blocks (ESP32-S3 PIE)
+// ============================================================================
+
+#if MIXER_HAS_SIMD
+
+// q2 = broadcast(g15), SAR = 15; every vmul below uses both
+static inline void simd_load_gain(const int16_t *g15)
+{
+    __asm__ volatile (
+        "ssr %[sh]\n"
+        "ee.vldbc.16 q2, %[g]\n"
+        :
+        : [g] "r" (g15), [sh] "r" (GAIN_Q15_SHIFT)
+        : "memory");
+}
+
+// d[i] = (s[i] * q2) >> 15 for blocks * 8 samples
+static inline void simd_scale_blocks(int16_t *d, const int16_t *s, size_t blocks)
+{
+    __asm__ volatile (
+        "loopnez %[n], 1f\n"
+        "ee.vld.128.ip q0, %[s], 16\n"
+        "ee.vmul.s16 q0, q0, q2\n"
+        "ee.vst.128.ip q0, %[d], 16\n"
+        "1:\n"
+        : [d] "+r" (d), [s] "+r" (s)
+        : [n] "r" (blocks)
+        : "memory");
+}
+
+// d[i] = sat(d[i] + ((s[i] * q2) >> 15)) for blocks * 8 samples
+static inline void simd_scale_add_blocks(int16_t *d, const int16_t *s, size_t blocks)
+{
+    __asm__ volatile (
+        "loopnez %[n], 1f\n"
+        "ee.vld.128.ip q0, %[s], 16\n"
+        "ee.vmul.s16 q0, q0, q2\n"
+        "ee.vld.128.ip q1, %[d], 0\n"
+        "ee.vadds.s16 q1, q1, q0\n"
+        "ee.vst.128.ip q1, %[d], 16\n"
+        "1:\n"
+        : [d] "+r" (d), [s] "+r" (s)
+        : [n] "r" (blocks)
+        : "memory");
+}
+
+// d[i] = ((s[2i] * q2) >> 15) + ((s[2i + 1] * q2) >> 15) for blocks * 8 frames (q2 = 0.5)
+static inline void simd_downmix_blocks(int16_t *d, const int16_t *s, size_t blocks)
+{
+    __asm__ volatile (
+        "loopnez %[n], 1f\n"
+        "ee.vld.128.ip q0, %[s], 16\n"
+        "ee.vld.128.ip q1, %[s], 16\n"
+        "ee.vunzip.16 q0, q1\n"            // q0 = left, q1 = right
+        "ee.vmul.s16 q0, q0, q2\n"
+        "ee.vmul.s16 q1, q1, q2\n"
+        "ee.vadds.s16 q0, q0, q1\n"
+        "ee.vst.128.ip q0, %[d], 16\n"
+        "1:\n"
+        : [d] "+r" (d), [s] "+r" (s)
+        : [n] "r" (blocks)
+        : "memory");
+}
+
+#endif // MIXER_HAS_SIMD
+
+// ============================================================================
+// Reference (scalar) kernels
+// ============================================================================
+
+void mixer_add_sat_s16_ref(int16_t *dst, const int16_t *src, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = saturate_s16((int32_t)dst[i] + (int32_t)src[i]);
+    }
+}
+
+void mixer_scale_s16_ref(int16_t *dst, const int16_t *src, size_t count,
+                         uint32_t gain_from, uint32_t gain_to)
+{
+    // Fast paths: constant unity (copy) and constant mute
+    if (gain_from >= MIXER_GAIN_UNITY && gain_to >= MIXER_GAIN_UNITY) {
+        if (dst != src) {
+            memcpy(dst, src, count * sizeof(int16_t));
+        }
+        return;
+    }
+    if (gain_from == 0 && gain_to == 0) {
+        memset(dst, 0, count * sizeof(int16_t));
+        return;
+    }
+
+    int32_t gain = (int32_t)gain_from;
+    int32_t step = ramp_step(gain_from, gain_to, count);
+    int16_t g15 = gain_q15(gain);
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0 && (i % MIXER_SIMD_LANES) == 0) {
+            gain += step;
+            g15 = gain_q15(gain);
+        }
+        dst[i] = scale_sample(src[i], g15);
+    }
+}
+
+void mixer_scale_add_sat_s16_ref(int16_t *dst, const int16_t *src, size_t count,
+                                 uint32_t gain_from, uint32_t gain_to)
+{
+    // Fast paths: constant unity (plain mix) and constant mute (nothing to add)
+    if (gain_from >= MIXER_GAIN_UNITY && gain_to >= MIXER_GAIN_UNITY) {
+        mixer_add_sat_s16(dst, src, count);
+        return;
+    }
+    if (gain_from == 0 && gain_to == 0) {
+        return;
+    }
+
+    int32_t gain = (int32_t)gain_from;
+    int32_t step = ramp_step(gain_from, gain_to, count);
+    int16_t g15 = gain_q15(gain);
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0 && (i % MIXER_SIMD_LANES) == 0) {
+            gain += step;
+            g15 = gain_q15(gain);
+        }
+        dst[i] = saturate_s16((int32_t)dst[i] + scale_sample(src[i], g15));
+    }
+}
+
+void mixer_downmix_s16_ref(int16_t *dst, const int16_t *src, size_t frames)
+{
+    for (size_t i = 0; i < frames; i++) {
+        dst[i] = (int16_t)((src[2 * i] >> 1) + (src[2 * i + 1] >> 1));
+    }
+}
+
+// ============================================================================
+// Public kernels
+// ============================================================================
+
+void mixer_add_sat_s16(int16_t *dst, const int16_t *src, size_t count)
+{
+    size_t i = 0;
+
+#if MIXER_HAS_SIMD
+    size_t blocks = count / MIXER_SIMD_LANES;
+    if (blocks > 0 && is_simd_aligned(dst) && is_simd_aligned(src)) {
+        int16_t *d = dst;
+        const int16_t *s = src;
+        // q0 = *d; q1 = *s++; q0 = sat(q0 + q1); *d++ = q0
+        __asm__ volatile (
+            "loopnez %[n], 1f\n"
+            "ee.vld.128.ip q0, %[d], 0\n"
+            "ee.vld.128.ip q1, %[s], 16\n"
+            "ee.vadds.s16 q0, q0, q1\n"
+            "ee.vst.128.ip q0, %[d], 16\n"
+            "1:\n"
+            : [d] "+r" (d), [s] "+r" (s)
+            : [n] "r" (blocks)
+            : "memory");
+        i = blocks * MIXER_SIMD_LANES;
+    }
+#endif
+
+    mixer_add_sat_s16_ref(dst + i, src + i, count - i);
+}
+
+void mixer_scale_s16(int16_t *dst, const int16_t *src, size_t count,
+                     uint32_t gain_from, uint32_t gain_to)
+{
+#if MIXER_HAS_SIMD
+    size_t blocks = count / MIXER_SIMD_LANES;
+    if (!is_trivial_gain(gain_from, gain_to) && blocks > 0 &&
+        is_simd_aligned(dst) && is_simd_aligned(src)) {
+        int32_t gain = (int32_t)gain_from;
+        int16_t g15 = gain_q15(gain);
+        if (gain_from == gain_to) {
+            simd_load_gain(&g15);
+            simd_scale_blocks(dst, src, blocks);
+        } else {
+            int32_t step = ramp_step(gain_from, gain_to, count);
+            for (size_t b = 0; b < blocks; b++) {
+                g15 = gain_q15(gain);
+                simd_load_gain(&g15);
+                simd_scale_blocks(dst + b * MIXER_SIMD_LANES, src + b * MIXER_SIMD_LANES, 1);
+                gain += step;
+            }
+            g15 = gain_q15(gain);
+        }
+        for (size_t i = blocks * MIXER_SIMD_LANES; i < count; i++) {
+            dst[i] = scale_sample(src[i], g15);
+        }
+        return;
+    }
+#endif
+
+    mixer_scale_s16_ref(dst, src, count, gain_from, gain_to);
+}
+
+void mixer_scale_add_sat_s16(int16_t *dst, const int16_t *src, size_t count,
+                             uint32_t gain_from, uint32_t gain_to)
+{
+#if MIXER_HAS_SIMD
+    size_t blocks = count / MIXER_SIMD_LANES;
+    if (!is_trivial_gain(gain_from, gain_to) && blocks > 0 &&
+        is_simd_aligned(dst) && is_simd_aligned(src)) {
+        int32_t gain = (int32_t)gain_from;
+        int16_t g15 = gain_q15(gain);
+        if (gain_from == gain_to) {
+            simd_load_gain(&g15);
+            simd_scale_add_blocks(dst, src, blocks);
+        } else {
+            int32_t step = ramp_step(gain_from, gain_to, count);
+            for (size_t b = 0; b < blocks; b++) {
+                g15 = gain_q15(gain);
+                simd_load_gain(&g15);
+                simd_scale_add_blocks(dst + b * MIXER_SIMD_LANES, src + b * MIXER_SIMD_LANES, 1);
+                gain += step;
+            }
+            g15 = gain_q15(gain);
+        }
+        for (size_t i = blocks * MIXER_SIMD_LANES; i < count; i++) {
+            dst[i] = saturate_s16((int32_t)dst[i] + scale_sample(src[i], g15));
+        }
+        return;
+    }
+#endif
+
+    mixer_scale_add_sat_s16_ref(dst, src, count, gain_from, gain_to);
+}
+
+void mixer_downmix_s16(int16_t *dst, const int16_t *src, size_t frames)
+{
+    size_t i = 0;
+
+#if MIXER_HAS_SIMD
+    size_t blocks = frames / MIXER_SIMD_LANES;
+    if (blocks > 0 && is_simd_aligned(dst) && is_simd_aligned(src)) {
+        static const int16_t half = GAIN_Q15_HALF;
+        simd_load_gain(&half);
+        simd_downmix_blocks(dst, src, blocks);
+        i = blocks * MIXER_SIMD_LANES;
+    }
+#endif
+
+    mixer_downmix_s16_ref(dst + i, src + 2 * i, frames - i);
+}
+
+void mixer_narrow_s16(int16_t *dst, const uint8_t *src, size_t count, uint16_t sample_bytes,
+                      uint32_t *dither)
+{
+    const uint8_t *p = src + (sample_bytes - 3);   // 24 most significant bits
+    uint32_t seed = *dither;
+    for (size_t i = 0; i < count; i++, p += sample_bytes) {
+        int32_t x = (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) >> 8;
+        // Two uniform bytes of one LCG step: triangular, +/-255 (one 16-bit LSB)
+        seed = seed * 1664525u + 1013904223u;
+        int32_t tpdf = (int32_t)(seed >> 24) + (int32_t)((seed >> 16) & 0xFF) - 255;
+        dst[i] = saturate_s16((x + 128 + tpdf) >> 8);
+    }
+    *dither = seed;
+}
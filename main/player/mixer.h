@@ -0,0 +1,145 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file mixer.h
+ * @brief PCM sample kernels of the player voice mixer and the provider's
+ *        source format conversion (downmix, bit depth)
+ *
+ * On ESP32-S3 the kernels use the PIE 128-bit SIMD extension (8 x int16 per
+ * instruction) when both buffers are MIXER_BUFFER_ALIGN aligned. A scalar
+ * loop handles unaligned buffers, the tail samples, and other targets.
+ *
+ * PIE registers are saved lazily by FreeRTOS on context switch, which
+ * requires the calling task to be pinned to a core (the player, preload,
+ * streamer and MSC update tasks are).
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+/**
+ * @brief Required buffer alignment (bytes) for the SIMD path
+ */
+#define MIXER_BUFFER_ALIGN 16
+
+/**
+ * @brief Gain factor for 0 dB (Q16 fixed-point: sample * gain >> 16)
+ */
+#define MIXER_GAIN_UNITY 65536
+
+/**
+ * @brief true when the SIMD kernels are compiled in for this target
+ */
+#if CONFIG_IDF_TARGET_ESP32S3
+    #define MIXER_HAS_SIMD 1
+#else
+    #define MIXER_HAS_SIMD 0
+#endif
+
+/**
+ * @brief Saturating in-place mix: dst[i] = clamp(dst[i] + src[i])
+ *
+ * @param dst Accumulator buffer (mixed output)
+ * @param src Samples to add
+ * @param count Number of int16 samples
+ */
+void mixer_add_sat_s16(int16_t *dst, const int16_t *src, size_t count);
+
+/**
+ * @brief Fused scale-and-store with gain ramp: dst[i] = (src[i] * gain(i)) >> 16
+ *
+ * The gain moves linearly from gain_from to gain_to across the buffer (one
+ * step per 8 samples), which removes the zipper noise of volume changes at
+ * chunk boundaries. Pass the same value twice for a constant gain.
+ *
+ * Reads each source sample once, so src may point straight into the PSRAM
+ * cache. Constant unity gain degrades to memcpy(), constant zero gain to
+ * memset(). dst and src may be the same buffer (in-place scaling).
+ *
+ * @param dst Output buffer
+ * @param src Input samples
+ * @param count Number of int16 samples
+ * @param gain_from Q16 gain at the first sample (0 = mute, MIXER_GAIN_UNITY = 0 dB)
+ * @param gain_to Q16 gain reached at the end of the buffer
+ */
+void mixer_scale_s16(int16_t *dst, const int16_t *src, size_t count,
+                     uint32_t gain_from, uint32_t gain_to);
+
+/**
+ * @brief Fused scale-and-mix with gain ramp: dst[i] = clamp(dst[i] + ((src[i] * gain(i)) >> 16))
+ *
+ * Same as mixer_scale_s16() followed by mixer_add_sat_s16(), without the
+ * scratch buffer in between. Constant zero gain leaves dst untouched.
+ *
+ * @param dst Accumulator buffer (mixed output)
+ * @param src Samples to scale and add
+ * @param count Number of int16 samples
+ * @param gain_from Q16 gain at the first sample (0 = mute, MIXER_GAIN_UNITY = 0 dB)
+ * @param gain_to Q16 gain reached at the end of the buffer
+ */
+void mixer_scale_add_sat_s16(int16_t *dst, const int16_t *src, size_t count,
+                             uint32_t gain_from, uint32_t gain_to);
+
+/**
+ * @brief Stereo to mono downmix: dst[i] = (src[2i] >> 1) + (src[2i + 1] >> 1)
+ *
+ * Each channel is halved before the sum, so the result never clips. dst may
+ * be src (in place: each output sample lands before the frame it comes from).
+ *
+ * @param dst Mono output (frames samples)
+ * @param src Interleaved stereo input (2 * frames samples)
+ * @param frames Number of stereo frames
+ */
+void mixer_downmix_s16(int16_t *dst, const int16_t *src, size_t frames);
+
+/**
+ * @brief Reduce 24-bit or 32-bit little-endian PCM to 16 bits with TPDF dither
+ *
+ * Keeps the 24 most significant bits of each sample, adds triangular dither
+ * of +/-1 output LSB, rounds and saturates. Scalar only: packed 24-bit
+ * samples do not map onto SIMD lanes. dst may be src (in place).
+ *
+ * @param dst 16-bit output (count samples)
+ * @param src Packed samples (count * sample_bytes bytes)
+ * @param count Number of samples
+ * @param sample_bytes Bytes per input sample (3 or 4)
+ * @param dither Dither generator state, carried across calls
+ */
+void mixer_narrow_s16(int16_t *dst, const uint8_t *src, size_t count, uint16_t sample_bytes,
+                      uint32_t *dither);
+
+/**
+ * @brief Scalar reference kernels (same results as the SIMD path)
+ *
+ * Used by the microbenchmark to compare against and validate the SIMD kernels.
+ */
+void mixer_add_sat_s16_ref(int16_t *dst, const int16_t *src, size_t count);
+void mixer_scale_s16_ref(int16_t *dst, const int16_t *src, size_t count,
+                         uint32_t gain_from, uint32_t gain_to);
+void mixer_scale_add_sat_s16_ref(int16_t *dst, const int16_t *src, size_t count,
+                                 uint32_t gain_from, uint32_t gain_to);
+void mixer_downmix_s16_ref(int16_t *dst, const int16_t *src, size_t frames);
+
+/**
+ * @brief Run the kernel microbenchmark and print cycles/sample per variant
+ *
+ * Runs every kernel (SIMD and scalar reference; constant, ramp, mute and
+ * unity gain) on a pinned task on the audio core, checks that SIMD and
+ * reference outputs match, and prints the results to the console.
+ *
+ * @param samples Buffer size in samples (rounded down to a multiple of 8)
+ * @param iterations Number of runs per variant (cycles are averaged)
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if samples or iterations is 0
+ *     - ESP_ERR_NO_MEM if buffers or the benchmark task cannot be allocated
+ */
+esp_err_t mixer_run_benchmark(size_t samples, int iterations);
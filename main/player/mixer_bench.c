@@ -0,0 +1,200 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file mixer_bench.c
+ * @brief Cycles/sample microbenchmark of the mixer kernels
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "mixer.h"
+
+static const char *TAG = "mixer";
+
+#define BENCH_TASK_STACK_SIZE  4096
+#define BENCH_TASK_PRIORITY    1    // Below player task: playback keeps priority
+#define BENCH_TASK_CORE        1    // Audio core (same as player task)
+
+#define GAIN_HALF      (MIXER_GAIN_UNITY / 2)             // -6 dB
+#define GAIN_RAMP_FROM (MIXER_GAIN_UNITY / 4)
+#define GAIN_RAMP_TO   (MIXER_GAIN_UNITY * 3 / 4)
+
+typedef void (*bench_kernel_fn)(int16_t *dst, const int16_t *src, size_t count,
+                                uint32_t gain_from, uint32_t gain_to);
+
+/**
+ * @brief One benchmarked kernel: optimized and reference implementations
+ */
+typedef struct {
+    const char *name;
+    bench_kernel_fn kernel;
+    bench_kernel_fn reference;
+    uint32_t gain_from;
+    uint32_t gain_to;
+    bool psram_src;         // Source in PSRAM (cache-hit case)
+} bench_variant_t;
+
+typedef struct {
+    size_t samples;
+    int iterations;
+    esp_err_t result;
+    SemaphoreHandle_t done;
+} bench_ctx_t;
+
+static void add_sat(int16_t *dst, const int16_t *src, size_t count, uint32_t g0, uint32_t g1)
+{
+    (void)g0;
+    (void)g1;
+    mixer_add_sat_s16(dst, src, count);
+}
+
+static void add_sat_ref(int16_t *dst, const int16_t *src, size_t count, uint32_t g0, uint32_t g1)
+{
+    (void)g0;
+    (void)g1;
+    mixer_add_sat_s16_ref(dst, src, count);
+}
+
+// count interleaved stereo samples in, count / 2 mono samples out
+static void downmix(int16_t *dst, const int16_t *src, size_t count, uint32_t g0, uint32_t g1)
+{
+    (void)g0;
+    (void)g1;
+    mixer_downmix_s16(dst, src, count / 2);
+}
+
+static void downmix_ref(int16_t *dst, const int16_t *src, size_t count, uint32_t g0, uint32_t g1)
+{
+    (void)g0;
+    (void)g1;
+    mixer_downmix_s16_ref(dst, src, count / 2);
+}
+
+static const bench_variant_t s_variants[] = {
+    { "add_sat",            add_sat,                 add_sat_ref,                 0,                0,                false },
+    { "scale const",        mixer_scale_s16,         mixer_scale_s16_ref,         GAIN_HALF,        GAIN_HALF,        false },
+    { "scale const (psram)", mixer_scale_s16,        mixer_scale_s16_ref,         GAIN_HALF,        GAIN_HALF,        true  },
+    { "scale ramp",         mixer_scale_s16,         mixer_scale_s16_ref,         GAIN_RAMP_FROM,   GAIN_RAMP_TO,     false },
+    { "scale mute",         mixer_scale_s16,         mixer_scale_s16_ref,         0,                0,                false },
+    { "scale unity",        mixer_scale_s16,         mixer_scale_s16_ref,         MIXER_GAIN_UNITY, MIXER_GAIN_UNITY, false },
+    { "scale_add const",    mixer_scale_add_sat_s16, mixer_scale_add_sat_s16_ref, GAIN_HALF,        GAIN_HALF,        false },
+    { "scale_add ramp",     mixer_scale_add_sat_s16, mixer_scale_add_sat_s16_ref, GAIN_RAMP_FROM,   GAIN_RAMP_TO,     false },
+    { "downmix",            downmix,                 downmix_ref,                 0,                0,                false },
+};
+
+static void fill_pattern(int16_t *buf, size_t count, uint32_t seed)
+{
+    // Full-scale pseudo-random samples (exercises saturation)
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        buf[i] = (int16_t)(seed >> 16);
+    }
+}
+
+static double run_cycles_per_sample(bench_kernel_fn fn, const bench_variant_t *v,
+                                    int16_t *dst, const int16_t *src,
+                                    size_t samples, int iterations)
+{
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < iterations; i++) {
+        fn(dst, src, samples, v->gain_from, v->gain_to);
+    }
+    uint32_t cycles = esp_cpu_get_cycle_count() - start;
+    return (double)cycles / ((double)samples * iterations);
+}
+
+static void bench_task(void *arg)
+{
+    bench_ctx_t *ctx = (bench_ctx_t *)arg;
+    size_t bytes = ctx->samples * sizeof(int16_t);
+
+    int16_t *src = heap_caps_aligned_alloc(MIXER_BUFFER_ALIGN, bytes, MALLOC_CAP_INTERNAL);
+    int16_t *src_psram = heap_caps_aligned_alloc(MIXER_BUFFER_ALIGN, bytes, MALLOC_CAP_SPIRAM);
+    int16_t *dst = heap_caps_aligned_alloc(MIXER_BUFFER_ALIGN, bytes, MALLOC_CAP_INTERNAL);
+    int16_t *dst_ref = heap_caps_aligned_alloc(MIXER_BUFFER_ALIGN, bytes, MALLOC_CAP_INTERNAL);
+    if (!src || !dst || !dst_ref) {
+        ctx->result = ESP_ERR_NO_MEM;
+        goto done;
+    }
+
+    fill_pattern(src, ctx->samples, 1);
+    if (src_psram) {
+        memcpy(src_psram, src, bytes);
+    }
+
+    printf("Mixer kernel benchmark (%zu samples, %d runs, core %d, %s kernels):\n",
+           ctx->samples, ctx->iterations, BENCH_TASK_CORE, MIXER_HAS_SIMD ? "SIMD" : "scalar");
+    printf("  %-20s %10s %10s %8s  %s\n", "Kernel", "opt c/s", "ref c/s", "speedup", "check");
+
+    for (size_t i = 0; i < sizeof(s_variants) / sizeof(s_variants[0]); i++) {
+        const bench_variant_t *v = &s_variants[i];
+        const int16_t *s = v->psram_src ? src_psram : src;
+        if (s == NULL) {
+            printf("  %-20s (no PSRAM)\n", v->name);
+            continue;
+        }
+
+        // Bit-exactness check from identical accumulator contents
+        fill_pattern(dst, ctx->samples, 2);
+        fill_pattern(dst_ref, ctx->samples, 2);
+        v->kernel(dst, s, ctx->samples, v->gain_from, v->gain_to);
+        v->reference(dst_ref, s, ctx->samples, v->gain_from, v->gain_to);
+        bool match = (memcmp(dst, dst_ref, bytes) == 0);
+
+        double opt = run_cycles_per_sample(v->kernel, v, dst, s, ctx->samples, ctx->iterations);
+        double ref = run_cycles_per_sample(v->reference, v, dst_ref, s, ctx->samples, ctx->iterations);
+        printf("  %-20s %10.2f %10.2f %7.1fx  %s\n",
+               v->name, opt, ref, opt > 0 ? ref / opt : 0.0, match ? "OK" : "MISMATCH");
+        if (!match) {
+            ESP_LOGW(TAG, "Kernel '%s' differs from reference", v->name);
+        }
+    }
+    ctx->result = ESP_OK;
+
+done:
+    heap_caps_free(src);
+    heap_caps_free(src_psram);
+    heap_caps_free(dst);
+    heap_caps_free(dst_ref);
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+esp_err_t mixer_run_benchmark(size_t samples, int iterations)
+{
+    samples -= samples % 8;
+    if (samples == 0 || iterations <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bench_ctx_t ctx = {
+        .samples = samples,
+        .iterations = iterations,
+        .result = ESP_FAIL,
+        .done = xSemaphoreCreateBinary(),
+    };
+    if (ctx.done == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // PIE registers need a pinned task: run on the audio core like the player
+    if (xTaskCreatePinnedToCore(bench_task, "mixbench", BENCH_TASK_STACK_SIZE, &ctx,
+                                BENCH_TASK_PRIORITY, NULL, BENCH_TASK_CORE) != pdPASS) {
+        vSemaphoreDelete(ctx.done);
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(ctx.done, portMAX_DELAY);
+    vSemaphoreDelete(ctx.done);
+    return ctx.result;
+}
@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file msg_ring.c
+ * @brief Bounded many-producer / single-consumer ring (per-slot sequence numbers)
+ *
+ * Slot i starts with sequence i. A producer owning position pos finds
+ * seq == pos (free), copies the message and stores pos + 1 (published).
+ * The consumer at position pos waits for seq == pos + 1, copies the
+ * message out and stores pos + depth (free for the next lap).
+ */
+
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "msg_ring.h"
+
+struct msg_ring_s {
+    uint32_t mask;                      // depth - 1
+    size_t item_size;
+    size_t slot_size;                   // Sequence number + message, 4-byte aligned
+    uint32_t head;                      // Next position to claim (producers, CAS)
+    uint32_t tail;                      // Next position to read (consumer)
+    uint8_t slots[];
+};
+
+static inline uint32_t *slot_seq(const msg_ring_t *ring, uint32_t pos)
+{
+    return (uint32_t *)(ring->slots + (size_t)(pos & ring->mask) * ring->slot_size);
+}
+
+esp_err_t msg_ring_create(uint32_t depth, size_t item_size, msg_ring_t **ring)
+{
+    if (ring == NULL || depth < 2 || (depth & (depth - 1)) != 0 || item_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t slot_size = (sizeof(uint32_t) + item_size + 3) & ~(size_t)3;
+    msg_ring_t *r = heap_caps_malloc(sizeof(msg_ring_t) + depth * slot_size,
+                                     MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (r == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    r->mask = depth - 1;
+    r->item_size = item_size;
+    r->slot_size = slot_size;
+    r->head = 0;
+    r->tail = 0;
+    for (uint32_t i = 0; i < depth; i++) {
+        *slot_seq(r, i) = i;
+    }
+
+    *ring = r;
+    return ESP_OK;
+}
+
+void msg_ring_destroy(msg_ring_t *ring)
+{
+    heap_caps_free(ring);
+}
+
+bool msg_ring_push(msg_ring_t *ring, const void *item)
+{
+    uint32_t pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    uint32_t *seq;
+    for (;;) {
+        seq = slot_seq(ring, pos);
+        int32_t diff = (int32_t)(__atomic_load_n(seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            // Free slot: claim it (pos is reloaded on failure)
+            if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;   // Slot of the previous lap not read yet: full
+        } else {
+            pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);  // Claimed by another producer
+        }
+    }
+
+    memcpy(seq + 1, item, ring->item_size);
+    __atomic_store_n(seq, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool msg_ring_pop(msg_ring_t *ring, void *item)
+{
+    uint32_t pos = ring->tail;
+    uint32_t *seq = slot_seq(ring, pos);
+    if (__atomic_load_n(seq, __ATOMIC_ACQUIRE) != pos + 1) {
+        return false;   // Empty, or the oldest slot is claimed but not published yet
+    }
+
+    memcpy(item, seq + 1, ring->item_size);
+    __atomic_store_n(seq, pos + ring->mask + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->tail, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t msg_ring_count(const msg_ring_t *ring)
+{
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    return head - tail;
+}
@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file msg_ring.h
+ * @brief Bounded lock-free message ring (many producers, one consumer)
+ *
+ * Fixed-size messages are copied into a power-of-two array of slots. Each
+ * slot carries a sequence number: producers claim a slot with a
+ * compare-and-swap on the head index and publish it by advancing the
+ * sequence, the consumer reads published slots in order and hands them back
+ * by advancing the sequence again. Neither side takes a lock or enters a
+ * critical section, so a producer on core 0 never delays the consumer on
+ * core 1 (a producer preempted between claim and publish only hides the
+ * slots queued after it until it resumes).
+ *
+ * The ring does not block: consumers pair it with a task notification
+ * (producer: msg_ring_push() then xTaskNotifyGive(); consumer: drain with
+ * msg_ring_pop(), then ulTaskNotifyTake()).
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/**
+ * @brief Message ring (opaque)
+ */
+typedef struct msg_ring_s msg_ring_t;
+
+/**
+ * @brief Create a ring (internal RAM)
+ *
+ * @param depth Number of slots (power of two)
+ * @param item_size Message size in bytes
+ * @param[out] ring Ring (on success)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, or ESP_ERR_NO_MEM
+ */
+esp_err_t msg_ring_create(uint32_t depth, size_t item_size, msg_ring_t **ring);
+
+/**
+ * @brief Free a ring (NULL-safe). No task may still use it.
+ */
+void msg_ring_destroy(msg_ring_t *ring);
+
+/**
+ * @brief Copy a message into the ring (any task, lock-free)
+ *
+ * @return true if queued, false if the ring is full
+ */
+bool msg_ring_push(msg_ring_t *ring, const void *item);
+
+/**
+ * @brief Copy the oldest published message out of the ring (consumer task only)
+ *
+ * @return true if a message was read, false if none is published
+ */
+bool msg_ring_pop(msg_ring_t *ring, void *item);
+
+/**
+ * @brief Messages claimed and not read yet (any task, approximate)
+ */
+uint32_t msg_ring_count(const msg_ring_t *ring);
@@ -5,19 +5,30 @@
  */
 
 
+#include <sys/stat.h>
 #include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"  // IWYU pragma: keep
 #include "esp_log.h"
 #include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
 #include "driver/i2s_std.h"
 #include "driver/gpio.h"
 #include "player.h"
 #include "provider.h"
+#include "mixer.h"
+#include "msg_ring.h"
 #include "persistent_volume.h"
 
 #ifdef CONFIG_SOUNDBOARD_IO_STATS_ENABLE
     #include "benchmark.h"
 #endif
+#ifdef CONFIG_SOUNDBOARD_LATENCY_STATS_ENABLE
+    #include "latency.h"
+#endif
+#ifdef CONFIG_SOUNDBOARD_TRACE_ENABLE
+    #include "trace.h"
+#endif
 
 static const char *TAG = "player";
 
@@ -25,24 +36,59 @@ static const char *TAG = "player";
 #define PLAYER_TASK_PRIORITY        2       // Run between input scanner (3) and idle (0)
 #define PLAYER_TASK_STACK_SIZE      8192    // Sufficient for file I/O, decoding, I2S transfers
 #define PLAYER_TASK_CORE_ID         1       // Pin to core 1 (APP_CPU) for real-time audio
-#define PLAYER_CMD_QUEUE_DEPTH      10      // Command queue depth (PLAY/STOP commands)
+#define PLAYER_CMD_RING_DEPTH       16      // Command ring depth (PLAY/STOP commands, power of two)
+#define PLAYER_CMD_SEND_TIMEOUT_MS  100     // Producer retry time when the command ring is full
 
-// I2S DMA buffer architecture (ESP-IDF I2S_CHANNEL_DEFAULT_CONFIG):
-//   dma_desc_num  = 6    -- number of DMA descriptors (ring buffer of 6 slots)
-//   dma_frame_num = 240  -- audio frames per descriptor
+// I2S DMA buffer architecture:
+//   dma_desc_num  -- number of DMA descriptors (ring buffer of slots)
+//   dma_frame_num -- audio frames per descriptor
 //   One frame = one sample per channel. For mono 16-bit: 240 frames = 480 bytes.
-//   Total DMA ring: 6 * 480 = 2880 bytes (~30 ms at 48 kHz mono).
 //
 // i2s_channel_write() copies our PCM buffer into the DMA ring and blocks until
-// space is available. Sizing the PCM buffer to a multiple of dma_frame_num
-// avoids partial descriptor fills and keeps writes aligned.
+// space is available. The mix chunk is 2 * dma_frame_num samples: each write
+// fills exactly 2 descriptors in mono (1 in stereo), which avoids partial
+// descriptor fills and halves the per-chunk overhead vs single-descriptor.
+// Commands are serviced between chunks; the other descriptors are the runway
+// before an underrun.
 //
-// PCM_BUFFER_SIZE = 480 samples = 2 * dma_frame_num (mono 16-bit)
-//   -> each i2s_channel_write() fills exactly 2 DMA descriptors (~10 ms at 48 kHz)
-//   -> remaining 4 descriptors provide ~20 ms of runway before underrun
-//   -> stop/play commands are serviced within ~10 ms (good responsiveness)
-//   -> 2-descriptor batching halves the per-chunk overhead vs single-descriptor
-#define PCM_BUFFER_SIZE 480
+// Profiles (player_dma_profile_t), durations at 48 kHz mono:
+//   LOW_LATENCY  4 x 120 frames:  5 ms chunks, 10 ms ring (cached sounds)
+//   BALANCED     6 x 240 frames: 10 ms chunks, 30 ms ring (I2S_CHANNEL_DEFAULT_CONFIG)
+//   ROBUST       8 x 480 frames: 20 ms chunks, 80 ms ring (sounds streamed from SD)
+//
+// The driver fixes the DMA layout at channel creation: changing profile
+// deletes and recreates the channel, which the player only does when a sound
+// starts with no other voice playing. PCM_BUFFER_SIZE is the largest chunk.
+#define PCM_BUFFER_SIZE 960
+
+/**
+ * @brief DMA ring layout of a profile
+ */
+typedef struct {
+    uint32_t desc_num;          // DMA descriptors
+    uint32_t frame_num;         // Frames per descriptor (chunk = 2 * frame_num samples)
+} dma_layout_t;
+
+static const dma_layout_t dma_layouts[PLAYER_DMA_PROFILE_COUNT] = {
+    [PLAYER_DMA_PROFILE_LOW_LATENCY] = { .desc_num = 4, .frame_num = 120 },
+    [PLAYER_DMA_PROFILE_BALANCED]    = { .desc_num = 6, .frame_num = 240 },
+    [PLAYER_DMA_PROFILE_ROBUST]      = { .desc_num = 8, .frame_num = 480 },
+};
+
+static const char *const dma_profile_names[PLAYER_DMA_PROFILE_COUNT] = {
+    [PLAYER_DMA_PROFILE_AUTO]        = "auto",
+    [PLAYER_DMA_PROFILE_LOW_LATENCY] = "low_latency",
+    [PLAYER_DMA_PROFILE_BALANCED]    = "balanced",
+    [PLAYER_DMA_PROFILE_ROBUST]      = "robust",
+};
+
+// Ring used with PLAYER_DMA_PROFILE_AUTO until the first sound picks one
+#define DMA_PROFILE_AUTO_INITIAL PLAYER_DMA_PROFILE_LOW_LATENCY
+
+// Polyphony: every voice is read, scaled and mixed into pcm_buf once per chunk,
+// so the I2S write cadence (~10 ms) does not depend on the number of voices.
+#define PLAYER_MAX_VOICES CONFIG_SOUNDBOARD_PLAYER_VOICES
+#define PLAYER_VOICE_NAME_LEN 48    // Name copy shown by status (truncated)
 
 #define I2S_WRITE_TIMEOUT_MS 100
 
@@ -60,7 +106,8 @@ static const char *TAG = "player";
 
 // Software volume control (MAX98357A has no hardware volume)
 #define VOLUME_LEVELS 32
-#define VOLUME_FACTOR_UNITY 65536  // 65536 = 0dB (unity gain), 16-bit fixed-point
+#define VOLUME_FACTOR_UNITY MIXER_GAIN_UNITY  // 65536 = 0dB (unity gain), 16-bit fixed-point
+#define VOLUME_GAIN_NONE    UINT32_MAX           // No gain applied yet (next chunk starts unramped)
 
 /**
  * @brief Logarithmic volume lookup table (32 entries)
@@ -87,20 +134,64 @@ typedef enum {
 } player_cmd_type_t;
 
 /**
- * @brief Player command message 
+ * @brief Player command message
+ *
+ * Sounds travel as IDs of the provider's sound table. A path is only
+ * carried (heap copy, freed by the player task) for a file that could not
+ * be resolved because the table is full.
  */
 typedef struct {
     player_cmd_type_t type;
-    union {
-        struct {
-            char filename[SOUNDBOARD_MAX_PATH_LEN];
-        } play;
-        struct {
-            bool interrupt_now;  /* true=stop playing as fast as possible. false= stop loop timer and finish playing current sample*/
-        } stop;
-    };
+    bool interrupt_now;         /* STOP: true=stop playing as fast as possible. false= stop loop timer and finish playing current sample*/
+    audio_sound_id_t sound_id;  /* PLAY: sound to open. STOP: only voices playing it (NONE and no path = all voices) */
+    char *path;                 /* Unresolved file, used when sound_id is AUDIO_SOUND_ID_NONE (owned by the command) */
+#ifdef LATENCY_STATS_ENABLE
+    latency_trace_t trace;      /* PLAY: press-to-sound timestamps */
+#endif
 } player_cmd_t;
 
+/**
+ * @brief One mixer voice (a stream being played)
+ *
+ * CPU counters cover provider read + volume + mix for this voice. They are
+ * reset when the voice starts a new sound and kept after it ends, so status
+ * shows the cost of the last sound played on each voice.
+ */
+typedef struct {
+    audio_stream_handle_t stream;               // NULL when the voice is free
+    audio_sound_id_t sound_id;                  // AUDIO_SOUND_ID_NONE for an unresolved file
+    const char *name;                           // Interned name, or owned_name
+    char *owned_name;                           // Path of an unresolved file (freed when the voice is reused)
+    char status_name[PLAYER_VOICE_NAME_LEN];    // Copy of name read by status from the console task
+    uint32_t start_seq;                         // Start order, oldest voice is stolen first
+    uint64_t busy_us;                           // Time spent on this voice
+    uint32_t chunks;                            // Chunks mixed from this voice
+#ifdef LATENCY_STATS_ENABLE
+    latency_trace_t trace;                      // Start latency, recorded at the first I2S write
+    bool trace_pending;
+    bool cache_hit;
+#endif
+} player_voice_t;
+
+/**
+ * @brief Mixer timing counters (since boot)
+ *
+ * busy_us is the mix time per chunk, excluding the blocking I2S write.
+ * budget_us is the audio duration of the chunks written: headroom is
+ * 1 - busy_us / budget_us.
+ */
+typedef struct {
+    uint64_t busy_us;
+    uint64_t budget_us;
+    uint32_t chunks;
+    uint32_t peak_us;
+    uint32_t direct_chunks;     // Chunks written straight from the PSRAM cache (no copy)
+    uint32_t ramp_chunks;       // Chunks with a gain ramp (volume change)
+    uint32_t span_reads;        // Cache-hit voice reads without memcpy()
+    uint32_t copy_reads;        // File stream voice reads (copied into a buffer)
+    uint32_t jitter_peak_us;    // Worst late I2S write (interval beyond the previous chunk's duration)
+} mixer_stats_t;
+
 /**
  * @brief Player task state
  */
@@ -108,18 +199,40 @@ typedef struct player_s {
     // Task handle
     TaskHandle_t player_task_handle;
 
-    // Command queue (public API → player task)
-    QueueHandle_t cmd_queue;
+    // Command ring (public API → player task, woken by task notification)
+    msg_ring_t *cmd_ring;
+    uint32_t cmd_ring_full;         // Sends that found the ring full (any task, __atomic)
 
     // i2s channel handle (from I2S driver)
     i2s_chan_handle_t i2s_channel;
+
+    // I2S DMA profile (ring rebuilt by the player task when a sound starts alone)
+    player_dma_profile_t dma_selected;  // Kconfig / player_set_dma_profile(), may be AUTO (__atomic)
+    player_dma_profile_t dma_active;    // Layout of the current channel (player task)
+    size_t chunk_samples;               // Mix chunk of the active profile (<= PCM_BUFFER_SIZE)
+    uint32_t underruns;                 // Send queue overflows while armed (I2S ISR, __atomic)
+    bool underrun_armed;                // Playing with the DMA ring filled once (read by the ISR)
+    uint32_t run_frames;                // Frames written since playback started (arming)
     
     // Streaming resources (persistent)
     audio_provider_handle_t provider;
-    int16_t *pcm_buf;       // buffer between audio_provider and i2s_channel_write
-
-    // Stream resources (NULL when not playing)
-    audio_stream_handle_t stream;
+    int16_t *pcm_buf;       // buffer between audio_provider and i2s_channel_write (mix output)
+    int16_t *mix_buf;       // scratch buffer for voices mixed into pcm_buf
+
+    // Voices (stream == NULL when free)
+    player_voice_t voices[PLAYER_MAX_VOICES];
+    int active_voices;
+    uint32_t voice_seq;
+    player_voice_t *lead_voice;     // Most recently started voice (progress events)
+    mixer_stats_t mixer;
+    int64_t last_write_us;          // Return of the previous I2S write (0: idle since)
+    uint32_t last_chunk_us;         // Audio duration of the previous chunk
+
+    // Timing window (player_get_timing()), cleared by the player task on request
+    player_timing_t timing;
+    bool timing_reset;              // Set by player_reset_timing() (__atomic)
+    uint32_t timing_cmd_base;       // cmd_ring_full at the last reset
+    uint32_t timing_underrun_base;  // underruns at the last reset
 
     // callback to notify player state changes event to other modules (e.g. display)
     player_event_callback_t event_cb;
@@ -131,13 +244,11 @@ typedef struct player_s {
     uint8_t last_channels;
 
     // Software volume control (logarithmic scaling for MAX98357A)
-    SemaphoreHandle_t volume_mutex;  // Protects sw_volume_factor and vol_current
-    uint32_t sw_volume_factor;  // 0=mute, 65536=unity (from volume_table[])
-    uint8_t vol_current;        // Current volume index (0 to VOLUME_LEVELS-1)
+    uint32_t vol_current;       // Current volume index (0 to VOLUME_LEVELS-1), any task (__atomic)
+    uint32_t gain_applied;      // Gain at the end of the last chunk, ramp start (player task only)
 
     // Progress reporting (time-throttled to avoid display queue flood)
     TickType_t last_progress_tick;    // Last tick when progress was sent
-    char current_filename[SOUNDBOARD_MAX_PATH_LEN]; // Filename of current stream (for progress events)
 
 } player_state_t;
 
@@ -167,16 +278,19 @@ static void fire_event_close(player_state_t *player, player_event_name_t event,
 }
 
 /**
- * @brief Fire PLAYER_EVENT_STARTED with the filename being played
+ * @brief Fire PLAYER_EVENT_STARTED with the sound a voice starts
  */
-static void fire_event_started(player_state_t *player, const char *filename)
+static void fire_event_started(player_state_t *player, const player_voice_t *voice)
 {
     if (player->event_cb == NULL) {
         return;
     }
     player_event_data_t data = {
         .name = PLAYER_EVENT_STARTED,
-        .filename = filename,
+        .playback = {
+            .filename = voice->name,
+            .sound_id = voice->sound_id,
+        },
     };
     player->event_cb(&data, player->event_cb_ctx);
 }
@@ -189,7 +303,7 @@ static void fire_event_started(player_state_t *player, const char *filename)
  */
 static void fire_event_progress(player_state_t *player)
 {
-    if (player->event_cb == NULL) {
+    if (player->event_cb == NULL || player->lead_voice == NULL) {
         return;
     }
     TickType_t now = xTaskGetTickCount();
@@ -197,11 +311,12 @@ static void fire_event_progress(player_state_t *player)
         return;
     }
     player->last_progress_tick = now;
-    uint16_t progress = audio_provider_get_stream_progress(player->stream);
+    uint16_t progress = audio_provider_get_stream_progress(player->lead_voice->stream);
     player_event_data_t data = {
         .name = PLAYER_EVENT_PROGRESS,
         .playback = {
-            .filename = player->current_filename,
+            .filename = player->lead_voice->name,
+            .sound_id = player->lead_voice->sound_id,
             .progress = progress,
         },
     };
@@ -227,81 +342,6 @@ static void fire_event_volume(player_state_t *player, player_event_name_t event,
  * Audio processing helpers
  * ------------------------------------------------------------------------- */
 
-static void apply_software_volume(int16_t *buffer, size_t sample_count, uint32_t factor)
-{
-    // Skip if full volume (no scaling needed)
-    if (factor >= VOLUME_FACTOR_UNITY) {
-        return;
-    }
-
-    // Mute case - zero all samples
-    if (factor == 0) {
-        memset(buffer, 0, sample_count * sizeof(int16_t));
-        return;
-    }
-
-    // Apply scaling: sample = (sample * factor) >> 16
-    for (size_t i = 0; i < sample_count; i++) {
-        int32_t scaled = ((int32_t)buffer[i] * (int32_t)factor) >> 16;
-        buffer[i] = (int16_t)scaled;
-    }
-}
-
-/**
- * @brief Transfer PCM data chunk from provider to I2S device
- *
- * Reads a chunk of samples from the audio stream, applies software volume,
- * and writes them to the I2S device. Called repeatedly for continuous playback.
- *
- * @param[in] player Player state containing provider and I2S channel handles
- * @param[out] bytes_written Number of bytes successfully written to I2S (0 = end of stream)
- * @return ESP_OK on success or end of stream, error code otherwise
- */
-static esp_err_t send_chunk(player_state_t *player, size_t *bytes_written)
-{
-    *bytes_written = 0;
-
-    // Read samples from provider
-    size_t samples_read = 0;
-    esp_err_t ret = audio_provider_read_stream(player->stream, player->pcm_buf, PCM_BUFFER_SIZE, &samples_read);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Provider read error: %s", esp_err_to_name(ret));
-        return ret;
-    }
-
-    // End of stream - no more samples available
-    if (samples_read == 0) {
-        ESP_LOGD(TAG, "End of stream reached");
-        return ESP_OK;
-    }
-
-    // Apply software volume control (read factor under mutex)
-    xSemaphoreTake(player->volume_mutex, portMAX_DELAY);
-    uint32_t volume_factor = player->sw_volume_factor;
-    xSemaphoreGive(player->volume_mutex);
-    apply_software_volume(player->pcm_buf, samples_read, volume_factor);
-
-    // Note: MAX98357A with SD pin pulled to 1MOhm outputs Left channel only.
-    // If stereo mixing is needed, implement L+R mix here before I2S write.
-    // Currently deferred until hardware testing confirms unmixed audio issue.
-
-    // Write samples to I2S device
-    size_t bytes_to_write = samples_read * sizeof(int16_t);
-#ifdef IO_STATS_ENABLE
-    int64_t start_us = benchmark_start();
-#endif
-    ret = i2s_channel_write(player->i2s_channel, player->pcm_buf, bytes_to_write, bytes_written, I2S_WRITE_TIMEOUT_MS);
-#ifdef IO_STATS_ENABLE
-    benchmark_record(BENCH_I2S_WRITE, start_us, *bytes_written);
-#endif
-    if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "I2S write error: %s", esp_err_to_name(ret));
-        return ret;
-    }
-    return ESP_OK;
-}
-
-
 static bool i2s_sd_gpio_initialized = false;
 
 /**
@@ -338,20 +378,61 @@ static esp_err_t set_i2s_sd_gpio(bool enable)
     return ESP_OK;
 }
 
+/**
+ * @brief Standard-mode slot configuration for a stream format
+ */
+static i2s_std_slot_config_t std_slot_config(uint16_t channels, uint16_t bit_depth)
+{
+    i2s_data_bit_width_t bit_width = I2S_DATA_BIT_WIDTH_16BIT;
+    if (bit_depth == 24) {
+        bit_width = I2S_DATA_BIT_WIDTH_24BIT;
+    } else if (bit_depth == 32) {
+        bit_width = I2S_DATA_BIT_WIDTH_32BIT;
+    }
+    i2s_slot_mode_t slot_mode = (channels == 1) ? I2S_SLOT_MODE_MONO : I2S_SLOT_MODE_STEREO;
+
+    i2s_std_slot_config_t slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(bit_width, slot_mode);
+    return slot_cfg;
+}
+
+/**
+ * @brief I2S send queue overflow (ISR): the DMA finished a descriptor while
+ *        every other one was already played, i.e. the ring ran dry
+ *
+ * The DMA keeps cycling while no sound plays, so overflows only count while
+ * the player task has armed the counter (see underrun_armed).
+ */
+static bool IRAM_ATTR i2s_on_send_q_ovf(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    player_state_t *player = (player_state_t *)user_ctx;
+    if (__atomic_load_n(&player->underrun_armed, __ATOMIC_RELAXED)) {
+        __atomic_add_fetch(&player->underruns, 1, __ATOMIC_RELAXED);
+    }
+    return false;
+}
+
 /**
  * @brief Initialize I2S channel for audio output
  *
- * Creates and configures the I2S channel with standard Philips mode.
- * Uses GPIOs defined in Kconfig for LRC, BCLK, and DIN.
+ * Creates and configures the I2S channel with standard Philips mode and the
+ * DMA layout of the given profile. Uses GPIOs defined in Kconfig for LRC,
+ * BCLK, and DIN.
  *
  * @param player Player state to store channel handle
+ * @param profile DMA profile (not AUTO)
+ * @param frame_rate Sample rate (the fixed output rate, if configured)
+ * @param channels Number of channels (1=mono, 2=stereo)
+ * @param bit_depth Bits per sample
  * @return ESP_OK on success
  */
-static esp_err_t init_i2s_channel(player_state_t *player)
+static esp_err_t init_i2s_channel(player_state_t *player, player_dma_profile_t profile,
+                                  uint32_t frame_rate, uint16_t channels, uint16_t bit_depth)
 {
     // Channel configuration
     i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER);
-    chan_cfg.auto_clear = true;  // Clear DMA buffer on underflow
+    chan_cfg.dma_desc_num = dma_layouts[profile].desc_num;
+    chan_cfg.dma_frame_num = dma_layouts[profile].frame_num;
+    chan_cfg.auto_clear = true;  // Play silence on underflow (counted by i2s_on_send_q_ovf)
 
     esp_err_t ret = i2s_new_channel(&chan_cfg, &player->i2s_channel, NULL);
     if (ret != ESP_OK) {
@@ -361,9 +442,8 @@ static esp_err_t init_i2s_channel(player_state_t *player)
 
     // Standard I2S mode configuration (Philips format)
     i2s_std_config_t std_cfg = {
-        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(INITIAL_SAMPLE_FREQ),
-        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT,
-                    (INITIAL_CHANNELS == 1) ? I2S_SLOT_MODE_MONO : I2S_SLOT_MODE_STEREO),
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(frame_rate),
+        .slot_cfg = std_slot_config(channels, bit_depth),
         .gpio_cfg = {
             .mclk = I2S_GPIO_UNUSED,
             .bclk = I2S_BCLK_GPIO,
@@ -386,6 +466,15 @@ static esp_err_t init_i2s_channel(player_state_t *player)
         return ret;
     }
 
+    // Callbacks can only be registered before the channel is enabled
+    i2s_event_callbacks_t callbacks = {
+        .on_send_q_ovf = i2s_on_send_q_ovf,
+    };
+    ret = i2s_channel_register_event_callback(player->i2s_channel, &callbacks, player);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to register I2S underrun callback: %s", esp_err_to_name(ret));
+    }
+
     ret = i2s_channel_enable(player->i2s_channel);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to enable I2S channel: %s", esp_err_to_name(ret));
@@ -395,12 +484,56 @@ static esp_err_t init_i2s_channel(player_state_t *player)
     }
 
     // Initialize format tracking
-    player->last_frame_rate = INITIAL_SAMPLE_FREQ;
-    player->last_bit_depth = INITIAL_BIT_RESOLUTION;
-    player->last_channels = INITIAL_CHANNELS;
+    player->last_frame_rate = frame_rate;
+    player->last_bit_depth = bit_depth;
+    player->last_channels = channels;
+    player->dma_active = profile;
+    player->chunk_samples = 2 * dma_layouts[profile].frame_num;
+
+    ESP_LOGD(TAG, "I2S channel created: %s DMA ring (%lu x %lu frames), %lu Hz, %d ch, %d bit",
+             dma_profile_names[profile], dma_layouts[profile].desc_num, dma_layouts[profile].frame_num,
+             frame_rate, channels, bit_depth);
+    return ESP_OK;
+}
+
+/**
+ * @brief Rebuild the I2S channel with another DMA profile
+ *
+ * The DMA layout is only set at channel creation. Must not be called while
+ * voices play: the output stops for the time of the rebuild (amplifier off).
+ * If the new layout cannot be created, the previous one is restored.
+ *
+ * @param player Player state with I2S channel handle
+ * @param profile New DMA profile (not AUTO)
+ * @param frame_rate Sample rate in Hz of the sound about to start
+ * @param channels Number of channels of the sound about to start
+ * @param bit_depth Bits per sample of the sound about to start
+ * @return ESP_OK on success
+ */
+static esp_err_t switch_dma_profile(player_state_t *player, player_dma_profile_t profile,
+                                    uint32_t frame_rate, uint16_t channels, uint16_t bit_depth)
+{
+    player_dma_profile_t previous = player->dma_active;
+    ESP_LOGD(TAG, "Switching I2S DMA profile: %s -> %s",
+             dma_profile_names[previous], dma_profile_names[profile]);
+
+    set_i2s_sd_gpio(false);
+    if (player->i2s_channel != NULL) {
+        i2s_channel_disable(player->i2s_channel);
+        i2s_del_channel(player->i2s_channel);
+        player->i2s_channel = NULL;
+    }
+
+    esp_err_t ret = init_i2s_channel(player, profile, frame_rate, channels, bit_depth);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Keeping %s DMA profile", dma_profile_names[previous]);
+        if (init_i2s_channel(player, previous, frame_rate, channels, bit_depth) != ESP_OK) {
+            return ret;
+        }
+    }
 
-    ESP_LOGI(TAG, "I2S channel initialized (LRC=%d, BCLK=%d, DIN=%d)",
-             I2S_LRC_GPIO, I2S_BCLK_GPIO, I2S_DIN_GPIO);
+    // Enable amplifier
+    set_i2s_sd_gpio(true);
     return ESP_OK;
 }
 
@@ -449,15 +582,7 @@ static esp_err_t configure_stream(player_state_t *player, uint32_t frame_rate, u
 
     // Reconfigure slot if channels or bit depth changed
     if (channels != player->last_channels || bit_depth != player->last_bit_depth) {
-        i2s_data_bit_width_t bit_width = I2S_DATA_BIT_WIDTH_16BIT;
-        if (bit_depth == 24) {
-            bit_width = I2S_DATA_BIT_WIDTH_24BIT;
-        } else if (bit_depth == 32) {
-            bit_width = I2S_DATA_BIT_WIDTH_32BIT;
-        }
-        i2s_slot_mode_t slot_mode = (channels == 1) ? I2S_SLOT_MODE_MONO : I2S_SLOT_MODE_STEREO;
-
-        i2s_std_slot_config_t slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(bit_width, slot_mode);
+        i2s_std_slot_config_t slot_cfg = std_slot_config(channels, bit_depth);
         ret = i2s_channel_reconfig_std_slot(player->i2s_channel, &slot_cfg);
         if (ret != ESP_OK) {
             ESP_LOGE(TAG, "Failed to reconfigure I2S slot: %s", esp_err_to_name(ret));
@@ -485,19 +610,73 @@ static esp_err_t configure_stream(player_state_t *player, uint32_t frame_rate, u
 }
 
 
-static void close_stream(player_state_t *player, player_event_name_t event, esp_err_t error_code, bool enable_amp)
+/* -------------------------------------------------------------------------
+ * Voice management
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Pick the newest active voice as lead (progress events), or NULL
+ */
+static void update_lead_voice(player_state_t *player)
 {
-    if (player->stream != NULL) {
-        esp_err_t ret = audio_provider_close_stream(player->stream);
-        if (ret != ESP_OK) {
-            ESP_LOGW(TAG, "Error closing stream: %s", esp_err_to_name(ret));
+    player->lead_voice = NULL;
+    for (int v = 0; v < PLAYER_MAX_VOICES; v++) {
+        player_voice_t *voice = &player->voices[v];
+        if (voice->stream == NULL) {
+            continue;
+        }
+        if (player->lead_voice == NULL || voice->start_seq > player->lead_voice->start_seq) {
+            player->lead_voice = voice;
+        }
+    }
+}
+
+/**
+ * @brief Close a voice and release its stream
+ *
+ * PLAYER_EVENT_STOPPED is only fired when the last voice closes, so the
+ * display keeps its playing screen while other voices are still mixed.
+ * Errors are always reported.
+ *
+ * @param enable_amp Amplifier state to leave when no voice remains
+ */
+static void close_voice(player_state_t *player, player_voice_t *voice,
+                        player_event_name_t event, esp_err_t error_code, bool enable_amp)
+{
+    if (voice->stream == NULL) {
+        return;
+    }
+
+    esp_err_t ret = audio_provider_close_stream(voice->stream);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Error closing stream: %s", esp_err_to_name(ret));
+    }
+    voice->stream = NULL;
+    player->active_voices--;
+    if (player->lead_voice == voice) {
+        update_lead_voice(player);
+    }
+
+    ESP_LOGD(TAG, "Voice %d closed: %s (%d active)",
+             (int)(voice - player->voices), voice->name, player->active_voices);
+
+    if (player->active_voices > 0) {
+        if (event == PLAYER_EVENT_ERROR) {
+            fire_event_close(player, event, error_code);
         }
-        player->stream = NULL;
+        return;
     }
 
+    // Next sound starts at the current volume, without a ramp from a stale gain
+    player->gain_applied = VOLUME_GAIN_NONE;
+
+    // The DMA ring drains from here on: not an underrun
+    __atomic_store_n(&player->underrun_armed, false, __ATOMIC_RELAXED);
+    player->run_frames = 0;
+
 #ifdef IO_STATS_ENABLE
     // log stats
-    benchmark_log_and_reset(BENCH_I2S_WRITE, player->current_filename);
+    benchmark_log_and_reset(BENCH_I2S_WRITE, voice->name);
 #endif
 
     // Shutdown amplifier if requested
@@ -506,61 +685,370 @@ static void close_stream(player_state_t *player, player_event_name_t event, esp_
     fire_event_close(player, event, error_code);
 }
 
+/**
+ * @brief Close all voices, or only those playing sound_id (or the unresolved path)
+ *
+ * With sound_id AUDIO_SOUND_ID_NONE and no path, every voice is closed.
+ */
+static void close_voices(player_state_t *player, audio_sound_id_t sound_id, const char *path,
+                         player_event_name_t event, bool enable_amp)
+{
+    for (int v = 0; v < PLAYER_MAX_VOICES; v++) {
+        player_voice_t *voice = &player->voices[v];
+        if (voice->stream == NULL) {
+            continue;
+        }
+        if (sound_id != AUDIO_SOUND_ID_NONE && voice->sound_id != sound_id) {
+            continue;
+        }
+        if (sound_id == AUDIO_SOUND_ID_NONE && path != NULL && strcmp(voice->name, path) != 0) {
+            continue;
+        }
+        close_voice(player, voice, event, ESP_OK, enable_amp);
+    }
+}
+
+/**
+ * @brief Get a free voice, stealing the oldest one when all are busy
+ */
+static player_voice_t *alloc_voice(player_state_t *player)
+{
+    player_voice_t *oldest = NULL;
+    for (int v = 0; v < PLAYER_MAX_VOICES; v++) {
+        player_voice_t *voice = &player->voices[v];
+        if (voice->stream == NULL) {
+            return voice;
+        }
+        if (oldest == NULL || voice->start_seq < oldest->start_seq) {
+            oldest = voice;
+        }
+    }
+
+    ESP_LOGD(TAG, "All %d voices busy, stealing voice %d (%s)",
+             PLAYER_MAX_VOICES, (int)(oldest - player->voices), oldest->name);
+    close_voice(player, oldest, PLAYER_EVENT_STOPPED, ESP_OK, true);
+    return oldest;
+}
+
+/**
+ * @brief Read one chunk of a voice
+ *
+ * Cache-hit voices return a span into the PSRAM cache entry (no copy), file
+ * voices are copied into the given scratch buffer.
+ *
+ * @return ESP_OK with *samples_read == 0 at end of stream, provider error otherwise
+ */
+static esp_err_t read_voice(player_state_t *player, player_voice_t *voice, int16_t *scratch,
+                            const int16_t **samples, size_t *samples_read)
+{
+    esp_err_t ret = audio_provider_read_span(voice->stream, samples, player->chunk_samples, samples_read);
+    if (ret != ESP_ERR_NOT_SUPPORTED) {
+        player->mixer.span_reads += (ret == ESP_OK && *samples_read > 0);
+        return ret;
+    }
+
+    ret = audio_provider_read_stream(voice->stream, scratch, player->chunk_samples, samples_read);
+    *samples = scratch;
+    player->mixer.copy_reads += (ret == ESP_OK && *samples_read > 0);
+    return ret;
+}
+
+/**
+ * @brief Mix one chunk of all active voices and write it to the I2S device
+ *
+ * Each sample is touched once on its way to I2S: the first voice is scaled
+ * into pcm_buf, the next ones are scaled and added with saturation (volume
+ * is applied ahead of the clipping stage). Cache-hit voices are read in
+ * place from PSRAM. A single cache-hit voice at unity gain is handed to
+ * i2s_channel_write() directly, without any intermediate buffer.
+ * Voices reaching end of stream (or failing) are closed here.
+ *
+ * @param[in] player Player state containing provider and I2S channel handles
+ * @param[out] bytes_written Number of bytes successfully written to I2S (0 = all voices ended)
+ * @return ESP_OK on success or end of streams, I2S error code otherwise
+ */
+static esp_err_t mix_chunk(player_state_t *player, size_t *bytes_written)
+{
+    *bytes_written = 0;
+    int64_t chunk_start_us = esp_timer_get_time();
+
+    // Read volume once per chunk (single word, written by any task)
+    uint32_t volume_factor = volume_table[__atomic_load_n(&player->vol_current, __ATOMIC_RELAXED)];
+
+    // Ramp linearly from the previous chunk's gain to the new volume (no zipper noise)
+    uint32_t gain_from = (player->gain_applied == VOLUME_GAIN_NONE) ? volume_factor : player->gain_applied;
+    uint32_t gain_to = volume_factor;
+
+    const int16_t *out = player->pcm_buf;   // I2S source (pcm_buf or a cache span)
+    size_t mixed = 0;                       // valid samples in out
+    for (int v = 0; v < PLAYER_MAX_VOICES; v++) {
+        player_voice_t *voice = &player->voices[v];
+        if (voice->stream == NULL) {
+            continue;
+        }
+
+        int64_t voice_start_us = esp_timer_get_time();
+        int16_t *scratch = (mixed == 0) ? player->pcm_buf : player->mix_buf;
+        const int16_t *samples = NULL;
+        size_t samples_read = 0;
+        esp_err_t ret = read_voice(player, voice, scratch, &samples, &samples_read);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Provider read error on '%s': %s", voice->name, esp_err_to_name(ret));
+            close_voice(player, voice, PLAYER_EVENT_ERROR, ret, false);
+            continue;
+        }
+
+        // End of stream - no more samples available
+        if (samples_read == 0) {
+            ESP_LOGD(TAG, "End of stream reached: %s", voice->name);
+#ifdef TRACE_ENABLE
+            trace_event(TRACE_PLAYER_EOF, voice->sound_id, (uint32_t)v);
+#endif
+            close_voice(player, voice, PLAYER_EVENT_STOPPED, ESP_OK, false);
+            continue;
+        }
+
+        if (mixed == 0) {
+            if (player->active_voices == 1 && samples != player->pcm_buf &&
+                gain_from >= VOLUME_FACTOR_UNITY && gain_to >= VOLUME_FACTOR_UNITY) {
+                // Zero-copy: I2S driver reads the cache entry directly
+                out = samples;
+            } else {
+                mixer_scale_s16(player->pcm_buf, samples, samples_read, gain_from, gain_to);
+            }
+            mixed = samples_read;
+        } else {
+            if (out != player->pcm_buf) {
+                // Defensive: direct output is only chosen for a single active voice
+                mixer_scale_s16(player->pcm_buf, out, mixed, gain_from, gain_to);
+                out = player->pcm_buf;
+            }
+            // Extend mix with silence if this voice is longer than the previous ones
+            if (samples_read > mixed) {
+                memset(&player->pcm_buf[mixed], 0, (samples_read - mixed) * sizeof(int16_t));
+                mixed = samples_read;
+            }
+            mixer_scale_add_sat_s16(player->pcm_buf, samples, samples_read, gain_from, gain_to);
+        }
+
+        voice->busy_us += (uint64_t)(esp_timer_get_time() - voice_start_us);
+        voice->chunks++;
+    }
+
+    if (mixed == 0) {
+        return ESP_OK;
+    }
+    if (out != player->pcm_buf) {
+        player->mixer.direct_chunks++;
+    }
+    if (gain_from != gain_to) {
+        player->mixer.ramp_chunks++;
+    }
+    player->gain_applied = gain_to;
+
+    // Mixer timing vs. the audio duration of this chunk
+    uint32_t busy_us = (uint32_t)(esp_timer_get_time() - chunk_start_us);
+    uint32_t frames = mixed / (player->last_channels > 0 ? player->last_channels : 1);
+    player->mixer.busy_us += busy_us;
+    player->mixer.budget_us += (uint64_t)frames * 1000000 / player->last_frame_rate;
+    player->mixer.chunks++;
+    if (busy_us > player->mixer.peak_us) {
+        player->mixer.peak_us = busy_us;
+    }
+    if (__atomic_exchange_n(&player->timing_reset, false, __ATOMIC_ACQUIRE)) {
+        memset(&player->timing, 0, sizeof(player->timing));
+    }
+    player->timing.chunks++;
+    if (busy_us > player->timing.busy_peak_us) {
+        player->timing.busy_peak_us = busy_us;
+    }
+
+    // Note: MAX98357A with SD pin pulled to 1MOhm outputs Left channel only.
+    // Stereo sources are averaged to mono by the provider when they are
+    // loaded or streamed (SOUNDBOARD_OUTPUT_DOWNMIX_MONO), not here.
+
+    // Write samples to I2S device
+    size_t bytes_to_write = mixed * sizeof(int16_t);
+#ifdef IO_STATS_ENABLE
+    int64_t start_us = benchmark_start();
+#endif
+#ifdef TRACE_ENABLE
+    int64_t trace_us = trace_start();
+#endif
+    esp_err_t ret = i2s_channel_write(player->i2s_channel, out, bytes_to_write, bytes_written, I2S_WRITE_TIMEOUT_MS);
+#ifdef IO_STATS_ENABLE
+    benchmark_record(BENCH_I2S_WRITE, start_us, *bytes_written);
+#endif
+#ifdef TRACE_ENABLE
+    trace_span(TRACE_PLAYER_WRITE, trace_us, player->active_voices, *bytes_written);
+#endif
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "I2S write error: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Jitter: once the DMA ring is full, writes return one chunk duration apart.
+    // A longer interval means the task was late (early returns are the ring filling up).
+    int64_t now_us = esp_timer_get_time();
+    if (player->last_write_us != 0) {
+        int64_t late_us = (now_us - player->last_write_us) - player->last_chunk_us;
+        if (late_us > (int64_t)player->mixer.jitter_peak_us) {
+            player->mixer.jitter_peak_us = (uint32_t)late_us;
+        }
+        if (late_us > (int64_t)player->timing.jitter_peak_us) {
+            player->timing.jitter_peak_us = (uint32_t)late_us;
+        }
+    }
+    player->last_write_us = now_us;
+    player->last_chunk_us = (uint32_t)((uint64_t)frames * 1000000 / player->last_frame_rate);
+
+    // Count underruns once the start of playback has filled the DMA ring
+    if (!player->underrun_armed) {
+        const dma_layout_t *layout = &dma_layouts[player->dma_active];
+        player->run_frames += frames;
+        if (player->run_frames >= layout->desc_num * layout->frame_num) {
+            __atomic_store_n(&player->underrun_armed, true, __ATOMIC_RELAXED);
+        }
+    }
+#ifdef LATENCY_STATS_ENABLE
+    // Voices started since the last write were mixed into this chunk
+    for (int v = 0; v < PLAYER_MAX_VOICES; v++) {
+        player_voice_t *voice = &player->voices[v];
+        if (voice->stream != NULL && voice->trace_pending && voice->chunks > 0) {
+            latency_trace_mark(&voice->trace, LATENCY_MARK_FIRST_WRITE);
+            latency_record(&voice->trace, voice->cache_hit);
+            voice->trace_pending = false;
+        }
+    }
+#endif
+    return ESP_OK;
+}
+
 /**
  * @brief Command handler for play command
  *
+ * Starts the file on a free voice (or steals the oldest one). Voices share
+ * the I2S format: if the new file has a different format, the other voices
+ * are stopped before I2S is reconfigured. With a fixed output rate the
+ * provider reports every stream at that rate, so only channel count changes
+ * reconfigure. A sound starting with no other voice playing also selects
+ * the DMA profile (cache-backed or file-backed stream in AUTO mode).
+ *
  * @param player Player state
- * @param filename Path to audio file
+ * @param cmd Play command: sound ID, or AUDIO_SOUND_ID_NONE and the path of
+ *            an unresolved file (ownership moves to the voice), latency trace
  */
-static void cmd_play(player_state_t *player, const char *filename)
+static void cmd_play(player_state_t *player, player_cmd_t *cmd)
 {
-    if(player->stream != NULL) {
-        // stop current stream first
-        close_stream(player, PLAYER_EVENT_STOPPED, ESP_OK, true);
+    audio_sound_id_t sound_id = cmd->sound_id;
+    const char *filename;
+    audio_stream_handle_t stream = NULL;
+    esp_err_t err;
+    if (sound_id != AUDIO_SOUND_ID_NONE) {
+        const char *name = audio_provider_get_sound_name(player->provider, sound_id);
+        filename = (name != NULL) ? name : "(unknown)";
+        err = audio_provider_open_sound(player->provider, sound_id, &stream);
+    } else {
+        filename = cmd->path;
+        err = audio_provider_open_stream(player->provider, filename, &stream);
     }
-
-    esp_err_t err = audio_provider_open_stream(player->provider, filename, &player->stream);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to open stream '%s': %s", filename, esp_err_to_name(err));
-        close_stream(player, PLAYER_EVENT_ERROR, err, false);
-        player->stream = NULL;
+        if (player->active_voices == 0) {
+            set_i2s_sd_gpio(false);
+        }
+        fire_event_close(player, PLAYER_EVENT_ERROR, err);
         return;
     }
 
     // Get audio format from stream
-    const audio_info_t *stream_info = audio_provider_get_stream_info(player->stream);
+    const audio_info_t *stream_info = audio_provider_get_stream_info(stream);
     if (stream_info == NULL) {
         ESP_LOGE(TAG, "Failed to get stream info");
-        close_stream(player, PLAYER_EVENT_ERROR, ESP_FAIL, false);
+        audio_provider_close_stream(stream);
+        if (player->active_voices == 0) {
+            set_i2s_sd_gpio(false);
+        }
+        fire_event_close(player, PLAYER_EVENT_ERROR, ESP_FAIL);
         return;
     }
 
-    // Reconfigure output channel if format changed (no-op if format is unchanged)
-    err = configure_stream(player, stream_info->frame_rate, stream_info->channels, stream_info->bit_depth);
+    bool format_changed = (stream_info->frame_rate != player->last_frame_rate ||
+                           stream_info->channels != player->last_channels ||
+                           stream_info->bit_depth != player->last_bit_depth);
+    if (format_changed && player->active_voices > 0) {
+        ESP_LOGW(TAG, "Format change (%lu Hz, %d ch, %d bit): stopping %d voice(s)",
+                 stream_info->frame_rate, stream_info->channels, stream_info->bit_depth,
+                 player->active_voices);
+        close_voices(player, AUDIO_SOUND_ID_NONE, NULL, PLAYER_EVENT_STOPPED, true);
+    }
+
+    player_voice_t *voice = alloc_voice(player);
+
+    // A sound starting alone may change the DMA ring (rebuilding it cuts the output)
+    player_dma_profile_t profile = player->dma_active;
+    if (player->active_voices == 0) {
+        profile = __atomic_load_n(&player->dma_selected, __ATOMIC_RELAXED);
+        if (profile == PLAYER_DMA_PROFILE_AUTO) {
+            profile = audio_provider_stream_is_cached(stream) ? PLAYER_DMA_PROFILE_LOW_LATENCY
+                                                              : PLAYER_DMA_PROFILE_ROBUST;
+        }
+    }
+
+    if (profile != player->dma_active) {
+        err = switch_dma_profile(player, profile, stream_info->frame_rate,
+                                 stream_info->channels, stream_info->bit_depth);
+    } else {
+        // Reconfigure output channel if format changed (no-op if format is unchanged)
+        err = configure_stream(player, stream_info->frame_rate, stream_info->channels, stream_info->bit_depth);
+    }
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to reconfigure stream: %s", esp_err_to_name(err));
-        close_stream(player, PLAYER_EVENT_ERROR, err, false);
+        audio_provider_close_stream(stream);
+        if (player->active_voices == 0) {
+            set_i2s_sd_gpio(false);
+        }
+        fire_event_close(player, PLAYER_EVENT_ERROR, err);
         return;
     }
 
-    ESP_LOGD(TAG, "Started playback: %s", filename);
+    // Status reads status_name from another core, never name or owned_name
+    strncpy(voice->status_name, filename, sizeof(voice->status_name) - 1);
+    voice->status_name[sizeof(voice->status_name) - 1] = '\0';
+    free(voice->owned_name);
+    voice->owned_name = cmd->path;
+    cmd->path = NULL;
+
+    voice->stream = stream;
+    voice->sound_id = sound_id;
+    voice->name = filename;
+    voice->start_seq = ++player->voice_seq;
+    voice->busy_us = 0;
+    voice->chunks = 0;
+#ifdef LATENCY_STATS_ENABLE
+    latency_trace_mark(&cmd->trace, LATENCY_MARK_OPEN);
+    voice->trace = cmd->trace;
+    voice->trace_pending = true;
+    voice->cache_hit = audio_provider_stream_is_cached(stream);
+#endif
+    player->active_voices++;
 
-    // Store filename and reset progress tick for periodic reporting
-    strncpy(player->current_filename, filename, sizeof(player->current_filename) - 1);
-    player->current_filename[sizeof(player->current_filename) - 1] = '\0';
+    // New voice leads progress reporting, reset progress tick
+    player->lead_voice = voice;
     player->last_progress_tick = 0;
 
-    fire_event_started(player, filename);
+    ESP_LOGD(TAG, "Started playback on voice %d: %s (%d active)",
+             (int)(voice - player->voices), filename, player->active_voices);
 
-    // player main loop will start sending chunks from player->stream to I2S channel
+    fire_event_started(player, voice);
+
+    // player main loop will start mixing chunks from active voices to I2S channel
 }
 
-static void cmd_stop(player_state_t *player, bool immediate)
+static void cmd_stop(player_state_t *player, const player_cmd_t *cmd)
 {
-    if (immediate) {
-        if (player->stream != NULL) {
-            close_stream(player, PLAYER_EVENT_STOPPED, ESP_OK, false);
-        }
+    if (cmd->interrupt_now) {
+        close_voices(player, cmd->sound_id, cmd->path, PLAYER_EVENT_STOPPED, false);
     } else {
         ESP_LOGD(TAG, "Non-immediate stop: will stop after current playback completes");
     }
@@ -572,7 +1060,7 @@ static void cmd_stop(player_state_t *player, bool immediate)
  *
  * Waits for commands (PLAY/STOP) and handles audio streaming
  * - When idle: Blocks waiting for commands
- * - When playing: Continuously sends chunks and poll queue for commands
+ * - When playing: Continuously mixes chunks and poll queue for commands
  */
 static void player_task(void *arg)
 {
@@ -581,46 +1069,58 @@ static void player_task(void *arg)
 
     player_cmd_t cmd;
     while (1) {
-        // when idle (stream==NULL): Block indefinitely
-        // when playing (stream!=NULL): Non-blocking check for STOP while continuing to stream
-        TickType_t wait_time = (player->stream == NULL) ? portMAX_DELAY : 0;
+        // when idle (no active voice): Block until a command is pushed
+        // when playing: Non-blocking check for commands while continuing to stream
+        bool have_cmd = msg_ring_pop(player->cmd_ring, &cmd);
+        if (!have_cmd && player->active_voices == 0) {
+            player->last_write_us = 0;
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
 
-        if (xQueueReceive(player->cmd_queue, &cmd, wait_time) == pdTRUE) {
+        if (have_cmd) {
+#ifdef TRACE_ENABLE
+            trace_event(TRACE_PLAYER_CMD, cmd.sound_id, cmd.type);
+#endif
             // process command
             switch (cmd.type) {
             case PLAYER_CMD_PLAY:
-                cmd_play(player, cmd.play.filename);
+#ifdef LATENCY_STATS_ENABLE
+                latency_trace_mark(&cmd.trace, LATENCY_MARK_DEQUEUE);
+#endif
+                cmd_play(player, &cmd);
                 break;
 
             case PLAYER_CMD_STOP:
-                cmd_stop(player, cmd.stop.interrupt_now);
+                cmd_stop(player, &cmd);
                 break;
 
             default:
                 ESP_LOGW(TAG, "Unknown command type: %d", cmd.type);
                 break;
             }
+            free(cmd.path);     // NULL unless an unresolved path was not taken over
         }
 
-        // If we have an active stream, send the next chunk
-        if (player->stream == NULL) {
+        // If we have active voices, mix and send the next chunk
+        if (player->active_voices == 0) {
             continue;  // No stream, wait for commands
         }
 
-        // Send next chunk
+        // Send next chunk (voices reaching end of stream are closed by mix_chunk)
         size_t written = 0;
-        esp_err_t ret = send_chunk(player, &written);
+        esp_err_t ret = mix_chunk(player, &written);
 
         if (ret != ESP_OK) {
             // Transfer error
-            ESP_LOGE(TAG, "Chunk send error: %s, stopping stream", esp_err_to_name(ret));
-            close_stream(player, PLAYER_EVENT_ERROR, ret, false);
+            ESP_LOGE(TAG, "Chunk send error: %s, stopping all voices", esp_err_to_name(ret));
+            for (int v = 0; v < PLAYER_MAX_VOICES; v++) {
+                close_voice(player, &player->voices[v], PLAYER_EVENT_ERROR, ret, false);
+            }
             continue;
         }
 
         if (written == 0) {
-            // End of stream reached
-            close_stream(player, PLAYER_EVENT_STOPPED, ESP_OK, false);
             continue;
         }
 
@@ -641,15 +1141,59 @@ static esp_err_t send_cmd(player_handle_t player, player_cmd_t *cmd)
     }
 
     player_state_t *state = (player_state_t *)player;
-    if (xQueueSend(state->cmd_queue, cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
-        ESP_LOGW(TAG, "Failed to queue player command (queue full)");
-        return ESP_FAIL;
+    if (!msg_ring_push(state->cmd_ring, cmd)) {
+        // Full: the player task drains one command per chunk, retry for a while
+        __atomic_add_fetch(&state->cmd_ring_full, 1, __ATOMIC_RELAXED);
+        TickType_t start = xTaskGetTickCount();
+        while (!msg_ring_push(state->cmd_ring, cmd)) {
+            if (xTaskGetTickCount() - start >= pdMS_TO_TICKS(PLAYER_CMD_SEND_TIMEOUT_MS)) {
+                ESP_LOGW(TAG, "Failed to queue player command (ring full)");
+                return ESP_FAIL;
+            }
+            vTaskDelay(1);
+        }
     }
 
+    xTaskNotifyGive(state->player_task_handle);
     return ESP_OK;
 }
 
 
+/**
+ * @brief Fill the sound of a command from a filename
+ *
+ * Looks the file up in the provider's sound table without adding it: the
+ * table holds the sounds resolved at load time, console names never fill it.
+ * Other files are carried as a heap copy of the path; for a play, only if
+ * the file exists.
+ */
+static esp_err_t cmd_set_file(player_state_t *state, player_cmd_t *cmd, const char *filename)
+{
+    if (audio_provider_find_sound(state->provider, filename, &cmd->sound_id) == ESP_OK) {
+        return ESP_OK;
+    }
+    cmd->sound_id = AUDIO_SOUND_ID_NONE;
+    struct stat st;
+    if (cmd->type == PLAYER_CMD_PLAY && stat(filename, &st) != 0) {
+        ESP_LOGW(TAG, "Not playing unknown file: %s", filename);
+        return ESP_ERR_NOT_FOUND;
+    }
+    cmd->path = strdup(filename);
+    return (cmd->path != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+/**
+ * @brief Send a command that may own a path (freed if it could not be queued)
+ */
+static esp_err_t send_file_cmd(player_handle_t player, player_cmd_t *cmd)
+{
+    esp_err_t ret = send_cmd(player, cmd);
+    if (ret != ESP_OK) {
+        free(cmd->path);
+    }
+    return ret;
+}
+
 esp_err_t player_play(player_handle_t player, const char *filename)
 {
     if (player == NULL || filename == NULL) {
@@ -659,14 +1203,47 @@ esp_err_t player_play(player_handle_t player, const char *filename)
     player_cmd_t cmd = {
         .type = PLAYER_CMD_PLAY,
     };
+    esp_err_t ret = cmd_set_file((player_state_t *)player, &cmd, filename);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+#ifdef LATENCY_STATS_ENABLE
+    latency_trace_start(&cmd.trace);
+#endif
+    return send_file_cmd(player, &cmd);
+}
 
-    // Copy filename (safely truncate if too long)
-    strncpy(cmd.play.filename, filename, sizeof(cmd.play.filename) - 1);
-    cmd.play.filename[sizeof(cmd.play.filename) - 1] = '\0';
+esp_err_t player_play_sound(player_handle_t player, player_sound_id_t sound_id)
+{
+    if (player == NULL || sound_id == PLAYER_SOUND_ID_NONE) {
+        return ESP_ERR_INVALID_ARG;
+    }
 
+    player_cmd_t cmd = {
+        .type = PLAYER_CMD_PLAY,
+        .sound_id = (audio_sound_id_t)sound_id,
+    };
+
+#ifdef LATENCY_STATS_ENABLE
+    latency_trace_start(&cmd.trace);
+#endif
     return send_cmd(player, &cmd);
 }
 
+esp_err_t player_resolve_sound(player_handle_t player, const char *filename,
+                               player_sound_id_t *sound_id)
+{
+    if (player == NULL || filename == NULL || sound_id == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    audio_sound_id_t id;
+    esp_err_t ret = audio_provider_resolve_sound(state->provider, filename, &id);
+    *sound_id = (ret == ESP_OK) ? (player_sound_id_t)id : PLAYER_SOUND_ID_NONE;
+    return ret;
+}
+
 
 esp_err_t player_stop(player_handle_t player, bool interrupt_now)
 {
@@ -676,9 +1253,42 @@ esp_err_t player_stop(player_handle_t player, bool interrupt_now)
 
     player_cmd_t cmd = {
         .type = PLAYER_CMD_STOP,
-        .stop = {
-            .interrupt_now = interrupt_now
-        }
+        .interrupt_now = interrupt_now,
+        .sound_id = AUDIO_SOUND_ID_NONE,
+    };
+
+    return send_cmd(player, &cmd);
+}
+
+
+esp_err_t player_stop_file(player_handle_t player, const char *filename)
+{
+    if (player == NULL || filename == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    player_cmd_t cmd = {
+        .type = PLAYER_CMD_STOP,
+        .interrupt_now = true,
+    };
+    esp_err_t ret = cmd_set_file((player_state_t *)player, &cmd, filename);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return send_file_cmd(player, &cmd);
+}
+
+esp_err_t player_stop_sound(player_handle_t player, player_sound_id_t sound_id)
+{
+    if (player == NULL || sound_id == PLAYER_SOUND_ID_NONE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    player_cmd_t cmd = {
+        .type = PLAYER_CMD_STOP,
+        .interrupt_now = true,
+        .sound_id = (audio_sound_id_t)sound_id,
     };
 
     return send_cmd(player, &cmd);
@@ -694,6 +1304,53 @@ esp_err_t player_preload(player_handle_t player, const char *filename)
     return audio_provider_preload(state->provider, filename);
 }
 
+esp_err_t player_preload_bank(player_handle_t player, const char *bank_path)
+{
+    if (player == NULL || bank_path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    return audio_provider_preload_bank(state->provider, bank_path);
+}
+
+esp_err_t player_preload_head(player_handle_t player, const char *filename)
+{
+    if (player == NULL || filename == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    return audio_provider_register_head(state->provider, filename);
+}
+
+esp_err_t player_load_sound_index(player_handle_t player, const char *path)
+{
+    if (player == NULL || path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    return audio_provider_load_index(state->provider, path);
+}
+
+esp_err_t player_set_cache_pins(player_handle_t player,
+                                const player_sound_id_t *current, size_t current_count,
+                                const player_sound_id_t *neighbours, size_t neighbour_count)
+{
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    return audio_provider_set_pins(state->provider, current, current_count, neighbours, neighbour_count);
+}
+
+esp_err_t player_prefetch(player_handle_t player, const char *path, bool bank)
+{
+    if (player == NULL || path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    return audio_provider_prefetch(state->provider, path, bank);
+}
+
 void player_flush_preload(player_handle_t player)
 {
     if (player == NULL) {
@@ -703,6 +1360,96 @@ void player_flush_preload(player_handle_t player)
     audio_provider_flush_preload_queue(state->provider);
 }
 
+esp_err_t player_purge_cache(player_handle_t player)
+{
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    return audio_provider_purge_cache(state->provider);
+}
+
+esp_err_t player_get_warmup(player_handle_t player, audio_provider_warmup_t *warmup)
+{
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    return audio_provider_get_warmup(state->provider, warmup);
+}
+
+esp_err_t player_get_preload_stats(player_handle_t player, audio_provider_preload_stats_t *stats)
+{
+    if (player == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    return audio_provider_get_preload_stats(state->provider, stats);
+}
+
+esp_err_t player_get_timing(player_handle_t player, player_timing_t *timing)
+{
+    if (player == NULL || timing == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    if (__atomic_load_n(&state->timing_reset, __ATOMIC_ACQUIRE)) {
+        memset(timing, 0, sizeof(*timing));     // Reset not applied yet: no chunk since
+    } else {
+        *timing = state->timing;
+    }
+    timing->cmd_ring_full = __atomic_load_n(&state->cmd_ring_full, __ATOMIC_RELAXED) - state->timing_cmd_base;
+    timing->underruns = __atomic_load_n(&state->underruns, __ATOMIC_RELAXED) - state->timing_underrun_base;
+    return ESP_OK;
+}
+
+esp_err_t player_reset_timing(player_handle_t player)
+{
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    state->timing_cmd_base = __atomic_load_n(&state->cmd_ring_full, __ATOMIC_RELAXED);
+    state->timing_underrun_base = __atomic_load_n(&state->underruns, __ATOMIC_RELAXED);
+    __atomic_store_n(&state->timing_reset, true, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
+
+esp_err_t player_set_dma_profile(player_handle_t player, player_dma_profile_t profile)
+{
+    if (player == NULL || (unsigned)profile >= PLAYER_DMA_PROFILE_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    __atomic_store_n(&state->dma_selected, profile, __ATOMIC_RELAXED);
+    ESP_LOGI(TAG, "I2S DMA profile: %s (applied when a sound starts alone)", dma_profile_names[profile]);
+    return ESP_OK;
+}
+
+esp_err_t player_get_dma_profile(player_handle_t player, player_dma_profile_t *selected,
+                                 player_dma_profile_t *active)
+{
+    if (player == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    player_state_t *state = (player_state_t *)player;
+    if (selected != NULL) {
+        *selected = __atomic_load_n(&state->dma_selected, __ATOMIC_RELAXED);
+    }
+    if (active != NULL) {
+        *active = state->dma_active;
+    }
+    return ESP_OK;
+}
+
+const char *player_dma_profile_name(player_dma_profile_t profile)
+{
+    if ((unsigned)profile >= PLAYER_DMA_PROFILE_COUNT) {
+        return "unknown";
+    }
+    return dma_profile_names[profile];
+}
+
 /* =============================================================================
  * Synchronous Volume API (for software volume - no USB queries needed)
  * ============================================================================= */
@@ -719,12 +1466,23 @@ esp_err_t player_volume_get(player_handle_t player, int *volume_index)
     }
 
     player_state_t *state = (player_state_t *)player;
-    xSemaphoreTake(state->volume_mutex, portMAX_DELAY);
-    *volume_index = (int)state->vol_current;
-    xSemaphoreGive(state->volume_mutex);
+    *volume_index = (int)__atomic_load_n(&state->vol_current, __ATOMIC_RELAXED);
     return ESP_OK;
 }
 
+/**
+ * @brief Log, save and announce a volume index just stored in vol_current
+ */
+static void volume_changed(player_state_t *state, int index)
+{
+    ESP_LOGI(TAG, "Set volume (sync): index %d (factor %lu/65536)", index, (unsigned long)volume_table[index]);
+
+    // Schedule deferred save to NVS (coalesces rapid changes)
+    persistent_volume_save_deferred((uint16_t)index);
+
+    fire_event_volume(state, PLAYER_EVENT_VOLUME_CHANGED, index);
+}
+
 esp_err_t player_volume_set(player_handle_t player, int8_t index)
 {
     if (player == NULL) {
@@ -741,19 +1499,9 @@ esp_err_t player_volume_set(player_handle_t player, int8_t index)
         index = VOLUME_LEVELS - 1;
     }
 
-    // Update volume fields under mutex protection
-    xSemaphoreTake(state->volume_mutex, portMAX_DELAY);
-    state->sw_volume_factor = volume_table[index];
-    state->vol_current = (uint8_t)index;
-    uint32_t factor = state->sw_volume_factor;
-    xSemaphoreGive(state->volume_mutex);
-
-    ESP_LOGI(TAG, "Set volume (sync): index %d (factor %lu/65536)", index, (unsigned long)factor);
-
-    // Schedule deferred save to NVS (coalesces rapid changes)
-    persistent_volume_save_deferred((uint16_t)index);
-
-    fire_event_volume(state, PLAYER_EVENT_VOLUME_CHANGED, index);
+    // Single word: the player task picks it up at the next chunk
+    __atomic_store_n(&state->vol_current, (uint32_t)index, __ATOMIC_RELAXED);
+    volume_changed(state, index);
 
     return ESP_OK;
 }
@@ -770,12 +1518,22 @@ esp_err_t player_volume_adjust(player_handle_t player, int8_t step)
 
     player_state_t *state = (player_state_t *)player;
 
-    // Read current index under mutex, then call set (which also takes mutex)
-    xSemaphoreTake(state->volume_mutex, portMAX_DELAY);
-    int32_t new_index = (int32_t)state->vol_current + (int32_t)step;
-    xSemaphoreGive(state->volume_mutex);
+    // Read-modify-write with compare-and-swap: concurrent steps are not lost
+    uint32_t current = __atomic_load_n(&state->vol_current, __ATOMIC_RELAXED);
+    int32_t new_index;
+    do {
+        new_index = (int32_t)current + (int32_t)step;
+        if (new_index < 0) {
+            new_index = 0;
+        }
+        if (new_index >= VOLUME_LEVELS) {
+            new_index = VOLUME_LEVELS - 1;
+        }
+    } while (!__atomic_compare_exchange_n(&state->vol_current, &current, (uint32_t)new_index, true,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
 
-    return player_volume_set(player, (int8_t)new_index);
+    volume_changed(state, (int)new_index);
+    return ESP_OK;
 }
 
 
@@ -796,15 +1554,22 @@ static void cleanup_player_state(player_state_t *state)
     if (state->player_task_handle != NULL) {
         vTaskDelete(state->player_task_handle);
     }
-    if (state->cmd_queue != NULL) {
-        vQueueDelete(state->cmd_queue);
+    if (state->cmd_ring != NULL) {
+        player_cmd_t cmd;
+        while (msg_ring_pop(state->cmd_ring, &cmd)) {
+            free(cmd.path);
+        }
     }
-    if (state->volume_mutex != NULL) {
-        vSemaphoreDelete(state->volume_mutex);
+    msg_ring_destroy(state->cmd_ring);
+    for (int v = 0; v < PLAYER_MAX_VOICES; v++) {
+        free(state->voices[v].owned_name);
     }
     if (state->pcm_buf != NULL) {
         heap_caps_free(state->pcm_buf);
     }
+    if (state->mix_buf != NULL) {
+        heap_caps_free(state->mix_buf);
+    }
     if (state->provider != NULL) {
         audio_provider_deinit(state->provider);
     }
@@ -831,22 +1596,22 @@ esp_err_t player_init(const player_config_t *config, player_handle_t *player)
     // Store configuration
     state->event_cb = config->event_cb;
     state->event_cb_ctx = config->event_cb_ctx;
-
-    // Create volume mutex for thread-safe volume access
-    state->volume_mutex = xSemaphoreCreateMutex();
-    if (state->volume_mutex == NULL) {
-        ESP_LOGE(TAG, "Failed to create volume mutex");
-        cleanup_player_state(state);
-        return ESP_ERR_NO_MEM;
-    }
+    state->dma_selected = ((unsigned)config->dma_profile < PLAYER_DMA_PROFILE_COUNT)
+                              ? config->dma_profile : PLAYER_DMA_PROFILE_AUTO;
 
     // Initialize I2S channel for audio output
-    esp_err_t ret = init_i2s_channel(state);
+    player_dma_profile_t profile = (state->dma_selected == PLAYER_DMA_PROFILE_AUTO)
+                                       ? DMA_PROFILE_AUTO_INITIAL : state->dma_selected;
+    esp_err_t ret = init_i2s_channel(state, profile,
+                                     config->output_rate > 0 ? config->output_rate : INITIAL_SAMPLE_FREQ,
+                                     INITIAL_CHANNELS, INITIAL_BIT_RESOLUTION);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize I2S channel: %s", esp_err_to_name(ret));
         cleanup_player_state(state);
         return ret;
     }
+    ESP_LOGI(TAG, "I2S channel initialized (LRC=%d, BCLK=%d, DIN=%d), DMA profile %s",
+             I2S_LRC_GPIO, I2S_BCLK_GPIO, I2S_DIN_GPIO, dma_profile_names[state->dma_selected]);
 
     // Initialize persistent volume module (creates deferred save timer)
     persistent_volume_init();
@@ -865,13 +1630,23 @@ esp_err_t player_init(const player_config_t *config, player_handle_t *player)
         saved_index = VOLUME_LEVELS - 1;
     }
 
-    state->vol_current = (uint8_t)saved_index;
-    state->sw_volume_factor = volume_table[state->vol_current];
-    ESP_LOGI(TAG, "Initial volume: index %d (factor %lu/65536)", state->vol_current, (unsigned long)state->sw_volume_factor);
+    state->vol_current = saved_index;
+    state->gain_applied = VOLUME_GAIN_NONE;
+    ESP_LOGI(TAG, "Initial volume: index %d (factor %lu/65536)", (int)state->vol_current,
+             (unsigned long)volume_table[state->vol_current]);
 
     // Create audio provider
     audio_provider_config_t provider_config = {
         .cache_size_kb = config->cache_size_kb,
+        .stream_ring_kb = config->stream_ring_kb,
+        .head_cache_kb = config->head_cache_kb,
+        .head_ms = config->head_ms,
+        .eviction_policy = config->cache_policy,
+        .cache_format = config->cache_format,
+        .output_rate = config->output_rate,
+        .resampler_taps = config->resampler_taps,
+        .preload_share = config->preload_share,
+        .downmix_mono = config->downmix_mono,
     };
     ret = audio_provider_init(&provider_config, &state->provider);
     if (ret != ESP_OK) {
@@ -881,19 +1656,31 @@ esp_err_t player_init(const player_config_t *config, player_handle_t *player)
     }
 
     // Allocate PCM buffer - pass data chunks from audio_provider to i2s_channel_write()
-    state->pcm_buf = (int16_t *)heap_caps_malloc(PCM_BUFFER_SIZE * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+    // Mix buffers are aligned for the SIMD mixer kernel
+    state->pcm_buf = (int16_t *)heap_caps_aligned_alloc(MIXER_BUFFER_ALIGN, PCM_BUFFER_SIZE * sizeof(int16_t),
+                                                        MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
     if (state->pcm_buf == NULL) {
         ESP_LOGE(TAG, "Failed to allocate PCM buffer");
         cleanup_player_state(state);
         return ESP_ERR_NO_MEM;
     }
 
-    // Create command queue
-    state->cmd_queue = xQueueCreate(PLAYER_CMD_QUEUE_DEPTH, sizeof(player_cmd_t));
-    if (state->cmd_queue == NULL) {
-        ESP_LOGE(TAG, "Failed to create command queue");
+    if (PLAYER_MAX_VOICES > 1) {
+        state->mix_buf = (int16_t *)heap_caps_aligned_alloc(MIXER_BUFFER_ALIGN, PCM_BUFFER_SIZE * sizeof(int16_t),
+                                                            MALLOC_CAP_INTERNAL);
+        if (state->mix_buf == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate mix buffer");
+            cleanup_player_state(state);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // Create command ring
+    ret = msg_ring_create(PLAYER_CMD_RING_DEPTH, sizeof(player_cmd_t), &state->cmd_ring);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create command ring");
         cleanup_player_state(state);
-        return ESP_ERR_NO_MEM;
+        return ret;
     }
 
     // Create player task
@@ -930,9 +1717,7 @@ esp_err_t player_deinit(player_handle_t player)
     player_state_t *state = (player_state_t *)player;
 
     // Stop playback if active
-    if (state->stream != NULL) {
-        close_stream(player, PLAYER_EVENT_STOPPED, ESP_OK, false);
-    }
+    close_voices(state, AUDIO_SOUND_ID_NONE, NULL, PLAYER_EVENT_STOPPED, false);
 
     // Cleanup all resources
     cleanup_player_state(state);
@@ -955,15 +1740,14 @@ void player_print_status(player_handle_t player, status_output_type_t output_typ
     player_state_t *state = (player_state_t *)player;
 
     // Get current state
-    xSemaphoreTake(state->volume_mutex, portMAX_DELAY);
-    int vol_index = state->vol_current;
-    xSemaphoreGive(state->volume_mutex);
+    int vol_index = (int)__atomic_load_n(&state->vol_current, __ATOMIC_RELAXED);
 
-    bool is_playing = (state->stream != NULL);
+    bool is_playing = (state->active_voices > 0);
 
     if (output_type == STATUS_OUTPUT_COMPACT) {
-        printf("[player] %s, vol=%d/%d\n",
+        printf("[player] %s, voices=%d/%d, vol=%d/%d\n",
                is_playing ? "playing" : "idle",
+               state->active_voices, PLAYER_MAX_VOICES,
                vol_index, VOLUME_LEVELS - 1);
     } else {
         printf("Player Status:\n");
@@ -971,6 +1755,49 @@ void player_print_status(player_handle_t player, status_output_type_t output_typ
         printf("  Volume: %d / %d\n", vol_index, VOLUME_LEVELS - 1);
         printf("  I2S: GPIO LRC=%d, BCLK=%d, DIN=%d, SD=%d\n",
                I2S_LRC_GPIO, I2S_BCLK_GPIO, I2S_DIN_GPIO, I2S_SD_GPIO);
+
+        // Counters are updated by the player task, values may be one chunk apart
+        mixer_stats_t mix = state->mixer;
+        uint32_t budget_avg_us = mix.chunks ? (uint32_t)(mix.budget_us / mix.chunks) : 0;
+        printf("  Mixer: %d/%d voices active, %s kernel\n",
+               state->active_voices, PLAYER_MAX_VOICES, MIXER_HAS_SIMD ? "SIMD" : "scalar");
+        if (mix.chunks > 0 && mix.budget_us > 0) {
+            uint32_t busy_avg_us = (uint32_t)(mix.busy_us / mix.chunks);
+            double headroom = 100.0 * (1.0 - (double)mix.busy_us / (double)mix.budget_us);
+            printf("  Mixer load: %lu us/chunk avg, %lu us peak, budget %lu us/chunk, headroom %.1f%%\n",
+                   (unsigned long)busy_avg_us, (unsigned long)mix.peak_us,
+                   (unsigned long)budget_avg_us, headroom);
+        } else {
+            printf("  Mixer load: no chunk mixed yet\n");
+        }
+        printf("  Mixer reads: %lu in place (cache), %lu copied (file), %lu/%lu chunks zero-copy to I2S\n",
+               (unsigned long)mix.span_reads, (unsigned long)mix.copy_reads,
+               (unsigned long)mix.direct_chunks, (unsigned long)mix.chunks);
+        printf("  Gain ramps: %lu chunks (linear ramp over one chunk per volume step)\n",
+               (unsigned long)mix.ramp_chunks);
+        printf("  Jitter: %lu us worst late I2S write, %lu command sends found the ring full\n",
+               (unsigned long)mix.jitter_peak_us,
+               (unsigned long)__atomic_load_n(&state->cmd_ring_full, __ATOMIC_RELAXED));
+        const dma_layout_t *layout = &dma_layouts[state->dma_active];
+        printf("  I2S DMA: %s ring (%lu x %lu frames, %u-sample chunks), selected %s, %lu underruns\n",
+               dma_profile_names[state->dma_active],
+               (unsigned long)layout->desc_num, (unsigned long)layout->frame_num,
+               (unsigned)state->chunk_samples,
+               dma_profile_names[__atomic_load_n(&state->dma_selected, __ATOMIC_RELAXED)],
+               (unsigned long)__atomic_load_n(&state->underruns, __ATOMIC_RELAXED));
+
+        for (int v = 0; v < PLAYER_MAX_VOICES; v++) {
+            const player_voice_t *voice = &state->voices[v];
+            if (voice->chunks == 0) {
+                printf("  Voice %d: %s\n", v, voice->stream != NULL ? "starting" : "unused");
+                continue;
+            }
+            uint32_t voice_avg_us = (uint32_t)(voice->busy_us / voice->chunks);
+            double cpu = budget_avg_us ? 100.0 * voice_avg_us / budget_avg_us : 0.0;
+            printf("  Voice %d: %s, %lu us/chunk (%.1f%% CPU), %s\n",
+                   v, voice->stream != NULL ? "playing" : "last",
+                   (unsigned long)voice_avg_us, cpu, voice->status_name);
+        }
     }
 
     // Delegate to audio provider for cache status
@@ -7,22 +7,91 @@
 #pragma once
 #include "esp_err.h"
 #include "sdkconfig.h"
+#include "provider.h"
+#include "resampler.h"
 #include "soundboard.h"
 
 // Player configuration from Kconfig
 #define CACHE_SIZE_KB CONFIG_SOUNDBOARD_PLAYER_CACHE_SIZE_KB
+#define STREAM_RING_SIZE_KB CONFIG_SOUNDBOARD_STREAM_RING_SIZE_KB
+#define HEAD_CACHE_SIZE_KB CONFIG_SOUNDBOARD_HEAD_CACHE_SIZE_KB
+#if defined(CONFIG_SOUNDBOARD_CACHE_EVICTION_LRU)
+    #define CACHE_EVICTION_POLICY AUDIO_CACHE_POLICY_LRU
+#elif defined(CONFIG_SOUNDBOARD_CACHE_EVICTION_PAGE_LRU)
+    #define CACHE_EVICTION_POLICY AUDIO_CACHE_POLICY_PAGE_LRU
+#else
+    #define CACHE_EVICTION_POLICY AUDIO_CACHE_POLICY_PAGE_COST
+#endif
+#if defined(CONFIG_SOUNDBOARD_CACHE_FORMAT_IMA_ADPCM)
+    #define CACHE_SAMPLE_FORMAT AUDIO_CACHE_FORMAT_IMA_ADPCM
+#elif defined(CONFIG_SOUNDBOARD_CACHE_FORMAT_MULAW)
+    #define CACHE_SAMPLE_FORMAT AUDIO_CACHE_FORMAT_MULAW
+#else
+    #define CACHE_SAMPLE_FORMAT AUDIO_CACHE_FORMAT_PCM16
+#endif
+#ifdef CONFIG_SOUNDBOARD_OUTPUT_FIXED_RATE
+    #define OUTPUT_SAMPLE_RATE CONFIG_SOUNDBOARD_OUTPUT_RATE
+#else
+    #define OUTPUT_SAMPLE_RATE 0
+#endif
+#ifdef CONFIG_SOUNDBOARD_OUTPUT_DOWNMIX_MONO
+    #define OUTPUT_DOWNMIX_MONO true
+#else
+    #define OUTPUT_DOWNMIX_MONO false
+#endif
+#ifdef CONFIG_SOUNDBOARD_RESAMPLER_LINEAR
+    #define OUTPUT_RESAMPLER_TAPS RESAMPLER_TAPS_LINEAR
+#else
+    #define OUTPUT_RESAMPLER_TAPS RESAMPLER_TAPS_SINC
+#endif
+#if defined(CONFIG_SOUNDBOARD_I2S_DMA_PROFILE_LOW_LATENCY)
+    #define I2S_DMA_PROFILE PLAYER_DMA_PROFILE_LOW_LATENCY
+#elif defined(CONFIG_SOUNDBOARD_I2S_DMA_PROFILE_BALANCED)
+    #define I2S_DMA_PROFILE PLAYER_DMA_PROFILE_BALANCED
+#elif defined(CONFIG_SOUNDBOARD_I2S_DMA_PROFILE_ROBUST)
+    #define I2S_DMA_PROFILE PLAYER_DMA_PROFILE_ROBUST
+#else
+    #define I2S_DMA_PROFILE PLAYER_DMA_PROFILE_AUTO
+#endif
+#define PRELOAD_STREAM_SHARE CONFIG_SOUNDBOARD_PRELOAD_STREAM_SHARE
+#ifdef CONFIG_SOUNDBOARD_HEAD_CACHE_MS
+    #define HEAD_CACHE_MS CONFIG_SOUNDBOARD_HEAD_CACHE_MS
+#else
+    #define HEAD_CACHE_MS 0
+#endif
 
 // Forward declarations
 typedef struct player_s* player_handle_t;
 
+/**
+ * @brief Pre-resolved sound ID (same value space as the provider's audio_sound_id_t)
+ */
+typedef uint16_t player_sound_id_t;
+
+/**
+ * @brief Invalid / unresolved sound ID
+ */
+#define PLAYER_SOUND_ID_NONE UINT16_MAX
+
+/**
+ * @brief I2S DMA ring layout and mix chunk size
+ */
+typedef enum {
+    PLAYER_DMA_PROFILE_AUTO,            /**< Per sound: LOW_LATENCY if cached, ROBUST if streamed */
+    PLAYER_DMA_PROFILE_LOW_LATENCY,     /**< 4 descriptors x 120 frames, 240-sample chunks */
+    PLAYER_DMA_PROFILE_BALANCED,        /**< 6 descriptors x 240 frames, 480-sample chunks (ESP-IDF default) */
+    PLAYER_DMA_PROFILE_ROBUST,          /**< 8 descriptors x 480 frames, 960-sample chunks */
+    PLAYER_DMA_PROFILE_COUNT,
+} player_dma_profile_t;
+
 /**
  * @brief Player event types for callback
  */
 typedef enum {
     PLAYER_EVENT_READY,             /**< Player initialized, carries initial volume_index */
-    PLAYER_EVENT_STARTED,           /**< Playback started */
+    PLAYER_EVENT_STARTED,           /**< Playback started, carries filename + sound ID */
     PLAYER_EVENT_STOPPED,           /**< Playback stopped (finished or interrupted) */
-    PLAYER_EVENT_PROGRESS,          /**< Playback progress update, carries filename + progress */
+    PLAYER_EVENT_PROGRESS,          /**< Playback progress update, carries filename + sound ID + progress */
     PLAYER_EVENT_VOLUME_CHANGED,    /**< Volume level changed */
     PLAYER_EVENT_ERROR,             /**< Playback error occurred */
 } player_event_name_t;
@@ -31,11 +100,12 @@ typedef enum {
 typedef struct {
     player_event_name_t name;
     union {
-        const char *filename;   // For PLAYER_EVENT_STARTED, PLAYER_EVENT_STOPPED
+        const char *filename;   // For PLAYER_EVENT_STARTED (same as playback.filename), PLAYER_EVENT_STOPPED
         struct {
             const char *filename;   // Current file being played
+            player_sound_id_t sound_id; // PLAYER_SOUND_ID_NONE if the file was not resolved
             uint16_t progress;      // 0 = start, UINT16_MAX = end
-        } playback;             // For PLAYER_EVENT_PROGRESS
+        } playback;             // For PLAYER_EVENT_STARTED, PLAYER_EVENT_PROGRESS
         int volume_index;       // For PLAYER_EVENT_READY, PLAYER_EVENT_VOLUME_CHANGED
         esp_err_t error_code;   // For PLAYER_EVENT_ERROR
     };
@@ -56,6 +126,16 @@ typedef void (*player_event_callback_t)(const player_event_data_t *event_data, v
  */
 typedef struct {
     size_t cache_size_kb;                /**< Cache size in KB (0 = disabled, >0 = enabled, requires PSRAM) */
+    size_t stream_ring_kb;               /**< Read-ahead ring per streamed file in KB (0 = direct reads) */
+    size_t head_cache_kb;                /**< Attack-segment cache budget in KB (0 = disabled) */
+    uint32_t head_ms;                    /**< Attack-segment length per file in ms */
+    audio_cache_policy_t cache_policy;   /**< PSRAM cache eviction policy */
+    audio_cache_format_t cache_format;   /**< Sample format of PSRAM cache entries */
+    uint32_t output_rate;                /**< Fixed I2S rate in Hz, sources resampled (0 = follow each file) */
+    uint8_t resampler_taps;              /**< Resampler kernel taps (RESAMPLER_TAPS_*) */
+    bool downmix_mono;                   /**< Average stereo sources to mono at load / stream time */
+    player_dma_profile_t dma_profile;    /**< I2S DMA profile (PLAYER_DMA_PROFILE_AUTO = per sound) */
+    uint8_t preload_share;               /**< Preload share of SD time while files stream, percent (0 = pause) */
     player_event_callback_t event_cb;    /**< to notify player state changes to other modules (e.g. display)*/
     void *event_cb_ctx;                  /**< User context for player events callback */
 } player_config_t;
@@ -65,6 +145,16 @@ typedef struct {
  */
 #define PLAYER_CONFIG_DEFAULT() {       \
     .cache_size_kb = CACHE_SIZE_KB,     \
+    .stream_ring_kb = STREAM_RING_SIZE_KB, \
+    .head_cache_kb = HEAD_CACHE_SIZE_KB, \
+    .head_ms = HEAD_CACHE_MS,           \
+    .cache_policy = CACHE_EVICTION_POLICY, \
+    .cache_format = CACHE_SAMPLE_FORMAT, \
+    .output_rate = OUTPUT_SAMPLE_RATE,  \
+    .resampler_taps = OUTPUT_RESAMPLER_TAPS, \
+    .downmix_mono = OUTPUT_DOWNMIX_MONO, \
+    .dma_profile = I2S_DMA_PROFILE,     \
+    .preload_share = PRELOAD_STREAM_SHARE, \
     .event_cb = NULL,                   \
     .event_cb_ctx = NULL,               \
 }
@@ -106,7 +196,14 @@ esp_err_t player_deinit(player_handle_t player);
  * @brief Play audio file (async, queued request)
  *
  * Queues a play request to the player task. Plays the file once until EOF.
- * If already playing, stops the current stream and starts the new one.
+ * The file is mixed with the sounds already playing, on a free voice
+ * (CONFIG_SOUNDBOARD_PLAYER_VOICES). When all voices are busy, the oldest
+ * one is stopped and replaced. With a single voice, the current stream is
+ * stopped and the new one started.
+ *
+ * A file resolved at load time (see player_resolve_sound()) is queued by
+ * its sound ID; any other file is queued by path, without entering the
+ * sound table. Prefer player_play_sound() on the button path.
  *
  * @param player Player handle returned from player_init()
  * @param filename Path to audio file (e.g., "/sdcard/sound.wav")
@@ -114,14 +211,64 @@ esp_err_t player_deinit(player_handle_t player);
  *     - ESP_OK if request queued successfully
  *     - ESP_ERR_INVALID_STATE if player not initialized
  *     - ESP_ERR_INVALID_ARG if filename is NULL or player is NULL
+ *     - ESP_ERR_NOT_FOUND if the file is neither resolved nor present
+ *     - ESP_ERR_NO_MEM if the path could not be copied
  *     - ESP_FAIL if queue is full
  */
 esp_err_t player_play(player_handle_t player, const char *filename);
 
+/**
+ * @brief Resolve a file into a sound ID for player_play_sound()
+ *
+ * Call once per file when mappings are loaded; the ID stays valid for the
+ * lifetime of the player.
+ *
+ * @param player Player handle returned from player_init()
+ * @param filename Path to audio file
+ * @param[out] sound_id Sound ID (PLAYER_SOUND_ID_NONE on failure)
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if any parameter is NULL
+ *     - ESP_ERR_NO_MEM if the sound table is full
+ */
+esp_err_t player_resolve_sound(player_handle_t player, const char *filename,
+                               player_sound_id_t *sound_id);
+
+/**
+ * @brief Play a resolved sound (async, queued request)
+ *
+ * Same as player_play(), but the provider finds the cached data by index
+ * instead of comparing filenames.
+ *
+ * @param player Player handle returned from player_init()
+ * @param sound_id Sound ID from player_resolve_sound()
+ * @return Same as player_play(); ESP_ERR_INVALID_ARG for PLAYER_SOUND_ID_NONE
+ */
+esp_err_t player_play_sound(player_handle_t player, player_sound_id_t sound_id);
+
+/**
+ * @brief Pin sounds of the current and adjacent pages in the cache
+ *
+ * Replaces the previous pin set (see audio_provider_set_pins()). Called by
+ * the mapper on every page change, before the page preload.
+ *
+ * @param player Player handle returned from player_init()
+ * @param current Sound IDs of the current page
+ * @param current_count Number of IDs in current
+ * @param neighbours Sound IDs of the previous/next pages
+ * @param neighbour_count Number of IDs in neighbours
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if player is NULL or an array is NULL with a non-zero count
+ */
+esp_err_t player_set_cache_pins(player_handle_t player,
+                                const player_sound_id_t *current, size_t current_count,
+                                const player_sound_id_t *neighbours, size_t neighbour_count);
+
 /**
  * @brief Stop audio playback (async, queued request)
  *
- * Queues a stop request to the player task.
+ * Queues a stop request to the player task. Stops all voices.
  *
  * @param player Player handle returned from player_init()
  * @param interrupt_now If true, stop immediately. If false, finish current sample then stop.
@@ -133,6 +280,32 @@ esp_err_t player_play(player_handle_t player, const char *filename);
  */
 esp_err_t player_stop(player_handle_t player, bool interrupt_now);
 
+/**
+ * @brief Stop voices playing a given file (async, queued request)
+ *
+ * Stops immediately every voice playing filename; other voices continue.
+ *
+ * @param player Player handle returned from player_init()
+ * @param filename Path of the audio file to stop (as passed to player_play())
+ * @return
+ *     - ESP_OK if request queued successfully
+ *     - ESP_ERR_INVALID_ARG if player or filename is NULL
+ *     - ESP_ERR_NO_MEM if the path of a file never resolved could not be copied
+ *     - ESP_FAIL if queue is full
+ */
+esp_err_t player_stop_file(player_handle_t player, const char *filename);
+
+/**
+ * @brief Stop voices playing a resolved sound (async, queued request)
+ *
+ * Same as player_stop_file(), by sound ID.
+ *
+ * @param player Player handle returned from player_init()
+ * @param sound_id Sound ID from player_resolve_sound()
+ * @return Same as player_stop_file(); ESP_ERR_INVALID_ARG for PLAYER_SOUND_ID_NONE
+ */
+esp_err_t player_stop_sound(player_handle_t player, player_sound_id_t sound_id);
+
 
 /**
  * @brief Get current volume index
@@ -199,16 +372,161 @@ int player_volume_get_max_index(void);
  */
 esp_err_t player_preload(player_handle_t player, const char *filename);
 
+/**
+ * @brief Queue a page sound bank for background cache loading
+ *
+ * Loads every still-valid file of the bank with large sequential reads
+ * (see audio_provider_preload_bank()). Queue the per-file preloads after
+ * it: files already loaded from the bank are skipped.
+ *
+ * @param player Player handle returned from player_init()
+ * @param bank_path Path to the bank file (e.g., "/sdcard/banks/default.bnk")
+ * @return Same as player_preload()
+ */
+esp_err_t player_preload_bank(player_handle_t player, const char *bank_path);
+
+/**
+ * @brief Keep the attack segment of an audio file resident
+ *
+ * Registers the file in the attack-segment cache: its header and first
+ * HEAD_CACHE_MS of PCM are loaded in the background and kept in PSRAM, so
+ * that playback can start immediately even when the file is not cached.
+ * Call once per mapped file (duplicates are ignored).
+ *
+ * @param player Player handle returned from player_init()
+ * @param filename Path to audio file
+ * @return
+ *     - ESP_OK if registered (or already registered)
+ *     - ESP_ERR_INVALID_ARG if player or filename is NULL
+ *     - ESP_ERR_NOT_SUPPORTED if the attack-segment cache is disabled
+ *     - ESP_ERR_NO_MEM if the attack-segment table is full
+ */
+esp_err_t player_preload_head(player_handle_t player, const char *filename);
+
+/**
+ * @brief Load the on-card WAV layout index (see audio_provider_load_index())
+ *
+ * Indexed files start playing / loading without a header parse. Call once,
+ * before resolving the mapped sounds.
+ *
+ * @param player Player handle returned from player_init()
+ * @param path Index file (e.g. "/sdcard/.sound_index")
+ * @return Same as audio_provider_load_index()
+ */
+esp_err_t player_load_sound_index(player_handle_t player, const char *path);
+
+/**
+ * @brief Queue a speculative preload of an adjacent page's file or bank
+ *
+ * Best effort (see audio_provider_prefetch()): dropped quietly when the
+ * preload queue is full. Queue after the current page's preloads.
+ *
+ * @param player Player handle returned from player_init()
+ * @param path Path to the audio file or sound bank
+ * @param bank true if path is a sound bank
+ * @return Same as player_preload()
+ */
+esp_err_t player_prefetch(player_handle_t player, const char *path, bool bank);
+
 /**
  * @brief Flush the preload queue
  *
  * Discards all pending preload requests without affecting cached files.
+ * The load in flight is cancelled if its sound is no longer pinned by
+ * player_set_cache_pins() (page left).
  * Call before preloading a new page to avoid stale requests.
  *
  * @param player Player handle returned from player_init()
  */
 void player_flush_preload(player_handle_t player);
 
+/**
+ * @brief Drop every cached sound not being played (see audio_provider_purge_cache())
+ *
+ * @param player Player handle
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, or the provider error
+ */
+esp_err_t player_purge_cache(player_handle_t player);
+
+/**
+ * @brief Get the page warm-up state and last result (see audio_provider_get_warmup())
+ *
+ * @param player Player handle
+ * @param[out] warmup Warm-up state
+ * @return ESP_OK or ESP_ERR_INVALID_ARG
+ */
+esp_err_t player_get_warmup(player_handle_t player, audio_provider_warmup_t *warmup);
+
+/**
+ * @brief Get the preload scheduler counters (see audio_provider_get_preload_stats())
+ *
+ * @param player Player handle
+ * @param[out] stats Counters
+ * @return ESP_OK or ESP_ERR_INVALID_ARG
+ */
+esp_err_t player_get_preload_stats(player_handle_t player, audio_provider_preload_stats_t *stats);
+
+/**
+ * @brief Chunk timing since the last player_reset_timing()
+ */
+typedef struct {
+    uint32_t chunks;            /**< Chunks written to I2S */
+    uint32_t jitter_peak_us;    /**< Worst late I2S write (interval beyond the previous chunk's duration) */
+    uint32_t busy_peak_us;      /**< Worst mix time of a chunk */
+    uint32_t cmd_ring_full;     /**< Command sends that found the command ring full */
+    uint32_t underruns;         /**< DMA descriptors replayed as silence during playback */
+} player_timing_t;
+
+/**
+ * @brief Get the chunk timing window (values may be one chunk apart)
+ *
+ * @param player Player handle
+ * @param[out] timing Timing since the last reset
+ * @return ESP_OK or ESP_ERR_INVALID_ARG
+ */
+esp_err_t player_get_timing(player_handle_t player, player_timing_t *timing);
+
+/**
+ * @brief Start a new timing window
+ *
+ * The player task clears the counters before its next chunk.
+ *
+ * @param player Player handle
+ * @return ESP_OK or ESP_ERR_INVALID_ARG
+ */
+esp_err_t player_reset_timing(player_handle_t player);
+
+/**
+ * @brief Select the I2S DMA profile
+ *
+ * Takes effect when the next sound starts with no other voice playing
+ * (rebuilding the DMA ring interrupts the output). With
+ * PLAYER_DMA_PROFILE_AUTO, that sound picks the profile.
+ *
+ * @param player Player handle
+ * @param profile Profile, or PLAYER_DMA_PROFILE_AUTO
+ * @return ESP_OK or ESP_ERR_INVALID_ARG
+ */
+esp_err_t player_set_dma_profile(player_handle_t player, player_dma_profile_t profile);
+
+/**
+ * @brief Get the selected and the active I2S DMA profile
+ *
+ * @param player Player handle
+ * @param[out] selected Profile set by Kconfig / player_set_dma_profile() (may be AUTO), NULL to skip
+ * @param[out] active Layout of the current DMA ring (never AUTO), NULL to skip
+ * @return ESP_OK or ESP_ERR_INVALID_ARG
+ */
+esp_err_t player_get_dma_profile(player_handle_t player, player_dma_profile_t *selected,
+                                 player_dma_profile_t *active);
+
+/**
+ * @brief Profile name ("auto", "low_latency", "balanced", "robust")
+ *
+ * @return Name, or "unknown" for an invalid value
+ */
+const char *player_dma_profile_name(player_dma_profile_t profile);
+
 /**
  * @brief Print player status information to console
  *
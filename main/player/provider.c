@@ -4,21 +4,37 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <sys/stat.h>
 #include "sdkconfig.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h" // IWYU pragma: keep
 #include "soundboard.h"
 #include "provider.h"
+#include "codec.h"
+#include "msg_ring.h"
+#include "resampler.h"
+#include "sound_bank.h"
+#include "sound_index.h"
 
 #ifdef CONFIG_SOUNDBOARD_IO_STATS_ENABLE
     #include "benchmark.h"
 #endif
+#ifdef CONFIG_SOUNDBOARD_TRACE_ENABLE
+    #include "trace.h"
+#endif
+#ifdef CONFIG_SOUNDBOARD_SD_DIRECT_READ
+    #include "sd_card.h"
+#endif
 
 static const char *TAG_PROVIDER = "audio_provider";
 static const char *TAG_CACHE = "audio_cache";
 
 #define CACHE_ENTRY_COUNT 64
 #define WAV_CHUNK_SIZE 4096  // WAV read chunk size
+#define WAV_FORMAT_PCM             1
+#define WAV_FORMAT_EXTENSIBLE      0xFFFE
+#define WAV_FMT_EXTENSIBLE_SIZE    40   // fmt chunk of WAVE_FORMAT_EXTENSIBLE
 
 // Maximum cacheable file size: files larger than half of total PSRAM are not cached
 // (they would cause excessive eviction and fragmentation)
@@ -27,7 +43,34 @@ static const char *TAG_CACHE = "audio_cache";
 // Preload task configuration
 #define PRELOAD_TASK_PRIORITY    1   // Lower than player (2)
 #define PRELOAD_TASK_STACK_SIZE  4096
-#define PRELOAD_QUEUE_LENGTH     16
+#define PRELOAD_RING_DEPTH       32    // Preload requests, current page + prefetch (power of two)
+#define PRELOAD_THROTTLE_MAX_US  200000 // Longest sleep owed after one slow read while streaming
+#define PURGE_TIMEOUT_MS         10000 // Queued preloads run before a purge
+#define BANK_READ_CHUNK          (64 * 1024) // Sound bank read size (pause checks in between)
+
+// Read-ahead streamer task configuration (cache-miss playback)
+#define STREAM_TASK_PRIORITY     3   // Above player (2): only waits on SD I/O
+#define STREAM_TASK_STACK_SIZE   4096
+#define STREAM_TASK_CORE         0   // Keep SD reads off the audio core
+#define STREAM_TASK_IDLE_MS      20  // Poll period when no consumer notification arrives
+#define STREAM_READER_MAX        8   // Max file streams with a ring (others read directly)
+
+// Attack-segment (head) cache configuration
+#define HEAD_ENTRY_COUNT         128 // Max files with a resident head
+#define HEAD_BUFFER_ALIGN        16  // Head spans stay aligned for the SIMD mixer
+
+// Cache arena (one PSRAM region owned by the provider, compacted instead of evicting)
+#define CACHE_ARENA_ALIGN        16            // Entry alignment (cache spans feed the SIMD mixer)
+#define CACHE_ARENA_HEADROOM     (256 * 1024)  // PSRAM left to the heap besides heads and rings
+
+// Eviction cost model (until the first loads are measured)
+#define LOAD_COST_DEFAULT_OPEN_US   20000  // fopen + header parse
+#define LOAD_COST_DEFAULT_US_PER_KB 1000   // ~1 MB/s SPI SD read
+#define LOAD_COST_EWMA_SHIFT        3      // New measurement weight 1/8
+
+// Sound table (pre-resolved IDs for O(1) cache/head lookup on open)
+#define SOUND_ID_COUNT           256 // Max distinct resolved files
+#define SOUND_SLOT_NONE          (-1)
 
 
 /*
@@ -41,6 +84,44 @@ static const char *TAG_CACHE = "audio_cache";
  * 2. PSRAM cache:
  *    - stream_read() copies data chunks from cache entry to caller's buffer
  *    - ~100-500x faster than file streaming
+ *
+ * File streams are read ahead by a streamer task into a per-stream PSRAM ring
+ * (single producer: streamer task, single consumer: player task). The player
+ * only memcpy()s from the ring; the streamer owns the FILE and frees the
+ * stream once the player has closed it.
+ *
+ * Attack-segment cache: the header and first head_ms of PCM of every mapped
+ * file stay resident in PSRAM (separate budget, no eviction). A cache miss
+ * with a resident head plays from the head at once; the file is opened and
+ * read by the streamer task in the background, starting after the head.
+ *
+ * Cache arena: all cache entries live in one PSRAM region allocated at init.
+ * Allocation is first-fit over the holes between entries; when the free
+ * space is sufficient but not contiguous, unreferenced entries are slid
+ * down (compaction) instead of evicting them. Entries being moved are
+ * treated as cache misses by open_stream().
+ *
+ * Eviction: victims are chosen by a pluggable policy (cache_policy_ops_t).
+ * Page-aware policies never evict sounds pinned for the current page and
+ * evict sounds pinned for adjacent pages last. Recency is an access clock
+ * stamped on open under cache_mutex (no per-chunk locking).
+ *
+ * Hot path locking: reads take no lock, and a cache stream's close only
+ * decrements the entry's atomic ref_count. Preload requests go through a
+ * lock-free ring (msg_ring.h) drained by the preload task; a flush bumps
+ * a generation number instead of draining the ring from the caller.
+ *
+ * Preload scheduling: requests run in FIFO order, the current page first,
+ * then prefetches of the adjacent pages. After a flush, the load in flight
+ * stops at its next chunk if its sound is no longer pinned (the user left
+ * its page). While file streams are open, the preload task reads in small
+ * chunks and sleeps between them so that it uses at most preload_share
+ * percent of the SD card time (0: it waits for the streams to close).
+ *
+ * Sound IDs: callers resolve a filename once (at mapping load) into an
+ * index of an append-only sound table. Each table entry tracks the cache
+ * slot and head slot of its file, so opening by ID is array indexing
+ * instead of strcmp() over the cache and head tables.
  */
 
 /**
@@ -55,32 +136,139 @@ typedef enum {
 /**
  * @brief Cache entry structure
  *
- * Stores pre-loaded PCM data in PSRAM for fast playback.
- * Data size in bytes = frame_count * info.channels * (info.bit_depth / 8)
+ * Stores pre-loaded audio data in PSRAM for fast playback, as 16-bit PCM
+ * or in a compressed format decoded by read_stream (see codec.h).
+ * Data size in bytes = codec_encoded_size(format, frame_count, info.channels)
  */
 typedef struct cache_entry_s {
     char *filename;                  // Heap-allocated filename string
     size_t frame_count;              // Number of audio frames
     audio_info_t info;               // Audio format parameters
-    size_t buf_size;                 // Total buffer size in bytes
+    audio_cache_format_t format;     // Sample format of buffer
+    size_t buf_size;                 // Total buffer size in bytes (encoded)
     size_t total_samples;            // Pre-calculated: frame_count * channels (optimization)
-    int16_t *buffer;                 // PSRAM-allocated PCM buffer (16-bit only)
+    int16_t *buffer;                 // Data in the cache arena (raw bytes unless format is PCM16)
 
-    // Reference counting for safe multi-stream support
-    uint8_t ref_count;               // Number of active streams using this entry
+    // Arena placement (arena_bytes > 0: region in use, reserved or filled)
+    size_t arena_offset;             // Offset of buffer in the arena
+    size_t arena_bytes;              // Region size (buf_size rounded up to CACHE_ARENA_ALIGN)
+    bool moving;                     // Being relocated by compaction (not openable)
 
-    // LRU tracking
-    uint32_t last_access_tick;       // FreeRTOS tick count of last access
+    // Reference counting for safe multi-stream support (__atomic: incremented
+    // on open under cache_mutex, decremented on close without any lock)
+    uint32_t ref_count;              // Number of active streams using this entry
 
-    // Thread safety
-    SemaphoreHandle_t mutex;         // Protects ref_count and last_access_tick
+    // Eviction policy state (cache_mutex)
+    uint32_t last_access;            // Access clock value of last open
+    uint32_t priority;               // Cost-aware policy value (evicted lowest first)
+
+    audio_sound_id_t sound_id;       // Resolved ID of filename (AUDIO_SOUND_ID_NONE if unresolved)
 } cache_entry_t;
 
+/**
+ * @brief true while a stream reads the entry (any task)
+ */
+static inline bool cache_entry_in_use(const cache_entry_t *entry)
+{
+    return __atomic_load_n(&entry->ref_count, __ATOMIC_ACQUIRE) > 0;
+}
+
+/**
+ * @brief Why an entry was evicted
+ */
+typedef enum {
+    EVICT_REASON_BUDGET,     // Arena budget exceeded
+    EVICT_REASON_SLOTS,      // All cache slots in use
+    EVICT_REASON_FRAGMENTED, // Budget OK but no hole, even after compaction (pinned entries)
+    EVICT_REASON_COUNT,
+} evict_reason_t;
+
+static const char *const evict_reason_names[EVICT_REASON_COUNT] = { "budget", "slots", "fragmented" };
+
+/**
+ * @brief Evictions made by one cache_reserve_and_alloc() call, logged without the mutex
+ */
+typedef struct {
+    int count;
+    size_t bytes;
+    const char *policy;
+    evict_reason_t reason;          // Of the last eviction
+    char *last_name;                // Filename taken from the last victim (owned)
+} cache_eviction_log_t;
+
+struct audio_provider_s;
+
+/**
+ * @brief Eviction policy operations
+ *
+ * rank() orders candidates (lowest evicted first); on_access() is called on
+ * store and on every open hit, on_evict() when the policy's victim is freed.
+ * All run under cache_mutex.
+ */
+typedef struct {
+    audio_cache_policy_t id;
+    const char *name;
+    bool use_pins;                   // Honour current/adjacent page pins
+    uint32_t (*rank)(const struct audio_provider_s *provider, const cache_entry_t *entry);
+    void (*on_access)(struct audio_provider_s *provider, cache_entry_t *entry);
+    void (*on_evict)(struct audio_provider_s *provider, const cache_entry_t *entry);
+} cache_policy_ops_t;
+
+/**
+ * @brief WAV layout knowledge of a resolved sound (sound_meta[])
+ */
+typedef enum {
+    SOUND_META_NONE,         // Not known: opening parses the header
+    SOUND_META_INDEXED,      // Known and in the on-card index
+    SOUND_META_DIRTY,        // Known, not in the index yet (new file, or stale entry refreshed)
+    SOUND_META_FAILED,       // Header not parseable: not indexed
+} sound_meta_state_t;
+
+/**
+ * @brief Attack-segment entry state
+ */
+typedef enum {
+    HEAD_STATE_EMPTY,        // Free slot
+    HEAD_STATE_PENDING,      // Registered, waiting for the preload task
+    HEAD_STATE_READY,        // Head loaded (immutable until deinit)
+    HEAD_STATE_FAILED,       // Not loadable (bad file or budget exhausted)
+} head_state_t;
+
+/**
+ * @brief Attack-segment (head) cache entry
+ *
+ * Written once by the preload task, then immutable until deinit: streams
+ * use READY entries without reference counting.
+ */
+typedef struct {
+    char *filename;                  // Heap-allocated filename string (set while not EMPTY)
+    head_state_t state;              // Protected by cache_mutex
+    audio_info_t info;               // Audio format parameters (16-bit PCM handed out)
+    codec_pcm_t pcm;                 // Conversion of the file samples to info
+    uint32_t data_offset;            // Offset to PCM data in file
+    uint32_t data_size;              // Size of the 16-bit PCM in bytes (whole frames)
+    int16_t *buffer;                 // PSRAM head buffer (first head_bytes of PCM)
+    uint32_t head_bytes;             // Bytes held in buffer (== data_size for short files)
+} head_entry_t;
+
+/**
+ * @brief Preload queue item kinds
+ */
+typedef enum {
+    PRELOAD_ITEM_FILE,       // Cache one WAV file
+    PRELOAD_ITEM_BANK,       // Load a sound bank image
+    PRELOAD_ITEM_PURGE,      // Free every unreferenced entry, then give done
+} preload_item_kind_t;
+
 /**
  * @brief Preload queue item
  */
 typedef struct {
-    char filename[SOUNDBOARD_MAX_PATH_LEN];
+    char filename[SOUNDBOARD_MAX_PATH_LEN];  // WAV file or bank image (unused for purge)
+    preload_item_kind_t kind;
+    bool prefetch;                           // Speculative (adjacent page), counted apart
+    uint32_t generation;                     // preload_generation when queued (stale after a flush)
+    SemaphoreHandle_t done;                  // Purge: given when the cache is empty
 } preload_item_t;
 
 /**
@@ -89,24 +277,142 @@ typedef struct {
 typedef struct audio_provider_s {
     // Cache management
     cache_entry_t cache[CACHE_ENTRY_COUNT];
-    size_t max_cache_bytes;                   // Total cache size limit (from config)
-    size_t used_cache_bytes;                  // Current cache usage
+    size_t max_cache_bytes;                   // Total cache size limit (arena size)
+    size_t used_cache_bytes;                  // Arena bytes in use (including alignment padding)
+
+    // Cache arena
+    uint8_t *arena;                           // PSRAM region holding all entry buffers
+    uint32_t arena_compactions;               // Compaction passes run
+    size_t arena_moved_bytes;                 // Bytes relocated by compaction
+
+    // Eviction policy (cache_mutex)
+    const cache_policy_ops_t *policy;
+    uint32_t access_clock;                    // Incremented on every store / open hit
+    uint32_t cost_inflation;                  // Cost-aware policy: value of the last victim
+    uint32_t load_open_us;                    // Measured fopen + parse time (EWMA)
+    uint32_t load_us_per_kb;                  // Measured cache load read time (EWMA)
+    uint32_t evictions[EVICT_REASON_COUNT];   // Evictions per reason
+    uint32_t neighbour_evictions;             // Of which sounds pinned for an adjacent page
+    uint32_t reload_misses;                   // Misses on sounds that had been cached and evicted
 
     // Thread safety
     SemaphoreHandle_t cache_mutex;            // Protects cache array operations
 
     // Preload task
     TaskHandle_t preload_task_handle;         // Background preload task
-    QueueHandle_t preload_queue;              // Queue for preload requests
+    msg_ring_t *preload_ring;                 // Preload requests (any task -> preload task)
+    uint32_t preload_generation;              // Bumped by a flush: older items are dropped (__atomic)
     bool preload_task_running;                // Flag to signal task shutdown
-
-    // Preload pause control (pause during active playback to avoid SD card contention)
-    volatile int active_stream_count;         // Number of open WAV file streams (atomically updated)
+    bool preload_idle;                        // Waiting for a push, nothing queued or pending (__atomic)
+
+    // Preload scheduling (preload task, read without lock by status)
+    volatile int active_stream_count;         // Open streams reading the SD card (atomically updated)
+    uint8_t preload_share;                    // SD time share while streams are open, percent (0 = pause)
+    int64_t throttle_debt_us;                 // Sleep owed for reads done while streaming
+    uint32_t inflight_generation;             // Generation of the item being loaded
+    bool inflight_prefetch;                   // Item being loaded is a prefetch
+    uint32_t preload_queue_peak;              // Most items queued at once (any task, __atomic)
+    uint32_t preload_flushed;                 // Items dropped by a flush
+    uint32_t preload_cancelled;               // Loads stopped in flight (page left)
+    uint32_t prefetch_dropped;                // Prefetch requests dropped, ring full (any task, __atomic)
+    uint64_t preload_throttle_us;             // Time yielded to file streams
+    uint32_t preload_files;                   // Files cached by the preload task (cache_mutex)
+    size_t preload_bytes;
+    uint32_t prefetch_files;                  // Of which from prefetch requests (cache_mutex)
+    size_t prefetch_bytes;
+
+    // Read-ahead streamer (ring_size == 0: disabled, direct file reads)
+    size_t ring_size;                         // Ring buffer size per file stream (bytes)
+    TaskHandle_t stream_task_handle;
+    bool stream_task_running;
+    SemaphoreHandle_t reader_mutex;           // Protects readers[]
+    audio_stream_handle_t readers[STREAM_READER_MAX];
+
+    // Read-ahead statistics (since boot, updated by player task on close)
+    uint32_t ring_underruns;                  // Reads that found the ring empty before EOF
+    uint32_t ring_low_watermark;              // Lowest ring fill seen before a read (bytes)
+    uint32_t ring_streams;                    // File streams played through a ring
+
+    // Attack-segment cache (max_head_bytes == 0: disabled)
+    head_entry_t heads[HEAD_ENTRY_COUNT];     // Protected by cache_mutex (state, filename)
+    size_t max_head_bytes;                    // Head budget (from config, separate from cache)
+    size_t used_head_bytes;
+    uint32_t head_ms;                         // Head length per file
+    int heads_pending;                        // Registered heads not loaded yet
+
+    // Sound table (append-only, names immutable until deinit)
+    char *sound_names[SOUND_ID_COUNT];        // Interned filenames
+    int16_t sound_cache_slot[SOUND_ID_COUNT]; // Index into cache[] or SOUND_SLOT_NONE (cache_mutex)
+    int16_t sound_head_slot[SOUND_ID_COUNT];  // Index into heads[] or SOUND_SLOT_NONE (cache_mutex)
+    uint8_t sound_pin[SOUND_ID_COUNT];        // audio_cache_pin_t (cache_mutex)
+    bool sound_evicted[SOUND_ID_COUNT];       // Evicted and not cached again (cache_mutex)
+    sound_index_meta_t sound_meta[SOUND_ID_COUNT]; // WAV layout, valid unless NONE / FAILED (cache_mutex)
+    uint8_t sound_meta_state[SOUND_ID_COUNT]; // sound_meta_state_t (cache_mutex)
+    uint16_t sound_count;                     // Published with release after the name is set
+
+    // On-card WAV layout index (index_path == NULL: not loaded). Entries only
+    // change in the preload task, under cache_mutex; it saves them unlocked
+    sound_index_t index;
+    char *index_path;
+    size_t index_root_len;                    // Files under the index directory are indexed
+    bool index_scan;                          // Sounds may need a parse or an index update (__atomic)
+    uint32_t index_opens;                     // Opens that skipped the header parse (__atomic)
+    uint32_t header_parses;                   // WAV headers parsed (__atomic)
+    uint32_t index_stale;                     // Index entries whose file size changed (__atomic)
+
+    // Open statistics (since boot, updated under cache_mutex)
+    uint32_t cache_hits;                      // Opens served by the PSRAM cache
+    uint32_t head_hits;                       // Cache misses started from a resident head
+    uint32_t cold_misses;                     // Cache misses without head (fopen + parse on press)
+
+    // Page warm-up (cache_mutex): a window opens on flush_preload_queue()
+    // and closes when the preload queue drains
+    int64_t warmup_start_us;                  // 0 = no window open
+    uint32_t warmup_files;                    // Files cached in the open window
+    size_t warmup_bytes;
+    bool warmup_bank;                         // Open window loaded from a sound bank
+    uint32_t last_warmup_ms;                  // Last window that cached anything
+    uint32_t last_warmup_files;
+    size_t last_warmup_bytes;
+    bool last_warmup_bank;
+    uint32_t warmup_count;                    // Windows that cached anything
+
+    // Sound banks (preload task, read under cache_mutex)
+    uint32_t bank_loads;                      // Bank images read
+    uint32_t bank_files;                      // Files cached from banks
+    uint32_t bank_stale;                      // Entries skipped (source file changed or other format)
+
+    // Cache sample format and decode cost (decode stats: player task only)
+    audio_cache_format_t cache_format;        // Format of new entries (PCM16 fallback per file)
+    uint32_t decode_chunks;                   // Chunks decoded from compressed entries
+    uint64_t decode_us;                       // Total decode time
+    uint32_t decode_peak_us;                  // Slowest chunk
+
+    // Fixed output rate (output_rate == 0: streams play at their native rate)
+    uint32_t output_rate;
+    resampler_kernel_t *resampler_kernel;     // Shared by all resamplers
+    uint32_t resampled_streams;               // File streams converted while playing (player task)
+    uint32_t resampled_loads;                 // Cache entries converted at load (cache_mutex)
+
+    // Source conversion to 16-bit PCM (downmix: stereo files handed out as mono)
+    bool downmix;
+    uint32_t downmixed_files;                 // Loads / streams of stereo files averaged to mono (atomic)
+    uint32_t narrowed_files;                  // Loads / streams of 24/32-bit files reduced to 16 bits (atomic)
 
     // Configuration
     bool initialized;
 } audio_provider_state_t;
 
+/**
+ * @brief WAV file open for its PCM data: stdio stream, or direct SD card reader
+ */
+typedef struct {
+    FILE *fp;                            // NULL when read directly (or closed)
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+    sd_card_file_t *direct;              // 16-bit files on the SD card (no stdio buffering)
+#endif
+} wav_file_t;
+
 /**
  * @brief Audio stream handle (concrete implementation)
  */
@@ -115,6 +421,7 @@ struct audio_stream_s {
     char filename[SOUNDBOARD_MAX_PATH_LEN];  // Copied on open for safety
     audio_info_t info;                   // Audio format parameters
     stream_type_t type;                  // WAV_FILE or CACHE
+    audio_sound_id_t sound_id;           // AUDIO_SOUND_ID_NONE for an unresolved file (trace only)
 
     // State flags
     bool eof_reached;                    // End of stream indicator
@@ -123,20 +430,43 @@ struct audio_stream_s {
     // Parent provider reference (for cache updates)
     audio_provider_handle_t provider;
 
+    // Sample-rate conversion of file streams (NULL: native rate, or converted at cache load).
+    // info then holds the output rate and length; the wav state stays in source frames.
+    resampler_t *resampler;
+    uint32_t resample_frames_left;       // Output frames still to produce
+
     // Type-specific state (union for memory efficiency)
     union {
         // WAV file stream state
         struct {
-            FILE *fp;                    // File handle
+            wav_file_t file;             // File handle (owned by streamer when ring != NULL)
             uint32_t data_offset;        // Offset to PCM data in file
-            uint32_t data_size;          // Size of PCM data in bytes
-            uint32_t bytes_read;         // Bytes read so far
+            uint32_t data_size;          // Size of the 16-bit PCM in bytes (sizes below count the same)
+            uint32_t bytes_read;         // Bytes consumed by the player so far
+            codec_pcm_t pcm;             // Conversion of the file samples (used by the file reader)
+            uint8_t *pcm_scratch;        // File bytes staging of converted files (NULL: passthrough)
+            bool sd_active;              // Reads the SD card: counted in active_stream_count
+
+            // Read-ahead ring (NULL = direct file reads in read_stream)
+            uint8_t *ring;               // PSRAM ring buffer
+            uint32_t ring_head;          // Total bytes written (streamer, atomic)
+            uint32_t ring_tail;          // Total bytes consumed (player, atomic)
+            uint32_t file_bytes;         // Bytes read from file (streamer only)
+            bool file_done;              // Streamer reached end of data (atomic)
+            bool file_error;             // Streamer read error (atomic)
+            bool closing;                // Player closed the stream (atomic)
+            uint32_t underruns;          // Empty-ring reads before EOF
+            uint32_t low_watermark;      // Lowest fill seen before a read (bytes)
+
+            // Attack segment (NULL = file read from the start)
+            const head_entry_t *head;    // Served until bytes_read reaches head->head_bytes
         } wav;
 
         // Cache stream state
         struct {
             cache_entry_t *entry;        // Pointer to cache entry (not owned)
             size_t position;             // Current read position (int16_t samples)
+            codec_state_t decoder;       // Sequential decoder (compressed entries)
         } cache;
     };
 };
@@ -204,22 +534,34 @@ static esp_err_t parse_wav_header(FILE *fp, audio_info_t *info, uint32_t *data_o
                 break;
             }
 
-            if (audio_format != 1) {
-                ESP_LOGE(TAG_PROVIDER, "Only PCM format supported (format=%u)", audio_format);
-                return ESP_ERR_NOT_SUPPORTED;
-            }
-
             fread(&num_channels, 2, 1, fp);
             fread(&frame_rate, 4, 1, fp);
             fseek(fp, 6, SEEK_CUR);  // Skip ByteRate and BlockAlign
             fread(&bits_per_sample, 2, 1, fp);
+            uint32_t bytes_read = 16;
+
+            // WAVE_FORMAT_EXTENSIBLE (most 24-bit exports): format code in the SubFormat GUID
+            if (audio_format == WAV_FORMAT_EXTENSIBLE && chunk_size >= WAV_FMT_EXTENSIBLE_SIZE) {
+                fseek(fp, 8, SEEK_CUR);  // Skip cbSize, ValidBitsPerSample and ChannelMask
+                fread(&audio_format, 2, 1, fp);
+                bytes_read = 26;
+            }
+
+            if (audio_format != WAV_FORMAT_PCM) {
+                ESP_LOGE(TAG_PROVIDER, "Only PCM format supported (format=%u)", audio_format);
+                return ESP_ERR_NOT_SUPPORTED;
+            }
+            if (!codec_pcm_supports(bits_per_sample) || num_channels == 0) {
+                ESP_LOGE(TAG_PROVIDER, "Unsupported PCM layout (%u bits, %u channels)",
+                         bits_per_sample, num_channels);
+                return ESP_ERR_NOT_SUPPORTED;
+            }
 
             info->frame_rate = frame_rate;
             info->channels = num_channels;
             info->bit_depth = bits_per_sample;
 
             // Skip any extra format bytes
-            uint32_t bytes_read = 16;
             if (chunk_size > bytes_read) {
                 fseek(fp, chunk_size - bytes_read, SEEK_CUR);
             }
@@ -234,12 +576,14 @@ static esp_err_t parse_wav_header(FILE *fp, audio_info_t *info, uint32_t *data_o
             *data_offset = ftell(fp);
             found_data = true;
 
-            ESP_LOGD(TAG_PROVIDER, "WAV data: offset=%lu, size=%lu", *data_offset, *data_size);
+            ESP_LOGD(TAG_PROVIDER, "WAV data: offset=%lu, size=%lu",
+                     (unsigned long)*data_offset, (unsigned long)*data_size);
             break;  // Found data, done parsing
 
         } else {
             // Unknown chunk - skip it
-            ESP_LOGD(TAG_PROVIDER, "Skipping unknown chunk: %.4s (size=%lu)", chunk_id, chunk_size);
+            ESP_LOGD(TAG_PROVIDER, "Skipping unknown chunk: %.4s (size=%lu)",
+                     chunk_id, (unsigned long)chunk_size);
             fseek(fp, chunk_size, SEEK_CUR);
         }
 
@@ -263,6 +607,28 @@ static esp_err_t parse_wav_header(FILE *fp, audio_info_t *info, uint32_t *data_o
 
 
 
+esp_err_t audio_provider_parse_wav_file(const char *filename, audio_info_t *info,
+                                        uint32_t *data_offset, uint32_t *data_size)
+{
+    if (!filename || !info || !data_offset || !data_size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    esp_err_t ret = parse_wav_header(fp, info, data_offset, data_size);
+    fclose(fp);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Whole frames only, as read by the cache
+    *data_size = info->total_frames * info->channels * (info->bit_depth / 8);
+    return ESP_OK;
+}
+
 // ============================================================================
 // Internal Cache Implementation
 // ============================================================================
@@ -282,418 +648,2445 @@ static cache_entry_t* cache_lookup(audio_provider_state_t *provider, const char
 }
 
 /**
- * @brief Find LRU victim for eviction
+ * @brief Find resolved sound ID by filename
  *
- * @return Index of oldest unused entry, or -1 if all entries have ref_count > 0
+ * Caller must hold cache_mutex. Only used off the hot path (resolve, cache
+ * store, head register).
  */
-static int cache_find_lru_victim(audio_provider_state_t *provider)
+static audio_sound_id_t sound_lookup(audio_provider_state_t *provider, const char *filename)
 {
-    int victim_idx = -1;
-    uint32_t oldest_tick = UINT32_MAX;
-
-    for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
-        cache_entry_t *entry = &provider->cache[i];
-
-        // Skip empty slots
-        if (entry->filename == NULL) continue;
-
-        // Skip entries currently in use
-        if (entry->ref_count > 0) continue;
-
-        // Find oldest accessed entry
-        if (entry->last_access_tick < oldest_tick) {
-            oldest_tick = entry->last_access_tick;
-            victim_idx = i;
+    for (uint16_t id = 0; id < provider->sound_count; id++) {
+        if (strcmp(provider->sound_names[id], filename) == 0) {
+            return id;
         }
     }
+    return AUDIO_SOUND_ID_NONE;
+}
 
-    return victim_idx;
+// ============================================================================
+// Eviction Policies
+// ============================================================================
+
+static uint32_t lru_rank(const audio_provider_state_t *provider, const cache_entry_t *entry)
+{
+    // Age in accesses (wrap-safe): oldest has the largest age, rank lowest
+    return UINT32_MAX - (provider->access_clock - entry->last_access);
 }
 
 /**
- * @brief Free cache entry resources
+ * @brief Estimated reload cost of an entry per KB freed (us/KB)
+ *
+ * Small files cost more per byte to reload (open + parse dominates), so
+ * large rarely used files are evicted first. The read cost is per KB of
+ * 16-bit PCM loaded from the card (after downmix / bit-depth conversion),
+ * the result per KB of cache held (compressed entries hold more seconds per KB).
  */
-static void free_cache_entry(audio_provider_state_t *provider, cache_entry_t *entry)
+static uint32_t reload_cost_per_kb(const audio_provider_state_t *provider, const cache_entry_t *entry)
 {
-    if (entry == NULL || entry->filename == NULL) {
-        return;
-    }
-
-    // Assert ref_count == 0 (defensive programming)
-    assert(entry->ref_count == 0 && "Cannot free entry with active streams");
-
-    // Free PSRAM buffer
-    if (entry->buffer != NULL) {
-        heap_caps_free(entry->buffer);
-        entry->buffer = NULL;
-    }
-
-    // Update cache size
-    provider->used_cache_bytes -= entry->buf_size;
+    uint32_t kb = (uint32_t)(entry->buf_size / 1024) + 1;
+    uint32_t pcm_kb = (uint32_t)(entry->total_samples * sizeof(int16_t) / 1024) + 1;
+    return (provider->load_open_us + provider->load_us_per_kb * pcm_kb) / kb;
+}
 
-    // Free filename
-    free(entry->filename);
-    entry->filename = NULL;
+static uint32_t cost_rank(const audio_provider_state_t *provider, const cache_entry_t *entry)
+{
+    (void)provider;
+    return entry->priority;
+}
 
-    // Note: entry->mutex is NOT deleted here - it's a persistent resource
-    // of the cache slot, created once in audio_provider_init() and reused
-    // across different cached files
+// GreedyDual-Size: value = inflation + cost/size, inflation rises to each victim's value
+static void cost_on_access(audio_provider_state_t *provider, cache_entry_t *entry)
+{
+    entry->priority = provider->cost_inflation + reload_cost_per_kb(provider, entry);
+}
 
-    ESP_LOGD(TAG_CACHE, "Freed cache entry (used: %zu/%zu KB)",
-             provider->used_cache_bytes / 1024, provider->max_cache_bytes / 1024);
+static void cost_on_evict(audio_provider_state_t *provider, const cache_entry_t *entry)
+{
+    if (entry->priority > provider->cost_inflation) {
+        provider->cost_inflation = entry->priority;
+    }
 }
 
+static const cache_policy_ops_t cache_policies[] = {
+    { AUDIO_CACHE_POLICY_LRU,       "lru",       false, lru_rank,  NULL,           NULL          },
+    { AUDIO_CACHE_POLICY_PAGE_LRU,  "page_lru",  true,  lru_rank,  NULL,           NULL          },
+    { AUDIO_CACHE_POLICY_PAGE_COST, "page_cost", true,  cost_rank, cost_on_access, cost_on_evict },
+};
+
 /**
- * @brief Parse WAV file header to determine buffer size needed
+ * @brief Record an access to an entry (store or open hit)
  *
- * Opens and closes the file — caller will reopen for PCM data read.
+ * Caller must hold cache_mutex.
  */
-static esp_err_t cache_parse_wav_file(const char *filename, audio_info_t *info,
-                                       uint32_t *data_offset, size_t *total_bytes)
+static void cache_touch(audio_provider_state_t *provider, cache_entry_t *entry)
 {
-    FILE *fp = fopen(filename, "rb");
-    if (!fp) {
-        ESP_LOGE(TAG_CACHE, "Failed to open file: %s", filename);
-        return ESP_ERR_NOT_FOUND;
+    entry->last_access = ++provider->access_clock;
+    if (provider->policy->on_access) {
+        provider->policy->on_access(provider, entry);
     }
+}
 
-    uint32_t data_size;
-    esp_err_t ret = parse_wav_header(fp, info, data_offset, &data_size);
-    fclose(fp);
-
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG_CACHE, "Failed to parse WAV header: %s", filename);
-        return ret;
+static audio_cache_pin_t cache_entry_pin(const audio_provider_state_t *provider, const cache_entry_t *entry)
+{
+    if (!provider->policy->use_pins || entry->sound_id == AUDIO_SOUND_ID_NONE) {
+        return AUDIO_CACHE_PIN_NONE;
     }
-
-    *total_bytes = (size_t)info->total_frames * info->channels * sizeof(int16_t);
-    return ESP_OK;
+    return (audio_cache_pin_t)provider->sound_pin[entry->sound_id];
 }
 
 /**
- * @brief Reserve a cache slot and allocate PSRAM buffer, evicting LRU entries until malloc succeeds
+ * @brief Find eviction victim according to the active policy
  *
- * Combines slot reservation and PSRAM allocation in a single eviction loop.
- * This handles heap fragmentation: even if used_cache_bytes says there's enough
- * room, the actual malloc may fail due to non-contiguous free blocks. By evicting
- * one entry at a time and retrying malloc, we consolidate free memory.
+ * Entries in use and entries pinned for the current page are never chosen;
+ * entries pinned for an adjacent page only when nothing else is evictable.
  *
- * Caller must hold NO mutex. This function acquires cache_mutex internally.
+ * Caller must hold cache_mutex.
+ *
+ * @return Index of the victim, or -1 if no entry is evictable
  */
-static esp_err_t cache_reserve_and_alloc(audio_provider_state_t *provider, size_t total_bytes,
-                                          int *out_slot, int16_t **out_buffer)
+static int cache_find_victim(audio_provider_state_t *provider)
 {
-    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    int victim_idx = -1;
+    audio_cache_pin_t victim_pin = AUDIO_CACHE_PIN_CURRENT;
+    uint32_t victim_rank = UINT32_MAX;
 
-    int slot = -1;
-    int16_t *buffer = NULL;
+    for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
+        cache_entry_t *entry = &provider->cache[i];
 
-    while (true) {
-        // Find an empty slot
-        if (slot < 0) {
-            for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
-                if (provider->cache[i].filename == NULL) {
-                    slot = i;
-                    break;
-                }
-            }
-        }
+        // Skip empty slots
+        if (entry->filename == NULL) continue;
 
-        // Check memory budget first
-        if (slot >= 0 && provider->used_cache_bytes + total_bytes <= provider->max_cache_bytes) {
-            // Budget OK — try actual allocation (may fail due to fragmentation)
-            buffer = heap_caps_malloc(total_bytes, MALLOC_CAP_SPIRAM);
-            if (buffer != NULL) {
-                break;  // Success: have slot, budget, and buffer
-            }
-            ESP_LOGD(TAG_CACHE, "PSRAM fragmented, evicting to defragment (%zu KB requested)", total_bytes / 1024);
-        }
+        // Skip entries currently in use
+        if (cache_entry_in_use(entry)) continue;
 
-        // Need to evict: no slot, budget exceeded, or malloc failed despite budget
-        int victim = cache_find_lru_victim(provider);
-        if (victim < 0) {
-            xSemaphoreGive(provider->cache_mutex);
-            ESP_LOGW(TAG_CACHE, "Cannot allocate %zu KB: no evictable entries", total_bytes / 1024);
-            return ESP_ERR_NO_MEM;
-        }
-        ESP_LOGI(TAG_CACHE, "Evicting LRU entry: %s (%zu KB)",
-                 provider->cache[victim].filename, provider->cache[victim].buf_size / 1024);
-        free_cache_entry(provider, &provider->cache[victim]);
+        audio_cache_pin_t pin = cache_entry_pin(provider, entry);
+        if (pin == AUDIO_CACHE_PIN_CURRENT) continue;
 
-        if (slot < 0) {
-            slot = victim;
+        uint32_t rank = provider->policy->rank(provider, entry);
+        if (victim_idx < 0 || pin < victim_pin || (pin == victim_pin && rank < victim_rank)) {
+            victim_idx = i;
+            victim_pin = pin;
+            victim_rank = rank;
         }
     }
 
-    // Reserve memory budget
-    provider->used_cache_bytes += total_bytes;
+    return victim_idx;
+}
 
+/**
+ * @brief Update the measured load cost model (preload task)
+ */
+static void cache_record_load_cost(audio_provider_state_t *provider, int64_t open_us,
+                                   int64_t read_us, size_t bytes)
+{
+    uint32_t per_kb = (uint32_t)(read_us * 1024 / (int64_t)(bytes + 1));
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    provider->load_open_us += ((int32_t)open_us - (int32_t)provider->load_open_us) >> LOAD_COST_EWMA_SHIFT;
+    provider->load_us_per_kb += ((int32_t)per_kb - (int32_t)provider->load_us_per_kb) >> LOAD_COST_EWMA_SHIFT;
     xSemaphoreGive(provider->cache_mutex);
-
-    *out_slot = slot;
-    *out_buffer = buffer;
-    return ESP_OK;
 }
 
+// ============================================================================
+// Cache Arena
+// ============================================================================
+
 /**
- * @brief Read PCM data from file into a pre-allocated buffer
+ * @brief Lowest-offset arena region at or after offset
  *
- * Pause-aware: blocks during active playback to yield SD bandwidth.
+ * Caller must hold cache_mutex.
+ *
+ * @return Entry owning the region, or NULL if none
  */
-static esp_err_t cache_read_pcm_data(audio_provider_state_t *provider, const char *filename,
-                                      uint32_t data_offset, size_t total_bytes, int16_t *buffer)
+static cache_entry_t *arena_next_region(audio_provider_state_t *provider, size_t offset)
 {
-    FILE *fp = fopen(filename, "rb");
-    if (!fp) {
-        ESP_LOGE(TAG_CACHE, "Failed to reopen file: %s", filename);
-        return ESP_ERR_NOT_FOUND;
+    cache_entry_t *next = NULL;
+    for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
+        cache_entry_t *entry = &provider->cache[i];
+        if (entry->arena_bytes > 0 && entry->arena_offset >= offset &&
+            (next == NULL || entry->arena_offset < next->arena_offset)) {
+            next = entry;
+        }
     }
+    return next;
+}
 
-    fseek(fp, data_offset, SEEK_SET);
-    size_t total_read = 0;
-    while (total_read < total_bytes) {
-        // Block if playback is active (yield SD card bandwidth to player task)
-        while (provider->active_stream_count > 0) {
-            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        }
+/**
+ * @brief Find a hole of at least bytes (first fit), or the largest hole
+ *
+ * Caller must hold cache_mutex.
+ *
+ * @param bytes Requested size (0: only compute largest hole)
+ * @param[out] largest Largest hole in the arena (can be NULL)
+ * @return Offset of the first hole that fits, or SIZE_MAX
+ */
+static size_t arena_find_hole(audio_provider_state_t *provider, size_t bytes, size_t *largest)
+{
+    size_t found = SIZE_MAX;
+    size_t max_hole = 0;
+    size_t cursor = 0;
 
-        size_t to_read = total_bytes - total_read;
-        if (to_read > WAV_CHUNK_SIZE) {
-            to_read = WAV_CHUNK_SIZE;
+    while (true) {
+        cache_entry_t *next = arena_next_region(provider, cursor);
+        size_t end = next ? next->arena_offset : provider->max_cache_bytes;
+        size_t hole = end - cursor;
+        if (hole > max_hole) {
+            max_hole = hole;
         }
-
-#ifdef IO_STATS_ENABLE
-        int64_t t0 = benchmark_start();
-#endif
-        size_t n = fread((uint8_t*)buffer + total_read, 1, to_read, fp);
-#ifdef IO_STATS_ENABLE
-        benchmark_record(BENCH_CACHE_LOAD, t0, n);
-#endif
-        if (n == 0) {
+        if (found == SIZE_MAX && bytes > 0 && hole >= bytes) {
+            found = cursor;
+            if (largest == NULL) {
+                break;
+            }
+        }
+        if (next == NULL) {
             break;
         }
-        total_read += n;
+        cursor = next->arena_offset + next->arena_bytes;
     }
 
-    fclose(fp);
-#ifdef IO_STATS_ENABLE
-    // Log benchmark data
-    benchmark_log_and_reset(BENCH_CACHE_LOAD, filename);
-#endif
-
-    if (total_read != total_bytes) {
-        ESP_LOGE(TAG_CACHE, "Failed to read entire file: read %zu/%zu bytes", total_read, total_bytes);
-        return ESP_FAIL;
+    if (largest != NULL) {
+        *largest = max_hole;
     }
-
-    return ESP_OK;
+    return found;
 }
 
 /**
- * @brief Store entry metadata in a previously reserved cache slot
+ * @brief Slide unreferenced entries down to merge holes
  *
- * Acquires cache_mutex internally. Slot must already be reserved with budget accounted for.
+ * Entries with ref_count > 0 stay in place (streams read their buffer).
+ * cache_mutex is held on entry and exit but released around each memmove;
+ * a moving entry is skipped by open_stream(), and only the preload task
+ * allocates, frees or moves regions, so placement cannot change meanwhile.
+ *
+ * Caller must hold cache_mutex. Preload task only.
  */
-static void cache_store_entry(audio_provider_state_t *provider, int slot, const char *filename,
-                               const audio_info_t *info, int16_t *buffer, size_t total_bytes)
+static void arena_compact(audio_provider_state_t *provider)
 {
-    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    size_t cursor = 0;
+    size_t moved = 0;
+
+    cache_entry_t *entry;
+    while ((entry = arena_next_region(provider, cursor)) != NULL) {
+        if (entry->arena_offset == cursor) {
+            cursor += entry->arena_bytes;
+            continue;
+        }
 
-    cache_entry_t *entry = &provider->cache[slot];
-    entry->filename = strdup(filename);
-    entry->frame_count = info->total_frames;
-    memcpy(&entry->info, info, sizeof(audio_info_t));
-    entry->buf_size = total_bytes;
-    entry->total_samples = (size_t)info->total_frames * info->channels;
-    entry->buffer = buffer;
-    entry->ref_count = 0;
-    entry->last_access_tick = xTaskGetTickCount();
+        // Opens increment ref_count under cache_mutex (held here): no new
+        // reader can appear between this check and the move
+        bool pinned = cache_entry_in_use(entry);
+        entry->moving = !pinned;
+        if (pinned) {
+            cursor = entry->arena_offset + entry->arena_bytes;
+            continue;
+        }
 
-    ESP_LOGI(TAG_CACHE, "Cached file: %s (%zu KB, %u Hz, %u ch) - cache usage: %zu/%zu KB",
-             filename, total_bytes / 1024, info->frame_rate, info->channels,
-             provider->used_cache_bytes / 1024, provider->max_cache_bytes / 1024);
+        uint8_t *src = provider->arena + entry->arena_offset;
+        uint8_t *dst = provider->arena + cursor;
+        xSemaphoreGive(provider->cache_mutex);
+        memmove(dst, src, entry->buf_size);
+        xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
 
-    xSemaphoreGive(provider->cache_mutex);
+        entry->buffer = (int16_t *)dst;
+        entry->arena_offset = cursor;
+        entry->moving = false;
+        cursor += entry->arena_bytes;
+        moved += entry->arena_bytes;
+    }
+
+    provider->arena_compactions++;
+    provider->arena_moved_bytes += moved;
+    ESP_LOGI(TAG_CACHE, "Cache arena compacted: %zu KB moved", moved / 1024);
 }
 
 /**
- * @brief Cache a file into PSRAM
- *
- * Only called from preload task (single writer). Evicts LRU entries before
- * allocating the buffer to minimize peak PSRAM usage.
+ * @brief Free cache entry resources
+ */
+static void free_cache_entry(audio_provider_state_t *provider, cache_entry_t *entry)
+{
+    if (entry == NULL || entry->filename == NULL) {
+        return;
+    }
+
+    // Assert ref_count == 0 (defensive programming)
+    assert(!cache_entry_in_use(entry) && "Cannot free entry with active streams");
+
+    // Release arena region
+    entry->buffer = NULL;
+    provider->used_cache_bytes -= entry->arena_bytes;
+    entry->arena_bytes = 0;
+
+    if (entry->sound_id != AUDIO_SOUND_ID_NONE) {
+        provider->sound_cache_slot[entry->sound_id] = SOUND_SLOT_NONE;
+    }
+    entry->sound_id = AUDIO_SOUND_ID_NONE;
+
+    // Free filename
+    free(entry->filename);
+    entry->filename = NULL;
+
+    ESP_LOGD(TAG_CACHE, "Freed cache entry (used: %zu/%zu KB)",
+             provider->used_cache_bytes / 1024, provider->max_cache_bytes / 1024);
+}
+
+/**
+ * @brief Whether a file lives in the directory of the on-card index
+ *
+ * Caller must hold cache_mutex.
+ */
+static bool sound_indexable(const audio_provider_state_t *provider, const char *filename)
+{
+    return provider->index_path != NULL &&
+           strncmp(filename, provider->index_path, provider->index_root_len) == 0;
+}
+
+/**
+ * @brief Take the WAV layout of a sound from the on-card index
+ *
+ * Sounds the index does not list are left to index_update_next().
+ * Caller must hold cache_mutex.
+ */
+static void sound_meta_attach(audio_provider_state_t *provider, audio_sound_id_t sound_id)
+{
+    if (provider->sound_meta_state[sound_id] != SOUND_META_NONE ||
+        !sound_indexable(provider, provider->sound_names[sound_id])) {
+        return;
+    }
+    const sound_index_entry_t *entry = sound_index_find(&provider->index, provider->sound_names[sound_id]);
+    if (entry != NULL) {
+        provider->sound_meta[sound_id] = entry->meta;
+        provider->sound_meta_state[sound_id] = SOUND_META_INDEXED;
+    } else {
+        __atomic_store_n(&provider->index_scan, true, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Record the parsed WAV layout of a sound (any task)
+ */
+static void sound_meta_record(audio_provider_state_t *provider, audio_sound_id_t sound_id,
+                              const sound_index_meta_t *meta)
+{
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    provider->sound_meta[sound_id] = *meta;
+    provider->sound_meta_state[sound_id] = SOUND_META_DIRTY;
+    __atomic_store_n(&provider->index_scan, true, __ATOMIC_RELAXED);
+    xSemaphoreGive(provider->cache_mutex);
+}
+
+// ============================================================================
+// WAV Data Files
+// ============================================================================
+
+static inline bool wav_file_is_open(const wav_file_t *file)
+{
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+    if (file->direct != NULL) {
+        return true;
+    }
+#endif
+    return file->fp != NULL;
+}
+
+static size_t wav_file_read(wav_file_t *file, void *dst, size_t bytes)
+{
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+    if (file->direct != NULL) {
+        return sd_card_file_read(file->direct, dst, bytes);
+    }
+#endif
+    return fread(dst, 1, bytes, file->fp);
+}
+
+/**
+ * @brief codec_pcm_read() from a WAV file (only passthrough files are read directly)
+ */
+static size_t wav_file_read_frames(wav_file_t *file, codec_pcm_t *pcm, int16_t *dst, size_t frames,
+                                   void *scratch, size_t scratch_size)
+{
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+    if (file->direct != NULL) {
+        size_t frame_bytes = codec_pcm_frame_bytes(pcm);
+        return sd_card_file_read(file->direct, dst, frames * frame_bytes) / frame_bytes;
+    }
+#endif
+    return codec_pcm_read(pcm, file->fp, dst, frames, scratch, scratch_size);
+}
+
+static bool wav_file_seek(wav_file_t *file, uint32_t offset)
+{
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+    if (file->direct != NULL) {
+        return sd_card_file_seek(file->direct, offset) == ESP_OK;
+    }
+#endif
+    return fseek(file->fp, offset, SEEK_SET) == 0;
+}
+
+static bool wav_file_eof(const wav_file_t *file)
+{
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+    if (file->direct != NULL) {
+        return sd_card_file_eof(file->direct);
+    }
+#endif
+    return feof(file->fp);
+}
+
+static void wav_file_close(wav_file_t *file)
+{
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+    sd_card_file_close(file->direct);
+    file->direct = NULL;
+#endif
+    if (file->fp != NULL) {
+        fclose(file->fp);
+        file->fp = NULL;
+    }
+}
+
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+/**
+ * @brief true if the samples of a file are read as is (16-bit, not downmixed)
+ */
+static bool wav_file_passthrough(const audio_provider_state_t *provider, const audio_info_t *info)
+{
+    codec_pcm_t pcm;
+    codec_pcm_init(&pcm, info, provider->downmix);
+    return codec_pcm_passthrough(&pcm);
+}
+
+/**
+ * @brief Open the SD card reader of a passthrough file at offset
+ *
+ * @return ESP_OK, ESP_ERR_NOT_FOUND, or another error to fall back to stdio
+ *         (not on the SD card, no internal RAM for the buffer, file shorter than offset)
+ */
+static esp_err_t wav_file_open_direct(const char *filename, uint32_t offset, sd_card_file_t **out_direct)
+{
+    sd_card_file_t *direct;
+    esp_err_t ret = sd_card_file_open(filename, &direct);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = sd_card_file_seek(direct, offset);
+    if (ret != ESP_OK) {
+        sd_card_file_close(direct);
+        return ret;
+    }
+    *out_direct = direct;
+    return ESP_OK;
+}
+#endif
+
+/**
+ * @brief Reopen a WAV file of known layout at a position of its PCM data
+ *
+ * @param pcm Conversion of the file (passthrough files are read directly from the SD card)
+ * @param offset File offset to read from
+ * @return ESP_OK, ESP_ERR_NOT_FOUND, ESP_FAIL if the offset cannot be reached
+ */
+static esp_err_t wav_file_reopen(const codec_pcm_t *pcm, const char *filename, uint32_t offset,
+                                 wav_file_t *file)
+{
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+    if (codec_pcm_passthrough(pcm)) {
+        esp_err_t ret = wav_file_open_direct(filename, offset, &file->direct);
+        if (ret == ESP_OK || ret == ESP_ERR_NOT_FOUND) {
+            return ret;
+        }
+    }
+#else
+    (void)pcm;
+#endif
+    file->fp = fopen(filename, "rb");
+    if (file->fp == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (fseek(file->fp, offset, SEEK_SET) != 0) {
+        wav_file_close(file);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Open a WAV file positioned at its PCM data
+ *
+ * With a known layout this is one fopen() + fseek(). The file size (fstat(),
+ * answered from the open file) guards against a stale layout, which falls
+ * back to parsing the header; a parsed layout is recorded for the index.
+ * 16-bit files on the SD card are opened for direct reads instead (their
+ * size comes from the FatFS file object, no stdio stream at all when the
+ * layout is known).
+ *
+ * @param sound_id Sound ID of filename, or AUDIO_SOUND_ID_NONE (layout neither used nor recorded)
+ * @param[out] meta Layout of the file
+ * @param[out] out_file File positioned at meta->data_offset (on success, caller closes it)
+ */
+static esp_err_t wav_open_data(audio_provider_state_t *provider, const char *filename,
+                               audio_sound_id_t sound_id, sound_index_meta_t *meta, wav_file_t *out_file)
+{
+    bool known = false;
+    if (sound_id != AUDIO_SOUND_ID_NONE) {
+        xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+        uint8_t state = provider->sound_meta_state[sound_id];
+        known = (state == SOUND_META_INDEXED || state == SOUND_META_DIRTY);
+        if (known) {
+            *meta = provider->sound_meta[sound_id];
+        }
+        xSemaphoreGive(provider->cache_mutex);
+    }
+    *out_file = (wav_file_t){ 0 };
+
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+    if (known && wav_file_passthrough(provider, &meta->info)) {
+        sd_card_file_t *direct = NULL;
+        esp_err_t ret = wav_file_open_direct(filename, meta->data_offset, &direct);
+        if (ret == ESP_ERR_NOT_FOUND) {
+            return ret;
+        }
+        if (ret == ESP_OK && sd_card_file_size(direct) == meta->file_size) {
+            __atomic_add_fetch(&provider->index_opens, 1, __ATOMIC_RELAXED);
+            out_file->direct = direct;
+            return ESP_OK;
+        }
+        sd_card_file_close(direct);     // Stale layout (reported below) or stdio fallback
+    }
+#endif
+
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    struct stat st;
+    uint32_t file_size = (fstat(fileno(fp), &st) == 0) ? (uint32_t)st.st_size : 0;
+
+    if (known && meta->file_size == file_size) {
+        fseek(fp, meta->data_offset, SEEK_SET);
+        __atomic_add_fetch(&provider->index_opens, 1, __ATOMIC_RELAXED);
+        out_file->fp = fp;
+        return ESP_OK;
+    }
+    if (known) {
+        ESP_LOGW(TAG_CACHE, "Stale WAV layout (size %lu, indexed %lu): %s",
+                 (unsigned long)file_size, (unsigned long)meta->file_size, filename);
+        __atomic_add_fetch(&provider->index_stale, 1, __ATOMIC_RELAXED);
+    }
+
+    // parse_wav_header() stops at the start of the data chunk
+    esp_err_t ret = parse_wav_header(fp, &meta->info, &meta->data_offset, &meta->data_size);
+    __atomic_add_fetch(&provider->header_parses, 1, __ATOMIC_RELAXED);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_CACHE, "Failed to parse WAV header: %s", filename);
+        fclose(fp);
+        return ret;
+    }
+    meta->file_size = file_size;
+    if (sound_id != AUDIO_SOUND_ID_NONE) {
+        sound_meta_record(provider, sound_id, meta);
+    }
+
+#ifdef SD_CARD_DIRECT_READ_ENABLE
+    // Layout just parsed: reopen for direct reads (once, later opens use the index)
+    if (wav_file_passthrough(provider, &meta->info) &&
+        wav_file_open_direct(filename, meta->data_offset, &out_file->direct) == ESP_OK) {
+        fclose(fp);
+        return ESP_OK;
+    }
+#endif
+    out_file->fp = fp;
+    return ESP_OK;
+}
+
+static void cache_eviction_log(cache_eviction_log_t *log)
+{
+    if (log->count > 0) {
+        ESP_LOGI(TAG_CACHE, "Evicted %d %s entr%s (%s): %s%s (%zu KB)", log->count, log->policy,
+                 log->count == 1 ? "y" : "ies", evict_reason_names[log->reason],
+                 log->count > 1 ? "last " : "", log->last_name, log->bytes / 1024);
+    }
+    free(log->last_name);
+    log->last_name = NULL;
+}
+
+/**
+ * @brief Reserve a cache slot and an arena region
+ *
+ * First fit in the arena. When the free space would fit but is split into
+ * holes, compacts once before evicting; evicts LRU entries one at a time
+ * only when the budget (or a hole next to pinned entries) is missing.
+ *
+ * Caller must hold NO mutex. This function acquires cache_mutex internally.
+ */
+static esp_err_t cache_reserve_and_alloc(audio_provider_state_t *provider, size_t total_bytes,
+                                          int *out_slot, int16_t **out_buffer)
+{
+    size_t region = (total_bytes + CACHE_ARENA_ALIGN - 1) & ~(size_t)(CACHE_ARENA_ALIGN - 1);
+    if (region > provider->max_cache_bytes) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+
+    int slot = -1;
+    size_t offset = SIZE_MAX;
+    bool compacted = false;
+
+    // Evictions are logged once the mutex is released (taken by every cache-hit open)
+    cache_eviction_log_t evicted = { 0 };
+
+    while (true) {
+        // Find an empty slot (not filled and not reserved)
+        if (slot < 0) {
+            for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
+                if (provider->cache[i].filename == NULL && provider->cache[i].arena_bytes == 0) {
+                    slot = i;
+                    break;
+                }
+            }
+        }
+
+        if (slot >= 0 && provider->used_cache_bytes + region <= provider->max_cache_bytes) {
+            offset = arena_find_hole(provider, region, NULL);
+            if (offset != SIZE_MAX) {
+                break;  // Success: have slot, budget, and region
+            }
+            if (!compacted) {
+                // Enough free bytes, not contiguous: move entries instead of evicting
+                ESP_LOGD(TAG_CACHE, "Cache arena fragmented, compacting (%zu KB requested)", total_bytes / 1024);
+                arena_compact(provider);
+                compacted = true;
+                continue;
+            }
+        }
+
+        // Need to evict: no slot, budget exceeded, or no hole despite compaction (pinned entries)
+        evict_reason_t reason = (slot < 0) ? EVICT_REASON_SLOTS
+                              : (provider->used_cache_bytes + region > provider->max_cache_bytes) ? EVICT_REASON_BUDGET
+                              : EVICT_REASON_FRAGMENTED;
+        int victim = cache_find_victim(provider);
+        if (victim < 0) {
+            xSemaphoreGive(provider->cache_mutex);
+            cache_eviction_log(&evicted);
+            ESP_LOGW(TAG_CACHE, "Cannot allocate %zu KB: no evictable entries", total_bytes / 1024);
+            return ESP_ERR_NO_MEM;
+        }
+        cache_entry_t *victim_entry = &provider->cache[victim];
+        provider->evictions[reason]++;
+#ifdef TRACE_ENABLE
+        trace_event(TRACE_EVICT, victim_entry->sound_id, (uint32_t)(victim_entry->buf_size / 1024));
+#endif
+        if (cache_entry_pin(provider, victim_entry) == AUDIO_CACHE_PIN_NEIGHBOUR) {
+            provider->neighbour_evictions++;
+        }
+        if (victim_entry->sound_id != AUDIO_SOUND_ID_NONE) {
+            provider->sound_evicted[victim_entry->sound_id] = true;
+        }
+        if (provider->policy->on_evict) {
+            provider->policy->on_evict(provider, victim_entry);
+        }
+
+        // The log keeps the name of the last victim instead of it being freed
+        evicted.count++;
+        evicted.bytes += victim_entry->buf_size;
+        evicted.policy = provider->policy->name;
+        evicted.reason = reason;
+        free(evicted.last_name);
+        evicted.last_name = victim_entry->filename;
+        victim_entry->filename = NULL;
+        free_cache_entry(provider, victim_entry);
+        compacted = false;
+
+        if (slot < 0) {
+            slot = victim;
+        }
+    }
+
+    // Reserve the region (slot stays unfilled until cache_store_entry())
+    cache_entry_t *entry = &provider->cache[slot];
+    entry->arena_offset = offset;
+    entry->arena_bytes = region;
+    provider->used_cache_bytes += region;
+
+    xSemaphoreGive(provider->cache_mutex);
+    cache_eviction_log(&evicted);
+
+    *out_slot = slot;
+    *out_buffer = (int16_t *)(provider->arena + offset);
+    return ESP_OK;
+}
+
+/**
+ * @brief Block the preload task while streams are open
+ *
+ * Yields SD bandwidth to the player; woken by the last stream close.
+ */
+static inline void preload_wait_streams_idle(audio_provider_state_t *provider)
+{
+    while (provider->active_stream_count > 0) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief Share the SD card with open file streams before a preload read
+ *
+ * With preload_share == 0, blocks while streams are open. Otherwise sleeps
+ * off the time owed by the previous reads (preload_charge()), so the
+ * streamer task gets the card for the rest of the time.
+ */
+static void preload_throttle(audio_provider_state_t *provider)
+{
+    if (provider->active_stream_count == 0) {
+        provider->throttle_debt_us = 0;
+        return;
+    }
+
+    const int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+    int64_t t_start = esp_timer_get_time();
+    if (provider->preload_share == 0) {
+        preload_wait_streams_idle(provider);
+    } else if (provider->throttle_debt_us >= tick_us) {
+        vTaskDelay((TickType_t)(provider->throttle_debt_us / tick_us));
+        provider->throttle_debt_us = 0;
+    } else {
+        return;
+    }
+    provider->preload_throttle_us += (uint64_t)(esp_timer_get_time() - t_start);
+}
+
+/**
+ * @brief Charge a preload read to the streaming share (see preload_throttle())
+ */
+static void preload_charge(audio_provider_state_t *provider, int64_t read_us)
+{
+    if (provider->preload_share == 0 || provider->active_stream_count == 0) {
+        return;
+    }
+    provider->throttle_debt_us += read_us * (100 - provider->preload_share) / provider->preload_share;
+    if (provider->throttle_debt_us > PRELOAD_THROTTLE_MAX_US) {
+        provider->throttle_debt_us = PRELOAD_THROTTLE_MAX_US;
+    }
+}
+
+/**
+ * @brief Whether the user left the page of the load in flight
+ *
+ * Only after a flush (page change), and only when the sound is no longer
+ * pinned for the current or an adjacent page: the mapper re-pins before it
+ * flushes. Unresolved files and attack-segment loads are never cancelled.
+ */
+static bool preload_cancelled(audio_provider_state_t *provider, audio_sound_id_t sound_id)
+{
+    if (sound_id == AUDIO_SOUND_ID_NONE ||
+        provider->inflight_generation == __atomic_load_n(&provider->preload_generation, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    bool left = (provider->sound_pin[sound_id] == AUDIO_CACHE_PIN_NONE);
+    xSemaphoreGive(provider->cache_mutex);
+    return left;
+}
+
+/**
+ * @brief Read 16-bit PCM data from file into a pre-allocated buffer (no conversion)
+ *
+ * Shares the SD card with open file streams (preload_throttle()) and stops
+ * early when the load is cancelled.
+ *
+ * @param file WAV file positioned at its PCM data (wav_open_data(), left open)
+ * @param sound_id Sound being loaded, AUDIO_SOUND_ID_NONE if it cannot be cancelled
+ * @param[out] read_us Time spent in file reads only, pauses excluded (can be NULL)
+ * @return ESP_OK, ESP_ERR_NOT_FINISHED if cancelled (preload_cancelled()), or a read error
+ */
+static esp_err_t cache_read_pcm_data(audio_provider_state_t *provider, wav_file_t *file, const char *filename,
+                                      audio_sound_id_t sound_id, size_t total_bytes, int16_t *buffer,
+                                      int64_t *read_us)
+{
+    int64_t busy_us = 0;
+    size_t total_read = 0;
+    bool cancelled = false;
+    while (total_read < total_bytes) {
+        // Yield SD card bandwidth to the streamed voices
+        preload_throttle(provider);
+        if (preload_cancelled(provider, sound_id)) {
+            cancelled = true;
+            break;
+        }
+
+        size_t to_read = total_bytes - total_read;
+        if (to_read > WAV_CHUNK_SIZE) {
+            to_read = WAV_CHUNK_SIZE;
+        }
+
+        int64_t t_read = esp_timer_get_time();
+#ifdef IO_STATS_ENABLE
+        int64_t t0 = benchmark_start();
+#endif
+        size_t n = wav_file_read(file, (uint8_t*)buffer + total_read, to_read);
+#ifdef IO_STATS_ENABLE
+        benchmark_record(BENCH_CACHE_LOAD, t0, n);
+#endif
+        int64_t chunk_us = esp_timer_get_time() - t_read;
+        busy_us += chunk_us;
+        preload_charge(provider, chunk_us);
+        if (n == 0) {
+            break;
+        }
+        total_read += n;
+    }
+
+#ifdef IO_STATS_ENABLE
+    // Log benchmark data
+    benchmark_log_and_reset(BENCH_CACHE_LOAD, filename);
+#endif
+
+    if (cancelled) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    if (total_read != total_bytes) {
+        ESP_LOGE(TAG_CACHE, "Failed to read entire file: read %zu/%zu bytes", total_read, total_bytes);
+        return ESP_FAIL;
+    }
+
+    if (read_us != NULL) {
+        *read_us = busy_us;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Read PCM data from file, convert, resample and/or encode it into a pre-allocated buffer
+ *
+ * Same sharing and cancellation as cache_read_pcm_data(). The PCM goes through an
+ * internal RAM staging buffer, one encoder chunk (ADPCM block) at a time;
+ * 24/32-bit and downmixed files are converted to 16-bit PCM on the way in
+ * (codec_pcm_read()), and when the source rate differs from dst_info, the
+ * PCM is resampled.
+ *
+ * @param file WAV file positioned at its PCM data (wav_open_data(), left open)
+ * @param pcm Conversion of the file to 16-bit PCM
+ * @param src_info Format of the file after conversion (source rate)
+ * @param dst_info Format of the cache entry (output rate and length)
+ * @param[out] read_us Time spent in file reads only, pauses excluded (can be NULL)
+ */
+static esp_err_t cache_read_converted_data(audio_provider_state_t *provider, wav_file_t *file, const char *filename,
+                                            audio_sound_id_t sound_id, codec_pcm_t *pcm,
+                                            const audio_info_t *src_info, const audio_info_t *dst_info,
+                                            audio_cache_format_t format, uint8_t *buffer, int64_t *read_us)
+{
+    uint16_t ch = src_info->channels;
+    size_t frame_bytes = (size_t)ch * sizeof(int16_t);
+    size_t file_frame_bytes = codec_pcm_frame_bytes(pcm);
+    codec_state_t encoder;
+    codec_state_init(&encoder, format, ch);
+    size_t chunk_frames = codec_encode_chunk_frames(&encoder, WAV_CHUNK_SIZE / frame_bytes);
+    if (chunk_frames == 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    resampler_t *resampler = NULL;
+    if (dst_info->frame_rate != src_info->frame_rate) {
+        esp_err_t ret = resampler_create(provider->resampler_kernel, src_info->frame_rate,
+                                         dst_info->frame_rate, ch, &resampler);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    int16_t *staging = heap_caps_malloc(chunk_frames * frame_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    uint8_t *scratch = codec_pcm_passthrough(pcm)
+                           ? NULL
+                           : heap_caps_aligned_alloc(CODEC_PCM_SCRATCH_ALIGN, WAV_CHUNK_SIZE,
+                                                     MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!staging || (!scratch && !codec_pcm_passthrough(pcm))) {
+        heap_caps_free(staging);
+        heap_caps_free(scratch);
+        resampler_destroy(resampler);
+        return ESP_ERR_NO_MEM;
+    }
+
+    int64_t busy_us = 0;
+    bool read_error = false;
+    bool cancelled = false;
+    size_t src_left = src_info->total_frames;
+    size_t done = 0;
+    size_t out = 0;
+    while (done < dst_info->total_frames && !read_error) {
+        size_t frames = dst_info->total_frames - done;
+        if (frames > chunk_frames) {
+            frames = chunk_frames;
+        }
+
+        // Fill staging with `frames` frames at the cache rate
+        size_t staged = 0;
+        while (staged < frames) {
+            if (resampler != NULL) {
+#ifdef IO_STATS_ENABLE
+                int64_t t_conv = benchmark_start();
+#endif
+                size_t got = resampler_output(resampler, staging + staged * ch, frames - staged);
+#ifdef IO_STATS_ENABLE
+                benchmark_record(BENCH_RESAMPLE_LOAD, t_conv, got * frame_bytes);
+#endif
+                staged += got;
+                if (staged == frames) {
+                    break;
+                }
+            }
+
+            size_t space = frames - staged;
+            int16_t *dst = staging + staged * ch;
+            if (resampler != NULL) {
+                dst = resampler_input(resampler, &space);
+                if (src_left == 0) {
+                    resampler_finish(resampler);
+                    continue;
+                }
+            }
+            size_t n = (space < src_left) ? space : src_left;
+
+            preload_throttle(provider);
+            if (preload_cancelled(provider, sound_id)) {
+                cancelled = read_error = true;
+                break;
+            }
+            int64_t t_read = esp_timer_get_time();
+#ifdef IO_STATS_ENABLE
+            int64_t t0 = benchmark_start();
+#endif
+            size_t got = wav_file_read_frames(file, pcm, dst, n, scratch, WAV_CHUNK_SIZE);
+#ifdef IO_STATS_ENABLE
+            benchmark_record(BENCH_CACHE_LOAD, t0, got * file_frame_bytes);
+#endif
+            int64_t chunk_us = esp_timer_get_time() - t_read;
+            busy_us += chunk_us;
+            preload_charge(provider, chunk_us);
+            if (got != n) {
+                read_error = true;
+                break;
+            }
+            src_left -= n;
+            if (resampler != NULL) {
+                resampler_commit(resampler, n);
+            } else {
+                staged += n;
+            }
+        }
+        if (read_error) {
+            break;
+        }
+
+        out += codec_encode(&encoder, buffer + out, staging, frames);
+        done += frames;
+    }
+
+    heap_caps_free(staging);
+    heap_caps_free(scratch);
+    resampler_destroy(resampler);
+#ifdef IO_STATS_ENABLE
+    benchmark_log_and_reset(BENCH_CACHE_LOAD, filename);
+    benchmark_log_and_reset(BENCH_RESAMPLE_LOAD, filename);
+#endif
+
+    if (cancelled) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    if (done != dst_info->total_frames) {
+        ESP_LOGE(TAG_CACHE, "Failed to read entire file: read %zu/%lu frames",
+                 done, (unsigned long)dst_info->total_frames);
+        return ESP_FAIL;
+    }
+
+    if (read_us != NULL) {
+        *read_us = busy_us;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Format of a file once converted to the output rate (unchanged at native rates)
+ */
+static void cache_output_info(const audio_provider_state_t *provider, const audio_info_t *src,
+                              audio_info_t *dst)
+{
+    *dst = *src;
+    if (provider->output_rate != 0 && src->frame_rate != provider->output_rate) {
+        dst->frame_rate = provider->output_rate;
+        dst->total_frames = resampler_output_frames(src->total_frames, src->frame_rate, provider->output_rate);
+    }
+}
+
+/**
+ * @brief Set up the conversion of a file to the 16-bit PCM handed out
+ *
+ * @param src Format of the file (WAV header)
+ * @param[out] out Format after conversion (same rate and length)
+ */
+static void provider_pcm_init(audio_provider_state_t *provider, const audio_info_t *src,
+                              codec_pcm_t *pcm, audio_info_t *out)
+{
+    codec_pcm_init(pcm, src, provider->downmix);
+    codec_pcm_output_info(pcm, src, out);
+    if (pcm->out_channels != pcm->channels) {
+        __atomic_add_fetch(&provider->downmixed_files, 1, __ATOMIC_RELAXED);
+    }
+    if (pcm->sample_bytes != sizeof(int16_t)) {
+        __atomic_add_fetch(&provider->narrowed_files, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Cache format for a file: the configured one, or PCM16 if it cannot hold it
+ */
+static audio_cache_format_t cache_entry_format(const audio_provider_state_t *provider,
+                                               const audio_info_t *info)
+{
+    return codec_supports(provider->cache_format, info->channels) ? provider->cache_format
+                                                                  : AUDIO_CACHE_FORMAT_PCM16;
+}
+
+/**
+ * @brief Give back the arena region of a slot reserved but never stored
+ *
+ * Acquires cache_mutex internally.
+ */
+static void cache_unreserve(audio_provider_state_t *provider, int slot)
+{
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    provider->used_cache_bytes -= provider->cache[slot].arena_bytes;
+    provider->cache[slot].arena_bytes = 0;
+    xSemaphoreGive(provider->cache_mutex);
+}
+
+/**
+ * @brief Store entry metadata in a previously reserved cache slot
+ *
+ * Acquires cache_mutex internally. Slot must already be reserved with budget accounted for.
+ */
+static void cache_store_entry(audio_provider_state_t *provider, int slot, const char *filename,
+                               const audio_info_t *info, audio_cache_format_t format,
+                               int16_t *buffer, size_t total_bytes)
+{
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+
+    cache_entry_t *entry = &provider->cache[slot];
+    entry->filename = strdup(filename);
+    entry->frame_count = info->total_frames;
+    memcpy(&entry->info, info, sizeof(audio_info_t));
+    entry->format = format;
+    entry->buf_size = total_bytes;
+    entry->total_samples = (size_t)info->total_frames * info->channels;
+    entry->buffer = buffer;
+    entry->ref_count = 0;
+    entry->sound_id = sound_lookup(provider, filename);
+    if (entry->sound_id != AUDIO_SOUND_ID_NONE) {
+        provider->sound_cache_slot[entry->sound_id] = (int16_t)slot;
+        provider->sound_evicted[entry->sound_id] = false;
+    }
+    cache_touch(provider, entry);
+    if (provider->warmup_start_us != 0) {
+        provider->warmup_files++;
+        provider->warmup_bytes += total_bytes;
+    }
+    provider->preload_files++;
+    provider->preload_bytes += total_bytes;
+    if (provider->inflight_prefetch) {
+        provider->prefetch_files++;
+        provider->prefetch_bytes += total_bytes;
+    }
+    size_t used_bytes = provider->used_cache_bytes;
+
+    // Logged after the release: the player takes the mutex on every cache-hit open
+    xSemaphoreGive(provider->cache_mutex);
+
+    ESP_LOGI(TAG_CACHE, "Cached file: %s (%zu KB %s, %u Hz, %u ch) - cache usage: %zu/%zu KB",
+             filename, total_bytes / 1024, codec_format_name(format), info->frame_rate, info->channels,
+             used_bytes / 1024, provider->max_cache_bytes / 1024);
+}
+
+/**
+ * @brief Cache a file into PSRAM
+ *
+ * Only called from preload task (single writer). Evicts LRU entries before
+ * allocating the buffer to minimize peak PSRAM usage.
+ *
+ * @param[out] sound_id_out Sound ID of the file (looked up under cache_mutex), also set on error
+ * @return ESP_OK (also if already cached), ESP_ERR_NOT_FINISHED if cancelled, or an error
+ */
+static esp_err_t cache_file_internal(audio_provider_state_t *provider, const char *filename,
+                                     audio_sound_id_t *sound_id_out)
+{
+    *sound_id_out = AUDIO_SOUND_ID_NONE;
+    if (!provider || !filename) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Check if already cached
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    audio_sound_id_t sound_id = sound_lookup(provider, filename);
+    *sound_id_out = sound_id;
+    if (cache_lookup(provider, filename) != NULL) {
+        ESP_LOGD(TAG_CACHE, "File already cached: %s", filename);
+        xSemaphoreGive(provider->cache_mutex);
+        return ESP_OK;
+    }
+    xSemaphoreGive(provider->cache_mutex);
+
+    // Open at the PCM data (header parsed only if the layout is not indexed)
+    sound_index_meta_t meta;
+    wav_file_t file;
+    int64_t t_open = esp_timer_get_time();
+    esp_err_t ret = wav_open_data(provider, filename, sound_id, &meta, &file);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_CACHE, "Failed to open file: %s", filename);
+        return ret;
+    }
+    int64_t open_us = esp_timer_get_time() - t_open;
+
+    // Entries are stored as 16-bit PCM (downmixed) at the output rate: cached playback never converts
+    codec_pcm_t pcm;
+    audio_info_t info;
+    provider_pcm_init(provider, &meta.info, &pcm, &info);
+    size_t total_bytes = (size_t)info.total_frames * info.channels * sizeof(int16_t);
+    audio_info_t cache_info;
+    cache_output_info(provider, &info, &cache_info);
+    bool resample = (cache_info.frame_rate != info.frame_rate);
+    audio_cache_format_t format = cache_entry_format(provider, &cache_info);
+    size_t cache_bytes = codec_encoded_size(format, cache_info.total_frames, cache_info.channels);
+
+    // Reject files too large to cache (avoids excessive eviction and fragmentation)
+    if (cache_bytes > CACHE_ITEM_MAXSIZE) {
+        ESP_LOGW(TAG_CACHE, "File too large to cache: %s (%zu KB, max %zu KB)",
+                 filename, cache_bytes / 1024, (size_t)CACHE_ITEM_MAXSIZE / 1024);
+        wav_file_close(&file);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Reserve slot + arena region (compacts, then evicts per policy if needed)
+    int slot;
+    int16_t *buffer;
+    ret = cache_reserve_and_alloc(provider, cache_bytes, &slot, &buffer);
+    if (ret != ESP_OK) {
+        wav_file_close(&file);
+        return ret;
+    }
+
+    // Read (resample, encode) PCM data into allocated buffer (no mutex — slow I/O)
+    int64_t read_us = 0;
+    if (format == AUDIO_CACHE_FORMAT_PCM16 && !resample && codec_pcm_passthrough(&pcm)) {
+        ret = cache_read_pcm_data(provider, &file, filename, sound_id, total_bytes, buffer, &read_us);
+    } else {
+        ret = cache_read_converted_data(provider, &file, filename, sound_id, &pcm, &info, &cache_info,
+                                        format, (uint8_t *)buffer, &read_us);
+    }
+    wav_file_close(&file);
+    if (ret != ESP_OK) {
+        cache_unreserve(provider, slot);
+        return ret;
+    }
+
+    // Measured reload cost feeds the cost-aware policy, then store entry in reserved slot
+    cache_record_load_cost(provider, open_us, read_us, total_bytes);
+    if (resample) {
+        xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+        provider->resampled_loads++;
+        xSemaphoreGive(provider->cache_mutex);
+    }
+    cache_store_entry(provider, slot, filename, &cache_info, format, buffer, cache_bytes);
+    return ESP_OK;
+}
+
+/**
+ * @brief Read one bank PCM span into a reserved cache buffer
+ *
+ * Large unbuffered reads (sector-aligned start); while file streams are open,
+ * WAV_CHUNK_SIZE reads shared with them (preload_throttle()).
+ *
+ * @return ESP_OK, ESP_ERR_NOT_FINISHED if cancelled, or ESP_FAIL
+ */
+static esp_err_t bank_read_span(audio_provider_state_t *provider, FILE *fp, audio_sound_id_t sound_id,
+                                int16_t *buffer, size_t total_bytes)
+{
+    size_t total_read = 0;
+    while (total_read < total_bytes) {
+        preload_throttle(provider);
+        if (preload_cancelled(provider, sound_id)) {
+            return ESP_ERR_NOT_FINISHED;
+        }
+
+        size_t to_read = total_bytes - total_read;
+        size_t chunk = (provider->active_stream_count > 0) ? WAV_CHUNK_SIZE : BANK_READ_CHUNK;
+        if (to_read > chunk) {
+            to_read = chunk;
+        }
+        int64_t t_read = esp_timer_get_time();
+#ifdef IO_STATS_ENABLE
+        int64_t t0 = benchmark_start();
+#endif
+        size_t n = fread((uint8_t *)buffer + total_read, 1, to_read, fp);
+#ifdef IO_STATS_ENABLE
+        benchmark_record(BENCH_CACHE_LOAD, t0, n);
+#endif
+        preload_charge(provider, esp_timer_get_time() - t_read);
+        if (n == 0) {
+            return ESP_FAIL;
+        }
+        total_read += n;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Cache every usable entry of a sound bank
+ *
+ * Only called from preload task. One read for the header and index, then
+ * one sequential pass over the PCM spans (forward seeks over skipped
+ * entries). Stops at the first entry that does not fit: the per-file
+ * preloads queued after the bank apply the same limit.
+ */
+static esp_err_t cache_load_bank(audio_provider_state_t *provider, const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        ESP_LOGD(TAG_CACHE, "No sound bank: %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    // Unbuffered: spans go from FATFS straight into the arena
+    setvbuf(fp, NULL, _IONBF, 0);
+
+    int64_t t_start = esp_timer_get_time();
+    sound_bank_header_t header;
+    if (fread(&header, 1, sizeof(header), fp) != sizeof(header) ||
+        header.magic != SOUND_BANK_MAGIC || header.version != SOUND_BANK_VERSION ||
+        header.entry_size != sizeof(sound_bank_entry_t) ||
+        header.entry_count == 0 || header.entry_count > SOUND_BANK_MAX_ENTRIES) {
+        ESP_LOGW(TAG_CACHE, "Invalid sound bank header: %s", path);
+        fclose(fp);
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    size_t index_bytes = header.entry_count * sizeof(sound_bank_entry_t);
+    sound_bank_entry_t *index = heap_caps_malloc(index_bytes, MALLOC_CAP_SPIRAM);
+    if (!index) {
+        fclose(fp);
+        return ESP_ERR_NO_MEM;
+    }
+    if (fread(index, 1, index_bytes, fp) != index_bytes) {
+        ESP_LOGW(TAG_CACHE, "Truncated sound bank index: %s", path);
+        heap_caps_free(index);
+        fclose(fp);
+        return ESP_FAIL;
+    }
+
+    esp_err_t ret = ESP_OK;
+    long position = (long)(sizeof(header) + index_bytes);
+    uint32_t loaded = 0;
+    uint32_t stale = 0;
+    size_t loaded_bytes = 0;
+
+    for (uint32_t i = 0; i < header.entry_count; i++) {
+        sound_bank_entry_t *e = &index[i];
+        e->filename[sizeof(e->filename) - 1] = '\0';
+        size_t total_bytes = e->size;
+
+        xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+        bool cached = (cache_lookup(provider, e->filename) != NULL);
+        audio_sound_id_t sound_id = sound_lookup(provider, e->filename);
+        xSemaphoreGive(provider->cache_mutex);
+        if (cached) {
+            continue;
+        }
+        if (preload_cancelled(provider, sound_id)) {
+            provider->preload_cancelled++;
+            continue;
+        }
+
+        // Directory lookup only: no fopen or header parse of the source.
+        // Spans are stored in the cache format (and output rate, if fixed):
+        // a bank built for other settings is stale.
+        struct stat st;
+        audio_cache_format_t format = (audio_cache_format_t)e->format;
+        if (stat(e->filename, &st) != 0 || (uint32_t)st.st_size != e->source_size ||
+            format != cache_entry_format(provider, &e->info) ||
+            (provider->output_rate != 0 && e->info.frame_rate != provider->output_rate) ||
+            (provider->downmix && e->info.channels == 2) ||
+            total_bytes != codec_encoded_size(format, e->info.total_frames, e->info.channels)) {
+            ESP_LOGD(TAG_CACHE, "Stale bank entry: %s", e->filename);
+            stale++;
+            continue;
+        }
+        if (total_bytes > CACHE_ITEM_MAXSIZE) {
+            continue;
+        }
+
+        int slot;
+        int16_t *buffer;
+        ret = cache_reserve_and_alloc(provider, total_bytes, &slot, &buffer);
+        if (ret != ESP_OK) {
+            break;
+        }
+
+        if (position != (long)e->offset && fseek(fp, e->offset, SEEK_SET) != 0) {
+            cache_unreserve(provider, slot);
+            ret = ESP_FAIL;
+            break;
+        }
+        ret = bank_read_span(provider, fp, sound_id, buffer, total_bytes);
+        if (ret == ESP_ERR_NOT_FINISHED) {
+            // Page left during this entry: skip it, the next one needs a seek
+            cache_unreserve(provider, slot);
+            provider->preload_cancelled++;
+            position = -1;
+            ret = ESP_OK;
+            continue;
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG_CACHE, "Failed to read bank entry %s from %s", e->filename, path);
+            cache_unreserve(provider, slot);
+            break;
+        }
+        position = (long)e->offset + (long)total_bytes;
+
+        cache_store_entry(provider, slot, e->filename, &e->info, format, buffer, total_bytes);
+        loaded++;
+        loaded_bytes += total_bytes;
+    }
+
+    heap_caps_free(index);
+    fclose(fp);
+#ifdef IO_STATS_ENABLE
+    benchmark_log_and_reset(BENCH_CACHE_LOAD, path);
+#endif
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    provider->bank_loads++;
+    provider->bank_files += loaded;
+    provider->bank_stale += stale;
+    if (provider->warmup_start_us != 0) {
+        provider->warmup_bank = true;
+    }
+    xSemaphoreGive(provider->cache_mutex);
+
+    ESP_LOGI(TAG_CACHE, "Sound bank %s: %lu/%lu files, %zu KB in %lld ms (%lu stale)",
+             path, (unsigned long)loaded, (unsigned long)header.entry_count, loaded_bytes / 1024,
+             (long long)((esp_timer_get_time() - t_start) / 1000), (unsigned long)stale);
+    return ret == ESP_ERR_NO_MEM ? ESP_OK : ret;
+}
+
+/**
+ * @brief Close the warm-up window once the preload queue has drained
+ *
+ * Only called from preload task.
+ */
+static void warmup_check_done(audio_provider_state_t *provider)
+{
+    if (msg_ring_count(provider->preload_ring) > 0) {
+        return;
+    }
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    if (provider->warmup_start_us == 0) {
+        xSemaphoreGive(provider->cache_mutex);
+        return;
+    }
+    uint32_t ms = (uint32_t)((esp_timer_get_time() - provider->warmup_start_us) / 1000);
+    uint32_t files = provider->warmup_files;
+    size_t bytes = provider->warmup_bytes;
+    bool bank = provider->warmup_bank;
+    provider->warmup_start_us = 0;
+    if (files > 0) {
+        provider->last_warmup_ms = ms;
+        provider->last_warmup_files = files;
+        provider->last_warmup_bytes = bytes;
+        provider->last_warmup_bank = bank;
+        provider->warmup_count++;
+    }
+    xSemaphoreGive(provider->cache_mutex);
+
+    if (files > 0) {
+        ESP_LOGI(TAG_CACHE, "Page warm-up: %lu files, %zu KB in %lu ms (%s)",
+                 (unsigned long)files, bytes / 1024, (unsigned long)ms, bank ? "bank" : "files");
+    } else {
+        ESP_LOGD(TAG_CACHE, "Page warm-up: all files already cached (%lu ms)", (unsigned long)ms);
+    }
+}
+
+// ============================================================================
+// Attack-segment (head) Cache
+// ============================================================================
+
+/**
+ * @brief Find head entry by filename (any state)
+ *
+ * Caller must hold cache_mutex.
+ */
+static head_entry_t *head_lookup(audio_provider_state_t *provider, const char *filename)
+{
+    for (int i = 0; i < HEAD_ENTRY_COUNT; i++) {
+        head_entry_t *head = &provider->heads[i];
+        if (head->state != HEAD_STATE_EMPTY && strcmp(head->filename, filename) == 0) {
+            return head;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Load the next pending head (preload task only)
+ *
+ * Opens the file at its PCM data (wav_open_data()) and reads the first head_ms into a PSRAM buffer
+ * charged to the head budget, then publishes the entry as READY.
+ *
+ * @return true if a pending entry was processed, false if none was pending
  */
-static esp_err_t cache_file_internal(audio_provider_state_t *provider, const char *filename)
+static bool head_load_next(audio_provider_state_t *provider)
+{
+    head_entry_t *head = NULL;
+    audio_sound_id_t sound_id = AUDIO_SOUND_ID_NONE;
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    for (int i = 0; i < HEAD_ENTRY_COUNT; i++) {
+        if (provider->heads[i].state == HEAD_STATE_PENDING) {
+            head = &provider->heads[i];
+            sound_id = sound_lookup(provider, head->filename);
+            break;
+        }
+    }
+    xSemaphoreGive(provider->cache_mutex);
+    if (head == NULL) {
+        return false;
+    }
+
+    // filename is stable while the entry is not EMPTY (only deinit frees it)
+    audio_info_t info;
+    codec_pcm_t pcm;
+    uint32_t data_offset = 0;
+    size_t data_size;
+    head_state_t new_state = HEAD_STATE_FAILED;
+    int16_t *buffer = NULL;
+    size_t head_bytes = 0;
+
+    sound_index_meta_t meta;
+    wav_file_t file;
+    esp_err_t ret = wav_open_data(provider, head->filename, sound_id, &meta, &file);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_CACHE, "Failed to open file: %s", head->filename);
+    } else {
+        provider_pcm_init(provider, &meta.info, &pcm, &info);
+        data_offset = meta.data_offset;
+        data_size = (size_t)info.total_frames * info.channels * sizeof(int16_t);
+        size_t frame_bytes = (size_t)info.channels * sizeof(int16_t);
+        head_bytes = (size_t)((uint64_t)info.frame_rate * provider->head_ms / 1000) * frame_bytes;
+        if (head_bytes > data_size) {
+            head_bytes = data_size;
+        }
+
+        // Reserve head budget (no eviction: heads are sized to stay resident)
+        xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+        bool fits = provider->used_head_bytes + head_bytes <= provider->max_head_bytes;
+        if (fits) {
+            provider->used_head_bytes += head_bytes;
+        }
+        xSemaphoreGive(provider->cache_mutex);
+
+        if (!fits) {
+            ESP_LOGW(TAG_CACHE, "Attack-segment budget full, skipping head: %s (%zu KB)",
+                     head->filename, head_bytes / 1024);
+        } else {
+            buffer = heap_caps_aligned_alloc(HEAD_BUFFER_ALIGN, head_bytes > 0 ? head_bytes : HEAD_BUFFER_ALIGN,
+                                             MALLOC_CAP_SPIRAM);
+            // Converted files: first head frames at the source rate, stored as PCM16
+            audio_info_t head_info = info;
+            head_info.total_frames = (uint32_t)(head_bytes / frame_bytes);
+            if (buffer == NULL) {
+                ret = ESP_ERR_NO_MEM;
+            } else if (codec_pcm_passthrough(&pcm)) {
+                ret = cache_read_pcm_data(provider, &file, head->filename, AUDIO_SOUND_ID_NONE,
+                                          head_bytes, buffer, NULL);
+            } else {
+                ret = cache_read_converted_data(provider, &file, head->filename, AUDIO_SOUND_ID_NONE, &pcm,
+                                                &info, &head_info, AUDIO_CACHE_FORMAT_PCM16,
+                                                (uint8_t *)buffer, NULL);
+            }
+            if (ret == ESP_OK) {
+                new_state = HEAD_STATE_READY;
+            } else {
+                ESP_LOGW(TAG_CACHE, "Failed to load head of %s: %s", head->filename, esp_err_to_name(ret));
+                heap_caps_free(buffer);
+                buffer = NULL;
+                xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+                provider->used_head_bytes -= head_bytes;
+                xSemaphoreGive(provider->cache_mutex);
+            }
+        }
+        wav_file_close(&file);
+    }
+
+    // Publish: fields first, state last (open_stream only uses READY entries)
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    if (new_state == HEAD_STATE_READY) {
+        memcpy(&head->info, &info, sizeof(audio_info_t));
+        head->pcm = pcm;
+        head->data_offset = data_offset;
+        head->data_size = (uint32_t)data_size;
+        head->buffer = buffer;
+        head->head_bytes = (uint32_t)head_bytes;
+        ESP_LOGD(TAG_CACHE, "Head cached: %s (%zu KB) - head usage: %zu/%zu KB",
+                 head->filename, head_bytes / 1024,
+                 provider->used_head_bytes / 1024, provider->max_head_bytes / 1024);
+    }
+    head->state = new_state;
+    provider->heads_pending--;
+    xSemaphoreGive(provider->cache_mutex);
+
+    return true;
+}
+
+esp_err_t audio_provider_register_head(audio_provider_handle_t provider, const char *filename)
 {
     if (!provider || !filename) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    // Check if already cached
+    if (provider->max_head_bytes == 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
     xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
-    if (cache_lookup(provider, filename) != NULL) {
-        ESP_LOGD(TAG_CACHE, "File already cached: %s", filename);
+    if (head_lookup(provider, filename) != NULL) {
         xSemaphoreGive(provider->cache_mutex);
         return ESP_OK;
     }
+
+    head_entry_t *head = NULL;
+    for (int i = 0; i < HEAD_ENTRY_COUNT; i++) {
+        if (provider->heads[i].state == HEAD_STATE_EMPTY) {
+            head = &provider->heads[i];
+            break;
+        }
+    }
+    char *name = (head != NULL) ? strdup(filename) : NULL;
+    if (name == NULL) {
+        xSemaphoreGive(provider->cache_mutex);
+        ESP_LOGW(TAG_CACHE, "Attack-segment table full (%d), skipping: %s", HEAD_ENTRY_COUNT, filename);
+        return ESP_ERR_NO_MEM;
+    }
+    head->filename = name;
+    head->state = HEAD_STATE_PENDING;
+    provider->heads_pending++;
+
+    audio_sound_id_t id = sound_lookup(provider, filename);
+    if (id != AUDIO_SOUND_ID_NONE) {
+        provider->sound_head_slot[id] = (int16_t)(head - provider->heads);
+    }
     xSemaphoreGive(provider->cache_mutex);
 
-    // Parse WAV header to determine buffer size needed
-    audio_info_t info;
-    uint32_t data_offset;
-    size_t total_bytes;
-    esp_err_t ret = cache_parse_wav_file(filename, &info, &data_offset, &total_bytes);
+    ESP_LOGD(TAG_CACHE, "Head registered: %s", filename);
+    return ESP_OK;
+}
+
+// ============================================================================
+// WAV Layout Index
+// ============================================================================
+
+/**
+ * @brief Bring one sound of the on-card index up to date (preload task only)
+ *
+ * Parses the header of one sound of the index directory whose layout is not
+ * known yet, or stores a layout learned (or refreshed) by an open in the
+ * index. Once nothing is left, writes the index if it changed. Skipped
+ * while files stream: the SD card is theirs.
+ *
+ * @return true if a sound was processed or the index written
+ */
+static bool index_update_next(audio_provider_state_t *provider)
+{
+    if (!__atomic_load_n(&provider->index_scan, __ATOMIC_RELAXED) || provider->active_stream_count > 0) {
+        return false;
+    }
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    audio_sound_id_t sound_id = AUDIO_SOUND_ID_NONE;
+    for (uint16_t i = 0; i < provider->sound_count; i++) {
+        uint8_t state = provider->sound_meta_state[i];
+        if ((state == SOUND_META_NONE || state == SOUND_META_DIRTY) &&
+            sound_indexable(provider, provider->sound_names[i])) {
+            sound_id = i;
+            break;
+        }
+    }
+    if (sound_id == AUDIO_SOUND_ID_NONE) {
+        __atomic_store_n(&provider->index_scan, false, __ATOMIC_RELAXED);
+        xSemaphoreGive(provider->cache_mutex);
+        if (!provider->index.changed) {
+            return false;
+        }
+        sound_index_save(provider->index_path, &provider->index);
+        return true;
+    }
+    uint8_t state = provider->sound_meta_state[sound_id];
+    sound_index_meta_t meta = provider->sound_meta[sound_id];
+    const char *filename = provider->sound_names[sound_id];
+    xSemaphoreGive(provider->cache_mutex);
+
+    if (state == SOUND_META_NONE) {
+        // Recorded as DIRTY on success, indexed on the next call
+        wav_file_t file;
+        esp_err_t ret = wav_open_data(provider, filename, sound_id, &meta, &file);
+        if (ret == ESP_OK) {
+            wav_file_close(&file);
+        } else {
+            ESP_LOGW(TAG_CACHE, "Not indexed: %s (%s)", filename, esp_err_to_name(ret));
+            xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+            if (provider->sound_meta_state[sound_id] == SOUND_META_NONE) {
+                provider->sound_meta_state[sound_id] = SOUND_META_FAILED;
+            }
+            xSemaphoreGive(provider->cache_mutex);
+        }
+        return true;
+    }
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    esp_err_t ret = sound_index_set(&provider->index, filename, &meta);
+    // Kept DIRTY if an open refreshed the layout meanwhile (a full index stays RAM-only)
+    if (memcmp(&provider->sound_meta[sound_id], &meta, sizeof(meta)) == 0) {
+        provider->sound_meta_state[sound_id] = SOUND_META_INDEXED;
+    }
+    xSemaphoreGive(provider->cache_mutex);
     if (ret != ESP_OK) {
-        return ret;
+        ESP_LOGW(TAG_CACHE, "Sound index full (%d), not indexed: %s", SOUND_INDEX_MAX_ENTRIES, filename);
+    }
+    return true;
+}
+
+esp_err_t audio_provider_load_index(audio_provider_handle_t provider, const char *path)
+{
+    const char *slash = path ? strrchr(path, '/') : NULL;
+    if (!provider || !slash) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Read outside the lock (one header + one entry-array read)
+    sound_index_t index;
+    esp_err_t ret = sound_index_load(path, &index);
+    char *index_path = (ret == ESP_OK) ? strdup(path) : NULL;
+    if (index_path == NULL) {
+        sound_index_free(&index);
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    if (provider->index_path != NULL) {
+        xSemaphoreGive(provider->cache_mutex);
+        free(index_path);
+        sound_index_free(&index);
+        return ESP_ERR_INVALID_STATE;
+    }
+    provider->index = index;
+    provider->index_path = index_path;
+    provider->index_root_len = (size_t)(slash - path) + 1;
+    for (uint16_t i = 0; i < provider->sound_count; i++) {
+        sound_meta_attach(provider, i);
+    }
+    // Also writes back an index that was ignored (corrupt / other version)
+    __atomic_store_n(&provider->index_scan, true, __ATOMIC_RELAXED);
+    xSemaphoreGive(provider->cache_mutex);
+
+    xTaskNotifyGive(provider->preload_task_handle);
+    return ESP_OK;
+}
+
+/**
+ * @brief Free every cache entry that no stream uses (benchmarks)
+ *
+ * Not an eviction: pins, the eviction policy and the re-load miss tracking
+ * are left alone. Preload task only (it owns arena placement).
+ */
+static void cache_purge(audio_provider_state_t *provider)
+{
+    int purged = 0;
+    size_t bytes = 0;
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
+        cache_entry_t *entry = &provider->cache[i];
+        if (entry->filename == NULL || cache_entry_in_use(entry)) {
+            continue;
+        }
+        bytes += entry->arena_bytes;
+        free_cache_entry(provider, entry);
+        purged++;
+    }
+    xSemaphoreGive(provider->cache_mutex);
+
+    ESP_LOGI(TAG_CACHE, "Cache purged: %d entries, %zu KB", purged, bytes / 1024);
+}
+
+// ============================================================================
+// Preload Task
+// ============================================================================
+
+/**
+ * @brief Background preload task
+ *
+ * Processes filenames from preload queue and caches them. When the queue
+ * is empty, loads pending attack segments one at a time (page preloads
+ * keep priority), then brings the WAV layout index up to date. Runs at
+ * low priority to avoid interfering with playback.
+ */
+static void cache_task(void *arg)
+{
+    audio_provider_state_t *provider = (audio_provider_state_t *)arg;
+    preload_item_t item;
+
+    ESP_LOGI(TAG_CACHE, "Preload task started");
+
+    int stale = 0;
+    while (provider->preload_task_running) {
+        // Cleared before the pop: a queued item is never seen as idle
+        __atomic_store_n(&provider->preload_idle, false, __ATOMIC_SEQ_CST);
+        if (msg_ring_pop(provider->preload_ring, &item)) {
+            if (item.kind == PRELOAD_ITEM_PURGE) {
+                cache_purge(provider);
+                xSemaphoreGive(item.done);
+                continue;
+            }
+
+            // Queued before the last flush: drop (a purge waiter is never dropped)
+            if (item.generation != __atomic_load_n(&provider->preload_generation, __ATOMIC_ACQUIRE)) {
+                provider->preload_flushed++;
+                stale++;
+                if (msg_ring_count(provider->preload_ring) == 0) {
+                    ESP_LOGI(TAG_CACHE, "Flushed %d items from preload queue", stale);
+                    stale = 0;
+                }
+                continue;
+            }
+            if (stale > 0) {
+                ESP_LOGI(TAG_CACHE, "Flushed %d items from preload queue", stale);
+                stale = 0;
+            }
+
+            bool bank = (item.kind == PRELOAD_ITEM_BANK);
+            ESP_LOGD(TAG_CACHE, "%s%s: %s", item.prefetch ? "Prefetching" : "Preloading",
+                     bank ? " bank" : "", item.filename);
+            provider->inflight_generation = item.generation;
+            provider->inflight_prefetch = item.prefetch;
+#ifdef TRACE_ENABLE
+            int64_t trace_us = trace_start();
+#endif
+            audio_sound_id_t sound_id = AUDIO_SOUND_ID_NONE;
+            esp_err_t ret = bank ? cache_load_bank(provider, item.filename)
+                                 : cache_file_internal(provider, item.filename, &sound_id);
+            provider->inflight_prefetch = false;
+#ifdef TRACE_ENABLE
+            trace_span(TRACE_PRELOAD, trace_us, sound_id, (uint32_t)ret);
+#endif
+            if (ret == ESP_ERR_NOT_FINISHED) {
+                provider->preload_cancelled++;
+                ESP_LOGD(TAG_CACHE, "Cancelled preload (page left): %s", item.filename);
+            } else if (ret != ESP_OK && ret != ESP_ERR_NO_MEM && !(bank && ret == ESP_ERR_NOT_FOUND)) {
+                ESP_LOGW(TAG_CACHE, "Failed to preload %s: %s", item.filename, esp_err_to_name(ret));
+            }
+            warmup_check_done(provider);
+        } else if (provider->heads_pending > 0) {
+            head_load_next(provider);
+        } else if (index_update_next(provider)) {
+            // One sound indexed: queued preloads and heads keep priority
+        } else {
+            // Woken by a push, the last stream close or deinit (100 ms: check shutdown flag)
+            __atomic_store_n(&provider->preload_idle, true, __ATOMIC_SEQ_CST);
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+        }
+    }
+
+    ESP_LOGI(TAG_CACHE, "Preload task exiting");
+    provider->preload_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+static esp_err_t preload_enqueue(audio_provider_handle_t provider, const char *filename, bool bank,
+                                 bool prefetch)
+{
+    if (!provider || !filename) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!provider->preload_ring) {
+        ESP_LOGW(TAG_CACHE, "Preload queue not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Prepare queue item
+    preload_item_t item;
+    strncpy(item.filename, filename, SOUNDBOARD_MAX_PATH_LEN - 1);
+    item.filename[SOUNDBOARD_MAX_PATH_LEN - 1] = '\0';
+    item.kind = bank ? PRELOAD_ITEM_BANK : PRELOAD_ITEM_FILE;
+    item.prefetch = prefetch;
+    item.generation = __atomic_load_n(&provider->preload_generation, __ATOMIC_ACQUIRE);
+    item.done = NULL;
+
+    // Non-blocking push (drop if full; prefetches are best effort)
+    if (!msg_ring_push(provider->preload_ring, &item)) {
+        if (prefetch) {
+            __atomic_add_fetch(&provider->prefetch_dropped, 1, __ATOMIC_RELAXED);
+            ESP_LOGD(TAG_CACHE, "Preload queue full, dropping prefetch: %s", filename);
+        } else {
+            ESP_LOGW(TAG_CACHE, "Preload queue full, dropping: %s", filename);
+        }
+        return ESP_ERR_NO_MEM;
+    }
+    xTaskNotifyGive(provider->preload_task_handle);
+
+    uint32_t depth = msg_ring_count(provider->preload_ring);
+    uint32_t peak = __atomic_load_n(&provider->preload_queue_peak, __ATOMIC_RELAXED);
+    while (depth > peak &&
+           !__atomic_compare_exchange_n(&provider->preload_queue_peak, &peak, depth, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+
+    ESP_LOGD(TAG_CACHE, "Queued for preload: %s", filename);
+    return ESP_OK;
+}
+
+esp_err_t audio_provider_preload(audio_provider_handle_t provider, const char *filename)
+{
+    return preload_enqueue(provider, filename, false, false);
+}
+
+esp_err_t audio_provider_preload_bank(audio_provider_handle_t provider, const char *bank_path)
+{
+    return preload_enqueue(provider, bank_path, true, false);
+}
+
+esp_err_t audio_provider_prefetch(audio_provider_handle_t provider, const char *path, bool bank)
+{
+    return preload_enqueue(provider, path, bank, true);
+}
+
+void audio_provider_flush_preload_queue(audio_provider_handle_t provider)
+{
+    if (!provider || !provider->preload_ring) {
+        return;
+    }
+
+    // The preload task is the only consumer: queued items are dropped as it
+    // reaches them (their generation is older)
+    __atomic_add_fetch(&provider->preload_generation, 1, __ATOMIC_RELEASE);
+
+    // Start a warm-up measurement for the requests queued next
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    provider->warmup_start_us = esp_timer_get_time();
+    provider->warmup_files = 0;
+    provider->warmup_bytes = 0;
+    provider->warmup_bank = false;
+    xSemaphoreGive(provider->cache_mutex);
+}
+
+esp_err_t audio_provider_purge_cache(audio_provider_handle_t provider)
+{
+    if (!provider) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!provider->preload_ring) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    preload_item_t item = {
+        .kind = PRELOAD_ITEM_PURGE,
+        .done = xSemaphoreCreateBinary(),
+    };
+    if (item.done == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Behind the queued preloads: the cache is empty once done is given
+    esp_err_t ret = ESP_OK;
+    TickType_t start = xTaskGetTickCount();
+    while (!msg_ring_push(provider->preload_ring, &item)) {
+        if (xTaskGetTickCount() - start >= pdMS_TO_TICKS(PURGE_TIMEOUT_MS)) {
+            vSemaphoreDelete(item.done);
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    xTaskNotifyGive(provider->preload_task_handle);
+    if (xSemaphoreTake(item.done, pdMS_TO_TICKS(PURGE_TIMEOUT_MS)) != pdTRUE) {
+        ret = ESP_ERR_TIMEOUT;
+    }
+    // On timeout the item may still be queued (deleting would be unsafe): leak it
+    if (ret == ESP_OK) {
+        vSemaphoreDelete(item.done);
+    }
+    return ret;
+}
+
+esp_err_t audio_provider_get_preload_stats(audio_provider_handle_t provider,
+                                           audio_provider_preload_stats_t *stats)
+{
+    if (!provider || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Preload task counters: read without lock, display only
+    stats->queue_depth = provider->preload_ring ? msg_ring_count(provider->preload_ring) : 0;
+    stats->idle = (stats->queue_depth == 0) && __atomic_load_n(&provider->preload_idle, __ATOMIC_SEQ_CST);
+    stats->queue_peak = __atomic_load_n(&provider->preload_queue_peak, __ATOMIC_RELAXED);
+    stats->flushed = provider->preload_flushed;
+    stats->cancelled = provider->preload_cancelled;
+    stats->prefetch_dropped = __atomic_load_n(&provider->prefetch_dropped, __ATOMIC_RELAXED);
+    stats->throttle_ms = (uint32_t)(provider->preload_throttle_us / 1000);
+    stats->share = provider->preload_share;
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    stats->files = provider->preload_files;
+    stats->bytes = provider->preload_bytes;
+    stats->prefetch_files = provider->prefetch_files;
+    stats->prefetch_bytes = provider->prefetch_bytes;
+    xSemaphoreGive(provider->cache_mutex);
+    return ESP_OK;
+}
+
+esp_err_t audio_provider_get_cache_stats(audio_provider_handle_t provider,
+                                         audio_provider_cache_stats_t *stats)
+{
+    if (!provider || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    stats->header_parses = __atomic_load_n(&provider->header_parses, __ATOMIC_RELAXED);
+    stats->index_opens = __atomic_load_n(&provider->index_opens, __ATOMIC_RELAXED);
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    stats->cache_hits = provider->cache_hits;
+    stats->head_hits = provider->head_hits;
+    stats->cold_misses = provider->cold_misses;
+    stats->reload_misses = provider->reload_misses;
+    stats->evictions = 0;
+    for (int i = 0; i < EVICT_REASON_COUNT; i++) {
+        stats->evictions += provider->evictions[i];
+    }
+    stats->neighbour_evictions = provider->neighbour_evictions;
+    stats->used_bytes = provider->used_cache_bytes;
+    stats->max_bytes = provider->max_cache_bytes;
+    xSemaphoreGive(provider->cache_mutex);
+    return ESP_OK;
+}
+
+esp_err_t audio_provider_get_warmup(audio_provider_handle_t provider, audio_provider_warmup_t *warmup)
+{
+    if (!provider || !warmup) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    warmup->active = (provider->warmup_start_us != 0);
+    warmup->ms = provider->last_warmup_ms;
+    warmup->files = provider->last_warmup_files;
+    warmup->bytes = provider->last_warmup_bytes;
+    warmup->bank = provider->last_warmup_bank;
+    warmup->count = provider->warmup_count;
+    xSemaphoreGive(provider->cache_mutex);
+    return ESP_OK;
+}
+
+
+// ============================================================================
+// Read-ahead Streamer
+// ============================================================================
+
+static inline uint32_t ring_fill(audio_stream_handle_t s)
+{
+    return __atomic_load_n(&s->wav.ring_head, __ATOMIC_ACQUIRE) -
+           __atomic_load_n(&s->wav.ring_tail, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Allocate the file bytes staging of a stream whose samples are converted
+ */
+static esp_err_t stream_alloc_scratch(audio_stream_handle_t s)
+{
+    if (codec_pcm_passthrough(&s->wav.pcm)) {
+        return ESP_OK;
+    }
+    s->wav.pcm_scratch = heap_caps_aligned_alloc(CODEC_PCM_SCRATCH_ALIGN, WAV_CHUNK_SIZE, MALLOC_CAP_SPIRAM);
+    return (s->wav.pcm_scratch != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+/**
+ * @brief Smallest unit read from a stream file: one sample, one frame if converted
+ */
+static inline size_t stream_read_unit(audio_stream_handle_t s)
+{
+    return codec_pcm_passthrough(&s->wav.pcm) ? sizeof(int16_t) : codec_pcm_out_frame_bytes(&s->wav.pcm);
+}
+
+/**
+ * @brief Read 16-bit PCM from the stream file (streamer, or player for direct reads)
+ *
+ * @param max_bytes PCM bytes wanted (a multiple of stream_read_unit())
+ * @return PCM bytes stored in dst, 0 at end of file or on error
+ */
+static size_t stream_file_read(audio_stream_handle_t s, void *dst, size_t max_bytes)
+{
+    size_t n;
+    size_t file_bytes;
+#ifdef IO_STATS_ENABLE
+    int64_t t0 = benchmark_start();
+#endif
+    if (codec_pcm_passthrough(&s->wav.pcm)) {
+        file_bytes = wav_file_read(&s->wav.file, dst, max_bytes);
+        n = file_bytes & ~(size_t)1;
+    } else {
+        size_t frames = wav_file_read_frames(&s->wav.file, &s->wav.pcm, dst,
+                                       max_bytes / codec_pcm_out_frame_bytes(&s->wav.pcm),
+                                       s->wav.pcm_scratch, WAV_CHUNK_SIZE);
+        file_bytes = frames * codec_pcm_frame_bytes(&s->wav.pcm);
+        n = frames * codec_pcm_out_frame_bytes(&s->wav.pcm);
+    }
+#ifdef IO_STATS_ENABLE
+    benchmark_record(BENCH_SD_READ, t0, file_bytes);
+#else
+    (void)file_bytes;
+#endif
+    return n;
+}
+
+/**
+ * @brief Read one chunk from file into the stream ring (streamer side)
+ *
+ * Reads at most WAV_CHUNK_SIZE bytes into the contiguous free part of the ring.
+ * Called from the streamer task, and once from open_stream() to prime the ring.
+ *
+ * @return Number of bytes added to the ring (0 when full or done)
+ */
+static size_t ring_fill_chunk(audio_provider_state_t *provider, audio_stream_handle_t s)
+{
+    uint32_t head = s->wav.ring_head;   // Single writer
+    uint32_t space = provider->ring_size - ring_fill(s);
+    uint32_t idx = head % provider->ring_size;
+    uint32_t remaining = s->wav.data_size - s->wav.file_bytes;
+
+    size_t to_read = space;
+    if (to_read > provider->ring_size - idx) {
+        to_read = provider->ring_size - idx;   // Contiguous part only
+    }
+    if (to_read > WAV_CHUNK_SIZE) {
+        to_read = WAV_CHUNK_SIZE;
+    }
+    if (to_read > remaining) {
+        to_read = remaining;
+    }
+    to_read -= to_read % stream_read_unit(s);  // Whole samples (whole frames when converted)
+    if (to_read == 0) {
+        if (remaining == 0) {
+            __atomic_store_n(&s->wav.file_done, true, __ATOMIC_RELEASE);
+        }
+        return 0;
     }
 
-    // Reject files too large to cache (avoids excessive eviction and fragmentation)
-    if (total_bytes > CACHE_ITEM_MAXSIZE) {
-        ESP_LOGW(TAG_CACHE, "File too large to cache: %s (%zu KB, max %zu KB)",
-                 filename, total_bytes / 1024, (size_t)CACHE_ITEM_MAXSIZE / 1024);
-        return ESP_ERR_NO_MEM;
+    if (!wav_file_is_open(&s->wav.file)) {
+        // Stream started from its attack segment: open the file behind the head
+        if (wav_file_reopen(&s->wav.pcm, s->filename,
+                            s->wav.data_offset + codec_pcm_file_bytes(&s->wav.pcm, s->wav.file_bytes),
+                            &s->wav.file) != ESP_OK) {
+            ESP_LOGE(TAG_PROVIDER, "Failed to open stream remainder: %s", s->filename);
+            __atomic_store_n(&s->wav.file_error, true, __ATOMIC_RELEASE);
+            return 0;
+        }
     }
 
-    // Reserve slot + allocate PSRAM buffer (evicts LRU entries until malloc succeeds)
-    int slot;
-    int16_t *buffer;
-    ret = cache_reserve_and_alloc(provider, total_bytes, &slot, &buffer);
-    if (ret != ESP_OK) {
-        return ret;
+    size_t n = stream_file_read(s, s->wav.ring + idx, to_read);
+    if (n == 0) {
+        if (wav_file_eof(&s->wav.file)) {
+            __atomic_store_n(&s->wav.file_done, true, __ATOMIC_RELEASE);
+        } else {
+            __atomic_store_n(&s->wav.file_error, true, __ATOMIC_RELEASE);
+        }
+        return 0;
     }
 
-    // Read PCM data into allocated buffer (no mutex — slow I/O)
-    ret = cache_read_pcm_data(provider, filename, data_offset, total_bytes, buffer);
-    if (ret != ESP_OK) {
-        // Unreserve: give back the memory budget and free buffer
-        heap_caps_free(buffer);
-        xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
-        provider->used_cache_bytes -= total_bytes;
-        xSemaphoreGive(provider->cache_mutex);
-        return ret;
+    s->wav.file_bytes += n;
+    __atomic_store_n(&s->wav.ring_head, head + n, __ATOMIC_RELEASE);
+    if (s->wav.file_bytes >= s->wav.data_size) {
+        __atomic_store_n(&s->wav.file_done, true, __ATOMIC_RELEASE);
     }
-
-    // Store entry in reserved slot
-    cache_store_entry(provider, slot, filename, &info, buffer, total_bytes);
-    return ESP_OK;
+    return n;
 }
 
-// ============================================================================
-// Preload Task
-// ============================================================================
+/**
+ * @brief Release a file stream closed by the player (streamer side)
+ */
+static void ring_release_stream(audio_stream_handle_t s)
+{
+    wav_file_close(&s->wav.file);
+    heap_caps_free(s->wav.ring);
+    heap_caps_free(s->wav.pcm_scratch);
+    heap_caps_free(s);
+}
 
 /**
- * @brief Background preload task
+ * @brief Register a primed file stream with the streamer
  *
- * Processes filenames from preload queue and caches them.
- * Runs at low priority to avoid interfering with playback.
+ * @return true if registered, false if all reader slots are busy
  */
-static void cache_task(void *arg)
+static bool ring_register_stream(audio_provider_state_t *provider, audio_stream_handle_t s)
 {
-    audio_provider_state_t *provider = (audio_provider_state_t *)arg;
-    preload_item_t item;
+    bool registered = false;
+    xSemaphoreTake(provider->reader_mutex, portMAX_DELAY);
+    for (int i = 0; i < STREAM_READER_MAX; i++) {
+        if (provider->readers[i] == NULL) {
+            provider->readers[i] = s;
+            registered = true;
+            break;
+        }
+    }
+    xSemaphoreGive(provider->reader_mutex);
 
-    ESP_LOGI(TAG_CACHE, "Preload task started");
+    if (registered) {
+        xTaskNotifyGive(provider->stream_task_handle);
+    }
+    return registered;
+}
 
-    while (provider->preload_task_running) {
-        // Block waiting for items (100ms timeout to check shutdown flag)
-        if (xQueueReceive(provider->preload_queue, &item, pdMS_TO_TICKS(100)) == pdTRUE) {
-            // Empty filename is sentinel for shutdown
-            if (item.filename[0] == '\0') {
-                break;
+/**
+ * @brief Streamer task: keeps the rings of all open file streams filled
+ *
+ * Each pass releases closed streams, then reads one chunk for the stream
+ * with the lowest fill level (most urgent first), until all rings are full
+ * or done. Woken by the player after each ring read.
+ */
+static void stream_task(void *arg)
+{
+    audio_provider_state_t *provider = (audio_provider_state_t *)arg;
+    ESP_LOGI(TAG_PROVIDER, "Streamer task started (ring: %zu KB per stream)",
+             provider->ring_size / 1024);
+
+    while (provider->stream_task_running) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(STREAM_TASK_IDLE_MS));
+
+        while (true) {
+            audio_stream_handle_t closed[STREAM_READER_MAX];
+            int closed_count = 0;
+            audio_stream_handle_t target = NULL;
+            uint32_t target_fill = UINT32_MAX;
+
+            xSemaphoreTake(provider->reader_mutex, portMAX_DELAY);
+            for (int i = 0; i < STREAM_READER_MAX; i++) {
+                audio_stream_handle_t s = provider->readers[i];
+                if (s == NULL) {
+                    continue;
+                }
+                if (__atomic_load_n(&s->wav.closing, __ATOMIC_ACQUIRE)) {
+                    closed[closed_count++] = s;
+                    provider->readers[i] = NULL;
+                    continue;
+                }
+                if (s->wav.file_done || s->wav.file_error) {
+                    continue;
+                }
+                uint32_t fill = ring_fill(s);
+                if (fill + WAV_CHUNK_SIZE <= provider->ring_size && fill < target_fill) {
+                    target = s;
+                    target_fill = fill;
+                }
             }
+            xSemaphoreGive(provider->reader_mutex);
 
-            ESP_LOGD(TAG_CACHE, "Preloading: %s", item.filename);
-            esp_err_t ret = cache_file_internal(provider, item.filename);
-            if (ret != ESP_OK && ret != ESP_ERR_NO_MEM) {
-                ESP_LOGW(TAG_CACHE, "Failed to preload %s: %s", item.filename, esp_err_to_name(ret));
+            // Slow I/O outside the mutex (only this task frees streams)
+            for (int i = 0; i < closed_count; i++) {
+                ring_release_stream(closed[i]);
+            }
+            if (target == NULL || ring_fill_chunk(provider, target) == 0) {
+                break;
             }
         }
     }
 
-    ESP_LOGI(TAG_CACHE, "Preload task exiting");
+    ESP_LOGI(TAG_PROVIDER, "Streamer task exiting");
+    provider->stream_task_handle = NULL;
     vTaskDelete(NULL);
 }
 
-esp_err_t audio_provider_preload(audio_provider_handle_t provider, const char *filename)
+/**
+ * @brief Copy PCM data from the stream ring (player side)
+ */
+static esp_err_t ring_read_stream(audio_stream_handle_t stream, int16_t *buffer,
+                                  size_t buffer_samples, size_t *samples_read)
 {
-    if (!provider || !filename) {
-        return ESP_ERR_INVALID_ARG;
+    audio_provider_state_t *provider = stream->provider;
+    uint32_t fill = ring_fill(stream);
+    bool file_done = __atomic_load_n(&stream->wav.file_done, __ATOMIC_ACQUIRE);
+
+    if (fill == 0) {
+        if (file_done) {
+            stream->eof_reached = true;
+            return ESP_OK;
+        }
+        if (__atomic_load_n(&stream->wav.file_error, __ATOMIC_ACQUIRE)) {
+            stream->error_state = true;
+            return ESP_FAIL;
+        }
+        // Underrun: keep the output cadence with silence while the streamer catches up
+        stream->wav.underruns++;
+#ifdef TRACE_ENABLE
+        trace_event(TRACE_UNDERRUN, stream->sound_id, stream->wav.underruns);
+#endif
+        memset(buffer, 0, buffer_samples * sizeof(int16_t));
+        *samples_read = buffer_samples;
+        xTaskNotifyGive(provider->stream_task_handle);
+        return ESP_OK;
     }
 
-    if (!provider->preload_queue) {
-        ESP_LOGW(TAG_CACHE, "Preload queue not initialized");
-        return ESP_ERR_INVALID_STATE;
+    if (!file_done && fill < stream->wav.low_watermark) {
+        stream->wav.low_watermark = fill;
     }
 
-    // Prepare queue item
-    preload_item_t item;
-    strncpy(item.filename, filename, SOUNDBOARD_MAX_PATH_LEN - 1);
-    item.filename[SOUNDBOARD_MAX_PATH_LEN - 1] = '\0';
+    size_t bytes = buffer_samples * sizeof(int16_t);
+    if (bytes > fill) {
+        bytes = fill;
+    }
 
-    // Non-blocking queue send (drop if full)
-    if (xQueueSend(provider->preload_queue, &item, 0) != pdTRUE) {
-        ESP_LOGW(TAG_CACHE, "Preload queue full, dropping: %s", filename);
-        return ESP_ERR_NO_MEM;
+    uint32_t tail = stream->wav.ring_tail;   // Single writer
+    uint32_t idx = tail % provider->ring_size;
+    size_t first = provider->ring_size - idx;
+    if (first > bytes) {
+        first = bytes;
     }
+    memcpy(buffer, stream->wav.ring + idx, first);
+    if (bytes > first) {
+        memcpy((uint8_t *)buffer + first, stream->wav.ring, bytes - first);
+    }
+    __atomic_store_n(&stream->wav.ring_tail, tail + bytes, __ATOMIC_RELEASE);
 
-    ESP_LOGD(TAG_CACHE, "Queued for preload: %s", filename);
+    stream->wav.bytes_read += bytes;
+    *samples_read = bytes / sizeof(int16_t);
+
+    // Wake streamer: there is now room for more data
+    xTaskNotifyGive(provider->stream_task_handle);
     return ESP_OK;
 }
 
-void audio_provider_flush_preload_queue(audio_provider_handle_t provider)
+/**
+ * @brief Allocate a read-ahead ring for a new file stream
+ *
+ * Streams with an open file are primed synchronously. Streams started from
+ * their attack segment (fp == NULL) are primed by the streamer task, which
+ * also opens the file.
+ *
+ * @return true if the stream is now owned by the streamer, false for direct
+ *         reads (read-ahead disabled, or PSRAM / reader slots exhausted)
+ */
+static bool ring_attach_stream(audio_provider_state_t *provider, audio_stream_handle_t s)
 {
-    if (!provider || !provider->preload_queue) {
-        return;
+    if (provider->ring_size == 0 || provider->stream_task_handle == NULL) {
+        return false;
     }
 
-    preload_item_t item;
-    int flushed = 0;
-    while (xQueueReceive(provider->preload_queue, &item, 0) == pdTRUE) {
-        flushed++;
+    s->wav.ring = heap_caps_malloc(provider->ring_size, MALLOC_CAP_SPIRAM);
+    if (s->wav.ring == NULL) {
+        ESP_LOGW(TAG_PROVIDER, "No PSRAM for read-ahead ring, direct reads: %s", s->filename);
+        return false;
+    }
+    s->wav.low_watermark = provider->ring_size;
+
+    if (wav_file_is_open(&s->wav.file)) {
+        // Prime the ring synchronously so the first read does not underrun
+        ring_fill_chunk(provider, s);
     }
 
-    if (flushed > 0) {
-        ESP_LOGI(TAG_CACHE, "Flushed %d items from preload queue", flushed);
+    if (!ring_register_stream(provider, s)) {
+        ESP_LOGW(TAG_PROVIDER, "All %d read-ahead slots busy, direct reads: %s",
+                 STREAM_READER_MAX, s->filename);
+        // Rewind consumed view: data already primed must still be delivered
+        s->wav.file_bytes -= s->wav.ring_head;
+        if (wav_file_is_open(&s->wav.file)) {
+            wav_file_seek(&s->wav.file,
+                          s->wav.data_offset + codec_pcm_file_bytes(&s->wav.pcm, s->wav.file_bytes));
+        }
+        heap_caps_free(s->wav.ring);
+        s->wav.ring = NULL;
+        s->wav.ring_head = 0;
+        s->wav.file_done = false;
+        return false;
     }
+    provider->ring_streams++;
+    return true;
 }
 
+/**
+ * @brief Open a file stream that starts from its resident attack segment
+ *
+ * No filesystem access when read-ahead is available: the streamer opens the
+ * file and reads from the end of the head while the player consumes it.
+ */
+static esp_err_t open_head_stream(audio_provider_state_t *provider, const head_entry_t *head,
+                                  const char *filename, audio_stream_handle_t *stream)
+{
+    audio_stream_handle_t s = heap_caps_calloc(1, sizeof(struct audio_stream_s), MALLOC_CAP_8BIT);
+    if (!s) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    strncpy(s->filename, filename, SOUNDBOARD_MAX_PATH_LEN - 1);
+    s->filename[SOUNDBOARD_MAX_PATH_LEN - 1] = '\0';
+    memcpy(&s->info, &head->info, sizeof(audio_info_t));
+    s->type = STREAM_TYPE_WAV_FILE;
+    s->provider = provider;
+    s->wav.file = (wav_file_t){ 0 };
+    s->wav.data_offset = head->data_offset;
+    s->wav.data_size = head->data_size;
+    s->wav.bytes_read = 0;
+    s->wav.file_bytes = head->head_bytes;
+    s->wav.pcm = head->pcm;
+    s->wav.head = head;
+
+    // Remainder after the head (nothing to open for files shorter than the head)
+    if (head->head_bytes < head->data_size) {
+        if (stream_alloc_scratch(s) != ESP_OK) {
+            heap_caps_free(s);
+            return ESP_ERR_NO_MEM;
+        }
+        if (!ring_attach_stream(provider, s)) {
+            // No read-ahead: open synchronously, header already known
+            esp_err_t ret = wav_file_reopen(&head->pcm, filename,
+                                            head->data_offset + codec_pcm_file_bytes(&head->pcm, head->head_bytes),
+                                            &s->wav.file);
+            if (ret != ESP_OK) {
+                heap_caps_free(s->wav.pcm_scratch);
+                heap_caps_free(s);
+                return ret;
+            }
+        }
+
+        // Only the SD remainder competes with preloading
+        s->wav.sd_active = true;
+        __atomic_add_fetch(&provider->active_stream_count, 1, __ATOMIC_SEQ_CST);
+    }
 
+    ESP_LOGD(TAG_CACHE, "Head hit: %s (%lu KB resident)", filename,
+             (unsigned long)(head->head_bytes / 1024));
 
-// ============================================================================
-// Public API Implementation
-// ============================================================================
-esp_err_t audio_provider_open_stream(audio_provider_handle_t provider,
-                                      const char *filename,
-                                      audio_stream_handle_t *stream)
+    *stream = s;
+    return ESP_OK;
+}
+
+/**
+ * @brief Open a file stream without attack segment
+ *
+ * fopen() + fseek() for an indexed sound (one f_open() for 16-bit files on the
+ * SD card), fopen() + header parse otherwise.
+ *
+ * @param sound_id Sound ID of filename, or AUDIO_SOUND_ID_NONE if not resolved
+ */
+static esp_err_t open_file_stream(audio_provider_state_t *provider, const char *filename,
+                                  audio_sound_id_t sound_id, audio_stream_handle_t *stream)
 {
-    if (!provider || !filename || !stream) {
-        return ESP_ERR_INVALID_ARG;
+    // Open file at the PCM data
+    sound_index_meta_t meta;
+    wav_file_t file;
+    esp_err_t ret = wav_open_data(provider, filename, sound_id, &meta, &file);
+    if (ret != ESP_OK) {
+        return ret;
     }
 
-    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    // Allocate stream structure
+    audio_stream_handle_t s = heap_caps_calloc(1, sizeof(struct audio_stream_s), MALLOC_CAP_8BIT);
+    if (!s) {
+        wav_file_close(&file);
+        return ESP_ERR_NO_MEM;
+    }
 
-    // Check cache first
-    cache_entry_t *entry = cache_lookup(provider, filename);
+    // Initialize WAV stream
+    strncpy(s->filename, filename, SOUNDBOARD_MAX_PATH_LEN - 1);
+    s->filename[SOUNDBOARD_MAX_PATH_LEN - 1] = '\0';
+    provider_pcm_init(provider, &meta.info, &s->wav.pcm, &s->info);
+    s->type = STREAM_TYPE_WAV_FILE;
+    s->provider = provider;
+    s->wav.file = file;
+    s->wav.data_offset = meta.data_offset;
+    s->wav.data_size = s->info.total_frames * (uint32_t)codec_pcm_out_frame_bytes(&s->wav.pcm);
+    s->wav.bytes_read = 0;
+    s->eof_reached = false;
+    s->error_state = false;
+    if (stream_alloc_scratch(s) != ESP_OK) {
+        wav_file_close(&s->wav.file);
+        heap_caps_free(s);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Hand the file over to the streamer (no-op if read-ahead is disabled)
+    (void)ring_attach_stream(provider, s);
+
+    // Throttle (preload_share 0: pause) the preload task while this WAV file stream is active
+    // (cache streams don't need SD card, so they don't slow preload)
+    // Atomic increment - preload task polls this flag
+    s->wav.sd_active = true;
+    __atomic_add_fetch(&provider->active_stream_count, 1, __ATOMIC_SEQ_CST);
+    ESP_LOGD(TAG_CACHE, "Preload throttled (active streams: %d)", provider->active_stream_count);
+
+    *stream = s;
+    return ESP_OK;
+}
+
+/**
+ * @brief Convert a file stream to the fixed output rate (no-op at native rate)
+ *
+ * Rewrites the stream info to the output rate and length; reads then go
+ * through resample_read_stream().
+ */
+static esp_err_t stream_attach_resampler(audio_provider_state_t *provider, audio_stream_handle_t s)
+{
+    if (provider->output_rate == 0 || s->info.frame_rate == provider->output_rate) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = resampler_create(provider->resampler_kernel, s->info.frame_rate,
+                                     provider->output_rate, s->info.channels, &s->resampler);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ESP_LOGD(TAG_PROVIDER, "Resampling %lu -> %lu Hz: %s", (unsigned long)s->info.frame_rate,
+             (unsigned long)provider->output_rate, s->filename);
+    cache_output_info(provider, &s->info, &s->info);
+    s->resample_frames_left = s->info.total_frames;
+    provider->resampled_streams++;
+    return ESP_OK;
+}
 
+/**
+ * @brief Open a stream on an already resolved cache entry / head
+ *
+ * Caller holds cache_mutex; it is released here before any allocation or
+ * file access.
+ *
+ * @param sound_id Sound ID of filename, or AUDIO_SOUND_ID_NONE if not known
+ * @param entry Cache entry of filename, or NULL on cache miss
+ * @param head READY head of filename, or NULL
+ */
+static esp_err_t open_resolved_stream(audio_provider_state_t *provider, const char *filename,
+                                      audio_sound_id_t sound_id, cache_entry_t *entry,
+                                      const head_entry_t *head, audio_stream_handle_t *stream)
+{
     if (entry != NULL) {
         // CACHE HIT PATH
         ESP_LOGD(TAG_CACHE, "Cache hit: %s", filename);
 
-        // Increment ref_count (thread-safe)
-        xSemaphoreTake(entry->mutex, portMAX_DELAY);
-        entry->ref_count++;
-        entry->last_access_tick = xTaskGetTickCount();
-        xSemaphoreGive(entry->mutex);
+        // Increment ref_count (under cache_mutex: ordered with eviction and compaction)
+        __atomic_add_fetch(&entry->ref_count, 1, __ATOMIC_ACQ_REL);
 
+        cache_touch(provider, entry);
+        provider->cache_hits++;
         xSemaphoreGive(provider->cache_mutex);
+#ifdef TRACE_ENABLE
+        trace_event(TRACE_OPEN_HIT, entry->sound_id, 0);
+#endif
 
         // Allocate stream structure
         audio_stream_handle_t s = heap_caps_calloc(1, sizeof(struct audio_stream_s), MALLOC_CAP_8BIT);
         if (!s) {
             // Rollback ref_count
-            xSemaphoreTake(entry->mutex, portMAX_DELAY);
-            entry->ref_count--;
-            xSemaphoreGive(entry->mutex);
+            __atomic_sub_fetch(&entry->ref_count, 1, __ATOMIC_RELEASE);
             return ESP_ERR_NO_MEM;
         }
 
@@ -703,8 +3096,10 @@ esp_err_t audio_provider_open_stream(audio_provider_handle_t provider,
         memcpy(&s->info, &entry->info, sizeof(audio_info_t));
         s->type = STREAM_TYPE_CACHE;
         s->provider = provider;
+        s->sound_id = entry->sound_id;
         s->cache.entry = entry;
         s->cache.position = 0;
+        codec_state_init(&s->cache.decoder, entry->format, entry->info.channels);
         s->eof_reached = false;
         s->error_state = false;
 
@@ -712,64 +3107,247 @@ esp_err_t audio_provider_open_stream(audio_provider_handle_t provider,
         return ESP_OK;
     }
 
-    // CACHE MISS PATH - Create WAV file stream
-    ESP_LOGD(TAG_CACHE, "Cache miss: %s", filename);
+    // CACHE MISS PATH - Create WAV file stream
+    ESP_LOGD(TAG_CACHE, "Cache miss: %s", filename);
+
+    if (head != NULL) {
+        provider->head_hits++;
+    } else {
+        provider->cold_misses++;
+    }
+    if (sound_id == AUDIO_SOUND_ID_NONE) {
+        sound_id = sound_lookup(provider, filename);
+    }
+    if (sound_id != AUDIO_SOUND_ID_NONE && provider->sound_evicted[sound_id]) {
+        provider->reload_misses++;
+    }
+    xSemaphoreGive(provider->cache_mutex);
+#ifdef TRACE_ENABLE
+    trace_event((head != NULL) ? TRACE_OPEN_HEAD : TRACE_OPEN_MISS, sound_id, 0);
+#endif
+
+    esp_err_t ret = (head != NULL) ? open_head_stream(provider, head, filename, stream)
+                                   : open_file_stream(provider, filename, sound_id, stream);
+    if (ret == ESP_OK) {
+        (*stream)->sound_id = sound_id;
+        ret = stream_attach_resampler(provider, *stream);
+        if (ret != ESP_OK) {
+            audio_provider_close_stream(*stream);
+            *stream = NULL;
+        }
+    }
+    return ret;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+esp_err_t audio_provider_open_stream(audio_provider_handle_t provider,
+                                      const char *filename,
+                                      audio_stream_handle_t *stream)
+{
+    if (!provider || !filename || !stream) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+
+    // Check cache first (entries being compacted count as misses), then attack segments
+    cache_entry_t *entry = cache_lookup(provider, filename);
+    if (entry != NULL && entry->moving) {
+        entry = NULL;
+    }
+    head_entry_t *head = NULL;
+    if (entry == NULL) {
+        head = head_lookup(provider, filename);
+        if (head != NULL && head->state != HEAD_STATE_READY) {
+            head = NULL;
+        }
+    }
+
+    return open_resolved_stream(provider, filename, AUDIO_SOUND_ID_NONE, entry, head, stream);
+}
+
+esp_err_t audio_provider_open_sound(audio_provider_handle_t provider,
+                                     audio_sound_id_t sound_id,
+                                     audio_stream_handle_t *stream)
+{
+    if (!provider || !stream ||
+        sound_id >= __atomic_load_n(&provider->sound_count, __ATOMIC_ACQUIRE)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+
+    // Slots are kept in sync by cache store/free and head register
+    int cache_slot = provider->sound_cache_slot[sound_id];
+    int head_slot = provider->sound_head_slot[sound_id];
+    cache_entry_t *entry = (cache_slot != SOUND_SLOT_NONE) ? &provider->cache[cache_slot] : NULL;
+    if (entry != NULL && entry->moving) {
+        entry = NULL;
+    }
+    const head_entry_t *head = NULL;
+    if (entry == NULL && head_slot != SOUND_SLOT_NONE &&
+        provider->heads[head_slot].state == HEAD_STATE_READY) {
+        head = &provider->heads[head_slot];
+    }
+
+    return open_resolved_stream(provider, provider->sound_names[sound_id], sound_id, entry, head, stream);
+}
+
+esp_err_t audio_provider_resolve_sound(audio_provider_handle_t provider,
+                                        const char *filename,
+                                        audio_sound_id_t *sound_id)
+{
+    if (!provider || !filename || !sound_id) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+
+    audio_sound_id_t id = sound_lookup(provider, filename);
+    if (id == AUDIO_SOUND_ID_NONE) {
+        char *name = (provider->sound_count < SOUND_ID_COUNT) ? strdup(filename) : NULL;
+        if (name == NULL) {
+            xSemaphoreGive(provider->cache_mutex);
+            ESP_LOGW(TAG_CACHE, "Sound table full (%d), not resolved: %s", SOUND_ID_COUNT, filename);
+            return ESP_ERR_NO_MEM;
+        }
+
+        id = provider->sound_count;
+        provider->sound_names[id] = name;
+
+        // Link file already cached / registered before it was resolved
+        cache_entry_t *entry = cache_lookup(provider, filename);
+        if (entry != NULL) {
+            entry->sound_id = id;
+        }
+        head_entry_t *head = head_lookup(provider, filename);
+        provider->sound_cache_slot[id] = entry ? (int16_t)(entry - provider->cache) : SOUND_SLOT_NONE;
+        provider->sound_head_slot[id] = head ? (int16_t)(head - provider->heads) : SOUND_SLOT_NONE;
+        provider->sound_meta_state[id] = SOUND_META_NONE;
+        sound_meta_attach(provider, id);
+
+        __atomic_store_n(&provider->sound_count, (uint16_t)(id + 1), __ATOMIC_RELEASE);
+    }
+
+    xSemaphoreGive(provider->cache_mutex);
+
+    *sound_id = id;
+    return ESP_OK;
+}
+
+esp_err_t audio_provider_find_sound(audio_provider_handle_t provider,
+                                    const char *filename,
+                                    audio_sound_id_t *sound_id)
+{
+    if (!provider || !filename || !sound_id) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    audio_sound_id_t id = sound_lookup(provider, filename);
+    xSemaphoreGive(provider->cache_mutex);
+
+    *sound_id = id;
+    return (id != AUDIO_SOUND_ID_NONE) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+const char *audio_provider_get_sound_name(audio_provider_handle_t provider, audio_sound_id_t sound_id)
+{
+    if (!provider || sound_id >= __atomic_load_n(&provider->sound_count, __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+    return provider->sound_names[sound_id];
+}
+
+esp_err_t audio_provider_set_pins(audio_provider_handle_t provider,
+                                   const audio_sound_id_t *current, size_t current_count,
+                                   const audio_sound_id_t *neighbours, size_t neighbour_count)
+{
+    if (!provider || (current_count > 0 && !current) || (neighbour_count > 0 && !neighbours)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
+    memset(provider->sound_pin, AUDIO_CACHE_PIN_NONE, sizeof(provider->sound_pin));
+    for (size_t i = 0; i < neighbour_count; i++) {
+        if (neighbours[i] < provider->sound_count) {
+            provider->sound_pin[neighbours[i]] = AUDIO_CACHE_PIN_NEIGHBOUR;
+        }
+    }
+    // Current page wins when a sound is also on an adjacent page
+    for (size_t i = 0; i < current_count; i++) {
+        if (current[i] < provider->sound_count) {
+            provider->sound_pin[current[i]] = AUDIO_CACHE_PIN_CURRENT;
+        }
+    }
+    xSemaphoreGive(provider->cache_mutex);
+
+    return ESP_OK;
+}
 
-    xSemaphoreGive(provider->cache_mutex);
+esp_err_t audio_provider_read_span(audio_stream_handle_t stream,
+                                   const int16_t **samples,
+                                   size_t max_samples,
+                                   size_t *samples_read)
+{
+    if (!stream || !samples || !samples_read) {
+        return ESP_ERR_INVALID_ARG;
+    }
 
-    // Open file
-    FILE *fp = fopen(filename, "rb");
-    if (!fp) {
-        return ESP_ERR_NOT_FOUND;
+    if (stream->error_state) {
+        return ESP_ERR_INVALID_STATE;
     }
 
-    // Parse WAV header
-    audio_info_t info;
-    uint32_t data_offset;
-    uint32_t data_size;
-    esp_err_t ret = parse_wav_header(fp, &info, &data_offset, &data_size);
-    if (ret != ESP_OK) {
-        fclose(fp);
-        return ret;
+    if (stream->resampler != NULL) {
+        return ESP_ERR_NOT_SUPPORTED;  // Converted by read_stream
     }
 
-    // Allocate stream structure
-    audio_stream_handle_t s = heap_caps_calloc(1, sizeof(struct audio_stream_s), MALLOC_CAP_8BIT);
-    if (!s) {
-        fclose(fp);
-        return ESP_ERR_NO_MEM;
+    if (stream->type != STREAM_TYPE_CACHE) {
+        // Attack segment: resident in PSRAM until consumed
+        const head_entry_t *head = stream->wav.head;
+        if (head == NULL || stream->wav.bytes_read >= head->head_bytes) {
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+        size_t count = (head->head_bytes - stream->wav.bytes_read) / sizeof(int16_t);
+        if (count > max_samples) {
+            count = max_samples;
+        }
+        *samples = (const int16_t *)((const uint8_t *)head->buffer + stream->wav.bytes_read);
+        *samples_read = count;
+        stream->wav.bytes_read += count * sizeof(int16_t);
+        return ESP_OK;
     }
 
-    // Initialize WAV stream
-    strncpy(s->filename, filename, SOUNDBOARD_MAX_PATH_LEN - 1);
-    s->filename[SOUNDBOARD_MAX_PATH_LEN - 1] = '\0';
-    memcpy(&s->info, &info, sizeof(audio_info_t));
-    s->type = STREAM_TYPE_WAV_FILE;
-    s->provider = provider;
-    s->wav.fp = fp;
-    s->wav.data_offset = data_offset;
-    s->wav.data_size = data_size;
-    s->wav.bytes_read = 0;
-    s->eof_reached = false;
-    s->error_state = false;
+    *samples = NULL;
+    *samples_read = 0;
 
-    // Seek to data start
-    fseek(fp, data_offset, SEEK_SET);
+    cache_entry_t *entry = stream->cache.entry;
+    if (entry->format != AUDIO_CACHE_FORMAT_PCM16) {
+        return ESP_ERR_NOT_SUPPORTED;  // Decoded by read_stream
+    }
+    size_t remaining = entry->total_samples - stream->cache.position;
+    if (stream->eof_reached || remaining == 0) {
+        stream->eof_reached = true;
+        return ESP_OK;
+    }
 
-    // Pause preload task while this WAV file stream is active
-    // (cache streams don't need SD card, so they don't pause preload)
-    // Atomic increment - preload task polls this flag
-    __atomic_add_fetch(&provider->active_stream_count, 1, __ATOMIC_SEQ_CST);
-    ESP_LOGD(TAG_CACHE, "Preload paused (active streams: %d)", provider->active_stream_count);
+    size_t count = (max_samples < remaining) ? max_samples : remaining;
+    *samples = entry->buffer + stream->cache.position;
+    *samples_read = count;
+    stream->cache.position += count;
 
-    *stream = s;
     return ESP_OK;
 }
 
-esp_err_t audio_provider_read_stream(audio_stream_handle_t stream,
-                                      int16_t *buffer,
-                                      size_t buffer_samples,
-                                      size_t *samples_read)
+/**
+ * @brief Read source-rate samples (cache, attack segment, ring or file)
+ */
+static esp_err_t read_stream_native(audio_stream_handle_t stream,
+                                    int16_t *buffer,
+                                    size_t buffer_samples,
+                                    size_t *samples_read)
 {
     if (!stream || !buffer || !samples_read) {
         return ESP_ERR_INVALID_ARG;
@@ -798,6 +3376,30 @@ esp_err_t audio_provider_read_stream(audio_stream_handle_t stream,
 
         size_t to_read = (buffer_samples < remaining) ? buffer_samples : remaining;
 
+        if (entry->format != AUDIO_CACHE_FORMAT_PCM16) {
+            // Decode whole frames from the compressed entry (sequential decoder state)
+            audio_provider_state_t *provider = stream->provider;
+            uint16_t channels = entry->info.channels;
+            size_t frames = to_read / channels;
+            if (frames == 0) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            int64_t t_decode = esp_timer_get_time();
+            codec_decode(&stream->cache.decoder, buffer, (const uint8_t *)entry->buffer,
+                         stream->cache.position / channels, frames);
+            uint32_t decode_us = (uint32_t)(esp_timer_get_time() - t_decode);
+
+            provider->decode_chunks++;
+            provider->decode_us += decode_us;
+            if (decode_us > provider->decode_peak_us) {
+                provider->decode_peak_us = decode_us;
+            }
+            to_read = frames * channels;
+            stream->cache.position += to_read;
+            *samples_read = to_read;
+            return ESP_OK;
+        }
+
         // Copy from PSRAM buffer
         size_t bytes_to_read = to_read * sizeof(int16_t);
 #ifdef IO_STATS_ENABLE        
@@ -810,16 +3412,42 @@ esp_err_t audio_provider_read_stream(audio_stream_handle_t stream,
         stream->cache.position += to_read;
         *samples_read = to_read;
 
-        // Update LRU timestamp
-        xSemaphoreTake(entry->mutex, portMAX_DELAY);
-        entry->last_access_tick = xTaskGetTickCount();
-        xSemaphoreGive(entry->mutex);
-
         return ESP_OK;
     }
 
     // WAV FILE READ PATH
 
+    const head_entry_t *head = stream->wav.head;
+    if (head != NULL && stream->wav.bytes_read < head->head_bytes) {
+        // Attack segment first, then continue from the ring in the same chunk
+        size_t bytes = head->head_bytes - stream->wav.bytes_read;
+        if (bytes > buffer_samples * sizeof(int16_t)) {
+            bytes = buffer_samples * sizeof(int16_t);
+        }
+#ifdef IO_STATS_ENABLE
+        int64_t t0 = benchmark_start();
+#endif
+        memcpy(buffer, (const uint8_t *)head->buffer + stream->wav.bytes_read, bytes);
+#ifdef IO_STATS_ENABLE
+        benchmark_record(BENCH_CACHE_HIT, t0, bytes);
+#endif
+        stream->wav.bytes_read += bytes;
+        *samples_read = bytes / sizeof(int16_t);
+
+        size_t rest = buffer_samples - *samples_read;
+        if (rest > 0 && stream->wav.ring != NULL && ring_fill(stream) > 0) {
+            size_t more = 0;
+            esp_err_t ret = ring_read_stream(stream, buffer + *samples_read, rest, &more);
+            *samples_read += more;
+            return ret;
+        }
+        return ESP_OK;
+    }
+
+    if (stream->wav.ring != NULL) {
+        return ring_read_stream(stream, buffer, buffer_samples, samples_read);
+    }
+
     uint32_t bytes_remaining = stream->wav.data_size - stream->wav.bytes_read;
     if (bytes_remaining == 0) {
         stream->eof_reached = true;
@@ -833,16 +3461,14 @@ esp_err_t audio_provider_read_stream(audio_stream_handle_t stream,
     if (bytes_to_read > WAV_CHUNK_SIZE) {
         bytes_to_read = WAV_CHUNK_SIZE;
     }
+    bytes_to_read -= bytes_to_read % stream_read_unit(stream);
+    if (bytes_to_read == 0) {
+        return ESP_ERR_INVALID_SIZE;    // Buffer smaller than one frame of a converted file
+    }
 
-#ifdef IO_STATS_ENABLE
-    int64_t t0 = benchmark_start();
-#endif
-    size_t bytes_read = fread(buffer, 1, bytes_to_read, stream->wav.fp);
-#ifdef IO_STATS_ENABLE
-    benchmark_record(BENCH_SD_READ, t0, bytes_read);
-#endif
+    size_t bytes_read = stream_file_read(stream, buffer, bytes_to_read);
     if (bytes_read == 0) {
-        if (feof(stream->wav.fp)) {
+        if (wav_file_eof(&stream->wav.file)) {
             stream->eof_reached = true;
             return ESP_OK;
         }
@@ -856,48 +3482,156 @@ esp_err_t audio_provider_read_stream(audio_stream_handle_t stream,
     return ESP_OK;
 }
 
+/**
+ * @brief Read a file stream converted to the output rate
+ *
+ * Refills the resampler from read_stream_native() in source frames; the
+ * end of the source flushes the filter tail, and output stops at the
+ * converted length set by stream_attach_resampler().
+ */
+static esp_err_t resample_read_stream(audio_stream_handle_t stream,
+                                      int16_t *buffer,
+                                      size_t buffer_samples,
+                                      size_t *samples_read)
+{
+    resampler_t *r = stream->resampler;
+    uint16_t ch = stream->info.channels;
+    size_t want = buffer_samples / ch;
+    if (want > stream->resample_frames_left) {
+        want = stream->resample_frames_left;
+    }
+
+    *samples_read = 0;
+    if (want == 0) {
+        stream->eof_reached = true;
+        return ESP_OK;
+    }
+
+    size_t done = 0;
+    while (done < want) {
+#ifdef IO_STATS_ENABLE
+        int64_t t0 = benchmark_start();
+#endif
+        size_t got = resampler_output(r, buffer + done * ch, want - done);
+#ifdef IO_STATS_ENABLE
+        benchmark_record(BENCH_RESAMPLE, t0, got * ch * sizeof(int16_t));
+#endif
+        done += got;
+        if (done == want) {
+            break;
+        }
+
+        size_t space;
+        int16_t *in = resampler_input(r, &space);
+        if (space == 0) {
+            if (!resampler_finished(r)) {
+                break;  // Defensive: a full line buffer always yields output
+            }
+            continue;
+        }
+        size_t n = 0;
+        esp_err_t ret = read_stream_native(stream, in, space * ch, &n);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        if (n == 0) {
+            resampler_finish(r);
+        } else {
+            resampler_commit(r, n / ch);
+        }
+    }
+
+    stream->resample_frames_left -= done;
+    *samples_read = done * ch;
+    return ESP_OK;
+}
+
+esp_err_t audio_provider_read_stream(audio_stream_handle_t stream,
+                                      int16_t *buffer,
+                                      size_t buffer_samples,
+                                      size_t *samples_read)
+{
+    if (!stream || !buffer || !samples_read) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (stream->resampler != NULL) {
+        if (stream->error_state) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        return resample_read_stream(stream, buffer, buffer_samples, samples_read);
+    }
+    return read_stream_native(stream, buffer, buffer_samples, samples_read);
+}
+
 esp_err_t audio_provider_close_stream(audio_stream_handle_t stream)
 {
     if (stream == NULL) {
         return ESP_OK;  // NULL-safe
     }
 
+    // Player-side state: the streamer never touches the resampler
+    resampler_destroy(stream->resampler);
+    stream->resampler = NULL;
+
     if (stream->type == STREAM_TYPE_CACHE) {
         // Decrement cache entry ref_count
         cache_entry_t *entry = stream->cache.entry;
 
-        xSemaphoreTake(entry->mutex, portMAX_DELAY);
-        if (entry->ref_count > 0) {
-            entry->ref_count--;
+        // Lock-free: a lower count only lets the preload task evict or move the entry
+        uint32_t refs = __atomic_load_n(&entry->ref_count, __ATOMIC_RELAXED);
+        while (refs > 0 &&
+               !__atomic_compare_exchange_n(&entry->ref_count, &refs, refs - 1, true,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
         }
-        xSemaphoreGive(entry->mutex);
 
 #ifdef IO_STATS_ENABLE
         // Log benchmark data
         benchmark_log_and_reset(BENCH_CACHE_HIT, stream->filename);
 #endif
     } else if (stream->type == STREAM_TYPE_WAV_FILE) {
-        // Close file handle
-        if (stream->wav.fp != NULL) {
-            fclose(stream->wav.fp);
-            stream->wav.fp = NULL;
+        audio_provider_state_t *provider = stream->provider;
+        bool streamer_owned = (stream->wav.ring != NULL);
+
+        if (streamer_owned) {
+            // Fold read-ahead stats into provider totals
+            provider->ring_underruns += stream->wav.underruns;
+            if (stream->wav.low_watermark < provider->ring_low_watermark) {
+                provider->ring_low_watermark = stream->wav.low_watermark;
+            }
+            if (stream->wav.underruns > 0) {
+                ESP_LOGW(TAG_PROVIDER, "Read-ahead underruns: %lu (%s)",
+                         (unsigned long)stream->wav.underruns, stream->filename);
+            }
+        } else {
+            // Close file handle
+            wav_file_close(&stream->wav.file);
+            heap_caps_free(stream->wav.pcm_scratch);
+            stream->wav.pcm_scratch = NULL;
         }
 
 #ifdef IO_STATS_ENABLE
         // Log benchmark data
         benchmark_log_and_reset(BENCH_SD_READ, stream->filename);
+        benchmark_log_and_reset(BENCH_RESAMPLE, stream->filename);
 #endif
-        // Resume preload task if this was the last active WAV file stream
-        audio_provider_state_t *provider = stream->provider;
-        int new_count = __atomic_sub_fetch(&provider->active_stream_count, 1, __ATOMIC_SEQ_CST);
-        if (new_count == 0 && provider->preload_task_handle != NULL) {
+        // Resume preload task if this was the last stream reading the SD card
+        if (stream->wav.sd_active &&
+            __atomic_sub_fetch(&provider->active_stream_count, 1, __ATOMIC_SEQ_CST) == 0 &&
+            provider->preload_task_handle != NULL) {
             // Last stream closed: notify preload task to resume
             xTaskNotifyGive(provider->preload_task_handle);
             ESP_LOGD(TAG_CACHE, "Preload resumed (no active streams)");
         }
     }
 
-    // Free stream structure
+    // Free stream structure (file streams with a ring are freed by the streamer)
+    if (stream->type == STREAM_TYPE_WAV_FILE && stream->wav.ring != NULL) {
+        audio_provider_state_t *provider = stream->provider;
+        __atomic_store_n(&stream->wav.closing, true, __ATOMIC_RELEASE);
+        xTaskNotifyGive(provider->stream_task_handle);
+        return ESP_OK;
+    }
     heap_caps_free(stream);
 
     return ESP_OK;
@@ -911,6 +3645,11 @@ const audio_info_t* audio_provider_get_stream_info(audio_stream_handle_t stream)
     return &stream->info;
 }
 
+bool audio_provider_stream_is_cached(audio_stream_handle_t stream)
+{
+    return stream != NULL && stream->type == STREAM_TYPE_CACHE;
+}
+
 uint16_t audio_provider_get_stream_progress(audio_stream_handle_t stream)
 {
     if (stream == NULL) {
@@ -932,6 +3671,90 @@ uint16_t audio_provider_get_stream_progress(audio_stream_handle_t stream)
     return (uint16_t)((uint64_t)stream->wav.bytes_read * UINT16_MAX / total);
 }
 
+/**
+ * @brief Stop the provider tasks and free what they use (deinit, and init failures)
+ *
+ * Safe on a partially initialized provider: every member is checked. The
+ * state itself is freed by the caller, only when this returns true.
+ *
+ * @return false if a task did not exit in time: everything it may still use
+ *         is leaked rather than freed under it
+ */
+static bool provider_teardown(audio_provider_state_t *provider)
+{
+    // Stop preload task
+    if (provider->preload_task_running) {
+        provider->preload_task_running = false;
+
+        // Wake up the task: it checks the flag between items
+        xTaskNotifyGive(provider->preload_task_handle);
+
+        // Wait for task to exit (max 500ms)
+        for (int i = 0; i < 50 && provider->preload_task_handle != NULL; i++) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+        if (provider->preload_task_handle != NULL) {
+            ESP_LOGE(TAG_CACHE, "Preload task did not exit, leaking provider state");
+            return false;
+        }
+    }
+
+    // Delete preload ring
+    msg_ring_destroy(provider->preload_ring);
+
+    // Stop streamer task (closed streams are released on its way out)
+    if (provider->stream_task_running) {
+        provider->stream_task_running = false;
+        xTaskNotifyGive(provider->stream_task_handle);
+        for (int i = 0; i < 50 && provider->stream_task_handle != NULL; i++) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+        if (provider->stream_task_handle != NULL) {
+            ESP_LOGE(TAG_PROVIDER, "Streamer task did not exit, leaking provider state");
+            return false;
+        }
+    }
+    if (provider->reader_mutex) {
+        for (int i = 0; i < STREAM_READER_MAX; i++) {
+            if (provider->readers[i] != NULL) {
+                ESP_LOGW(TAG_PROVIDER, "Releasing open file stream: %s", provider->readers[i]->filename);
+                ring_release_stream(provider->readers[i]);
+            }
+        }
+        vSemaphoreDelete(provider->reader_mutex);
+    }
+
+    // Free all cache entries
+    for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
+        if (provider->cache[i].filename != NULL) {
+            // Warn if entry still in use
+            if (cache_entry_in_use(&provider->cache[i])) {
+                ESP_LOGW(TAG_CACHE, "Freeing cache entry with active streams: %s",
+                         provider->cache[i].filename);
+            }
+            free_cache_entry(provider, &provider->cache[i]);
+        }
+    }
+
+    // Free attack segments (no stream may still point to them)
+    for (int i = 0; i < HEAD_ENTRY_COUNT; i++) {
+        heap_caps_free(provider->heads[i].buffer);
+        free(provider->heads[i].filename);
+    }
+    for (int i = 0; i < provider->sound_count; i++) {
+        free(provider->sound_names[i]);
+    }
+    sound_index_free(&provider->index);
+    free(provider->index_path);
+
+    heap_caps_free(provider->arena);
+    resampler_kernel_destroy(provider->resampler_kernel);
+    if (provider->cache_mutex) {
+        vSemaphoreDelete(provider->cache_mutex);
+    }
+    return true;
+}
+
 esp_err_t audio_provider_init(audio_provider_config_t *config, audio_provider_handle_t *provider)
 {
     if (!config || !provider) {
@@ -952,10 +3775,32 @@ esp_err_t audio_provider_init(audio_provider_config_t *config, audio_provider_ha
     }
 
     // Initialize cache mutex
+    esp_err_t ret = ESP_ERR_NO_MEM;
     p->cache_mutex = xSemaphoreCreateMutex();
     if (!p->cache_mutex) {
-        heap_caps_free(p);
-        return ESP_ERR_NO_MEM;
+        goto cleanup;
+    }
+
+    // Eviction policy and initial cost model
+    p->policy = &cache_policies[0];
+    for (size_t i = 0; i < sizeof(cache_policies) / sizeof(cache_policies[0]); i++) {
+        if (cache_policies[i].id == config->eviction_policy) {
+            p->policy = &cache_policies[i];
+        }
+    }
+    p->load_open_us = LOAD_COST_DEFAULT_OPEN_US;
+    p->load_us_per_kb = LOAD_COST_DEFAULT_US_PER_KB;
+    p->cache_format = config->cache_format;
+    p->downmix = config->downmix_mono;
+
+    // Fixed output rate: one kernel shared by every converted stream and cache load
+    if (config->output_rate > 0) {
+        if (resampler_kernel_create(config->resampler_taps, &p->resampler_kernel) == ESP_OK) {
+            p->output_rate = config->output_rate;
+        } else {
+            // Not fatal: the player reconfigures I2S per file instead
+            ESP_LOGW(TAG_PROVIDER, "Failed to create resampler kernel, playing at native rates");
+        }
     }
 
     // Initialize configuration
@@ -963,64 +3808,96 @@ esp_err_t audio_provider_init(audio_provider_config_t *config, audio_provider_ha
     p->used_cache_bytes = 0;
     p->initialized = true;
 
+    // Cache arena: clamp to the largest PSRAM block, leaving room for heads/rings
+    p->max_cache_bytes &= ~(size_t)(CACHE_ARENA_ALIGN - 1);
+    if (p->max_cache_bytes > 0) {
+        size_t reserve = config->head_cache_kb * 1024 + config->stream_ring_kb * 1024 * STREAM_READER_MAX +
+                         CACHE_ARENA_HEADROOM;
+        size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+        size_t avail = (largest > reserve) ? (largest - reserve) & ~(size_t)(CACHE_ARENA_ALIGN - 1) : 0;
+        if (p->max_cache_bytes > avail) {
+            ESP_LOGW(TAG_CACHE, "Cache size reduced to %zu KB (requested %zu KB, %zu KB kept for heads/rings)",
+                     avail / 1024, p->max_cache_bytes / 1024, reserve / 1024);
+            p->max_cache_bytes = avail;
+        }
+        p->arena = (p->max_cache_bytes > 0)
+                   ? heap_caps_aligned_alloc(CACHE_ARENA_ALIGN, p->max_cache_bytes, MALLOC_CAP_SPIRAM)
+                   : NULL;
+        if (p->arena == NULL) {
+            ESP_LOGW(TAG_CACHE, "Failed to allocate cache arena, caching disabled");
+            p->max_cache_bytes = 0;
+        }
+    }
+
     // Initialize all cache entries to empty
     for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
         p->cache[i].filename = NULL;
         p->cache[i].buffer = NULL;
         p->cache[i].ref_count = 0;
-        p->cache[i].mutex = xSemaphoreCreateMutex();
-        if (!p->cache[i].mutex) {
-            // Cleanup on failure
-            for (int j = 0; j < i; j++) {
-                vSemaphoreDelete(p->cache[j].mutex);
-            }
-            vSemaphoreDelete(p->cache_mutex);
-            heap_caps_free(p);
-            return ESP_ERR_NO_MEM;
-        }
+        p->cache[i].sound_id = AUDIO_SOUND_ID_NONE;
     }
 
     // Create preload queue
-    p->preload_queue = xQueueCreate(PRELOAD_QUEUE_LENGTH, sizeof(preload_item_t));
-    if (!p->preload_queue) {
-        for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
-            vSemaphoreDelete(p->cache[i].mutex);
-        }
-        vSemaphoreDelete(p->cache_mutex);
-        heap_caps_free(p);
-        return ESP_ERR_NO_MEM;
+    if (msg_ring_create(PRELOAD_RING_DEPTH, sizeof(preload_item_t), &p->preload_ring) != ESP_OK) {
+        goto cleanup;
     }
 
     // Initialize preload pause control
     p->active_stream_count = 0;
+    p->preload_share = (config->preload_share > 100) ? 100 : config->preload_share;
+
+    // Attack-segment cache (loaded by the preload task, separate budget)
+    p->max_head_bytes = (config->head_ms > 0) ? config->head_cache_kb * 1024 : 0;
+    p->head_ms = config->head_ms;
+
+    // Read-ahead streamer for cache-miss playback (optional)
+    p->ring_size = (config->stream_ring_kb * 1024) & ~(size_t)3;
+    p->ring_low_watermark = UINT32_MAX;
+    if (p->ring_size > 0 && p->ring_size < 2 * WAV_CHUNK_SIZE) {
+        ESP_LOGW(TAG_PROVIDER, "Read-ahead ring too small (%zu KB), using %d KB",
+                 p->ring_size / 1024, 2 * WAV_CHUNK_SIZE / 1024);
+        p->ring_size = 2 * WAV_CHUNK_SIZE;
+    }
+    if (p->ring_size > 0) {
+        p->reader_mutex = xSemaphoreCreateMutex();
+        p->stream_task_running = (p->reader_mutex != NULL);
+        if (p->stream_task_running &&
+            xTaskCreatePinnedToCore(stream_task, "streamer", STREAM_TASK_STACK_SIZE, p,
+                                    STREAM_TASK_PRIORITY, &p->stream_task_handle,
+                                    STREAM_TASK_CORE) != pdPASS) {
+            p->stream_task_running = false;
+            p->stream_task_handle = NULL;
+        }
+        if (!p->stream_task_running) {
+            // Not fatal: file streams fall back to direct reads
+            ESP_LOGW(TAG_PROVIDER, "Failed to start streamer task, read-ahead disabled");
+            p->ring_size = 0;
+        }
+    }
 
     // Create preload task (run on core 0 to avoid contention with player on core 1)
     p->preload_task_running = true;
-    BaseType_t ret = xTaskCreatePinnedToCore(
-        cache_task,
-        "cache",
-        PRELOAD_TASK_STACK_SIZE,
-        p,
-        PRELOAD_TASK_PRIORITY,
-        &p->preload_task_handle,
-        0  // Core 0
-    );
-
-    if (ret != pdPASS) {
-        vQueueDelete(p->preload_queue);
-        for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
-            vSemaphoreDelete(p->cache[i].mutex);
-        }
-        vSemaphoreDelete(p->cache_mutex);
-        heap_caps_free(p);
-        return ESP_ERR_NO_MEM;
+    if (xTaskCreatePinnedToCore(cache_task, "cache", PRELOAD_TASK_STACK_SIZE, p,
+                                PRELOAD_TASK_PRIORITY, &p->preload_task_handle,
+                                0 /* Core 0 */) != pdPASS) {
+        p->preload_task_running = false;
+        p->preload_task_handle = NULL;
+        goto cleanup;
     }
 
-    ESP_LOGI(TAG_PROVIDER, "Audio provider initialized (cache: %zu KB, PSRAM: %zu KB available)",
-             p->max_cache_bytes / 1024, psram_size / 1024);
+    ESP_LOGI(TAG_PROVIDER, "Audio provider initialized (cache: %zu KB, heads: %zu KB x %lu ms, PSRAM: %zu KB available)",
+             p->max_cache_bytes / 1024, p->max_head_bytes / 1024, (unsigned long)p->head_ms,
+             psram_size / 1024);
 
     *provider = p;
     return ESP_OK;
+
+cleanup:
+    // Streamer task (if started) stopped before its state is freed
+    if (provider_teardown(p)) {
+        heap_caps_free(p);
+    }
+    return ret;
 }
 
 void audio_provider_deinit(audio_provider_handle_t provider)
@@ -1029,39 +3906,9 @@ void audio_provider_deinit(audio_provider_handle_t provider)
         return;
     }
 
-    // Stop preload task
-    if (provider->preload_task_running) {
-        provider->preload_task_running = false;
-
-        // Send empty filename as sentinel to wake up task
-        preload_item_t sentinel = { .filename = "" };
-        xQueueSend(provider->preload_queue, &sentinel, pdMS_TO_TICKS(100));
-
-        // Wait for task to exit (max 500ms)
-        for (int i = 0; i < 50 && provider->preload_task_handle != NULL; i++) {
-            vTaskDelay(pdMS_TO_TICKS(10));
-        }
-    }
-
-    // Delete preload queue
-    if (provider->preload_queue) {
-        vQueueDelete(provider->preload_queue);
-    }
-
-    // Free all cache entries
-    for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
-        if (provider->cache[i].filename != NULL) {
-            // Warn if entry still in use
-            if (provider->cache[i].ref_count > 0) {
-                ESP_LOGW(TAG_CACHE, "Freeing cache entry with active streams: %s",
-                         provider->cache[i].filename);
-            }
-            free_cache_entry(provider, &provider->cache[i]);
-        }
-        vSemaphoreDelete(provider->cache[i].mutex);
+    if (!provider_teardown(provider)) {
+        return;
     }
-
-    vSemaphoreDelete(provider->cache_mutex);
     heap_caps_free(provider);
 
     ESP_LOGI(TAG_PROVIDER, "Audio provider deinitialized");
@@ -1083,24 +3930,108 @@ void audio_provider_print_status(audio_provider_handle_t provider, status_output
     // Count used slots and calculate stats
     int slots_used = 0;
     size_t total_cached_bytes = 0;
+    size_t total_pcm_bytes = 0;
+    size_t arena_padding = 0;
 
     xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
     for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
         if (provider->cache[i].filename != NULL) {
             slots_used++;
             total_cached_bytes += provider->cache[i].buf_size;
+            total_pcm_bytes += provider->cache[i].total_samples * sizeof(int16_t);
+            arena_padding += provider->cache[i].arena_bytes - provider->cache[i].buf_size;
         }
     }
     size_t max_cache = provider->max_cache_bytes;
+    size_t arena_used = provider->used_cache_bytes;
+    size_t largest_hole = 0;
+    arena_find_hole(provider, 0, &largest_hole);
+    uint32_t compactions = provider->arena_compactions;
+    size_t moved_bytes = provider->arena_moved_bytes;
+    uint32_t evictions[EVICT_REASON_COUNT];
+    memcpy(evictions, provider->evictions, sizeof(evictions));
+    uint32_t total_evictions = evictions[EVICT_REASON_BUDGET] + evictions[EVICT_REASON_SLOTS] +
+                               evictions[EVICT_REASON_FRAGMENTED];
+    uint32_t neighbour_evictions = provider->neighbour_evictions;
+    uint32_t reload_misses = provider->reload_misses;
+    uint32_t load_open_us = provider->load_open_us;
+    uint32_t load_us_per_kb = provider->load_us_per_kb;
+    int pinned_current = 0;
+    int pinned_neighbour = 0;
+    for (int i = 0; i < provider->sound_count; i++) {
+        pinned_current += (provider->sound_pin[i] == AUDIO_CACHE_PIN_CURRENT);
+        pinned_neighbour += (provider->sound_pin[i] == AUDIO_CACHE_PIN_NEIGHBOUR);
+    }
+    size_t arena_free = max_cache - arena_used;
+    int fragmentation = arena_free > 0 ? (int)((uint64_t)(arena_free - largest_hole) * 100 / arena_free) : 0;
     int active_streams = provider->active_stream_count;
     bool preload_running = provider->preload_task_running;
+
+    int heads_registered = 0;
+    int heads_ready = 0;
+    int heads_failed = 0;
+    for (int i = 0; i < HEAD_ENTRY_COUNT; i++) {
+        head_state_t state = provider->heads[i].state;
+        heads_registered += (state != HEAD_STATE_EMPTY);
+        heads_ready += (state == HEAD_STATE_READY);
+        heads_failed += (state == HEAD_STATE_FAILED);
+    }
+    size_t used_head = provider->used_head_bytes;
+    uint32_t cache_hits = provider->cache_hits;
+    uint32_t head_hits = provider->head_hits;
+    uint32_t cold_misses = provider->cold_misses;
+    uint32_t last_warmup_ms = provider->last_warmup_ms;
+    uint32_t last_warmup_files = provider->last_warmup_files;
+    size_t last_warmup_bytes = provider->last_warmup_bytes;
+    bool last_warmup_bank = provider->last_warmup_bank;
+    uint32_t bank_loads = provider->bank_loads;
+    uint32_t bank_files = provider->bank_files;
+    uint32_t bank_stale = provider->bank_stale;
+    uint32_t resampled_loads = provider->resampled_loads;
+    int index_entries = provider->index.count;
+    int sounds_indexed = 0;
+    int sounds_unindexed = 0;
+    for (int i = 0; i < provider->sound_count; i++) {
+        sounds_indexed += (provider->sound_meta_state[i] == SOUND_META_INDEXED);
+        sounds_unindexed += ((provider->sound_meta_state[i] == SOUND_META_NONE ||
+                              provider->sound_meta_state[i] == SOUND_META_DIRTY) &&
+                             sound_indexable(provider, provider->sound_names[i]));
+    }
     xSemaphoreGive(provider->cache_mutex);
+    uint32_t index_opens = __atomic_load_n(&provider->index_opens, __ATOMIC_RELAXED);
+    uint32_t header_parses = __atomic_load_n(&provider->header_parses, __ATOMIC_RELAXED);
+    uint32_t index_stale = __atomic_load_n(&provider->index_stale, __ATOMIC_RELAXED);
+    uint32_t downmixed_files = __atomic_load_n(&provider->downmixed_files, __ATOMIC_RELAXED);
+    uint32_t narrowed_files = __atomic_load_n(&provider->narrowed_files, __ATOMIC_RELAXED);
+
+    // Read-ahead: include open streams in the watermark/underrun totals
+    uint32_t underruns = provider->ring_underruns;
+    uint32_t low_watermark = provider->ring_low_watermark;
+    int open_rings = 0;
+    if (provider->ring_size > 0) {
+        xSemaphoreTake(provider->reader_mutex, portMAX_DELAY);
+        for (int i = 0; i < STREAM_READER_MAX; i++) {
+            audio_stream_handle_t s = provider->readers[i];
+            if (s == NULL || s->wav.closing) {
+                continue;
+            }
+            open_rings++;
+            underruns += s->wav.underruns;
+            if (s->wav.low_watermark < low_watermark) {
+                low_watermark = s->wav.low_watermark;
+            }
+        }
+        xSemaphoreGive(provider->reader_mutex);
+    }
 
     if (output_type == STATUS_OUTPUT_COMPACT) {
-        printf("[provider] cache: %d/%d slots, %.1fMB/%.1fMB\n",
+        printf("[provider] cache: %d/%d slots, %.1fMB/%.1fMB, frag=%d%%, evict=%lu, reload_miss=%lu, heads=%d/%d, underruns=%lu\n",
                slots_used, CACHE_ENTRY_COUNT,
                (double)total_cached_bytes / (1024 * 1024),
-               (double)max_cache / (1024 * 1024));
+               (double)max_cache / (1024 * 1024),
+               fragmentation, (unsigned long)total_evictions, (unsigned long)reload_misses,
+               heads_ready, heads_registered,
+               (unsigned long)underruns);
     } else {
         printf("Audio Provider Status:\n");
         printf("  PSRAM Cache: Enabled\n");
@@ -1109,25 +4040,160 @@ void audio_provider_print_status(audio_provider_handle_t provider, status_output
                (double)total_cached_bytes / (1024 * 1024),
                (double)max_cache / (1024 * 1024),
                max_cache > 0 ? (int)((total_cached_bytes * 100) / max_cache) : 0);
+        if (provider->cache_format != AUDIO_CACHE_FORMAT_PCM16) {
+            printf("  Sample format: %s, %.1f MB of PCM held (%.1fx)\n",
+                   codec_format_name(provider->cache_format),
+                   (double)total_pcm_bytes / (1024 * 1024),
+                   total_cached_bytes > 0 ? (double)total_pcm_bytes / (double)total_cached_bytes : 0.0);
+            // Player task counters: read without lock, display only
+            uint32_t chunks = provider->decode_chunks;
+            printf("  Decode: %lu chunks, avg %lu us, peak %lu us\n",
+                   (unsigned long)chunks,
+                   (unsigned long)(chunks > 0 ? provider->decode_us / chunks : 0),
+                   (unsigned long)provider->decode_peak_us);
+        } else {
+            printf("  Sample format: %s\n", codec_format_name(provider->cache_format));
+        }
+        if (provider->output_rate > 0) {
+            printf("  Output rate: %lu Hz fixed (%u-tap resampler), %lu streams / %lu cache loads converted\n",
+                   (unsigned long)provider->output_rate, resampler_kernel_taps(provider->resampler_kernel),
+                   (unsigned long)provider->resampled_streams, (unsigned long)resampled_loads);
+        } else {
+            printf("  Output rate: native (I2S follows each file)\n");
+        }
+        printf("  Arena: %zu KB free, largest hole %zu KB, fragmentation %d%%, %zu bytes alignment waste\n",
+               arena_free / 1024, largest_hole / 1024, fragmentation, arena_padding);
+        printf("  Arena maintenance: %lu compactions (%zu KB moved)\n",
+               (unsigned long)compactions, moved_bytes / 1024);
+        printf("  Eviction policy: %s (pinned: %d current, %d adjacent)\n",
+               provider->policy->name, pinned_current, pinned_neighbour);
+        printf("  Evictions: %lu (%lu budget, %lu slots, %lu fragmented; %lu adjacent-page), re-load misses: %lu\n",
+               (unsigned long)total_evictions, (unsigned long)evictions[EVICT_REASON_BUDGET],
+               (unsigned long)evictions[EVICT_REASON_SLOTS], (unsigned long)evictions[EVICT_REASON_FRAGMENTED],
+               (unsigned long)neighbour_evictions, (unsigned long)reload_misses);
+        printf("  Load cost: %lu ms open, %lu us/KB read\n",
+               (unsigned long)(load_open_us / 1000), (unsigned long)load_us_per_kb);
+        audio_provider_preload_stats_t preload;
+        audio_provider_get_preload_stats(provider, &preload);
         const char *preload_state = "Stopped";
         if (preload_running) {
-            preload_state = active_streams > 0 ? "Paused" : "Idle";
+            if (active_streams == 0) {
+                preload_state = "Idle";
+            } else {
+                preload_state = (preload.share == 0) ? "Paused" : "Sharing";
+            }
+        }
+        if (preload.share > 0) {
+            printf("  Preload task: %s (%u%% of SD time while streaming, %lu ms yielded)\n",
+                   preload_state, preload.share, (unsigned long)preload.throttle_ms);
+        } else {
+            printf("  Preload task: %s (paused while streaming, %lu ms paused)\n",
+                   preload_state, (unsigned long)preload.throttle_ms);
+        }
+        printf("  Preload queue: %lu/%d queued (peak %lu), %lu flushed, %lu cancelled in flight\n",
+               (unsigned long)preload.queue_depth, PRELOAD_RING_DEPTH, (unsigned long)preload.queue_peak,
+               (unsigned long)preload.flushed, (unsigned long)preload.cancelled);
+        printf("  Preloaded: %lu files, %zu KB; prefetched (adjacent pages): %lu files, %zu KB, %lu dropped\n",
+               (unsigned long)preload.files, preload.bytes / 1024,
+               (unsigned long)preload.prefetch_files, preload.prefetch_bytes / 1024,
+               (unsigned long)preload.prefetch_dropped);
+        if (last_warmup_files > 0) {
+            printf("  Last warm-up: %lu files, %zu KB in %lu ms (%s)\n",
+                   (unsigned long)last_warmup_files, last_warmup_bytes / 1024,
+                   (unsigned long)last_warmup_ms, last_warmup_bank ? "bank" : "files");
+        } else {
+            printf("  Last warm-up: n/a\n");
+        }
+        printf("  Sound banks: %lu loaded, %lu files, %lu stale entries\n",
+               (unsigned long)bank_loads, (unsigned long)bank_files, (unsigned long)bank_stale);
+        if (provider->max_head_bytes > 0) {
+            printf("  Attack segments: %d/%d ready (%d pending, %d failed), %lu ms each\n",
+                   heads_ready, heads_registered, heads_registered - heads_ready - heads_failed,
+                   heads_failed, (unsigned long)provider->head_ms);
+            printf("  Attack memory: %zu KB / %zu KB (%d%%)\n",
+                   used_head / 1024, provider->max_head_bytes / 1024,
+                   (int)((uint64_t)used_head * 100 / provider->max_head_bytes));
+        } else {
+            printf("  Attack segments: Disabled\n");
+        }
+        printf("  Opens: %lu cache hits, %lu head hits, %lu cold misses\n",
+               (unsigned long)cache_hits, (unsigned long)head_hits, (unsigned long)cold_misses);
+        printf("  Sound IDs: %u/%d resolved\n", provider->sound_count, SOUND_ID_COUNT);
+        if (provider->index_path != NULL) {
+            printf("  WAV index: %d entries, %d sounds indexed (%d pending), %s\n",
+                   index_entries, sounds_indexed, sounds_unindexed, provider->index_path);
+        } else {
+            printf("  WAV index: Not loaded\n");
         }
-        printf("  Preload task: %s\n", preload_state);
+        printf("  WAV opens: %lu without header parse, %lu headers parsed, %lu stale layouts\n",
+               (unsigned long)index_opens, (unsigned long)header_parses, (unsigned long)index_stale);
+        printf("  Source conversion: stereo %s, %lu downmixed, %lu reduced to 16 bits (loads and streams)\n",
+               provider->downmix ? "to mono" : "kept", (unsigned long)downmixed_files,
+               (unsigned long)narrowed_files);
         printf("  Active streams: %d\n", active_streams);
+        if (provider->ring_size > 0) {
+            printf("  Read-ahead: %zu KB ring per stream, %d open, %lu streams played\n",
+                   provider->ring_size / 1024, open_rings, (unsigned long)provider->ring_streams);
+            if (low_watermark != UINT32_MAX) {
+                printf("  Read-ahead low watermark: %lu KB (%d%%), underruns: %lu\n",
+                       (unsigned long)(low_watermark / 1024),
+                       (int)((uint64_t)low_watermark * 100 / provider->ring_size),
+                       (unsigned long)underruns);
+            } else {
+                printf("  Read-ahead low watermark: n/a, underruns: %lu\n", (unsigned long)underruns);
+            }
+        } else {
+            printf("  Read-ahead: Disabled (direct file reads)\n");
+        }
 
         if (output_type == STATUS_OUTPUT_VERBOSE) {
             printf("  Cached files:\n");
             xSemaphoreTake(provider->cache_mutex, portMAX_DELAY);
             for (int i = 0; i < CACHE_ENTRY_COUNT; i++) {
                 if (provider->cache[i].filename != NULL) {
-                    printf("    - %s (%zu KB, refs=%d)\n",
+                    printf("    - %s (%zu KB, refs=%lu)\n",
                            provider->cache[i].filename,
                            provider->cache[i].buf_size / 1024,
-                           provider->cache[i].ref_count);
+                           (unsigned long)__atomic_load_n(&provider->cache[i].ref_count, __ATOMIC_RELAXED));
+                }
+            }
+
+            if (heads_registered > 0) {
+                static const char *head_state_names[] = { "empty", "pending", "ready", "failed" };
+                printf("  Attack segments:\n");
+                for (int i = 0; i < HEAD_ENTRY_COUNT; i++) {
+                    const head_entry_t *head = &provider->heads[i];
+                    if (head->state == HEAD_STATE_EMPTY) {
+                        continue;
+                    }
+                    if (head->state == HEAD_STATE_READY) {
+                        printf("    - %s (%lu KB%s)\n", head->filename,
+                               (unsigned long)(head->head_bytes / 1024),
+                               head->head_bytes >= head->data_size ? ", whole file" : "");
+                    } else {
+                        printf("    - %s (%s)\n", head->filename, head_state_names[head->state]);
+                    }
                 }
             }
             xSemaphoreGive(provider->cache_mutex);
+
+            if (open_rings > 0) {
+                printf("  Read-ahead streams:\n");
+                xSemaphoreTake(provider->reader_mutex, portMAX_DELAY);
+                for (int i = 0; i < STREAM_READER_MAX; i++) {
+                    audio_stream_handle_t s = provider->readers[i];
+                    if (s == NULL || s->wav.closing) {
+                        continue;
+                    }
+                    printf("    - %s (fill %lu KB, low %lu KB, underruns=%lu%s)\n",
+                           s->filename,
+                           (unsigned long)(ring_fill(s) / 1024),
+                           (unsigned long)(s->wav.low_watermark / 1024),
+                           (unsigned long)s->wav.underruns,
+                           s->wav.file_done ? ", file done" : "");
+                }
+                xSemaphoreGive(provider->reader_mutex);
+            }
         }
     }
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include "esp_err.h"
 #include "soundboard.h"
 
@@ -28,7 +29,7 @@
 typedef struct {
     uint32_t frame_rate;      /**< Frame rate in Hz (e.g., 44100, 48000) */
     uint16_t channels;        /**< Number of channels (1=mono, 2=stereo) */
-    uint16_t bit_depth;       /**< Bits per sample (16 only supported) */
+    uint16_t bit_depth;       /**< Bits per sample (16 for streams and cache entries; files may be 16/24/32) */
     uint32_t total_frames;    /**< Total sample frames (1 frame = 1 value per channel) */
 } audio_info_t;
 
@@ -46,11 +47,64 @@ typedef struct audio_provider_s* audio_provider_handle_t;
  */
 typedef struct audio_stream_s* audio_stream_handle_t;
 
+/**
+ * @brief Pre-resolved sound identifier
+ *
+ * Small index into the provider's sound table, obtained once per file with
+ * audio_provider_resolve_sound(). Valid until the provider is destroyed.
+ */
+typedef uint16_t audio_sound_id_t;
+
+/**
+ * @brief Invalid / unresolved sound ID
+ */
+#define AUDIO_SOUND_ID_NONE UINT16_MAX
+
+/**
+ * @brief PSRAM cache eviction policy
+ */
+typedef enum {
+    AUDIO_CACHE_POLICY_LRU,         /**< Least recently opened, page-agnostic */
+    AUDIO_CACHE_POLICY_PAGE_LRU,    /**< Page pins honoured, least recently opened among the rest */
+    AUDIO_CACHE_POLICY_PAGE_COST,   /**< Page pins honoured, cost-aware (reload time per byte, recency) */
+} audio_cache_policy_t;
+
+/**
+ * @brief Sample format of PSRAM cache entries
+ *
+ * Compressed formats trade a per-chunk decode in the player task for more
+ * sounds per MB of cache. Streams of compressed entries do not support
+ * audio_provider_read_span() and are decoded by audio_provider_read_stream().
+ */
+typedef enum {
+    AUDIO_CACHE_FORMAT_PCM16,       /**< Raw 16-bit PCM (zero-copy reads) */
+    AUDIO_CACHE_FORMAT_MULAW,       /**< G.711 mu-law, 8 bits per sample (2:1) */
+    AUDIO_CACHE_FORMAT_IMA_ADPCM,   /**< IMA ADPCM, WAV block layout (~4:1, mono/stereo) */
+} audio_cache_format_t;
+
+/**
+ * @brief Cache pin level of a sound (see audio_provider_set_pins())
+ */
+typedef enum {
+    AUDIO_CACHE_PIN_NONE,           /**< Evictable by policy */
+    AUDIO_CACHE_PIN_NEIGHBOUR,      /**< On an adjacent page: evicted only if nothing else is evictable */
+    AUDIO_CACHE_PIN_CURRENT,        /**< On the current page: never evicted */
+} audio_cache_pin_t;
+
 /**
  * @brief Audio provider configuration
  */
 typedef struct {
     size_t cache_size_kb;     /**< Maximum cache size in KB (requires PSRAM) */
+    size_t stream_ring_kb;    /**< Read-ahead ring per file stream in KB (0 = direct file reads) */
+    size_t head_cache_kb;     /**< Attack-segment cache budget in KB (0 = disabled) */
+    uint32_t head_ms;         /**< Attack-segment length per file in ms */
+    audio_cache_policy_t eviction_policy; /**< PSRAM cache eviction policy */
+    audio_cache_format_t cache_format;    /**< Sample format of PSRAM cache entries */
+    uint32_t output_rate;     /**< Fixed output rate in Hz, sources are resampled (0 = native rates) */
+    uint8_t resampler_taps;   /**< Resampler kernel: RESAMPLER_TAPS_LINEAR or RESAMPLER_TAPS_SINC */
+    uint8_t preload_share;    /**< SD time share of the preload task while files stream, percent (0 = pause) */
+    bool downmix_mono;        /**< Average stereo files to mono (16-bit PCM handed out in any case) */
 } audio_provider_config_t;
 
 /**
@@ -92,12 +146,119 @@ esp_err_t audio_provider_open_stream(audio_provider_handle_t provider,
                               audio_stream_handle_t *stream);
 
 
+/**
+ * @brief Resolve a filename into a sound ID
+ *
+ * Interns the filename in the provider's sound table (idempotent: the same
+ * filename always yields the same ID). Intended for load time, not the
+ * playback path: it compares strings against all resolved sounds.
+ *
+ * @param provider Provider handle
+ * @param filename Path to WAV file
+ * @param[out] sound_id Sound ID (on success)
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if any parameter is NULL
+ *     - ESP_ERR_NO_MEM if the sound table is full
+ */
+esp_err_t audio_provider_resolve_sound(audio_provider_handle_t provider,
+                                const char *filename,
+                                audio_sound_id_t *sound_id);
+
+/**
+ * @brief Find the sound ID of an already resolved filename
+ *
+ * Same lookup as audio_provider_resolve_sound(), but never adds the filename
+ * to the sound table (names from the console or other untrusted sources).
+ *
+ * @param provider Provider handle
+ * @param filename Path to WAV file
+ * @param[out] sound_id Sound ID (on success)
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if any parameter is NULL
+ *     - ESP_ERR_NOT_FOUND if the filename was never resolved
+ */
+esp_err_t audio_provider_find_sound(audio_provider_handle_t provider,
+                                    const char *filename,
+                                    audio_sound_id_t *sound_id);
+
+/**
+ * @brief Open an audio stream from a resolved sound ID
+ *
+ * Same as audio_provider_open_stream(), but the cache entry and attack
+ * segment of the file are found by array indexing instead of filename
+ * comparison.
+ *
+ * @param provider Provider handle
+ * @param sound_id Sound ID from audio_provider_resolve_sound()
+ * @param[out] stream Stream handle (on success)
+ * @return Same as audio_provider_open_stream(); ESP_ERR_INVALID_ARG for an unknown ID
+ */
+esp_err_t audio_provider_open_sound(audio_provider_handle_t provider,
+                             audio_sound_id_t sound_id,
+                             audio_stream_handle_t *stream);
+
+/**
+ * @brief Get the filename of a resolved sound ID
+ *
+ * @param provider Provider handle
+ * @param sound_id Sound ID
+ * @return Interned filename (valid until deinit), or NULL for an unknown ID
+ */
+const char *audio_provider_get_sound_name(audio_provider_handle_t provider, audio_sound_id_t sound_id);
+
+/**
+ * @brief Replace the set of pinned sounds
+ *
+ * Used by page-aware eviction policies: sounds of the current page are
+ * never evicted, sounds of adjacent pages only when no other entry can be.
+ * Pinning does not load anything; it protects sounds once they are cached.
+ * Ignored by AUDIO_CACHE_POLICY_LRU.
+ *
+ * @param provider Provider handle
+ * @param current Sound IDs of the current page (can be NULL if current_count is 0)
+ * @param current_count Number of IDs in current
+ * @param neighbours Sound IDs of the adjacent pages (can be NULL if neighbour_count is 0)
+ * @param neighbour_count Number of IDs in neighbours
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if provider is NULL or an array is NULL with a non-zero count
+ */
+esp_err_t audio_provider_set_pins(audio_provider_handle_t provider,
+                           const audio_sound_id_t *current, size_t current_count,
+                           const audio_sound_id_t *neighbours, size_t neighbour_count);
+
+/**
+ * @brief Load the on-card WAV layout index (see sound_index.h)
+ *
+ * Once loaded, resolved sounds of the index directory open with one
+ * fopen() + fseek() instead of a header parse. Sounds the index does not
+ * list are parsed by the preload task in the background (after queued
+ * preloads and attack segments, never while files stream), and the index is
+ * written back once they are all known. Call once, before resolving the
+ * mapped sounds.
+ *
+ * @param provider Provider handle
+ * @param path Index file (e.g. "/sdcard/.sound_index"); files in its directory are indexed
+ * @return
+ *     - ESP_OK on success (also when the file is missing or invalid: it is rebuilt)
+ *     - ESP_ERR_INVALID_ARG if provider is NULL or path has no directory
+ *     - ESP_ERR_INVALID_STATE if an index is already loaded
+ *     - ESP_ERR_NO_MEM if the entry array could not be allocated
+ */
+esp_err_t audio_provider_load_index(audio_provider_handle_t provider, const char *path);
+
 /**
  * @brief Read PCM samples from a stream
  *
  * Fills the buffer with PCM data from cache or file. On EOF, returns ESP_OK
  * with *samples_read set to 0.
  *
+ * File streams with a read-ahead ring only copy from PSRAM. If the ring is
+ * empty before EOF (underrun), the buffer is filled with silence so that
+ * the output keeps its cadence, and the underrun is counted.
+ *
  * @param stream Stream handle
  * @param[out] buffer Output buffer for 16-bit PCM samples
  * @param buffer_samples Maximum number of samples to read
@@ -113,12 +274,42 @@ esp_err_t audio_provider_read_stream(audio_stream_handle_t stream,
                                size_t buffer_samples,
                                size_t *samples_read);
 
+/**
+ * @brief Read PCM samples from a cache-backed stream without copying
+ *
+ * Returns a pointer into the PSRAM cache entry and advances the stream
+ * position, like audio_provider_read_stream() but without the memcpy().
+ * The span stays valid until the stream is closed (the stream holds a
+ * reference on the cache entry, which prevents eviction). File streams
+ * started from the attack-segment cache return spans into the resident
+ * head until it is consumed.
+ *
+ * Other file-backed reads have no stable buffer and return
+ * ESP_ERR_NOT_SUPPORTED without consuming data: use
+ * audio_provider_read_stream() instead.
+ *
+ * @param stream Stream handle
+ * @param[out] samples Pointer to the first sample (NULL at EOF)
+ * @param max_samples Maximum number of samples to return
+ * @param[out] samples_read Number of samples in the span (0 at EOF)
+ * @return
+ *     - ESP_OK on success (including EOF)
+ *     - ESP_ERR_INVALID_ARG if any parameter is NULL
+ *     - ESP_ERR_INVALID_STATE if the stream encountered a previous error
+ *     - ESP_ERR_NOT_SUPPORTED if the stream is not cache-backed
+ */
+esp_err_t audio_provider_read_span(audio_stream_handle_t stream,
+                                   const int16_t **samples,
+                                   size_t max_samples,
+                                   size_t *samples_read);
+
 /**
  * @brief Close an audio stream and release its resources
  *
  * For cache-backed streams, decrements the cache entry reference count.
  * For file-backed streams, closes the file handle and resumes the preload
- * task if no other file streams remain active.
+ * task if no other file streams remain active. With read-ahead enabled,
+ * the file and ring are released asynchronously by the streamer task.
  *
  * @param stream Stream handle (NULL-safe, returns ESP_OK)
  * @return ESP_OK always
@@ -134,6 +325,16 @@ esp_err_t audio_provider_close_stream(audio_stream_handle_t stream);
  */
 const audio_info_t* audio_provider_get_stream_info(audio_stream_handle_t stream);
 
+/**
+ * @brief true if the stream is served by the PSRAM cache (open was a cache hit)
+ *
+ * Streams started from an attack segment or read from the SD card are
+ * cache misses.
+ *
+ * @param stream Stream handle (NULL-safe, returns false)
+ */
+bool audio_provider_stream_is_cached(audio_stream_handle_t stream);
+
 /**
  * @brief Get stream playback progress
  *
@@ -162,17 +363,178 @@ uint16_t audio_provider_get_stream_progress(audio_stream_handle_t stream);
  */
 esp_err_t audio_provider_preload(audio_provider_handle_t provider, const char *filename);
 
+/**
+ * @brief Queue a page sound bank for background cache loading
+ *
+ * The preload task reads the bank index, then copies the PCM span of every
+ * entry that is not cached yet straight into the cache arena with large
+ * sequential reads (see sound_bank.h). Entries whose source file size no
+ * longer matches the index are skipped, as are entries that do not fit once
+ * nothing evictable is left. A missing bank is not an error: queue the
+ * per-file preloads after the bank as a fallback.
+ *
+ * @param provider Provider handle
+ * @param bank_path Path to the bank file (e.g., "/sdcard/banks/default.bnk")
+ * @return Same as audio_provider_preload()
+ */
+esp_err_t audio_provider_preload_bank(audio_provider_handle_t provider, const char *bank_path);
+
+/**
+ * @brief Queue a speculative preload (file or bank of an adjacent page)
+ *
+ * Same as audio_provider_preload() / audio_provider_preload_bank(), but
+ * best effort: a full queue drops the request quietly (counted), and the
+ * files and bytes cached are reported apart. Queue prefetches after the
+ * current page's requests.
+ *
+ * @param provider Provider handle
+ * @param path Path to the WAV file or bank file
+ * @param bank true if path is a sound bank
+ * @return Same as audio_provider_preload()
+ */
+esp_err_t audio_provider_prefetch(audio_provider_handle_t provider, const char *path, bool bank);
+
+/**
+ * @brief Parse the WAV header of a file
+ *
+ * Used by the sound bank builder to record the same format parameters and
+ * PCM span as the cache would load. Both describe the file as stored
+ * (before the conversion to 16-bit, optionally mono, PCM).
+ *
+ * @param filename Path to WAV file
+ * @param[out] info Audio format parameters of the file
+ * @param[out] data_offset Offset of the PCM data in the file
+ * @param[out] data_size PCM bytes in the file (whole frames)
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the file cannot be opened, ESP_FAIL if not a supported WAV
+ */
+esp_err_t audio_provider_parse_wav_file(const char *filename, audio_info_t *info,
+                                        uint32_t *data_offset, uint32_t *data_size);
+
+/**
+ * @brief Register a file in the attack-segment cache
+ *
+ * The attack-segment cache is a second tier, budgeted separately from the
+ * PSRAM cache: it holds the WAV metadata and the first head_ms of PCM of
+ * each registered file, loaded in the background by the preload task when
+ * its queue is empty. Entries are never evicted.
+ *
+ * Opening a stream on a file that misses the PSRAM cache but has a resident
+ * head does not touch the filesystem: samples are served from the head while
+ * the streamer task opens the file and reads the remainder ahead.
+ *
+ * @param provider Provider handle
+ * @param filename Path to WAV file
+ * @return
+ *     - ESP_OK if registered (or already registered)
+ *     - ESP_ERR_INVALID_ARG if provider or filename is NULL
+ *     - ESP_ERR_NOT_SUPPORTED if the attack-segment cache is disabled
+ *     - ESP_ERR_NO_MEM if the attack-segment table is full
+ */
+esp_err_t audio_provider_register_head(audio_provider_handle_t provider, const char *filename);
+
 /**
  * @brief Flush the preload queue
  *
- * Discards all pending preload requests. Does not affect files already cached
- * or currently being loaded. Useful when switching pages to avoid loading
- * files from the previous page.
+ * Discards all pending preload requests. Does not affect files already cached.
+ * The load in flight stops at its next chunk if its sound is no longer pinned
+ * (audio_provider_set_pins(): set the new pins before flushing). Useful when
+ * switching pages to avoid loading files from the previous page.
+ *
+ * Also starts a warm-up measurement: the time until the preload queue drains
+ * again and the files/bytes cached meanwhile are logged and reported by
+ * audio_provider_print_status().
  *
  * @param provider Provider handle
  */
 void audio_provider_flush_preload_queue(audio_provider_handle_t provider);
 
+/**
+ * @brief Page warm-up measurement (see audio_provider_flush_preload_queue())
+ */
+typedef struct {
+    bool active;            /**< A warm-up window is open (preload queue not drained yet) */
+    uint32_t ms;            /**< Last completed warm-up that cached anything */
+    uint32_t files;
+    size_t bytes;
+    bool bank;              /**< Last warm-up loaded from a sound bank */
+    uint32_t count;         /**< Completed warm-ups that cached anything */
+} audio_provider_warmup_t;
+
+/**
+ * @brief Get the page warm-up state and last result
+ *
+ * @param provider Provider handle
+ * @param[out] warmup Warm-up state
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG
+ */
+esp_err_t audio_provider_get_warmup(audio_provider_handle_t provider, audio_provider_warmup_t *warmup);
+
+/**
+ * @brief Preload scheduler counters (since boot)
+ */
+typedef struct {
+    uint32_t queue_depth;       /**< Requests queued now */
+    bool idle;                  /**< Preload task waiting: nothing queued, loading, or pending (heads, index) */
+    uint32_t queue_peak;        /**< Most requests queued at once */
+    uint32_t flushed;           /**< Queued requests dropped by a flush */
+    uint32_t cancelled;         /**< Loads stopped in flight because their page was left */
+    uint32_t prefetch_dropped;  /**< Prefetch requests dropped (queue full) */
+    uint32_t files;             /**< Files cached by the preload task (files and banks) */
+    size_t bytes;
+    uint32_t prefetch_files;    /**< Of which from audio_provider_prefetch() */
+    size_t prefetch_bytes;
+    uint32_t throttle_ms;       /**< Time the preload task left the SD card to file streams */
+    uint8_t share;              /**< SD time share while files stream, percent (0 = pause) */
+} audio_provider_preload_stats_t;
+
+/**
+ * @brief Get the preload scheduler counters
+ *
+ * @param provider Provider handle
+ * @param[out] stats Counters
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG
+ */
+esp_err_t audio_provider_get_preload_stats(audio_provider_handle_t provider,
+                                           audio_provider_preload_stats_t *stats);
+
+/**
+ * @brief Cache open and eviction counters (since boot)
+ */
+typedef struct {
+    uint32_t cache_hits;            /**< Opens served by the PSRAM cache */
+    uint32_t head_hits;             /**< Cache misses started from a resident attack segment */
+    uint32_t cold_misses;           /**< Cache misses without head (fopen + parse on press) */
+    uint32_t reload_misses;         /**< Misses on sounds that had been cached and evicted */
+    uint32_t evictions;             /**< Cache entries evicted (any reason) */
+    uint32_t neighbour_evictions;   /**< Of which sounds pinned for an adjacent page */
+    uint32_t header_parses;         /**< WAV headers parsed */
+    uint32_t index_opens;           /**< Opens that skipped the header parse (sound index) */
+    size_t used_bytes;              /**< Cache arena bytes in use */
+    size_t max_bytes;               /**< Cache arena size */
+} audio_provider_cache_stats_t;
+
+/**
+ * @brief Get the cache open and eviction counters
+ *
+ * @param provider Provider handle
+ * @param[out] stats Counters
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG
+ */
+esp_err_t audio_provider_get_cache_stats(audio_provider_handle_t provider,
+                                         audio_provider_cache_stats_t *stats);
+
+/**
+ * @brief Free every cache entry not used by a stream (cold-cache benchmarks)
+ *
+ * Runs in the preload task after the requests already queued and blocks
+ * until done. Entries are dropped regardless of page pins; attack segments
+ * stay resident.
+ *
+ * @param provider Provider handle
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM, or ESP_ERR_TIMEOUT
+ */
+esp_err_t audio_provider_purge_cache(audio_provider_handle_t provider);
+
 /**
  * @brief Print audio provider status information to console
  *
@@ -0,0 +1,225 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file resampler.c
+ * @brief Streaming polyphase sample-rate converter
+ *
+ * The line buffer holds the source frames still needed by the filter,
+ * starting taps / 2 - 1 frames of silence ahead of the first source frame
+ * so that output frame 0 is centered on source frame 0. Consumed frames
+ * are dropped (memmove) before new input is accepted.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "resampler.h"
+
+#define RESAMPLER_PHASE_SHIFT   25      // Q32 fraction -> phase index (128 phases)
+#define RESAMPLER_CUTOFF        0.45f   // Sinc cutoff, fraction of the source rate
+#define Q15_ONE                 32768
+
+struct resampler_kernel_s {
+    uint8_t taps;
+    int16_t coeffs[];                   // [RESAMPLER_PHASES][taps], Q15, each phase sums to 1.0
+};
+
+struct resampler_s {
+    const resampler_kernel_t *kernel;
+    uint16_t channels;
+    uint64_t step;                      // Source frames per output frame (Q32)
+    uint64_t pos;                       // Next output position in buf (Q32, first tap)
+    size_t filled;                      // Frames in buf
+    size_t capacity;                    // Frames buf can hold
+    bool finished;                      // Source ended: pad with silence
+    int16_t buf[];                      // capacity * channels samples
+};
+
+_Static_assert((1u << (32 - RESAMPLER_PHASE_SHIFT)) == RESAMPLER_PHASES, "phase shift mismatch");
+
+static float kernel_tap(uint8_t taps, float d)
+{
+    float half = (float)taps / 2.0f;
+    if (taps == RESAMPLER_TAPS_LINEAR) {
+        float a = fabsf(d);
+        return a < 1.0f ? 1.0f - a : 0.0f;
+    }
+    if (fabsf(d) >= half) {
+        return 0.0f;
+    }
+    float x = 2.0f * RESAMPLER_CUTOFF * d;
+    float sinc = (fabsf(x) < 1e-6f) ? 1.0f : sinf((float)M_PI * x) / ((float)M_PI * x);
+    float w = 0.42f + 0.5f * cosf((float)M_PI * d / half) + 0.08f * cosf(2.0f * (float)M_PI * d / half);
+    return sinc * w;
+}
+
+esp_err_t resampler_kernel_create(uint8_t taps, resampler_kernel_t **kernel)
+{
+    if (kernel == NULL || (taps != RESAMPLER_TAPS_LINEAR && taps != RESAMPLER_TAPS_SINC)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t bytes = sizeof(resampler_kernel_t) + (size_t)RESAMPLER_PHASES * taps * sizeof(int16_t);
+    resampler_kernel_t *k = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (k == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    k->taps = taps;
+
+    // Output position of phase p: taps / 2 - 1 + p / PHASES (in line buffer frames)
+    float center = (float)(taps / 2 - 1);
+    for (int p = 0; p < RESAMPLER_PHASES; p++) {
+        float h[RESAMPLER_TAPS_SINC];
+        float sum = 0.0f;
+        for (int t = 0; t < taps; t++) {
+            h[t] = kernel_tap(taps, (float)t - center - (float)p / RESAMPLER_PHASES);
+            sum += h[t];
+        }
+
+        // Quantize, then put the rounding error on the largest tap (unity DC gain)
+        int16_t *c = &k->coeffs[p * taps];
+        int32_t total = 0;
+        int largest = 0;
+        for (int t = 0; t < taps; t++) {
+            c[t] = (int16_t)lrintf(h[t] / sum * (Q15_ONE - 1));
+            total += c[t];
+            if (abs(c[t]) > abs(c[largest])) {
+                largest = t;
+            }
+        }
+        c[largest] = (int16_t)(c[largest] + (Q15_ONE - 1) - total);
+    }
+
+    *kernel = k;
+    return ESP_OK;
+}
+
+void resampler_kernel_destroy(resampler_kernel_t *kernel)
+{
+    heap_caps_free(kernel);
+}
+
+uint8_t resampler_kernel_taps(const resampler_kernel_t *kernel)
+{
+    return kernel->taps;
+}
+
+uint32_t resampler_output_frames(uint32_t in_frames, uint32_t in_rate, uint32_t out_rate)
+{
+    if (in_rate == 0) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)in_frames * out_rate / in_rate);
+}
+
+esp_err_t resampler_create(const resampler_kernel_t *kernel, uint32_t in_rate, uint32_t out_rate,
+                           uint16_t channels, resampler_t **resampler)
+{
+    if (kernel == NULL || resampler == NULL || in_rate == 0 || out_rate == 0 || channels == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t capacity = RESAMPLER_BLOCK_FRAMES + kernel->taps;
+    size_t bytes = sizeof(resampler_t) + capacity * channels * sizeof(int16_t);
+    resampler_t *r = heap_caps_calloc(1, bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (r == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    r->kernel = kernel;
+    r->channels = channels;
+    r->step = ((uint64_t)in_rate << 32) / out_rate;
+    r->capacity = capacity;
+    r->filled = kernel->taps / 2 - 1;   // Leading silence (calloc)
+
+    *resampler = r;
+    return ESP_OK;
+}
+
+void resampler_destroy(resampler_t *resampler)
+{
+    heap_caps_free(resampler);
+}
+
+// Drop frames before the current position
+static void resampler_compact(resampler_t *r)
+{
+    size_t drop = (size_t)(r->pos >> 32);
+    if (drop == 0) {
+        return;
+    }
+    if (drop > r->filled) {
+        drop = r->filled;
+    }
+    size_t keep = r->filled - drop;
+    memmove(r->buf, r->buf + drop * r->channels, keep * r->channels * sizeof(int16_t));
+    r->filled = keep;
+    r->pos -= (uint64_t)drop << 32;
+}
+
+int16_t *resampler_input(resampler_t *resampler, size_t *frames)
+{
+    resampler_compact(resampler);
+    *frames = resampler->finished ? 0 : resampler->capacity - resampler->filled;
+    return resampler->buf + resampler->filled * resampler->channels;
+}
+
+void resampler_commit(resampler_t *resampler, size_t frames)
+{
+    resampler->filled += frames;
+}
+
+void resampler_finish(resampler_t *resampler)
+{
+    resampler->finished = true;
+}
+
+bool resampler_finished(const resampler_t *resampler)
+{
+    return resampler->finished;
+}
+
+size_t resampler_output(resampler_t *resampler, int16_t *out, size_t frames)
+{
+    resampler_t *r = resampler;
+    const uint8_t taps = r->kernel->taps;
+    const uint16_t ch = r->channels;
+    size_t produced = 0;
+
+    while (produced < frames) {
+        size_t idx = (size_t)(r->pos >> 32);
+        if (idx + taps > r->filled) {
+            if (!r->finished) {
+                break;
+            }
+            // Source ended: pad with silence so the tail has its look-ahead
+            resampler_compact(r);
+            idx = (size_t)(r->pos >> 32);
+            size_t need = idx + taps;
+            if (need > r->capacity) {
+                break;
+            }
+            memset(r->buf + r->filled * ch, 0, (need - r->filled) * ch * sizeof(int16_t));
+            r->filled = need;
+        }
+
+        const int16_t *c = &r->kernel->coeffs[((uint32_t)r->pos >> RESAMPLER_PHASE_SHIFT) * taps];
+        const int16_t *x = r->buf + idx * ch;
+        for (uint16_t k = 0; k < ch; k++) {
+            int32_t acc = 0;
+            for (uint8_t t = 0; t < taps; t++) {
+                acc += (int32_t)c[t] * x[t * ch + k];
+            }
+            acc = (acc + (1 << 14)) >> 15;
+            *out++ = (int16_t)(acc > INT16_MAX ? INT16_MAX : (acc < INT16_MIN ? INT16_MIN : acc));
+        }
+        r->pos += r->step;
+        produced++;
+    }
+
+    return produced;
+}
@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file resampler.h
+ * @brief Streaming sample-rate converter (polyphase FIR, 16-bit PCM)
+ *
+ * Converts interleaved 16-bit PCM from a source rate to a fixed output rate.
+ * The position in the input advances by in_rate / out_rate per output frame
+ * (Q32 fixed point); each output frame is the dot product of `taps` input
+ * frames with one of RESAMPLER_PHASES pre-computed Q15 filter phases.
+ *
+ * The kernel (coefficient table) is built once and shared read-only by all
+ * resamplers. A 2-tap kernel is linear interpolation; the windowed-sinc
+ * kernel has its cutoff at 0.45 of the source rate, which suits upsampling
+ * (the usual case: 16 / 22.05 / 44.1 kHz sources to 48 kHz). Sources above
+ * the output rate are converted without extra anti-alias filtering.
+ *
+ * Usage: resampler_input() / resampler_commit() to append source frames,
+ * resampler_finish() at end of source, resampler_output() to produce frames.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define RESAMPLER_PHASES        128     // Filter phases (fractional position resolution)
+#define RESAMPLER_TAPS_LINEAR   2
+#define RESAMPLER_TAPS_SINC     16
+#define RESAMPLER_BLOCK_FRAMES  256     // Source frames buffered per refill
+
+/**
+ * @brief Shared filter coefficients (opaque)
+ */
+typedef struct resampler_kernel_s resampler_kernel_t;
+
+/**
+ * @brief Per-stream converter state (opaque)
+ */
+typedef struct resampler_s resampler_t;
+
+/**
+ * @brief Build a kernel
+ *
+ * @param taps RESAMPLER_TAPS_LINEAR or RESAMPLER_TAPS_SINC
+ * @param[out] kernel Kernel (on success)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, or ESP_ERR_NO_MEM
+ */
+esp_err_t resampler_kernel_create(uint8_t taps, resampler_kernel_t **kernel);
+
+/**
+ * @brief Free a kernel (NULL-safe). No resampler may still use it.
+ */
+void resampler_kernel_destroy(resampler_kernel_t *kernel);
+
+/**
+ * @brief Number of taps of a kernel
+ */
+uint8_t resampler_kernel_taps(const resampler_kernel_t *kernel);
+
+/**
+ * @brief Output length of a source of in_frames frames
+ */
+uint32_t resampler_output_frames(uint32_t in_frames, uint32_t in_rate, uint32_t out_rate);
+
+/**
+ * @brief Create a converter (internal RAM)
+ *
+ * @param kernel Shared kernel (must outlive the resampler)
+ * @param in_rate Source rate in Hz
+ * @param out_rate Output rate in Hz
+ * @param channels Interleaved channels
+ * @param[out] resampler Converter (on success)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, or ESP_ERR_NO_MEM
+ */
+esp_err_t resampler_create(const resampler_kernel_t *kernel, uint32_t in_rate, uint32_t out_rate,
+                           uint16_t channels, resampler_t **resampler);
+
+/**
+ * @brief Free a converter (NULL-safe)
+ */
+void resampler_destroy(resampler_t *resampler);
+
+/**
+ * @brief Free space for source frames
+ *
+ * @param resampler Converter
+ * @param[out] frames Frames that can be written at the returned pointer (0 when full or finished)
+ * @return Write position in the internal line buffer
+ */
+int16_t *resampler_input(resampler_t *resampler, size_t *frames);
+
+/**
+ * @brief Append frames written at the pointer returned by resampler_input()
+ */
+void resampler_commit(resampler_t *resampler, size_t frames);
+
+/**
+ * @brief Mark the end of the source (the tail is flushed with silence)
+ */
+void resampler_finish(resampler_t *resampler);
+
+/**
+ * @brief true once the source is finished (no more input accepted)
+ */
+bool resampler_finished(const resampler_t *resampler);
+
+/**
+ * @brief Produce output frames from the buffered source
+ *
+ * After resampler_finish() the source is padded with silence indefinitely:
+ * callers stop at resampler_output_frames() of the source length.
+ *
+ * @param resampler Converter
+ * @param out Interleaved output (frames * channels samples)
+ * @param frames Frames wanted
+ * @return Frames produced; fewer than wanted means more input is needed
+ */
+size_t resampler_output(resampler_t *resampler, int16_t *out, size_t frames);
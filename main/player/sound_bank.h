@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file sound_bank.h
+ * @brief On-card sound bank image format (one file per mapping page)
+ *
+ * A bank holds the cache data of every file of one page back to back, so the
+ * preload task can warm the cache with a few large sequential reads instead
+ * of one fopen() + header parse per file. Banks are built by the MSC update
+ * flow under <sdcard>/banks/ and are only an accelerator: entries whose
+ * source file changed are skipped, and the per-file preload still runs.
+ *
+ * Spans are stored in the cache sample format (see codec.h) so that loading
+ * is a plain copy; a bank built for another cache format is skipped.
+ *
+ * Layout (little-endian, every PCM span starts on a SOUND_BANK_ALIGN boundary):
+ *
+ *   sound_bank_header_t
+ *   sound_bank_entry_t[entry_count]
+ *   padding to header.data_offset
+ *   Data span of entry 0, padding, data span of entry 1, ...
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <string.h>
+#include "provider.h"
+#include "soundboard.h"
+
+#define SOUND_BANK_MAGIC        0x4B4E4253u  // "SBNK"
+#define SOUND_BANK_VERSION      3
+#define SOUND_BANK_ALIGN        512          // SD sector size
+#define SOUND_BANK_MAX_ENTRIES  64           // Sanity bound on entry_count
+#define SOUND_BANK_DIR          "banks"
+#define SOUND_BANK_EXT          ".bnk"
+
+/**
+ * @brief Bank file header
+ */
+typedef struct {
+    uint32_t magic;          // SOUND_BANK_MAGIC
+    uint16_t version;        // SOUND_BANK_VERSION
+    uint16_t entry_size;     // sizeof(sound_bank_entry_t) at build time
+    uint32_t entry_count;    // Entries in the index
+    uint32_t data_offset;    // Offset of the first data span (header + index, padded)
+} sound_bank_header_t;
+
+/**
+ * @brief Bank index entry (one per source file)
+ */
+typedef struct {
+    char filename[SOUNDBOARD_MAX_PATH_LEN]; // Absolute path of the source WAV (cache key)
+    uint32_t source_size;    // Source file size at build time (staleness check)
+    uint32_t offset;         // Data span offset in the bank (SOUND_BANK_ALIGN multiple)
+    uint32_t size;           // Data span size in bytes (unpadded, encoded)
+    uint32_t format;         // audio_cache_format_t of the span
+    audio_info_t info;       // Audio format parameters of the span (16-bit, cache channels and rate)
+} sound_bank_entry_t;
+
+/**
+ * @brief Round a bank offset up to the next SOUND_BANK_ALIGN boundary
+ */
+static inline uint32_t sound_bank_align(uint32_t offset)
+{
+    return (offset + SOUND_BANK_ALIGN - 1) & ~(uint32_t)(SOUND_BANK_ALIGN - 1);
+}
+
+/**
+ * @brief Build the bank path of a page: <root>/banks/<page_id>.bnk
+ *
+ * Characters of page_id that are not alphanumeric, '-' or '_' are replaced
+ * by '_' so that any page ID maps to a valid FAT filename.
+ */
+static inline void sound_bank_path(char *dest, size_t size, const char *root, const char *page_id)
+{
+    int n = snprintf(dest, size, "%s/" SOUND_BANK_DIR "/", root);
+    if (n < 0 || (size_t)n >= size) {
+        dest[0] = '\0';
+        return;
+    }
+    size_t pos = (size_t)n;
+    for (const char *p = page_id; *p != '\0' && pos + 1 < size; p++) {
+        char c = *p;
+        dest[pos++] = (isalnum((unsigned char)c) || c == '-' || c == '_') ? c : '_';
+    }
+    dest[pos] = '\0';
+    if (pos + sizeof(SOUND_BANK_EXT) > size) {
+        dest[0] = '\0';
+        return;
+    }
+    memcpy(dest + pos, SOUND_BANK_EXT, sizeof(SOUND_BANK_EXT));
+}
@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file sound_index.c
+ * @brief On-card WAV layout index
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "sound_index.h"
+
+#define SOUND_INDEX_TMP_SUFFIX ".tmp"
+
+#define FNV_OFFSET_BASIS    2166136261u
+#define FNV_PRIME           16777619u
+
+static const char *TAG = "sound_index";
+
+static uint32_t fnv1a(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    uint32_t h = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ p[i]) * FNV_PRIME;
+    }
+    return h;
+}
+
+/**
+ * @brief Position of path: its entry, or where it would be inserted
+ */
+static int index_position(const sound_index_t *index, const char *path, bool *found)
+{
+    int lo = 0;
+    int hi = index->count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(path, index->entries[mid].path);
+        if (cmp == 0) {
+            *found = true;
+            return mid;
+        }
+        if (cmp < 0) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    *found = false;
+    return lo;
+}
+
+esp_err_t sound_index_load(const char *path, sound_index_t *index)
+{
+    index->count = 0;
+    index->changed = false;
+    index->entries = heap_caps_calloc(SOUND_INDEX_MAX_ENTRIES, sizeof(sound_index_entry_t),
+                                      MALLOC_CAP_SPIRAM);
+    if (index->entries == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        ESP_LOGI(TAG, "No sound index at %s: headers parsed on first use", path);
+        return ESP_OK;
+    }
+
+    sound_index_header_t hdr;
+    bool valid = (fread(&hdr, sizeof(hdr), 1, fp) == 1 &&
+                  hdr.magic == SOUND_INDEX_MAGIC && hdr.version == SOUND_INDEX_VERSION &&
+                  hdr.entry_size == sizeof(sound_index_entry_t) &&
+                  hdr.entry_count <= SOUND_INDEX_MAX_ENTRIES);
+    if (valid && hdr.entry_count > 0) {
+        valid = (fread(index->entries, sizeof(sound_index_entry_t), hdr.entry_count, fp) == hdr.entry_count &&
+                 fnv1a(index->entries, hdr.entry_count * sizeof(sound_index_entry_t)) == hdr.entries_hash);
+    }
+    fclose(fp);
+
+    if (!valid) {
+        ESP_LOGW(TAG, "Ignoring sound index %s (other version or corrupt)", path);
+        memset(index->entries, 0, SOUND_INDEX_MAX_ENTRIES * sizeof(sound_index_entry_t));
+        index->changed = true;      // Rewritten once refilled
+        return ESP_OK;
+    }
+
+    index->count = (int)hdr.entry_count;
+    ESP_LOGI(TAG, "Loaded sound index: %d entries", index->count);
+    return ESP_OK;
+}
+
+void sound_index_free(sound_index_t *index)
+{
+    heap_caps_free(index->entries);
+    index->entries = NULL;
+    index->count = 0;
+    index->changed = false;
+}
+
+const sound_index_entry_t *sound_index_find(const sound_index_t *index, const char *path)
+{
+    bool found;
+    int pos = index_position(index, path, &found);
+    return found ? &index->entries[pos] : NULL;
+}
+
+esp_err_t sound_index_set(sound_index_t *index, const char *path, const sound_index_meta_t *meta)
+{
+    if (strlen(path) >= SOUNDBOARD_MAX_PATH_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool found;
+    int pos = index_position(index, path, &found);
+    if (!found) {
+        if (index->count >= SOUND_INDEX_MAX_ENTRIES) {
+            return ESP_ERR_NO_MEM;
+        }
+        memmove(&index->entries[pos + 1], &index->entries[pos],
+                (size_t)(index->count - pos) * sizeof(sound_index_entry_t));
+        index->count++;
+        memset(&index->entries[pos], 0, sizeof(sound_index_entry_t));
+        strcpy(index->entries[pos].path, path);
+    } else if (memcmp(&index->entries[pos].meta, meta, sizeof(*meta)) == 0) {
+        return ESP_OK;
+    }
+    index->entries[pos].meta = *meta;
+    index->changed = true;
+    return ESP_OK;
+}
+
+void sound_index_drop(sound_index_t *index, const char *path)
+{
+    bool found;
+    int pos = index_position(index, path, &found);
+    if (!found) {
+        return;
+    }
+    index->count--;
+    memmove(&index->entries[pos], &index->entries[pos + 1],
+            (size_t)(index->count - pos) * sizeof(sound_index_entry_t));
+    index->changed = true;
+}
+
+esp_err_t sound_index_save(const char *path, sound_index_t *index)
+{
+    char tmp_path[SOUNDBOARD_MAX_PATH_LEN + sizeof(SOUND_INDEX_TMP_SUFFIX)];
+    snprintf(tmp_path, sizeof(tmp_path), "%s" SOUND_INDEX_TMP_SUFFIX, path);
+
+    FILE *fp = fopen(tmp_path, "wb");
+    if (fp == NULL) {
+        ESP_LOGE(TAG, "Failed to create %s", tmp_path);
+        return ESP_FAIL;
+    }
+
+    size_t body_size = (size_t)index->count * sizeof(sound_index_entry_t);
+    sound_index_header_t hdr = {
+        .magic = SOUND_INDEX_MAGIC,
+        .version = SOUND_INDEX_VERSION,
+        .entry_size = sizeof(sound_index_entry_t),
+        .entry_count = (uint32_t)index->count,
+        .entries_hash = fnv1a(index->entries, body_size),
+    };
+    bool ok = (fwrite(&hdr, sizeof(hdr), 1, fp) == 1) &&
+              (index->count == 0 ||
+               fwrite(index->entries, sizeof(sound_index_entry_t), index->count, fp) == (size_t)index->count);
+    ok = (fclose(fp) == 0) && ok;
+    if (ok) {
+        remove(path);
+        ok = (rename(tmp_path, path) == 0);
+    }
+    if (!ok) {
+        ESP_LOGE(TAG, "Failed to write sound index %s", path);
+        remove(tmp_path);
+        return ESP_FAIL;
+    }
+
+    index->changed = false;
+    ESP_LOGI(TAG, "Sound index written: %d entries", index->count);
+    return ESP_OK;
+}
@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file sound_index.h
+ * @brief On-card index of the WAV layout of every known sound
+ *
+ * Records, per file, the format parameters and PCM span found by the WAV
+ * header parser, so that the provider opens a stream (or loads the cache)
+ * with one fopen() + fseek() instead of a dozen small reads and seeks over
+ * SPI. The provider fills it in the background once the mappings are
+ * resolved and keeps it next to the mappings file; the MSC updater drops
+ * the entries of every file it rewrites or deletes. The file size is kept
+ * as a cheap staleness check (fstat() of the open file, no card access).
+ *
+ * Layout (little-endian):
+ *
+ *   sound_index_header_t
+ *   sound_index_entry_t[entry_count], sorted by path
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "provider.h"
+#include "soundboard.h"
+
+#define SOUND_INDEX_FILENAME    ".sound_index"
+#define SOUND_INDEX_MAGIC       0x58444953u  // "SIDX"
+#define SOUND_INDEX_VERSION     1
+#define SOUND_INDEX_MAX_ENTRIES 512          // Files known across all mappings / syncs
+
+/**
+ * @brief Index file header
+ */
+typedef struct {
+    uint32_t magic;          // SOUND_INDEX_MAGIC
+    uint16_t version;        // SOUND_INDEX_VERSION
+    uint16_t entry_size;     // sizeof(sound_index_entry_t) at write time
+    uint32_t entry_count;
+    uint32_t entries_hash;   // FNV-1a of the entry array
+} sound_index_header_t;
+
+/**
+ * @brief WAV layout of one file
+ */
+typedef struct {
+    audio_info_t info;       // Format parameters (of the source PCM)
+    uint32_t data_offset;    // Offset of the PCM data in the file
+    uint32_t data_size;      // Size of the data chunk in bytes
+    uint32_t file_size;      // File size when parsed (staleness check)
+} sound_index_meta_t;
+
+/**
+ * @brief Index entry (one per file)
+ */
+typedef struct {
+    char path[SOUNDBOARD_MAX_PATH_LEN];  // Absolute path, as resolved by the provider
+    sound_index_meta_t meta;
+} sound_index_entry_t;
+
+/**
+ * @brief Index loaded in memory (entries sorted by path)
+ */
+typedef struct {
+    sound_index_entry_t *entries;   // PSRAM, SOUND_INDEX_MAX_ENTRIES
+    int count;
+    bool changed;                   // Modified since loaded / saved
+} sound_index_t;
+
+/**
+ * @brief Load an index
+ *
+ * A missing file, or one of another version, size or hash, loads as an
+ * empty index (every header is parsed again).
+ *
+ * @return
+ *     - ESP_OK (possibly empty)
+ *     - ESP_ERR_NO_MEM if the entry array could not be allocated
+ */
+esp_err_t sound_index_load(const char *path, sound_index_t *index);
+
+/**
+ * @brief Free the entries of a loaded index
+ */
+void sound_index_free(sound_index_t *index);
+
+/**
+ * @brief Find the entry of a path (binary search)
+ *
+ * @return Entry, or NULL if the path is not indexed
+ */
+const sound_index_entry_t *sound_index_find(const sound_index_t *index, const char *path);
+
+/**
+ * @brief Add or replace the entry of a path
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if the path is too long, ESP_ERR_NO_MEM if the index is full
+ */
+esp_err_t sound_index_set(sound_index_t *index, const char *path, const sound_index_meta_t *meta);
+
+/**
+ * @brief Remove the entry of a path (no-op if it is not indexed)
+ */
+void sound_index_drop(sound_index_t *index, const char *path);
+
+/**
+ * @brief Write an index: <path>.tmp renamed over path on success
+ *
+ * Clears index->changed on success.
+ *
+ * @return ESP_OK, or ESP_FAIL if a write or the rename failed
+ */
+esp_err_t sound_index_save(const char *path, sound_index_t *index);
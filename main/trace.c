@@ -0,0 +1,208 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "trace.h"
+#include "freertos/FreeRTOS.h"  // IWYU pragma: keep
+#include "freertos/task.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <inttypes.h>
+#include <string.h>
+
+#define TRACE_FORMAT_VERSION    1
+#define TRACE_MIN_RECORDS       64
+#define TRACE_TASK_SLACK        4       // Tasks created between count and snapshot
+
+/**
+ * @brief One recorded event (20 bytes)
+ */
+typedef struct {
+    uint32_t t_us;          // esp_timer time, low 32 bits (span: start)
+    uint32_t dur_us;        // Span duration (0 for instant events)
+    uint32_t task;          // TaskHandle_t of the recording task
+    uint32_t b;
+    uint16_t a;
+    uint8_t event;          // trace_event_t
+    uint8_t core;
+} trace_record_t;
+
+static const struct {
+    const char *name;
+    const char *category;
+    bool span;
+    const char *a_name;
+    const char *b_name;
+} events[TRACE_EVENT_COUNT] = {
+    [TRACE_INPUT_EVENT]   = { "input",        "input",    false, "button",  "event" },
+    [TRACE_MAPPER_ACTION] = { "action",       "mapper",   false, "button",  "action" },
+    [TRACE_MAPPER_PAGE]   = { "page",         "mapper",   false, "page",    "" },
+    [TRACE_PLAYER_CMD]    = { "cmd",          "player",   false, "sound",   "cmd" },
+    [TRACE_PLAYER_WRITE]  = { "i2s_write",    "player",   true,  "voices",  "bytes" },
+    [TRACE_PLAYER_EOF]    = { "eof",          "player",   false, "sound",   "voice" },
+    [TRACE_OPEN_HIT]      = { "open_hit",     "provider", false, "sound",   "" },
+    [TRACE_OPEN_HEAD]     = { "open_head",    "provider", false, "sound",   "" },
+    [TRACE_OPEN_MISS]     = { "open_miss",    "provider", false, "sound",   "" },
+    [TRACE_PRELOAD]       = { "preload",      "provider", true,  "sound",   "err" },
+    [TRACE_EVICT]         = { "evict",        "provider", false, "sound",   "kb" },
+    [TRACE_UNDERRUN]      = { "underrun",     "provider", false, "sound",   "" },
+    [TRACE_MSC_STATE]     = { "msc_state",    "msc",      false, "state",   "event" },
+    [TRACE_MSC_COPY]      = { "copy",         "msc",      true,  "kb",      "err" },
+};
+
+static const char *TAG = "trace";
+
+static trace_record_t *s_ring = NULL;   // PSRAM, s_mask + 1 records
+static uint32_t s_mask = 0;
+static uint32_t s_head = 0;             // Records taken since init or clear (__atomic)
+static bool s_enabled = false;          // __atomic
+
+static inline void trace_put(trace_event_t event, uint32_t t_us, uint32_t dur_us, uint16_t a, uint32_t b)
+{
+    if (!__atomic_load_n(&s_enabled, __ATOMIC_RELAXED)) {
+        return;
+    }
+    uint32_t idx = __atomic_fetch_add(&s_head, 1, __ATOMIC_RELAXED);
+    trace_record_t *r = &s_ring[idx & s_mask];
+    r->t_us = t_us;
+    r->dur_us = dur_us;
+    r->task = (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+    r->b = b;
+    r->a = a;
+    r->event = (uint8_t)event;
+    r->core = (uint8_t)esp_cpu_get_core_id();
+}
+
+esp_err_t trace_init(size_t buffer_kb)
+{
+    if (s_ring != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    size_t records = buffer_kb * 1024 / sizeof(trace_record_t);
+    if (records < TRACE_MIN_RECORDS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    records = (size_t)1 << (31 - __builtin_clz((uint32_t)records));
+
+    s_ring = heap_caps_calloc(records, sizeof(trace_record_t), MALLOC_CAP_SPIRAM);
+    if (s_ring == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate %zu KB trace ring", records * sizeof(trace_record_t) / 1024);
+        return ESP_ERR_NO_MEM;
+    }
+    s_mask = (uint32_t)records - 1;
+    __atomic_store_n(&s_enabled, true, __ATOMIC_RELEASE);
+    ESP_LOGI(TAG, "Trace ring: %zu events (%zu KB PSRAM)", records, records * sizeof(trace_record_t) / 1024);
+    return ESP_OK;
+}
+
+void trace_event(trace_event_t event, uint16_t a, uint32_t b)
+{
+    trace_put(event, (uint32_t)esp_timer_get_time(), 0, a, b);
+}
+
+void trace_span(trace_event_t event, int64_t start_us, uint16_t a, uint32_t b)
+{
+    int64_t now = esp_timer_get_time();
+    trace_put(event, (uint32_t)start_us, (uint32_t)(now - start_us), a, b);
+}
+
+void trace_set_enabled(bool enabled)
+{
+    if (s_ring != NULL) {
+        __atomic_store_n(&s_enabled, enabled, __ATOMIC_RELEASE);
+    }
+}
+
+void trace_clear(void)
+{
+    bool was_enabled = __atomic_exchange_n(&s_enabled, false, __ATOMIC_ACQ_REL);
+    vTaskDelay(1);      // Let records in progress complete
+    __atomic_store_n(&s_head, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&s_enabled, was_enabled, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Write the names of the live tasks (records carry task handles)
+ */
+static bool dump_tasks(FILE *out)
+{
+    UBaseType_t capacity = uxTaskGetNumberOfTasks() + TRACE_TASK_SLACK;
+    TaskStatus_t *tasks = pvPortMalloc(capacity * sizeof(TaskStatus_t));
+    if (tasks == NULL) {
+        return true;        // Handles only: the converter names tasks by handle
+    }
+    UBaseType_t count = uxTaskGetSystemState(tasks, capacity, NULL);
+    bool ok = true;
+    for (UBaseType_t i = 0; i < count && ok; i++) {
+        ok = fprintf(out, "task,%08" PRIx32 ",%s\n",
+                     (uint32_t)(uintptr_t)tasks[i].xHandle, tasks[i].pcTaskName) >= 0;
+    }
+    vPortFree(tasks);
+    return ok;
+}
+
+esp_err_t trace_dump(FILE *out)
+{
+    if (s_ring == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    bool was_enabled = __atomic_exchange_n(&s_enabled, false, __ATOMIC_ACQ_REL);
+    vTaskDelay(1);      // Let records in progress complete
+
+    uint32_t head = __atomic_load_n(&s_head, __ATOMIC_ACQUIRE);
+    uint32_t capacity = s_mask + 1;
+    uint32_t count = (head < capacity) ? head : capacity;
+
+    bool ok = fprintf(out, "# soundboard trace %d\n", TRACE_FORMAT_VERSION) >= 0;
+    ok = ok && dump_tasks(out);
+    for (int e = 0; e < TRACE_EVENT_COUNT && ok; e++) {
+        ok = fprintf(out, "event,%d,%s,%s,%c,%s,%s\n", e, events[e].name, events[e].category,
+                     events[e].span ? 'X' : 'i', events[e].a_name, events[e].b_name) >= 0;
+    }
+    for (uint32_t i = head - count; i != head && ok; i++) {
+        const trace_record_t *r = &s_ring[i & s_mask];
+        ok = fprintf(out, "rec,%" PRIu32 ",%" PRIu32 ",%u,%08" PRIx32 ",%u,%u,%" PRIu32 "\n",
+                     r->t_us, r->dur_us, (unsigned int)r->core, r->task,
+                     (unsigned int)r->event, (unsigned int)r->a, r->b) >= 0;
+    }
+    ok = ok && fprintf(out, "# end: %" PRIu32 " events, %" PRIu32 " overwritten\n",
+                       count, head - count) >= 0;
+
+    __atomic_store_n(&s_enabled, was_enabled, __ATOMIC_RELEASE);
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+void trace_print_status(status_output_type_t output_type)
+{
+    if (s_ring == NULL) {
+        if (output_type == STATUS_OUTPUT_COMPACT) {
+            printf("[trace] not initialized\n");
+        } else {
+            printf("Trace Status:\n");
+            printf("  State: Not initialized\n");
+        }
+        return;
+    }
+
+    bool enabled = __atomic_load_n(&s_enabled, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&s_head, __ATOMIC_RELAXED);
+    uint32_t capacity = s_mask + 1;
+    uint32_t held = (head < capacity) ? head : capacity;
+
+    if (output_type == STATUS_OUTPUT_COMPACT) {
+        printf("[trace] %s, %lu/%lu events\n", enabled ? "recording" : "paused",
+               (unsigned long)held, (unsigned long)capacity);
+        return;
+    }
+
+    printf("Trace Status:\n");
+    printf("  State: %s\n", enabled ? "Recording" : "Paused");
+    printf("  Events: %lu recorded, %lu held, %lu overwritten\n",
+           (unsigned long)head, (unsigned long)held, (unsigned long)(head - held));
+    printf("  Ring: %lu events, %zu KB PSRAM\n",
+           (unsigned long)capacity, capacity * sizeof(trace_record_t) / 1024);
+}
@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file trace.h
+ * @brief Binary event trace — global API
+ *
+ * Timestamped events from the input scanner, mapper, player, provider and
+ * MSC updater, recorded into a PSRAM ring for offline timeline analysis of
+ * stutters and slow triggers. Recording takes a slot with one atomic
+ * increment and stores a 20-byte record (no lock, no allocation, any task);
+ * the oldest events are overwritten once the ring is full.
+ *
+ * trace_dump() pauses recording and writes the ring as text lines
+ * (task names, event table, one line per record). scripts/trace_to_json.py
+ * turns them into Chrome / Perfetto trace JSON: instant events, and spans
+ * (chunk writes, preloads, copies) recorded at their end with the start
+ * time and duration.
+ *
+ * All state is module-internal. Events recorded before trace_init() (or
+ * while paused) are dropped.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "soundboard.h"
+
+// to guard trace_*() calls in other modules with #ifdef
+#define TRACE_ENABLE
+
+/**
+ * @brief Traced events (a / b: event arguments)
+ */
+typedef enum {
+    TRACE_INPUT_EVENT,      /**< Input event emitted: a = button (0 = encoder), b = input_event_type_t */
+    TRACE_MAPPER_ACTION,    /**< Mapped action executed: a = button, b = action type */
+    TRACE_MAPPER_PAGE,      /**< Page changed: a = page number */
+    TRACE_PLAYER_CMD,       /**< Player command dequeued: a = sound ID, b = command type */
+    TRACE_PLAYER_WRITE,     /**< Span: I2S chunk write, a = active voices, b = bytes */
+    TRACE_PLAYER_EOF,       /**< Voice reached end of stream: a = sound ID, b = voice */
+    TRACE_OPEN_HIT,         /**< Stream opened from the PSRAM cache: a = sound ID */
+    TRACE_OPEN_HEAD,        /**< Cache miss started from an attack segment: a = sound ID */
+    TRACE_OPEN_MISS,        /**< Cold cache miss (file opened on press): a = sound ID */
+    TRACE_PRELOAD,          /**< Span: cache load of a file or bank, a = sound ID, b = esp_err_t */
+    TRACE_EVICT,            /**< Cache entry evicted: a = sound ID, b = KB freed */
+    TRACE_UNDERRUN,         /**< Read-ahead ring empty before EOF (silence): a = sound ID */
+    TRACE_MSC_STATE,        /**< MSC FSM state change: a = new state, b = event type */
+    TRACE_MSC_COPY,         /**< Span: file copied from the USB drive, a = KB, b = esp_err_t */
+    TRACE_EVENT_COUNT
+} trace_event_t;
+
+/**
+ * @brief Allocate the trace ring and start recording
+ *
+ * @param buffer_kb Ring size in KB of PSRAM (rounded down to a power of two records)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if too small, ESP_ERR_NO_MEM, ESP_ERR_INVALID_STATE if already done
+ */
+esp_err_t trace_init(size_t buffer_kb);
+
+/**
+ * @brief Record an instant event (now)
+ */
+void trace_event(trace_event_t event, uint16_t a, uint32_t b);
+
+/**
+ * @brief Record a span from start_us (esp_timer time) to now
+ */
+void trace_span(trace_event_t event, int64_t start_us, uint16_t a, uint32_t b);
+
+/**
+ * @brief Start time of a span
+ */
+static inline int64_t trace_start(void)
+{
+    return esp_timer_get_time();
+}
+
+/**
+ * @brief Pause or resume recording
+ */
+void trace_set_enabled(bool enabled);
+
+/**
+ * @brief Drop every recorded event
+ */
+void trace_clear(void);
+
+/**
+ * @brief Write the ring, oldest event first
+ *
+ * Recording is paused while the ring is read and resumed afterwards if it
+ * was running.
+ *
+ * @param out Output stream (stdout or an open file)
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if not initialized, ESP_FAIL on a write error
+ */
+esp_err_t trace_dump(FILE *out);
+
+/**
+ * @brief Print trace buffer state to console
+ *
+ * @param output_type Output verbosity level
+ */
+void trace_print_status(status_output_type_t output_type);
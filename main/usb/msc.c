@@ -16,16 +16,30 @@
 #include "usb/msc_host_vfs.h"
 #include <sys/stat.h>
 #include <dirent.h>
+#include <errno.h>
+#include <unistd.h>
 
 #include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_vfs_fat.h"
 #include "soundboard.h"
 #include "sd_card.h"
 #include "mapper.h"
+#include "player.h"
+#include "provider.h"
+#include "codec.h"
+#include "resampler.h"
+#include "sound_bank.h"
+#include "sound_index.h"
+#include "sync_manifest.h"
 #include "msc.h"
 
 #ifdef CONFIG_SOUNDBOARD_IO_STATS_ENABLE
     #include "benchmark.h"
 #endif
+#ifdef CONFIG_SOUNDBOARD_TRACE_ENABLE
+    #include "trace.h"
+#endif
 
 
 static const char *TAG = "msc";
@@ -41,6 +55,17 @@ static const char *TAG = "msc";
 // Minimum time between progress updates (milliseconds)
 #define PROGRESS_UPDATE_MIN_INTERVAL_MS 100
 
+// Sound bank build limits
+#define BANK_DIR_PATH        SDCARD_MOUNT_POINT "/" SOUND_BANK_DIR
+#define BANK_MAX_FILES       256   // (page, file) pairs collected from the mappings
+#define BANK_TMP_SUFFIX      ".tmp"
+#define BANK_PCM_SCRATCH_SIZE ((size_t)4096)  // File bytes staged per read of a converted source
+
+// Incremental sync
+#define SYNC_MANIFEST_FILE   SDCARD_MOUNT_POINT "/.sync_manifest"
+#define SOUND_INDEX_PATH     SDCARD_MOUNT_POINT "/" SOUND_INDEX_FILENAME
+#define SYNC_MAX_DEPTH       4     // Subdirectory levels below the soundboard directory
+
 // Internal event queue depth
 #define MSC_EVENT_QUEUE_DEPTH 8
 
@@ -52,6 +77,14 @@ static const char *TAG = "msc";
 #define MSC_FSM_TASK_PRIORITY    2
 #define MSC_FSM_TASK_CORE        0
 
+// Pipelined file copy: a reader task fills buffers from the USB drive while
+// the FSM task writes the previous ones to the SD card
+#define COPY_BUF_COUNT           4
+#define COPY_BUF_SIZE            ((size_t)(16 * 1024))  // One SD card cluster (16 KB allocation unit)
+#define COPY_TASK_STACK_SIZE     4096
+#define COPY_TASK_PRIORITY       1       // Below the player, blocks on USB transfers
+#define COPY_TASK_CORE           1       // Away from the USB host tasks
+
 /* ============================================================================
  * FSM State Enum
  * ============================================================================ */
@@ -103,9 +136,16 @@ struct msc_s {
     char current_filename[MSC_DISPLAY_FILENAME_LEN];
     TickType_t last_progress_update;
 
+    // Last sync result (manifest diff)
+    int sync_skipped;                    // Unchanged files (manifest match or same hash)
+    int sync_deleted;                    // Files removed from the USB drive, deleted on the SD card
+    size_t sync_avoided_bytes;           // Bytes of the skipped files (not written to the SD card)
+    bool sync_done;
+
     // FSM
     msc_fsm_state_t state;
     bool incremental;
+    volatile bool updating;              // run_update() in progress (FSM task)
     enum {
         CONFIRM_ACTION_SD_CLEAR,
         CONFIRM_ACTION_SYNC_BAD_DATA,
@@ -282,6 +322,9 @@ static esp_err_t uninstall_device(msc_handle_t handle)
 
 static void update_copy_progress(msc_handle_t handle, size_t bytes_copied)
 {
+    if (handle == NULL) {
+        return;  // Benchmark copy: no progress reporting
+    }
     handle->done_bytes += bytes_copied;
 
     TickType_t now = xTaskGetTickCount();
@@ -293,7 +336,94 @@ static void update_copy_progress(msc_handle_t handle, size_t bytes_copied)
     }
 }
 
-static esp_err_t copy_file(const char *src, const char *dst, msc_handle_t handle)
+/**
+ * @brief Chunk passed from the reader task to the writer (len 0 = end of file)
+ */
+typedef struct {
+    uint8_t index;                  // Buffer index
+    bool error;                     // End of file caused by a read error
+    size_t len;
+} copy_chunk_t;
+
+typedef struct {
+    FILE *src;
+    char *buffers[COPY_BUF_COUNT];
+    QueueHandle_t free_queue;       // Buffer indexes to fill (writer -> reader)
+    QueueHandle_t filled_queue;     // copy_chunk_t to write (reader -> writer), end marker last
+    volatile bool abort;            // Write failed: reader stops at the next buffer
+    int64_t read_us;                // USB busy time (valid after the end marker)
+    sync_hash_t hash;               // Content hash (valid after the end marker)
+} copy_pipeline_t;
+
+static void copy_reader_task(void *arg)
+{
+    copy_pipeline_t *pipe = arg;
+    copy_chunk_t end = { .len = 0 };
+    uint8_t index;
+
+    while (xQueueReceive(pipe->free_queue, &index, portMAX_DELAY) == pdTRUE && !pipe->abort) {
+        int64_t t0 = esp_timer_get_time();
+        size_t len = fread(pipe->buffers[index], 1, COPY_BUF_SIZE, pipe->src);
+        pipe->read_us += esp_timer_get_time() - t0;
+#ifdef IO_STATS_ENABLE
+        benchmark_record(BENCH_MSC_READ, t0, len);
+#endif
+        if (len > 0) {
+            sync_hash_update(&pipe->hash, pipe->buffers[index], len);
+            copy_chunk_t chunk = { .index = index, .len = len };
+            xQueueSend(pipe->filled_queue, &chunk, portMAX_DELAY);
+        }
+        if (len < COPY_BUF_SIZE) {
+            end.error = (ferror(pipe->src) != 0);
+            break;
+        }
+    }
+
+    // The writer frees the pipeline once it gets the end marker: last access
+    xQueueSend(pipe->filled_queue, &end, portMAX_DELAY);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Create dst with its final size allocated as one contiguous cluster run
+ *
+ * Keeps the FAT chain of the copy unfragmented (faster streaming reads later).
+ * Falls back to a plain file, grown cluster by cluster, when the free space
+ * has no run long enough.
+ */
+static FILE *open_preallocated(const char *dst, size_t size)
+{
+    remove(dst);
+    if (size > 0 && esp_vfs_fat_create_contiguous_file(SDCARD_MOUNT_POINT, dst, size, true) == ESP_OK) {
+        FILE *fp = fopen(dst, "r+b");
+        if (fp != NULL) {
+            return fp;
+        }
+    }
+    ESP_LOGD(TAG, "No contiguous allocation for %s (%zu bytes)", dst, size);
+    return fopen(dst, "wb");
+}
+
+/**
+ * @brief Copy buffer: internal DMA memory, PSRAM when internal RAM is short
+ *
+ * Both drivers bounce PSRAM buffers through internal memory: slower, still correct.
+ */
+static char *copy_buffer_alloc(void)
+{
+    char *buffer = heap_caps_aligned_alloc(4, COPY_BUF_SIZE, MALLOC_CAP_DMA);
+    if (buffer == NULL) {
+        buffer = heap_caps_aligned_alloc(64, COPY_BUF_SIZE, MALLOC_CAP_SPIRAM);
+    }
+    return buffer;
+}
+
+/**
+ * @brief Copy src (USB drive) to dst (SD card)
+ *
+ * @param hash Set to the xxHash32 of the content on success (NULL: not needed)
+ */
+static esp_err_t copy_file(const char *src, const char *dst, msc_handle_t handle, uint32_t *hash)
 {
     FILE *src_file = fopen(src, "rb");
     if (src_file == NULL) {
@@ -301,67 +431,111 @@ static esp_err_t copy_file(const char *src, const char *dst, msc_handle_t handle
         return ESP_ERR_NOT_FOUND;
     }
 
-    FILE *dst_file = fopen(dst, "wb");
+    struct stat st;
+    size_t src_size = (fstat(fileno(src_file), &st) == 0) ? (size_t)st.st_size : 0;
+
+    FILE *dst_file = open_preallocated(dst, src_size);
     if (dst_file == NULL) {
         ESP_LOGE(TAG, "Failed to create destination file: %s", dst);
         fclose(src_file);
         return ESP_FAIL;
     }
-
-    // 8192 = 16 SD sectors, fits ~2 GDMA descriptors (4092 bytes each)
-    // 4-byte alignment ensures DMA descriptor compatibility
-    static const size_t copy_buf_size = 8192;
-    char *buffer = heap_caps_aligned_alloc(4, copy_buf_size, MALLOC_CAP_DMA);
-    if (buffer == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate copy buffer");
-        fclose(src_file);
-        fclose(dst_file);
-        return ESP_ERR_NO_MEM;
+    // Whole-cluster chunks: no point copying them through stdio buffers
+    setvbuf(src_file, NULL, _IONBF, 0);
+    setvbuf(dst_file, NULL, _IONBF, 0);
+
+    copy_pipeline_t pipe = { .src = src_file };
+    sync_hash_init(&pipe.hash);
+    bool ok = true;
+    for (int i = 0; i < COPY_BUF_COUNT; i++) {
+        pipe.buffers[i] = copy_buffer_alloc();
+        ok = ok && (pipe.buffers[i] != NULL);
     }
+    pipe.free_queue = xQueueCreate(COPY_BUF_COUNT, sizeof(uint8_t));
+    pipe.filled_queue = xQueueCreate(COPY_BUF_COUNT + 1, sizeof(copy_chunk_t));   // + end marker
+    ok = ok && pipe.free_queue != NULL && pipe.filled_queue != NULL;
+    for (uint8_t i = 0; ok && i < COPY_BUF_COUNT; i++) {
+        xQueueSend(pipe.free_queue, &i, 0);
+    }
+    ok = ok && xTaskCreatePinnedToCore(copy_reader_task, "msc_copy", COPY_TASK_STACK_SIZE, &pipe,
+                                       COPY_TASK_PRIORITY, NULL, COPY_TASK_CORE) == pdPASS;
 
     esp_err_t ret = ESP_OK;
-    size_t bytes_read;
     size_t file_bytes = 0;
+    int64_t write_us = 0;
+    int64_t start_us = esp_timer_get_time();
 
-    while (true) {
-#ifdef IO_STATS_ENABLE
-        int64_t t0 = benchmark_start();
-#endif
-        bytes_read = fread(buffer, 1, copy_buf_size, src_file);
-#ifdef IO_STATS_ENABLE
-        benchmark_record(BENCH_MSC_READ, t0, bytes_read);
-#endif
-        if (bytes_read == 0) {
+    if (!ok) {
+        ESP_LOGE(TAG, "Failed to allocate copy pipeline");
+        ret = ESP_ERR_NO_MEM;
+    }
+
+    while (ok) {
+        copy_chunk_t chunk;
+        xQueueReceive(pipe.filled_queue, &chunk, portMAX_DELAY);
+        if (chunk.len == 0) {
+            if (chunk.error) {
+                ESP_LOGE(TAG, "Read error copying %s to %s", src, dst);
+                ret = ESP_FAIL;
+            }
             break;
         }
 
+        if (ret == ESP_OK) {
+            int64_t t0 = esp_timer_get_time();
+            size_t bytes_written = fwrite(pipe.buffers[chunk.index], 1, chunk.len, dst_file);
+            write_us += esp_timer_get_time() - t0;
 #ifdef IO_STATS_ENABLE
-        t0 = benchmark_start();
-#endif
-        size_t bytes_written = fwrite(buffer, 1, bytes_read, dst_file);
-#ifdef IO_STATS_ENABLE
-        benchmark_record(BENCH_MSC_WRITE, t0, bytes_written);
+            benchmark_record(BENCH_MSC_WRITE, t0, bytes_written);
 #endif
-        if (bytes_written != bytes_read) {
-            ESP_LOGE(TAG, "Write error copying %s to %s", src, dst);
-            ret = ESP_FAIL;
-            break;
+            if (bytes_written != chunk.len) {
+                ESP_LOGE(TAG, "Write error copying %s to %s", src, dst);
+                ret = ESP_FAIL;
+                pipe.abort = true;  // Drain what the reader still holds
+            } else {
+                file_bytes += bytes_written;
+                update_copy_progress(handle, bytes_written);
+            }
         }
-        file_bytes += bytes_written;
-        update_copy_progress(handle, bytes_written);
+        xQueueSend(pipe.free_queue, &chunk.index, 0);
     }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
 
-    heap_caps_free(buffer);
+    // Source shorter than announced: drop the preallocated tail
+    if (ret == ESP_OK && file_bytes < src_size && ftruncate(fileno(dst_file), (off_t)file_bytes) != 0) {
+        ESP_LOGW(TAG, "Failed to truncate %s", dst);
+    }
+
+    if (pipe.free_queue != NULL) {
+        vQueueDelete(pipe.free_queue);
+    }
+    if (pipe.filled_queue != NULL) {
+        vQueueDelete(pipe.filled_queue);
+    }
+    for (int i = 0; i < COPY_BUF_COUNT; i++) {
+        heap_caps_free(pipe.buffers[i]);
+    }
     fclose(src_file);
     fclose(dst_file);
 
     if (ret == ESP_OK) {
-        handle->done_files++;
-        ESP_LOGI(TAG, "Copied %s -> %s (%zu bytes)", src, dst, file_bytes);
+        if (handle != NULL) {
+            handle->done_files++;
+        }
+        if (hash != NULL) {
+            *hash = sync_hash_final(&pipe.hash);
+        }
+        // Busy shares over 100% in total: both buses worked at the same time
+        ESP_LOGI(TAG, "Copied %s -> %s (%zu bytes, %lld ms, USB %d%% / SD %d%% busy)", src, dst, file_bytes,
+                 elapsed_us / 1000,
+                 elapsed_us > 0 ? (int)(pipe.read_us * 100 / elapsed_us) : 0,
+                 elapsed_us > 0 ? (int)(write_us * 100 / elapsed_us) : 0);
 #ifdef IO_STATS_ENABLE
         benchmark_log_and_reset(BENCH_MSC_READ, dst);
         benchmark_log_and_reset(BENCH_MSC_WRITE, dst);
 #endif
+    } else {
+        remove(dst);
     }
 
     return ret;
@@ -379,91 +553,813 @@ static bool is_sync_file(const char *name)
     return is_wav_file(name) || (strcasecmp(name, MAPPINGS_FILENAME) == 0);
 }
 
-static bool sdcard_file_matches(const char *filename, off_t msc_size)
+/* ============================================================================
+ * Incremental Sync (manifest diff)
+ * ============================================================================ */
+
+typedef enum {
+    SYNC_ACTION_SKIP,       // Manifest size and mtime match, SD card copy present
+    SYNC_ACTION_VERIFY,     // Same size, new mtime: hash the source, copy only if it changed
+    SYNC_ACTION_COPY,
+} sync_action_t;
+
+/**
+ * @brief One sync-eligible file of the USB drive
+ */
+typedef struct {
+    sync_manifest_entry_t file;         // Source path (relative), size, mtime; hash once known
+    const sync_manifest_entry_t *old;   // Entry of the previous sync, NULL if not listed
+    sync_action_t action;
+    bool done;                          // SD card copy matches file (skipped, verified or copied)
+} sync_item_t;
+
+/**
+ * @brief Diff of the USB drive against the manifest, built in one directory walk
+ */
+typedef struct {
+    sync_item_t *items;                 // PSRAM, SYNC_MANIFEST_MAX_ENTRIES
+    int count;
+    int to_delete;                      // Manifest entries not seen on the USB drive
+    sync_manifest_t manifest;           // Previous sync (seen flags set by the walk)
+    bool incremental;
+    char path[SOUNDBOARD_MAX_PATH_LEN]; // Walk buffer: absolute path of the current entry
+    size_t root_len;
+} sync_plan_t;
+
+static bool is_mappings_file(const char *rel_path)
+{
+    return strcasecmp(rel_path, MAPPINGS_FILENAME) == 0;
+}
+
+static void sd_path_of(char *out, size_t out_size, const char *rel_path)
+{
+    snprintf(out, out_size, "%s/%s", SDCARD_MOUNT_POINT, rel_path);
+}
+
+static bool sdcard_file_matches(const char *rel_path, uint32_t size)
 {
     char path[SOUNDBOARD_MAX_PATH_LEN];
-    snprintf(path, sizeof(path), "%s/%s", SDCARD_MOUNT_POINT, filename);
+    sd_path_of(path, sizeof(path), rel_path);
     struct stat sd_st;
-    return (stat(path, &sd_st) == 0 && sd_st.st_size == msc_size);
+    return (stat(path, &sd_st) == 0 && (uint32_t)sd_st.st_size == size);
+}
+
+static sync_action_t sync_classify(const sync_plan_t *plan, const sync_item_t *item)
+{
+    // mappings.csv is always rewritten (small, and the mapper reloads it)
+    if (!plan->incremental || item->old == NULL || is_mappings_file(item->file.path) ||
+        item->old->size != item->file.size || !sdcard_file_matches(item->file.path, item->file.size)) {
+        return SYNC_ACTION_COPY;
+    }
+    return (item->old->mtime == item->file.mtime) ? SYNC_ACTION_SKIP : SYNC_ACTION_VERIFY;
 }
 
 /**
- * @brief Process sync-eligible files: scan only (count/sum) or copy to SD card.
- *
- * Iterates msc_root, skipping directories, non-sync files, and (when incremental)
- * WAV files that already exist on SD card with matching size.
- *
- * When scan_only is true, counts files and sums sizes into handle totals.
- * When scan_only is false, copies each matching file to SDCARD_MOUNT_POINT.
+ * @brief Walk plan->path recursively, adding one item per sync-eligible file
  */
-static esp_err_t process_sync_files(const char *msc_root, bool incremental,
-                                    bool scan_only, msc_handle_t handle)
+static esp_err_t sync_walk(sync_plan_t *plan, int depth)
 {
-    DIR *dir = opendir(msc_root);
+    DIR *dir = opendir(plan->path);
     if (dir == NULL) {
-        ESP_LOGE(TAG, "Failed to open directory: %s", msc_root);
+        ESP_LOGE(TAG, "Failed to open directory: %s", plan->path);
         return ESP_ERR_NOT_FOUND;
     }
 
-    if (scan_only) {
-        handle->total_files = 0;
-        handle->total_bytes = 0;
-        handle->done_files = 0;
-        handle->done_bytes = 0;
-    }
-
     esp_err_t ret = ESP_OK;
+    size_t dir_len = strlen(plan->path);
     struct dirent *entry;
     struct stat st;
-    char src_path[SOUNDBOARD_MAX_PATH_LEN];
-    int skipped = 0;
 
-    while ((entry = readdir(dir)) != NULL) {
-        if (entry->d_type == DT_DIR || !is_sync_file(entry->d_name)) {
+    while (ret == ESP_OK && (entry = readdir(dir)) != NULL) {
+        // Hidden entries (".", "..", OS metadata) and the bank directory name are reserved
+        if (entry->d_name[0] == '.' || (depth == 0 && strcmp(entry->d_name, SOUND_BANK_DIR) == 0)) {
+            continue;
+        }
+        if (snprintf(plan->path + dir_len, sizeof(plan->path) - dir_len, "/%s", entry->d_name) >=
+            (int)(sizeof(plan->path) - dir_len)) {
+            ESP_LOGW(TAG, "Path too long, skipping: %.40s/%.20s...", plan->path, entry->d_name);
+            plan->path[dir_len] = '\0';
             continue;
         }
 
-        snprintf(src_path, sizeof(src_path), "%s/%s", msc_root, entry->d_name);
-        if (stat(src_path, &st) != 0) {
+        if (entry->d_type == DT_DIR) {
+            if (depth < SYNC_MAX_DEPTH) {
+                ret = sync_walk(plan, depth + 1);
+            } else {
+                ESP_LOGW(TAG, "Too deep, skipping: %s", plan->path);
+            }
+        } else if (is_sync_file(entry->d_name) && (depth == 0 || is_wav_file(entry->d_name)) &&
+                   stat(plan->path, &st) == 0) {
+            if (plan->count == SYNC_MANIFEST_MAX_ENTRIES) {
+                ESP_LOGE(TAG, "Too many files to sync (max %d)", SYNC_MANIFEST_MAX_ENTRIES);
+                ret = ESP_ERR_INVALID_SIZE;
+            } else {
+                sync_item_t *item = &plan->items[plan->count++];
+                const char *rel_path = plan->path + plan->root_len + 1;
+                strcpy(item->file.path, rel_path);
+                item->file.size = (uint32_t)st.st_size;
+                item->file.mtime = st.st_mtime;
+                sync_manifest_entry_t *old = sync_manifest_find(&plan->manifest, rel_path);
+                if (old != NULL) {
+                    old->seen = true;
+                }
+                item->old = old;
+                item->action = sync_classify(plan, item);
+                if (item->action == SYNC_ACTION_SKIP) {
+                    item->file.hash = old->hash;
+                    item->done = true;
+                }
+            }
+        }
+        plan->path[dir_len] = '\0';
+    }
+
+    closedir(dir);
+    return ret;
+}
+
+/**
+ * @brief Diff msc_root against the SD card manifest (single directory walk)
+ *
+ * Sets the handle totals to the files to copy or verify, and the skip
+ * counters to the unchanged ones.
+ */
+static esp_err_t sync_plan_build(sync_plan_t *plan, const char *msc_root, bool incremental,
+                                 msc_handle_t handle)
+{
+    memset(plan, 0, sizeof(*plan));
+    plan->incremental = incremental;
+    plan->items = heap_caps_calloc(SYNC_MANIFEST_MAX_ENTRIES, sizeof(sync_item_t), MALLOC_CAP_SPIRAM);
+    if (plan->items == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = sync_manifest_load(SYNC_MANIFEST_FILE, &plan->manifest);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    strncpy(plan->path, msc_root, sizeof(plan->path) - 1);
+    plan->root_len = strlen(plan->path);
+    ret = sync_walk(plan, 0);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    handle->total_files = 0;
+    handle->total_bytes = 0;
+    handle->done_files = 0;
+    handle->done_bytes = 0;
+    handle->sync_skipped = 0;
+    handle->sync_deleted = 0;
+    handle->sync_avoided_bytes = 0;
+
+    int to_verify = 0;
+    for (int i = 0; i < plan->count; i++) {
+        const sync_item_t *item = &plan->items[i];
+        if (item->action == SYNC_ACTION_SKIP) {
+            handle->sync_skipped++;
+            handle->sync_avoided_bytes += item->file.size;
             continue;
         }
+        to_verify += (item->action == SYNC_ACTION_VERIFY);
+        handle->total_files++;
+        handle->total_bytes += item->file.size;
+        ESP_LOGD(TAG, "%s: %s (%lu bytes)", item->action == SYNC_ACTION_VERIFY ? "Verify" : "Copy",
+                 item->file.path, (unsigned long)item->file.size);
+    }
+    for (int i = 0; i < plan->manifest.count; i++) {
+        plan->to_delete += !plan->manifest.entries[i].seen;
+    }
+
+    ESP_LOGI(TAG, "Scan complete: %d files to copy (%d to verify), %d unchanged (%zu KB), %d to delete, "
+             "%zu bytes total", handle->total_files, to_verify, handle->sync_skipped,
+             handle->sync_avoided_bytes / 1024, plan->to_delete, handle->total_bytes);
+    return ESP_OK;
+}
+
+static void sync_plan_free(sync_plan_t *plan)
+{
+    heap_caps_free(plan->items);
+    plan->items = NULL;
+    sync_manifest_free(&plan->manifest);
+}
+
+/**
+ * @brief xxHash32 of a USB drive file (same-size files with a new mtime)
+ */
+static esp_err_t hash_source_file(const char *path, uint32_t *hash)
+{
+    FILE *fp = fopen(path, "rb");
+    char *buffer = copy_buffer_alloc();
+    if (fp == NULL || buffer == NULL) {
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        heap_caps_free(buffer);
+        return (fp == NULL) ? ESP_ERR_NOT_FOUND : ESP_ERR_NO_MEM;
+    }
+    setvbuf(fp, NULL, _IONBF, 0);
+
+    sync_hash_t state;
+    sync_hash_init(&state);
+    size_t len;
+    do {
+#ifdef IO_STATS_ENABLE
+        int64_t t0 = benchmark_start();
+#endif
+        len = fread(buffer, 1, COPY_BUF_SIZE, fp);
+#ifdef IO_STATS_ENABLE
+        benchmark_record(BENCH_MSC_READ, t0, len);
+#endif
+        sync_hash_update(&state, buffer, len);
+    } while (len == COPY_BUF_SIZE);
+
+    esp_err_t ret = ferror(fp) ? ESP_FAIL : ESP_OK;
+    *hash = sync_hash_final(&state);
+    heap_caps_free(buffer);
+    fclose(fp);
+    return ret;
+}
+
+/**
+ * @brief Create the SD card directories of a destination path
+ */
+static void make_parent_dirs(char *dst_path)
+{
+    for (char *p = dst_path + sizeof(SDCARD_MOUNT_POINT); *p != '\0'; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            mkdir(dst_path, 0775);   // EEXIST is fine, a real failure shows at fopen()
+            *p = '/';
+        }
+    }
+}
+
+/**
+ * @brief Remove the directories of a deleted file once they are empty
+ */
+static void remove_empty_parent_dirs(char *sd_path)
+{
+    char *slash;
+    while ((slash = strrchr(sd_path, '/')) != NULL && slash > sd_path + sizeof(SDCARD_MOUNT_POINT) - 1) {
+        *slash = '\0';
+        if (rmdir(sd_path) != 0) {
+            break;  // Not empty
+        }
+    }
+}
+
+/**
+ * @brief Copy / verify the planned files, then delete the removed ones
+ *
+ * Every file rewritten or deleted on the SD card leaves the WAV layout
+ * index (sound_index.h): the player parses its header again and re-indexes it.
+ */
+static esp_err_t sync_apply(sync_plan_t *plan, msc_handle_t handle)
+{
+    esp_err_t ret = ESP_OK;
+    char src_path[SOUNDBOARD_MAX_PATH_LEN];
+    char dst_path[SOUNDBOARD_MAX_PATH_LEN];
+
+    sound_index_t index;
+    if (sound_index_load(SOUND_INDEX_PATH, &index) != ESP_OK) {
+        remove(SOUND_INDEX_PATH);   // Cannot be edited: rebuilt from scratch by the player
+    }
 
-        if (incremental && is_wav_file(entry->d_name) &&
-            sdcard_file_matches(entry->d_name, st.st_size)) {
-            skipped++;
+    for (int i = 0; i < plan->count && ret == ESP_OK; i++) {
+        sync_item_t *item = &plan->items[i];
+        if (item->done) {
+            continue;
+        }
+        snprintf(src_path, sizeof(src_path), "%.*s/%s", (int)plan->root_len, plan->path, item->file.path);
+        strncpy(handle->current_filename, item->file.path, sizeof(handle->current_filename) - 1);
+        handle->current_filename[sizeof(handle->current_filename) - 1] = '\0';
+
+        if (item->action == SYNC_ACTION_VERIFY &&
+            hash_source_file(src_path, &item->file.hash) == ESP_OK && item->file.hash == item->old->hash) {
+            // Touched but not modified: only the manifest mtime changes
+            ESP_LOGD(TAG, "Unchanged (same hash): %s", item->file.path);
+            item->done = true;
+            handle->sync_skipped++;
+            handle->sync_avoided_bytes += item->file.size;
+            handle->total_files--;
+            update_copy_progress(handle, item->file.size);
             continue;
         }
 
-        if (scan_only) {
-            handle->total_files++;
-            handle->total_bytes += st.st_size;
-            ESP_LOGD(TAG, "Found: %s (%ld bytes)", entry->d_name, (long)st.st_size);
+        sd_path_of(dst_path, sizeof(dst_path), item->file.path);
+        make_parent_dirs(dst_path);
+        sound_index_drop(&index, dst_path);
+#ifdef TRACE_ENABLE
+        int64_t trace_us = trace_start();
+#endif
+        ret = copy_file(src_path, dst_path, handle, &item->file.hash);
+#ifdef TRACE_ENABLE
+        uint32_t copy_kb = item->file.size / 1024;
+        trace_span(TRACE_MSC_COPY, trace_us, (copy_kb > UINT16_MAX) ? UINT16_MAX : (uint16_t)copy_kb, (uint32_t)ret);
+#endif
+        if (ret == ESP_OK) {
+            item->done = true;
         } else {
-            strncpy(handle->current_filename, entry->d_name,
-                    sizeof(handle->current_filename) - 1);
-            handle->current_filename[sizeof(handle->current_filename) - 1] = '\0';
+            ESP_LOGE(TAG, "Failed to copy %s: %s", item->file.path, esp_err_to_name(ret));
+            item->old = NULL;   // copy_file() removed the SD card copy
+        }
+    }
 
-            char dst_path[SOUNDBOARD_MAX_PATH_LEN];
-            snprintf(dst_path, sizeof(dst_path), "%s/%s", SDCARD_MOUNT_POINT, entry->d_name);
+    // Removed files are only deleted after a complete copy: a failed sync keeps the old set
+    for (int i = 0; i < plan->manifest.count && ret == ESP_OK; i++) {
+        sync_manifest_entry_t *entry = &plan->manifest.entries[i];
+        if (entry->seen) {
+            continue;
+        }
+        sd_path_of(dst_path, sizeof(dst_path), entry->path);
+        if (remove(dst_path) == 0 || errno == ENOENT) {
+            ESP_LOGI(TAG, "Deleted %s (removed from the USB drive)", dst_path);
+            sound_index_drop(&index, dst_path);
+            handle->sync_deleted++;
+            entry->seen = true;     // Accounted for: dropped from the new manifest
+            remove_empty_parent_dirs(dst_path);
+        } else {
+            ESP_LOGW(TAG, "Failed to delete %s", dst_path);
+        }
+    }
 
-            ret = copy_file(src_path, dst_path, handle);
+    if (index.changed && sound_index_save(SOUND_INDEX_PATH, &index) != ESP_OK) {
+        remove(SOUND_INDEX_PATH);
+    }
+    sound_index_free(&index);
+    return ret;
+}
+
+/**
+ * @brief Write the manifest of what the SD card holds after sync_apply()
+ *
+ * Lists the synced files (new state when done, previous entry otherwise) and
+ * the removed files that could not be deleted.
+ */
+static esp_err_t sync_write_manifest(sync_plan_t *plan)
+{
+    sync_manifest_writer_t writer;
+    esp_err_t ret = sync_manifest_writer_open(&writer, SYNC_MANIFEST_FILE);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    for (int i = 0; i < plan->count; i++) {
+        const sync_item_t *item = &plan->items[i];
+        if (item->done) {
+            sync_manifest_writer_add(&writer, &item->file);
+        } else if (item->old != NULL) {
+            sync_manifest_writer_add(&writer, item->old);
+        }
+    }
+    for (int i = 0; i < plan->manifest.count; i++) {
+        if (!plan->manifest.entries[i].seen) {
+            sync_manifest_writer_add(&writer, &plan->manifest.entries[i]);
+        }
+    }
+    return sync_manifest_writer_close(&writer);
+}
+
+/* ============================================================================
+ * Sound Bank Builder
+ * ============================================================================ */
+
+/**
+ * @brief One file of a page bank (collected from the SD card mappings)
+ */
+typedef struct {
+    char page_id[PAGE_ID_MAX_LEN];
+    uint8_t button_number;                  // Lowest button mapping the file
+    char filename[SOUNDBOARD_MAX_PATH_LEN]; // Absolute SD card path
+    uint32_t data_offset;                   // PCM offset in the source file
+    audio_info_t info;                      // Source format (the entry may be resampled)
+} bank_file_t;
+
+typedef struct {
+    bank_file_t *files;
+    int count;
+} bank_file_list_t;
+
+static void collect_bank_file(const char *page_id, uint8_t button_number,
+                              const char *filename, void *ctx)
+{
+    bank_file_list_t *list = (bank_file_list_t *)ctx;
+
+    // Banks only cover files stored on the SD card
+    if (strncmp(filename, SDCARD_MOUNT_POINT "/", sizeof(SDCARD_MOUNT_POINT)) != 0) {
+        return;
+    }
+
+    for (int i = 0; i < list->count; i++) {
+        bank_file_t *f = &list->files[i];
+        if (strcmp(f->page_id, page_id) == 0 && strcmp(f->filename, filename) == 0) {
+            if (button_number < f->button_number) {
+                f->button_number = button_number;
+            }
+            return;
+        }
+    }
+
+    if (list->count >= BANK_MAX_FILES) {
+        ESP_LOGW(TAG, "Too many files for sound banks, ignoring %s", filename);
+        return;
+    }
+    bank_file_t *f = &list->files[list->count++];
+    strncpy(f->page_id, page_id, sizeof(f->page_id) - 1);
+    f->page_id[sizeof(f->page_id) - 1] = '\0';
+    f->button_number = button_number;
+    strncpy(f->filename, filename, sizeof(f->filename) - 1);
+    f->filename[sizeof(f->filename) - 1] = '\0';
+}
+
+static esp_err_t bank_write_padding(FILE *fp, uint32_t from, uint32_t to)
+{
+    static const uint8_t zeros[SOUND_BANK_ALIGN];
+    uint32_t bytes = to - from;
+    return (bytes == 0 || fwrite(zeros, 1, bytes, fp) == bytes) ? ESP_OK : ESP_FAIL;
+}
+
+/**
+ * @brief Resample and/or encode the PCM of one source file into an open bank
+ *
+ * The first half of buffer stages PCM at the entry rate, the second half
+ * the encoded chunk. src is positioned at the start of the PCM data;
+ * 24/32-bit and (with OUTPUT_DOWNMIX_MONO) stereo samples are converted to
+ * the entry's 16-bit layout as they are read.
+ */
+static esp_err_t bank_encode_span(FILE *src, FILE *dst, const bank_file_t *file,
+                                  const sound_bank_entry_t *entry, const resampler_kernel_t *kernel,
+                                  char *buffer, size_t buffer_size)
+{
+    uint16_t ch = entry->info.channels;
+    size_t frame_bytes = (size_t)ch * sizeof(int16_t);
+    size_t half = buffer_size / 2;
+    codec_state_t encoder;
+    codec_state_init(&encoder, (audio_cache_format_t)entry->format, ch);
+    size_t chunk_frames = codec_encode_chunk_frames(&encoder, half / frame_bytes);
+    if (chunk_frames == 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    codec_pcm_t conv;
+    codec_pcm_init(&conv, &file->info, OUTPUT_DOWNMIX_MONO);
+    void *scratch = NULL;
+    if (!codec_pcm_passthrough(&conv)) {
+        scratch = heap_caps_aligned_alloc(CODEC_PCM_SCRATCH_ALIGN, BANK_PCM_SCRATCH_SIZE, MALLOC_CAP_SPIRAM);
+        if (scratch == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    resampler_t *resampler = NULL;
+    if (file->info.frame_rate != entry->info.frame_rate) {
+        esp_err_t ret = resampler_create(kernel, file->info.frame_rate, entry->info.frame_rate, ch, &resampler);
+        if (ret != ESP_OK) {
+            heap_caps_free(scratch);
+            return ret;
+        }
+    }
+
+    esp_err_t ret = ESP_OK;
+    int16_t *pcm = (int16_t *)buffer;
+    uint8_t *out = (uint8_t *)buffer + half;
+    uint32_t src_left = file->info.total_frames;
+    uint32_t done = 0;
+    uint32_t written = 0;
+    while (done < entry->info.total_frames && ret == ESP_OK) {
+        size_t frames = entry->info.total_frames - done;
+        if (frames > chunk_frames) {
+            frames = chunk_frames;
+        }
+
+        if (resampler == NULL) {
+            if (codec_pcm_read(&conv, src, pcm, frames, scratch, BANK_PCM_SCRATCH_SIZE) != frames) {
+                ret = ESP_FAIL;
+                break;
+            }
+        } else {
+            size_t staged = 0;
+            while (staged < frames) {
+                staged += resampler_output(resampler, pcm + staged * ch, frames - staged);
+                if (staged == frames) {
+                    break;
+                }
+                size_t space;
+                int16_t *in = resampler_input(resampler, &space);
+                if (src_left == 0) {
+                    resampler_finish(resampler);
+                    continue;
+                }
+                size_t n = (space < src_left) ? space : src_left;
+                if (codec_pcm_read(&conv, src, in, n, scratch, BANK_PCM_SCRATCH_SIZE) != n) {
+                    ret = ESP_FAIL;
+                    break;
+                }
+                resampler_commit(resampler, n);
+                src_left -= n;
+            }
             if (ret != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to copy %s: %s", entry->d_name, esp_err_to_name(ret));
                 break;
             }
         }
+
+        size_t n = codec_encode(&encoder, out, pcm, frames);
+        if (fwrite(out, 1, n, dst) != n) {
+            ret = ESP_FAIL;
+            break;
+        }
+        done += frames;
+        written += n;
+    }
+
+    resampler_destroy(resampler);
+    heap_caps_free(scratch);
+    if (ret == ESP_OK && written != entry->size) {
+        ret = ESP_FAIL;
+    }
+    return ret;
+}
+
+/**
+ * @brief Copy (or encode) the data span of one source file into an open bank
+ */
+static esp_err_t bank_copy_span(FILE *dst, const bank_file_t *file, const sound_bank_entry_t *entry,
+                                const resampler_kernel_t *kernel, char *buffer, size_t buffer_size)
+{
+    FILE *src = fopen(file->filename, "rb");
+    if (src == NULL) {
+        ESP_LOGE(TAG, "Failed to open bank source: %s", file->filename);
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (fseek(src, file->data_offset, SEEK_SET) != 0) {
+        fclose(src);
+        return ESP_FAIL;
+    }
+
+    if (entry->format != AUDIO_CACHE_FORMAT_PCM16 || entry->info.frame_rate != file->info.frame_rate ||
+        entry->info.channels != file->info.channels || file->info.bit_depth != 16) {
+        esp_err_t ret = bank_encode_span(src, dst, file, entry, kernel, buffer, buffer_size);
+        fclose(src);
+        return ret;
+    }
+
+    esp_err_t ret = ESP_OK;
+    uint32_t copied = 0;
+    uint32_t size = entry->size;
+    while (copied < size) {
+        size_t to_read = size - copied;
+        if (to_read > buffer_size) {
+            to_read = buffer_size;
+        }
+        size_t n = fread(buffer, 1, to_read, src);
+        if (n == 0 || fwrite(buffer, 1, n, dst) != n) {
+            ret = ESP_FAIL;
+            break;
+        }
+        copied += n;
+    }
+
+    fclose(src);
+    return ret;
+}
+
+/**
+ * @brief Write the bank of one page
+ *
+ * files is the page's file list (button order); entries that fail to parse
+ * are dropped. kernel is set when entries are resampled to the fixed output
+ * rate (NULL: native rates). Writes to a temporary file and renames it on success so a
+ * failed build never leaves a truncated bank behind.
+ */
+static esp_err_t build_page_bank(const char *page_id, bank_file_t *files, int count,
+                                 const resampler_kernel_t *kernel, char *buffer, size_t buffer_size,
+                                 int *out_files, size_t *out_bytes)
+{
+    if (count > SOUND_BANK_MAX_ENTRIES) {
+        ESP_LOGW(TAG, "Page '%s': %d files, bank limited to %d", page_id, count, SOUND_BANK_MAX_ENTRIES);
+        count = SOUND_BANK_MAX_ENTRIES;
+    }
+
+    sound_bank_entry_t *index = heap_caps_calloc(count, sizeof(sound_bank_entry_t), MALLOC_CAP_SPIRAM);
+    if (index == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Parse every source file (compacting files[] to the valid ones)
+    int entry_count = 0;
+    for (int i = 0; i < count; i++) {
+        sound_bank_entry_t *e = &index[entry_count];
+        struct stat st;
+        uint32_t data_size;
+        if (stat(files[i].filename, &st) != 0 ||
+            audio_provider_parse_wav_file(files[i].filename, &files[i].info,
+                                          &files[i].data_offset, &data_size) != ESP_OK) {
+            ESP_LOGW(TAG, "Page '%s': skipping %s (not a valid WAV file)", page_id, files[i].filename);
+            continue;
+        }
+        strncpy(e->filename, files[i].filename, sizeof(e->filename) - 1);
+        e->source_size = (uint32_t)st.st_size;
+        // Same conversion as the provider's cache load: 16-bit (mono) PCM, output rate,
+        // then per-file format
+        codec_pcm_t conv;
+        codec_pcm_init(&conv, &files[i].info, OUTPUT_DOWNMIX_MONO);
+        codec_pcm_output_info(&conv, &files[i].info, &e->info);
+        if (kernel != NULL && e->info.frame_rate != OUTPUT_SAMPLE_RATE) {
+            e->info.frame_rate = OUTPUT_SAMPLE_RATE;
+            e->info.total_frames = resampler_output_frames(files[i].info.total_frames,
+                                                           files[i].info.frame_rate, OUTPUT_SAMPLE_RATE);
+        }
+        audio_cache_format_t format = codec_supports(CACHE_SAMPLE_FORMAT, e->info.channels)
+                                          ? CACHE_SAMPLE_FORMAT : AUDIO_CACHE_FORMAT_PCM16;
+        e->format = format;
+        e->size = (uint32_t)codec_encoded_size(format, e->info.total_frames, e->info.channels);
+        files[entry_count++] = files[i];
+    }
+    if (entry_count == 0) {
+        heap_caps_free(index);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Layout: header + index, then sector-aligned data spans
+    sound_bank_header_t header = {
+        .magic = SOUND_BANK_MAGIC,
+        .version = SOUND_BANK_VERSION,
+        .entry_size = sizeof(sound_bank_entry_t),
+        .entry_count = (uint32_t)entry_count,
+        .data_offset = sound_bank_align(sizeof(sound_bank_header_t) +
+                                        entry_count * sizeof(sound_bank_entry_t)),
+    };
+    uint32_t offset = header.data_offset;
+    for (int i = 0; i < entry_count; i++) {
+        index[i].offset = offset;
+        offset = sound_bank_align(offset + index[i].size);
+    }
+
+    char path[SOUNDBOARD_MAX_PATH_LEN];
+    char tmp_path[SOUNDBOARD_MAX_PATH_LEN + sizeof(BANK_TMP_SUFFIX)];
+    sound_bank_path(path, sizeof(path), SDCARD_MOUNT_POINT, page_id);
+    snprintf(tmp_path, sizeof(tmp_path), "%s" BANK_TMP_SUFFIX, path);
+
+    FILE *fp = fopen(tmp_path, "wb");
+    if (fp == NULL) {
+        ESP_LOGE(TAG, "Failed to create sound bank: %s", tmp_path);
+        heap_caps_free(index);
+        return ESP_FAIL;
+    }
+
+    uint32_t index_end = sizeof(header) + entry_count * sizeof(sound_bank_entry_t);
+    esp_err_t ret = ESP_OK;
+    if (fwrite(&header, 1, sizeof(header), fp) != sizeof(header) ||
+        fwrite(index, sizeof(sound_bank_entry_t), entry_count, fp) != (size_t)entry_count ||
+        bank_write_padding(fp, index_end, header.data_offset) != ESP_OK) {
+        ret = ESP_FAIL;
+    }
+    for (int i = 0; i < entry_count && ret == ESP_OK; i++) {
+        ret = bank_copy_span(fp, &files[i], &index[i], kernel, buffer, buffer_size);
+        if (ret == ESP_OK) {
+            uint32_t end = index[i].offset + index[i].size;
+            ret = bank_write_padding(fp, end, sound_bank_align(end));
+        }
+    }
+    fclose(fp);
+    heap_caps_free(index);
+
+    if (ret == ESP_OK) {
+        remove(path);
+        if (rename(tmp_path, path) != 0) {
+            ret = ESP_FAIL;
+        }
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write sound bank: %s", path);
+        remove(tmp_path);
+        return ret;
     }
 
+    ESP_LOGI(TAG, "Sound bank %s: %d files, %lu KB", path, entry_count, (unsigned long)(offset / 1024));
+    *out_files = entry_count;
+    *out_bytes = offset;
+    return ESP_OK;
+}
+
+/**
+ * @brief Remove every bank (and leftover temporary file) from the bank directory
+ */
+static void remove_sound_banks(void)
+{
+    DIR *dir = opendir(BANK_DIR_PATH);
+    if (dir == NULL) {
+        return;
+    }
+    struct dirent *entry;
+    char path[SOUNDBOARD_MAX_PATH_LEN];
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_type == DT_DIR) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", BANK_DIR_PATH, entry->d_name);
+        remove(path);
+    }
     closedir(dir);
+}
+
+/**
+ * @brief Build one sound bank per page of the SD card mappings
+ *
+ * Banks are an accelerator for cache warm-up: failures are logged and
+ * leave the per-file preload path in charge.
+ */
+static esp_err_t build_sound_banks(msc_handle_t handle)
+{
+    int64_t t_start = esp_timer_get_time();
+
+    if (mkdir(BANK_DIR_PATH, 0775) != 0 && errno != EEXIST) {
+        ESP_LOGE(TAG, "Failed to create %s", BANK_DIR_PATH);
+        return ESP_FAIL;
+    }
+    remove_sound_banks();
+
+    bank_file_list_t list = {
+        .files = heap_caps_calloc(BANK_MAX_FILES, sizeof(bank_file_t), MALLOC_CAP_SPIRAM),
+    };
+    bank_file_t *group = heap_caps_calloc(BANK_MAX_FILES, sizeof(bank_file_t), MALLOC_CAP_SPIRAM);
+    // 8192 = 16 SD sectors, fits ~2 GDMA descriptors (4092 bytes each)
+    // 4-byte alignment ensures DMA descriptor compatibility
+    static const size_t bank_buf_size = 8192;
+    char *buffer = heap_caps_aligned_alloc(4, bank_buf_size, MALLOC_CAP_DMA);
+    // Banks hold data at the output rate so that loading stays a plain copy
+    resampler_kernel_t *kernel = NULL;
+    esp_err_t ret = ESP_OK;
+    if (OUTPUT_SAMPLE_RATE > 0) {
+        ret = resampler_kernel_create(OUTPUT_RESAMPLER_TAPS, &kernel);
+    }
+    if (list.files == NULL || group == NULL || buffer == NULL || ret != ESP_OK) {
+        ret = ESP_ERR_NO_MEM;
+        goto done;
+    }
+
+    ret = mapper_for_each_file(SDCARD_MAPPINGS_PATH, SDCARD_MOUNT_POINT, collect_bank_file, &list);
+    if (ret != ESP_OK) {
+        goto done;
+    }
+
+    int pages = 0;
+    int files = 0;
+    size_t total_bytes = 0;
+    for (int i = 0; i < list.count; i++) {
+        const char *page_id = list.files[i].page_id;
 
-    if (scan_only) {
-        ESP_LOGI(TAG, "Scan complete: %d files to copy, %d skipped, %zu bytes total",
-                 handle->total_files, skipped, handle->total_bytes);
+        // Pages in order of first appearance
+        bool seen = false;
+        for (int j = 0; j < i && !seen; j++) {
+            seen = (strcmp(list.files[j].page_id, page_id) == 0);
+        }
+        if (seen) {
+            continue;
+        }
+
+        // Page's files by ascending button (button 1 loads first, like the per-file preload)
+        int count = 0;
+        for (int j = i; j < list.count; j++) {
+            if (strcmp(list.files[j].page_id, page_id) != 0) {
+                continue;
+            }
+            int k = count++;
+            while (k > 0 && group[k - 1].button_number > list.files[j].button_number) {
+                group[k] = group[k - 1];
+                k--;
+            }
+            group[k] = list.files[j];
+        }
+
+        snprintf(handle->current_filename, sizeof(handle->current_filename), "Bank: %s", page_id);
+        notify_progress(handle);
+
+        int bank_files = 0;
+        size_t bytes = 0;
+        esp_err_t bank_ret = build_page_bank(page_id, group, count, kernel, buffer, bank_buf_size,
+                                             &bank_files, &bytes);
+        if (bank_ret == ESP_OK) {
+            pages++;
+            files += bank_files;
+            total_bytes += bytes;
+        } else if (bank_ret != ESP_ERR_NOT_FOUND) {
+            ret = bank_ret;
+        }
     }
+
+    ESP_LOGI(TAG, "Sound banks built: %d pages, %d files, %zu KB in %lld ms",
+             pages, files, total_bytes / 1024, (esp_timer_get_time() - t_start) / 1000);
+
+done:
+    resampler_kernel_destroy(kernel);
+    heap_caps_free(buffer);
+    heap_caps_free(group);
+    heap_caps_free(list.files);
     return ret;
 }
 
-static esp_err_t run_update(msc_handle_t handle, bool incremental)
+static esp_err_t run_update_steps(msc_handle_t handle, bool incremental)
 {
     const char *mode = incremental ? "incremental" : "full";
     ESP_LOGI(TAG, "Running %s update...", mode);
@@ -474,30 +1370,57 @@ static esp_err_t run_update(msc_handle_t handle, bool incremental)
         return ESP_ERR_INVALID_STATE;
     }
 
-    esp_err_t ret = process_sync_files(MSC_SOUNDBOARD_DIR, incremental, true, handle);
+    sync_plan_t plan;
+    esp_err_t ret = sync_plan_build(&plan, MSC_SOUNDBOARD_DIR, incremental, handle);
     if (ret != ESP_OK) {
+        sync_plan_free(&plan);
         return ret;
     }
 
-    if (handle->total_files == 0) {
-        ESP_LOGI(TAG, "No files to copy");
+    if (handle->total_files == 0 && plan.to_delete == 0) {
+        ESP_LOGI(TAG, "No files to copy (%zu KB unchanged)", handle->sync_avoided_bytes / 1024);
+        sync_plan_free(&plan);
+        handle->sync_done = true;
+        // Nothing changed: only build banks if they were never built
+        struct stat bank_st;
+        if (stat(BANK_DIR_PATH, &bank_st) != 0 && build_sound_banks(handle) != ESP_OK) {
+            ESP_LOGW(TAG, "Sound bank build failed (per-file preload still works)");
+        }
         return ESP_OK;
     }
 
     ESP_LOGI(TAG, "Copying %d files from %s to %s...",
              handle->total_files, MSC_SOUNDBOARD_DIR, SDCARD_MOUNT_POINT);
 
-    ret = process_sync_files(MSC_SOUNDBOARD_DIR, incremental, false, handle);
+    ret = sync_apply(&plan, handle);
+    // Also after a failure: the manifest must describe what the SD card holds now
+    if (sync_write_manifest(&plan) != ESP_OK) {
+        ESP_LOGW(TAG, "Manifest not written (next incremental update copies everything)");
+    }
+    sync_plan_free(&plan);
+    handle->sync_done = true;
 
     if (ret == ESP_OK) {
-        ESP_LOGI(TAG, "%s update complete: %d/%d files copied",
-                 mode, handle->done_files, handle->total_files);
+        ESP_LOGI(TAG, "%s update complete: %d/%d files copied, %d unchanged (%zu KB avoided), %d deleted",
+                 mode, handle->done_files, handle->total_files, handle->sync_skipped,
+                 handle->sync_avoided_bytes / 1024, handle->sync_deleted);
+        if (build_sound_banks(handle) != ESP_OK) {
+            ESP_LOGW(TAG, "Sound bank build failed (per-file preload still works)");
+        }
     } else {
         ESP_LOGE(TAG, "%s update failed: %s", mode, esp_err_to_name(ret));
     }
     return ret;
 }
 
+static esp_err_t run_update(msc_handle_t handle, bool incremental)
+{
+    handle->updating = true;
+    esp_err_t ret = run_update_steps(handle, incremental);
+    handle->updating = false;
+    return ret;
+}
+
 /* ============================================================================
  * Queue Drain Helper
  * ============================================================================ */
@@ -733,6 +1656,9 @@ static void msc_fsm_task(void *arg)
             continue;
         }
 
+#ifdef TRACE_ENABLE
+        msc_fsm_state_t prev_state = h->state;
+#endif
         switch (h->state) {
             case MSC_STATE_WAIT_MSC:
                 if (evt.type == MSC_INTERNAL_USB_CONNECTED) {
@@ -761,6 +1687,11 @@ static void msc_fsm_task(void *arg)
                 ESP_LOGW(TAG, "FSM: unexpected event in state %d", h->state);
                 break;
         }
+#ifdef TRACE_ENABLE
+        if (h->state != prev_state) {
+            trace_event(TRACE_MSC_STATE, (uint16_t)h->state, evt.type);
+        }
+#endif
     }
 }
 
@@ -954,6 +1885,48 @@ void msc_on_input_event(msc_handle_t handle, uint8_t btn_num, input_event_type_t
     xQueueSend(handle->event_queue, &evt, 0);  // Non-blocking, drop if full
 }
 
+esp_err_t msc_run_copy_benchmark(msc_handle_t handle, const char *dst,
+                                 size_t *bytes, uint32_t *elapsed_us)
+{
+    if (handle == NULL || dst == NULL || bytes == NULL || elapsed_us == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->device == NULL || handle->updating) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Largest file of the soundboard directory: longest steady-state copy
+    DIR *dir = opendir(MSC_SOUNDBOARD_DIR);
+    if (dir == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    char src[SOUNDBOARD_MAX_PATH_LEN] = "";
+    char path[SOUNDBOARD_MAX_PATH_LEN];
+    off_t largest = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (snprintf(path, sizeof(path), "%s/%s", MSC_SOUNDBOARD_DIR, entry->d_name) >= (int)sizeof(path)) {
+            continue;
+        }
+        struct stat st;
+        if (stat(path, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > largest) {
+            largest = st.st_size;
+            strcpy(src, path);
+        }
+    }
+    closedir(dir);
+    if (src[0] == '\0') {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t ret = copy_file(src, dst, NULL, NULL);
+    *elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+    *bytes = (size_t)largest;
+    remove(dst);
+    return ret;
+}
+
 void msc_print_status(msc_handle_t handle, status_output_type_t output_type)
 {
     if (handle == NULL) {
@@ -988,6 +1961,12 @@ void msc_print_status(msc_handle_t handle, status_output_type_t output_type)
         printf("  Device: %s\n", device_connected ? "Connected" : "Not connected");
         printf("  USB Host: Running\n");
 
+        if (handle->sync_done) {
+            printf("  Last sync: %d copied, %d unchanged (%zu KB avoided), %d deleted\n",
+                   handle->done_files, handle->sync_skipped, handle->sync_avoided_bytes / 1024,
+                   handle->sync_deleted);
+        }
+
         if (output_type == STATUS_OUTPUT_VERBOSE) {
             if (device_connected) {
                 printf("  Device address: %d\n", handle->device_address);
@@ -133,6 +133,26 @@ esp_err_t msc_deinit(msc_handle_t handle);
  */
 void msc_on_input_event(msc_handle_t handle, uint8_t btn_num, input_event_type_t event);
 
+/**
+ * @brief Time the copy of one file from the USB drive to the SD card
+ *
+ * Copies the largest file of the drive's soundboard directory to dst with
+ * the update copy path, then deletes dst. Used by the benchmark suite.
+ *
+ * @param handle MSC handle returned from msc_init()
+ * @param dst Destination path on the SD card (removed afterwards)
+ * @param[out] bytes File size
+ * @param[out] elapsed_us Copy time (open to close)
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if a parameter is NULL
+ *     - ESP_ERR_INVALID_STATE if no drive is mounted or an update is running
+ *     - ESP_ERR_NOT_FOUND if the soundboard directory has no file
+ *     - copy error otherwise
+ */
+esp_err_t msc_run_copy_benchmark(msc_handle_t handle, const char *dst,
+                                 size_t *bytes, uint32_t *elapsed_us);
+
 /**
  * @brief Print MSC module status information to console
  *
@@ -0,0 +1,270 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file sync_manifest.c
+ * @brief MSC sync manifest file and xxHash32
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "sync_manifest.h"
+
+#define MANIFEST_HEADER     "# soundboard sync manifest"
+#define MANIFEST_TMP_SUFFIX ".tmp"
+#define MANIFEST_LINE_LEN   (SYNC_MANIFEST_PATH_LEN + 48)   // Hash, size, mtime, path
+
+#define XXH_PRIME1  0x9E3779B1u
+#define XXH_PRIME2  0x85EBCA77u
+#define XXH_PRIME3  0xC2B2AE3Du
+#define XXH_PRIME4  0x27D4EB2Fu
+#define XXH_PRIME5  0x165667B1u
+
+static const char *TAG = "sync_manifest";
+
+// ============================================================================
+// xxHash32
+// ============================================================================
+
+static inline uint32_t rotl32(uint32_t x, int r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline uint32_t read_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t xxh_round(uint32_t acc, uint32_t input)
+{
+    acc += input * XXH_PRIME2;
+    return rotl32(acc, 13) * XXH_PRIME1;
+}
+
+static void xxh_stripe(sync_hash_t *state, const uint8_t *p)
+{
+    state->acc[0] = xxh_round(state->acc[0], read_le32(p));
+    state->acc[1] = xxh_round(state->acc[1], read_le32(p + 4));
+    state->acc[2] = xxh_round(state->acc[2], read_le32(p + 8));
+    state->acc[3] = xxh_round(state->acc[3], read_le32(p + 12));
+}
+
+void sync_hash_init(sync_hash_t *state)
+{
+    memset(state, 0, sizeof(*state));
+    state->acc[0] = XXH_PRIME1 + XXH_PRIME2;
+    state->acc[1] = XXH_PRIME2;
+    state->acc[2] = 0;
+    state->acc[3] = 0u - XXH_PRIME1;
+}
+
+void sync_hash_update(sync_hash_t *state, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    state->total_len += (uint32_t)len;
+
+    // Complete a stripe left over from the previous call
+    if (state->buffered > 0) {
+        size_t fill = sizeof(state->buffer) - state->buffered;
+        if (len < fill) {
+            memcpy(state->buffer + state->buffered, p, len);
+            state->buffered += (uint8_t)len;
+            return;
+        }
+        memcpy(state->buffer + state->buffered, p, fill);
+        xxh_stripe(state, state->buffer);
+        p += fill;
+        len -= fill;
+        state->buffered = 0;
+    }
+
+    while (len >= sizeof(state->buffer)) {
+        xxh_stripe(state, p);
+        p += sizeof(state->buffer);
+        len -= sizeof(state->buffer);
+    }
+
+    memcpy(state->buffer, p, len);
+    state->buffered = (uint8_t)len;
+}
+
+uint32_t sync_hash_final(const sync_hash_t *state)
+{
+    uint32_t h;
+    if (state->total_len >= sizeof(state->buffer)) {
+        h = rotl32(state->acc[0], 1) + rotl32(state->acc[1], 7) +
+            rotl32(state->acc[2], 12) + rotl32(state->acc[3], 18);
+    } else {
+        h = XXH_PRIME5;     // Seed 0
+    }
+    h += state->total_len;
+
+    const uint8_t *p = state->buffer;
+    uint8_t left = state->buffered;
+    for (; left >= 4; left -= 4, p += 4) {
+        h += read_le32(p) * XXH_PRIME3;
+        h = rotl32(h, 17) * XXH_PRIME4;
+    }
+    for (; left > 0; left--, p++) {
+        h += *p * XXH_PRIME5;
+        h = rotl32(h, 11) * XXH_PRIME1;
+    }
+
+    h ^= h >> 15;
+    h *= XXH_PRIME2;
+    h ^= h >> 13;
+    h *= XXH_PRIME3;
+    h ^= h >> 16;
+    return h;
+}
+
+// ============================================================================
+// Manifest file
+// ============================================================================
+
+static int compare_entries(const void *a, const void *b)
+{
+    return strcmp(((const sync_manifest_entry_t *)a)->path, ((const sync_manifest_entry_t *)b)->path);
+}
+
+esp_err_t sync_manifest_load(const char *path, sync_manifest_t *manifest)
+{
+    manifest->entries = NULL;
+    manifest->count = 0;
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        ESP_LOGI(TAG, "No manifest at %s: full diff", path);
+        return ESP_OK;
+    }
+
+    char *line = heap_caps_malloc(MANIFEST_LINE_LEN, MALLOC_CAP_INTERNAL);
+    manifest->entries = heap_caps_calloc(SYNC_MANIFEST_MAX_ENTRIES, sizeof(sync_manifest_entry_t),
+                                         MALLOC_CAP_SPIRAM);
+    if (line == NULL || manifest->entries == NULL) {
+        heap_caps_free(line);
+        fclose(fp);
+        sync_manifest_free(manifest);
+        return ESP_ERR_NO_MEM;
+    }
+
+    int version = 0;
+    if (fgets(line, MANIFEST_LINE_LEN, fp) == NULL ||
+        sscanf(line, MANIFEST_HEADER " %d", &version) != 1 || version != SYNC_MANIFEST_VERSION) {
+        ESP_LOGW(TAG, "Ignoring manifest %s (version %d)", path, version);
+    } else {
+        while (manifest->count < SYNC_MANIFEST_MAX_ENTRIES && fgets(line, MANIFEST_LINE_LEN, fp) != NULL) {
+            line[strcspn(line, "\r\n")] = '\0';
+            sync_manifest_entry_t *entry = &manifest->entries[manifest->count];
+            int64_t mtime;
+            int path_pos = 0;
+            if (line[0] == '#' ||
+                sscanf(line, "%" SCNx32 " %" SCNu32 " %" SCNd64 " %n",
+                       &entry->hash, &entry->size, &mtime, &path_pos) != 3 ||
+                path_pos == 0 || line[path_pos] == '\0' ||
+                strlen(line + path_pos) >= sizeof(entry->path)) {
+                continue;
+            }
+            entry->mtime = mtime;
+            strcpy(entry->path, line + path_pos);
+            entry->seen = false;
+            manifest->count++;
+        }
+    }
+
+    heap_caps_free(line);
+    fclose(fp);
+
+    qsort(manifest->entries, manifest->count, sizeof(sync_manifest_entry_t), compare_entries);
+    ESP_LOGI(TAG, "Loaded manifest: %d entries", manifest->count);
+    return ESP_OK;
+}
+
+void sync_manifest_free(sync_manifest_t *manifest)
+{
+    heap_caps_free(manifest->entries);
+    manifest->entries = NULL;
+    manifest->count = 0;
+}
+
+sync_manifest_entry_t *sync_manifest_find(const sync_manifest_t *manifest, const char *path)
+{
+    int lo = 0;
+    int hi = manifest->count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(path, manifest->entries[mid].path);
+        if (cmp == 0) {
+            return &manifest->entries[mid];
+        }
+        if (cmp < 0) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return NULL;
+}
+
+static void tmp_path_of(char *out, size_t out_size, const char *path)
+{
+    snprintf(out, out_size, "%s" MANIFEST_TMP_SUFFIX, path);
+}
+
+esp_err_t sync_manifest_writer_open(sync_manifest_writer_t *writer, const char *path)
+{
+    char tmp_path[SOUNDBOARD_MAX_PATH_LEN + sizeof(MANIFEST_TMP_SUFFIX)];
+    tmp_path_of(tmp_path, sizeof(tmp_path), path);
+
+    writer->path = path;
+    writer->count = 0;
+    writer->failed = false;
+    writer->fp = fopen(tmp_path, "w");
+    if (writer->fp == NULL) {
+        ESP_LOGE(TAG, "Failed to create %s", tmp_path);
+        return ESP_FAIL;
+    }
+    writer->failed = fprintf(writer->fp, MANIFEST_HEADER " %d\n", SYNC_MANIFEST_VERSION) < 0;
+    return ESP_OK;
+}
+
+void sync_manifest_writer_add(sync_manifest_writer_t *writer, const sync_manifest_entry_t *entry)
+{
+    if (writer->fp == NULL || writer->failed) {
+        return;
+    }
+    writer->failed = fprintf(writer->fp, "%08" PRIx32 " %" PRIu32 " %" PRId64 " %s\n",
+                             entry->hash, entry->size, entry->mtime, entry->path) < 0;
+    writer->count++;
+}
+
+esp_err_t sync_manifest_writer_close(sync_manifest_writer_t *writer)
+{
+    if (writer->fp == NULL) {
+        return ESP_FAIL;
+    }
+
+    char tmp_path[SOUNDBOARD_MAX_PATH_LEN + sizeof(MANIFEST_TMP_SUFFIX)];
+    tmp_path_of(tmp_path, sizeof(tmp_path), writer->path);
+
+    bool ok = (fclose(writer->fp) == 0) && !writer->failed;
+    writer->fp = NULL;
+    if (ok) {
+        remove(writer->path);
+        ok = (rename(tmp_path, writer->path) == 0);
+    }
+    if (!ok) {
+        ESP_LOGE(TAG, "Failed to write manifest %s", writer->path);
+        remove(tmp_path);
+        return ESP_FAIL;
+    }
+    ESP_LOGI(TAG, "Manifest written: %d entries", writer->count);
+    return ESP_OK;
+}
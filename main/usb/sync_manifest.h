@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Vincent (Soundboard Project)
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file sync_manifest.h
+ * @brief Record of the files an MSC sync copied to the SD card
+ *
+ * The manifest lists every file copied from the USB drive with its size,
+ * source mtime and an xxHash32 of its content (computed while copying). The
+ * incremental sync diffs the USB drive against it in one directory walk:
+ * unchanged files are skipped, files with a new mtime but the same size are
+ * hashed on the USB side and only written when the content differs, and files
+ * gone from the drive are deleted from the SD card. Files the manifest does
+ * not list are never deleted.
+ *
+ * Text file, one entry per line after a version header; the path comes last
+ * so it may contain spaces:
+ *
+ *   # soundboard sync manifest 1
+ *   <hash, 8 hex digits> <size> <mtime> <path relative to the sync root>
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "esp_err.h"
+#include "soundboard.h"
+
+#define SYNC_MANIFEST_VERSION       1
+#define SYNC_MANIFEST_MAX_ENTRIES   512
+#define SYNC_MANIFEST_PATH_LEN      SOUNDBOARD_MAX_PATH_LEN
+
+/**
+ * @brief One synced file
+ */
+typedef struct {
+    char path[SYNC_MANIFEST_PATH_LEN];  // Relative to the sync root ("fx/boom.wav")
+    uint32_t size;
+    int64_t mtime;                      // Source (USB drive) modification time
+    uint32_t hash;                      // xxHash32 (seed 0) of the content
+    bool seen;                          // Set by the sync walk: file still on the USB drive
+} sync_manifest_entry_t;
+
+/**
+ * @brief Manifest loaded in memory (entries sorted by path)
+ */
+typedef struct {
+    sync_manifest_entry_t *entries;     // PSRAM
+    int count;
+} sync_manifest_t;
+
+/**
+ * @brief Incremental manifest writer (temporary file renamed on close)
+ */
+typedef struct {
+    FILE *fp;
+    const char *path;
+    int count;
+    bool failed;
+} sync_manifest_writer_t;
+
+/**
+ * @brief Streaming xxHash32 state
+ */
+typedef struct {
+    uint32_t acc[4];
+    uint32_t total_len;
+    uint8_t buffer[16];
+    uint8_t buffered;
+} sync_hash_t;
+
+/**
+ * @brief Load a manifest
+ *
+ * A missing or unreadable file, or one of another version, loads as an
+ * empty manifest (everything is copied again). Malformed lines are skipped.
+ *
+ * @return
+ *     - ESP_OK (possibly empty)
+ *     - ESP_ERR_NO_MEM if the entry array could not be allocated
+ */
+esp_err_t sync_manifest_load(const char *path, sync_manifest_t *manifest);
+
+/**
+ * @brief Free the entries of a loaded manifest
+ */
+void sync_manifest_free(sync_manifest_t *manifest);
+
+/**
+ * @brief Find the entry of a relative path (binary search)
+ *
+ * @return Entry, or NULL if the path is not listed
+ */
+sync_manifest_entry_t *sync_manifest_find(const sync_manifest_t *manifest, const char *path);
+
+/**
+ * @brief Start writing a manifest to <path>.tmp
+ */
+esp_err_t sync_manifest_writer_open(sync_manifest_writer_t *writer, const char *path);
+
+/**
+ * @brief Append one entry (errors are reported by sync_manifest_writer_close())
+ */
+void sync_manifest_writer_add(sync_manifest_writer_t *writer, const sync_manifest_entry_t *entry);
+
+/**
+ * @brief Finish the manifest: replaces path on success, deletes the temporary file otherwise
+ *
+ * @return ESP_OK, or ESP_FAIL if a write or the rename failed
+ */
+esp_err_t sync_manifest_writer_close(sync_manifest_writer_t *writer);
+
+/**
+ * @brief Streaming xxHash32: init, feed any number of chunks, then final
+ */
+void sync_hash_init(sync_hash_t *state);
+void sync_hash_update(sync_hash_t *state, const void *data, size_t len);
+uint32_t sync_hash_final(const sync_hash_t *state);
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+Event Trace Converter for Soundboard Project
+Converts the output of the console 'trace dump' / 'trace save' commands to
+Chrome trace event JSON (open in https://ui.perfetto.dev or chrome://tracing)
+
+Usage: python3 scripts/trace_to_json.py <trace.csv|-> [output.json]
+
+Lines other than the trace lines (log output captured from the UART with the
+dump) are ignored.
+"""
+
+import json
+import sys
+
+TIME_WRAP = 1 << 32     # Records carry the low 32 bits of the esp_timer time (us)
+
+
+def parse(lines):
+    """Return (tasks, events, records) from the dump lines."""
+    tasks = {}
+    events = {}
+    records = []
+    for line in lines:
+        fields = line.strip().split(',')
+        kind = fields[0]
+        if kind == 'task' and len(fields) >= 3:
+            tasks[fields[1]] = ','.join(fields[2:])
+        elif kind == 'event' and len(fields) == 7:
+            events[int(fields[1])] = {
+                'name': fields[2],
+                'cat': fields[3],
+                'ph': fields[4],
+                'a': fields[5],
+                'b': fields[6],
+            }
+        elif kind == 'rec' and len(fields) == 8:
+            try:
+                t_us, dur_us, core = int(fields[1]), int(fields[2]), int(fields[3])
+                event, a, b = int(fields[5]), int(fields[6]), int(fields[7])
+            except ValueError:
+                continue        # Line garbled by interleaved log output
+            records.append((t_us, dur_us, core, fields[4], event, a, b))
+    return tasks, events, records
+
+
+def convert(tasks, events, records):
+    """Build the Chrome trace event list (one thread per task)."""
+    tids = {}
+    out = []
+
+    def tid_of(handle):
+        if handle not in tids:
+            tids[handle] = len(tids) + 1
+            out.append({'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': tids[handle],
+                        'args': {'name': tasks.get(handle, 'task ' + handle)}})
+        return tids[handle]
+
+    out.append({'name': 'process_name', 'ph': 'M', 'pid': 1, 'args': {'name': 'soundboard'}})
+
+    # Unwrap the 32-bit timestamps: each one is taken nearest to the latest time seen
+    # (ring order is time order, except span starts)
+    now = None
+    for t_us, dur_us, core, handle, event, a, b in records:
+        if now is None:
+            ts = t_us
+        else:
+            ts = now + ((t_us - now + TIME_WRAP // 2) % TIME_WRAP) - TIME_WRAP // 2
+        now = ts if now is None else max(now, ts)
+        desc = events.get(event, {'name': 'event %d' % event, 'cat': 'unknown', 'ph': 'i', 'a': 'a', 'b': 'b'})
+        args = {'core': core}
+        if desc['a']:
+            args[desc['a']] = a
+        if desc['b']:
+            args[desc['b']] = b
+        entry = {'name': desc['name'], 'cat': desc['cat'], 'ph': desc['ph'], 'ts': ts,
+                 'pid': 1, 'tid': tid_of(handle), 'args': args}
+        if desc['ph'] == 'X':
+            entry['dur'] = dur_us
+        else:
+            entry['s'] = 't'
+        out.append(entry)
+    return out
+
+
+def main():
+    if len(sys.argv) < 2 or len(sys.argv) > 3:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+    if sys.argv[1] == '-':
+        tasks, events, records = parse(sys.stdin)
+    else:
+        with open(sys.argv[1], encoding='utf-8', errors='replace') as f:
+            tasks, events, records = parse(f)
+    if not records:
+        print("No trace records found", file=sys.stderr)
+        sys.exit(1)
+
+    trace = {'traceEvents': convert(tasks, events, records), 'displayTimeUnit': 'ms'}
+    if len(sys.argv) == 3:
+        with open(sys.argv[2], 'w', encoding='utf-8') as f:
+            json.dump(trace, f)
+        print("%d events written to %s" % (len(records), sys.argv[2]), file=sys.stderr)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
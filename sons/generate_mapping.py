@@ -11,9 +11,16 @@ This script:
 6. Creates new mapping entries for unmapped WAV files
 7. Outputs result as mappings_generated.csv
 
+With --align-data, the WAV files are first rewritten so that their PCM data
+starts on a 512-byte boundary (a JUNK chunk pads the headers): the firmware
+then reads them with whole-sector reads from the first byte. --align-only
+pads the files without generating the mappings (used by normalize.sh).
+
 Supported actions: play, play_cut, play_lock (each takes a single file parameter)
 """
 
+import argparse
+import struct
 from dataclasses import dataclass
 from datetime import datetime
 from typing import Optional
@@ -31,6 +38,7 @@ VALID_ACTIONS = {
 VALID_EVENTS = {"press", "long_press", "release"}
 VALID_BUTTONS = set(range(1, 13))  # 1-12
 MAX_PAGE_NAME_LENGTH = 31
+DATA_ALIGN = 512  # SD card sector size
 
 
 @dataclass
@@ -208,6 +216,66 @@ def get_referenced_files(mappings: list[MappingLine]) -> set:
     return files
 
 
+def align_wav_data(path: Path, boundary: int = DATA_ALIGN) -> bool:
+    """Pad a WAV file so its data chunk payload starts on a boundary.
+
+    A JUNK chunk is placed right before the data chunk (replacing the padding
+    of an earlier run); other chunks are kept in order.
+    Returns True if the file was rewritten, False if it was already aligned.
+    """
+    raw = path.read_bytes()
+    if len(raw) < 12 or raw[0:4] != b'RIFF' or raw[8:12] != b'WAVE':
+        raise ValueError("not a RIFF/WAVE file")
+
+    chunks = []  # (id, payload) before the data chunk
+    pos = 12
+    while pos + 8 <= len(raw):
+        chunk_id = raw[pos:pos + 4]
+        size = struct.unpack('<I', raw[pos + 4:pos + 8])[0]
+        if chunk_id == b'data':
+            break
+        chunks.append((chunk_id, raw[pos + 8:pos + 8 + size]))
+        pos += 8 + size + (size & 1)
+    else:
+        raise ValueError("no data chunk")
+    if (pos + 8) % boundary == 0:
+        return False
+
+    size = struct.unpack('<I', raw[pos + 4:pos + 8])[0]
+    data = raw[pos + 8:pos + 8 + size]
+    trailer = raw[pos + 8 + size + (size & 1):]  # Chunks after the data (LIST, id3)
+    while chunks and chunks[-1][0] == b'JUNK':
+        chunks.pop()
+
+    out = bytearray(raw[0:12])
+    for chunk_id, payload in chunks:
+        out += chunk_id + struct.pack('<I', len(payload)) + payload + b'\0' * (len(payload) & 1)
+    pad = -(len(out) + 16) % boundary  # JUNK and data chunk headers
+    out += b'JUNK' + struct.pack('<I', pad) + bytes(pad)
+    out += b'data' + struct.pack('<I', len(data)) + data + b'\0' * (len(data) & 1)
+    out += trailer
+    out[4:8] = struct.pack('<I', len(out) - 8)
+
+    tmp = path.with_suffix('.wav.tmp')
+    tmp.write_bytes(out)
+    tmp.replace(path)
+    return True
+
+
+def align_wav_files(directory: Path):
+    """Align the data chunk of every WAV file in directory."""
+    aligned = 0
+    wav_files = sorted(directory.glob('*.wav')) if directory.exists() else []
+    for path in wav_files:
+        try:
+            if align_wav_data(path):
+                aligned += 1
+        except ValueError as e:
+            print(f"WARNING: {path.name}: {e}, not aligned")
+    print(f"Aligned WAV data chunks to {DATA_ALIGN} bytes: {aligned} of {len(wav_files)} files rewritten")
+    print()
+
+
 def get_wav_files(directory: Path) -> set:
     """Get all .wav files in directory."""
     if not directory.exists():
@@ -418,4 +486,14 @@ def generate_mappings():
 
 
 if __name__ == "__main__":
-    generate_mappings()
+    parser = argparse.ArgumentParser(description="Generate mappings_generated.csv from soundboard/")
+    parser.add_argument('--align-data', action='store_true',
+                        help=f"pad the WAV data chunks to a {DATA_ALIGN}-byte boundary first")
+    parser.add_argument('--align-only', action='store_true',
+                        help="pad the WAV data chunks, do not generate the mappings")
+    args = parser.parse_args()
+
+    if args.align_data or args.align_only:
+        align_wav_files(Path(__file__).parent / 'soundboard')
+    if not args.align_only:
+        generate_mappings()
@@ -27,7 +27,10 @@ ffmpeg-normalize \
   --force \
   --extension wav \
   --output-folder "$OUT_FOLDER" \
-  "${files[@]}"
+  "${files[@]}" || exit 1
+
+# Pad the data chunks to a 512-byte boundary (sector-aligned reads on the SD card)
+python3 "$(dirname "$0")/generate_mapping.py" --align-only
 
 
 